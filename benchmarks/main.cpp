@@ -0,0 +1,1271 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+// Microbenchmarks for the CPU-side hot paths of the sample that do not need a GPU, D3D or the
+// NVIGI runtime.  Results are written as JSON so they can be compared between builds.
+//
+// Usage: NVIGISampleBenchmarks [-out <file.json>] [-filter <substring>] [-minTime <seconds>] [-repetitions <n>]
+//
+// When built with the plugin headers, the inference_host cases start the executable again with
+// -inferenceHost <name> to serve the synthetic backend, as the sample does with -outOfProcess, and
+// check the callback sequences of its evaluates both in-process and through the host.
+
+#include "AudioRecordingHelper.h"
+#include "AudioToBytes.h"
+#include "ChatLog.h"
+#include "ConversationHistory.h"
+#include "FramePacer.h"
+#include "ModelCatalog.h"
+#include "SharedRing.h"
+#include "StructuredOutput.h"
+#include "TokenQueue.h"
+#include "TTSStream.h"
+
+#ifdef NVIGI_BENCH_INFERENCE_HOST
+#include "InferenceHost.h"
+#include "SyntheticBackend.h"
+
+#include <nvigi.h>
+#include <nvigi_ai.h>
+#include <nvigi_gpt.h>
+#include <nvigi_stl_helpers.h>
+#include <nvigi_tts.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Options
+    {
+        std::string m_out;
+        std::string m_filter;
+        double m_minTime = 0.2;
+        int m_repetitions = 5;
+    };
+
+    struct Result
+    {
+        std::string m_name;
+        // Units of work per operation, e.g. samples or bytes, used for the rate
+        double m_itemsPerOp = 1.0;
+        const char* m_itemName = "items";
+        uint64_t m_iterations = 0;
+        double m_minNs = 0.0;
+        double m_medianNs = 0.0;
+        double m_maxNs = 0.0;
+        // Extra measurements of the benchmark, written next to the timings
+        std::vector<std::pair<std::string, double>> m_metrics;
+    };
+
+    // Keeps the optimizer from discarding a benchmark's result
+    volatile uint64_t g_sink = 0;
+
+    template <typename T>
+    void Consume(const T& value)
+    {
+        g_sink = g_sink + (uint64_t)value;
+    }
+
+    // Runs op in batches that double until a batch takes minTime, then times that batch size
+    // repetitions times and reports nanoseconds per op
+    Result Run(const Options& options, const std::string& name, double itemsPerOp, const char* itemName, const std::function<void()>& op)
+    {
+        Result result;
+        result.m_name = name;
+        result.m_itemsPerOp = itemsPerOp;
+        result.m_itemName = itemName;
+
+        auto timeBatch = [&op](uint64_t count)->double
+            {
+                auto start = Clock::now();
+                for (uint64_t i = 0; i < count; i++)
+                    op();
+                return std::chrono::duration<double>(Clock::now() - start).count();
+            };
+
+        uint64_t batch = 1;
+        while (timeBatch(batch) < options.m_minTime && batch < (1ull << 40))
+            batch *= 2;
+
+        std::vector<double> ns;
+        for (int r = 0; r < options.m_repetitions; r++)
+            ns.push_back(timeBatch(batch) * 1e9 / batch);
+        std::sort(ns.begin(), ns.end());
+
+        result.m_iterations = batch;
+        result.m_minNs = ns.front();
+        result.m_medianNs = ns[ns.size() / 2];
+        result.m_maxNs = ns.back();
+        return result;
+    }
+
+    // Deterministic filler so runs are comparable
+    uint32_t NextRandom(uint32_t& state)
+    {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+
+    // A typical GPT answer, with the markdown emphasis the models like to produce
+    std::string MakeAnswer()
+    {
+        const char* sentences[] = {
+            "The **main** hall of the palace is lit by candles, and the light falls across the floor. ",
+            "You can see 3*5 columns on each side, each one carved with *ornate* patterns.\n",
+            "Would you like to hear more about the history of this place? ",
+            "It was built over many years, by craftsmen who came from far away, and who never returned home! ",
+            "\"Stay a while,\" says the guard, \"and listen.\" ",
+        };
+        std::string answer;
+        for (int i = 0; i < 8; i++)
+            for (const char* s : sentences)
+                answer += s;
+        return answer;
+    }
+
+    // GPT streams roughly one word piece per callback
+    std::vector<std::string> SplitTokens(const std::string& text)
+    {
+        std::vector<std::string> tokens;
+        size_t pos = 0;
+        uint32_t state = 7;
+        while (pos < text.size())
+        {
+            size_t len = 1 + NextRandom(state) % 6;
+            tokens.push_back(text.substr(pos, len));
+            pos += len;
+        }
+        return tokens;
+    }
+
+    nvigi::PluginID MakePluginID(uint32_t n)
+    {
+        return nvigi::PluginID{ { n, 0, 0, { 0 } }, n };
+    }
+
+    // Roughly the shape of a full models tree: each model is offered by several backends
+    struct CatalogFixture
+    {
+        static constexpr uint32_t kModels = 24;
+        static constexpr uint32_t kPlugins = 5;
+
+        ModelCatalog m_catalog;
+        nvigi::PluginID m_nvdaID = MakePluginID(1);
+        nvigi::PluginID m_gpuID = MakePluginID(2);
+        size_t m_vramBudget = 8 * 1024;
+
+        CatalogFixture()
+        {
+            const char* plugins[kPlugins] = { "ggml.cuda", "ggml.d3d12", "ggml.vk", "ggml.cpu", "cloud.rest" };
+            std::vector<std::string> strings;
+            uint32_t state = 11;
+            for (uint32_t m = 0; m < kModels; m++)
+            {
+                char guid[64];
+                snprintf(guid, sizeof(guid), "{%08X-0000-0000-0000-%012u}", NextRandom(state), m);
+                std::string modelName = "Model " + std::to_string(m);
+                std::string modelRoot = std::string("nvigi.models/") + guid;
+                for (uint32_t p = 0; p < kPlugins; p++)
+                {
+                    ModelCatalog::ModelDesc desc;
+                    desc.m_modelName = modelName;
+                    desc.m_pluginName = plugins[p];
+                    desc.m_guid = guid;
+                    desc.m_modelRoot = modelRoot;
+                    desc.m_vram = 1024 + NextRandom(state) % (12 * 1024);
+                    desc.m_featureID = MakePluginID(p + 1);
+                    desc.m_modelStatus = p == 4 ? ModelStatus::AVAILABLE_CLOUD :
+                        (NextRandom(state) % 4 ? ModelStatus::AVAILABLE_LOCALLY : ModelStatus::AVAILABLE_MANUAL_DOWNLOAD);
+                    m_catalog.Add(desc);
+                }
+            }
+            m_catalog.Finalize();
+        }
+    };
+
+    // The chat as BuildChatUI sees it: a bounded list of answers that each frame walks in full
+    struct ChatFixture
+    {
+        static constexpr size_t kMaxMessageBytes = 2048;
+        static constexpr size_t kMaxMessages = 32;
+
+        std::vector<std::string> m_messages = { "" };
+
+        void Append(std::string_view text)
+        {
+            if (m_messages.back().size() >= kMaxMessageBytes)
+            {
+                if (m_messages.size() == kMaxMessages)
+                    m_messages.erase(m_messages.begin());
+                m_messages.emplace_back();
+            }
+            m_messages.back().append(text);
+        }
+
+        // Stands in for laying out the text: touches every byte
+        size_t Walk() const
+        {
+            size_t lines = 0;
+            for (const auto& message : m_messages)
+                lines += std::count(message.begin(), message.end(), ' ');
+            return lines;
+        }
+    };
+
+    // Streams tokens from its own thread at a fixed rate, far above what a GPT model produces
+    class TokenProducer
+    {
+    public:
+        static constexpr double kTokensPerSecond = 50000.0;
+
+        TokenProducer(const std::vector<std::string>& tokens, std::function<void(const std::string&)> push)
+        {
+            m_thread = std::thread([this, &tokens, push]()
+                {
+                    auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / kTokensPerSecond));
+                    auto next = Clock::now();
+                    for (size_t i = 0; !m_stop; i = (i + 1) % tokens.size())
+                    {
+                        while (Clock::now() < next)
+                            ;
+                        next += interval;
+                        push(tokens[i]);
+                    }
+                });
+        }
+        ~TokenProducer()
+        {
+            m_stop = true;
+            m_thread.join();
+        }
+
+    private:
+        std::atomic<bool> m_stop = false;
+        std::thread m_thread;
+    };
+
+#ifdef NVIGI_BENCH_INFERENCE_HOST
+    // Host and parent run the synthetic backend without any pacing, so only the IPC is measured
+    void SetUnpacedSyntheticConfig()
+    {
+        SyntheticBackend::Config config;
+        config.m_loadMs = 0.0;
+        config.m_ttftMs = 0.0;
+        config.m_tokensPerSecond = 0.0;
+        config.m_asrRTF = 0.0;
+        config.m_ttsRTF = 0.0;
+        config.m_jitter = 0.0;
+        SyntheticBackend::SetConfig(config);
+    }
+
+    nvigi::Result ResolveSynthetic(nvigi::PluginID id, nvigi::InferenceInterface** inference)
+    {
+        *inference = SyntheticBackend::GetInterface(id);
+        return *inference ? nvigi::kResultOk : nvigi::kResultItemNotFound;
+    }
+
+    // Counts the callbacks of an evaluate and touches their output the way the sample's callbacks do
+    nvigi::InferenceExecutionState CountOutputs(const nvigi::InferenceExecutionContext* ctx, nvigi::InferenceExecutionState state, void* userData)
+    {
+        auto count = (size_t*)userData;
+        const nvigi::InferenceDataText* text{};
+        const nvigi::InferenceDataByteArray* bytes{};
+        if (ctx->outputs && ctx->outputs->findAndValidateSlot(nvigi::kGPTDataSlotResponse, &text))
+            Consume(strlen(text->getUTF8Text()));
+        else if (ctx->outputs && ctx->outputs->findAndValidateSlot(nvigi::kTTSDataSlotOutputAudio, &bytes))
+            Consume(nvigi::castTo<nvigi::CpuData>(bytes->bytes)->sizeInBytes);
+        if (state == nvigi::kInferenceExecutionStateDataPending)
+            (*count)++;
+        return state;
+    }
+
+    // The states an evaluate called back with, cancelling at callback m_cancelAt
+    struct CallbackTrace
+    {
+        std::vector<nvigi::InferenceExecutionState> m_states;
+        size_t m_cancelAt = SIZE_MAX;
+    };
+
+    nvigi::InferenceExecutionState RecordStates(const nvigi::InferenceExecutionContext*, nvigi::InferenceExecutionState state, void* userData)
+    {
+        auto trace = (CallbackTrace*)userData;
+        trace->m_states.push_back(state);
+        return trace->m_states.size() == trace->m_cancelAt + 1 ? nvigi::kInferenceExecutionStateCancel : state;
+    }
+
+    // Evaluates to the end, then cancels at the first and at a middle callback. A whole evaluate must call
+    // back with DataPending until exactly one Done; a cancelled one must stop at the callback that cancelled.
+    // Counts the evaluates that did not in mismatches, reporting the first.
+    void CheckCallbackSequences(const char* name, nvigi::InferenceInstance* instance, nvigi::InferenceExecutionContext ctx, uint32_t& mismatches)
+    {
+        CallbackTrace full;
+        ctx.callback = RecordStates;
+        ctx.callbackUserData = &full;
+        nvigi::Result result = instance->evaluate(&ctx);
+        size_t count = full.m_states.size();
+        bool ok = result == nvigi::kResultOk && count >= 3 && full.m_states.back() == nvigi::kInferenceExecutionStateDone &&
+            std::count(full.m_states.begin(), full.m_states.end(), nvigi::kInferenceExecutionStateDataPending) == (ptrdiff_t)count - 1;
+        if (!ok && mismatches++ == 0)
+            fprintf(stderr, "%s: evaluate returned %d after %zu callbacks, not DataPending until one Done\n", name, (int)result, count);
+        if (count < 3)
+            return;
+
+        for (size_t cancelAt : { (size_t)0, count / 2 })
+        {
+            CallbackTrace cancelled;
+            cancelled.m_cancelAt = cancelAt;
+            ctx.callbackUserData = &cancelled;
+            result = instance->evaluate(&ctx);
+            ok = result == nvigi::kResultOk && cancelled.m_states.size() == cancelAt + 1 &&
+                std::count(cancelled.m_states.begin(), cancelled.m_states.end(), nvigi::kInferenceExecutionStateDataPending) == (ptrdiff_t)cancelAt + 1;
+            if (!ok && mismatches++ == 0)
+                fprintf(stderr, "%s: evaluate cancelled at callback %zu returned %d after %zu callbacks\n", name, cancelAt, (int)result,
+                    cancelled.m_states.size());
+        }
+    }
+#endif
+
+    // A response with <JSON> segments for the structured output checks: the input as the model would
+    // stream it, and the text and events it must parse to when every segment is well formed
+    struct StructuredStream
+    {
+        std::string m_input;
+        std::string m_text;
+        std::vector<std::string> m_events;
+    };
+
+    void AppendUTF8(std::string& out, uint32_t codePoint)
+    {
+        if (codePoint < 0x80)
+            out += (char)codePoint;
+        else if (codePoint < 0x800)
+            out += { (char)(0xC0 | (codePoint >> 6)), (char)(0x80 | (codePoint & 0x3F)) };
+        else if (codePoint < 0x10000)
+            out += { (char)(0xE0 | (codePoint >> 12)), (char)(0x80 | ((codePoint >> 6) & 0x3F)), (char)(0x80 | (codePoint & 0x3F)) };
+        else
+            out += { (char)(0xF0 | (codePoint >> 18)), (char)(0x80 | ((codePoint >> 12) & 0x3F)), (char)(0x80 | ((codePoint >> 6) & 0x3F)),
+                (char)(0x80 | (codePoint & 0x3F)) };
+    }
+
+    // Writes a random string both as JSON (with every escape form) and decoded
+    void GenerateString(uint32_t& state, std::string& input, std::string& decoded)
+    {
+        static const uint32_t codePoints[] = { 'a', 'z', ' ', '<', '>', '/', '{', '}', '"', '\\', '\n', '\t', 0x01, 0xE9, 0x20AC, 0x1F600 };
+        input += '"';
+        for (uint32_t n = NextRandom(state) % 12; n > 0; n--)
+        {
+            uint32_t cp = codePoints[NextRandom(state) % (sizeof(codePoints) / sizeof(codePoints[0]))];
+            AppendUTF8(decoded, cp);
+            char buffer[16];
+            if (cp == '"' || cp == '\\')
+            {
+                input += '\\';
+                input += (char)cp;
+            }
+            else if (cp == '\n')
+            {
+                input += "\\n";
+            }
+            else if (cp >= 0x10000)
+            {
+                uint32_t v = cp - 0x10000;
+                snprintf(buffer, sizeof(buffer), "\\u%04X\\u%04x", 0xD800 + (v >> 10), 0xDC00 + (v & 0x3FF));
+                input += buffer;
+            }
+            else if (cp < 0x20 || NextRandom(state) % 3 == 0)
+            {
+                snprintf(buffer, sizeof(buffer), "\\u%04x", cp);
+                input += buffer;
+            }
+            else
+            {
+                AppendUTF8(input, cp);
+            }
+        }
+        input += '"';
+    }
+
+    void GenerateValue(uint32_t& state, int depth, std::string& input, JsonValue& value)
+    {
+        const char* spaces[] = { "", "", " ", "\n  " };
+        uint32_t kind = NextRandom(state) % (depth < 4 ? 7 : 5);
+        switch (kind)
+        {
+        case 0:
+            value.m_type = JsonValue::Type::Null;
+            input += "null";
+            break;
+        case 1:
+            value.m_type = JsonValue::Type::Bool;
+            value.m_bool = NextRandom(state) % 2 == 0;
+            input += value.m_bool ? "true" : "false";
+            break;
+        case 2:
+        case 3:
+        {
+            // Values that print the same way they are written
+            static const char* numbers[] = { "0", "42", "-3", "0.5", "12.25", "-0.125", "1e+21", "250000" };
+            const char* number = numbers[NextRandom(state) % (sizeof(numbers) / sizeof(numbers[0]))];
+            value.m_type = JsonValue::Type::Number;
+            value.m_number = atof(number);
+            input += number;
+            break;
+        }
+        case 4:
+            value.m_type = JsonValue::Type::String;
+            GenerateString(state, input, value.m_string);
+            break;
+        default:
+        {
+            bool object = kind == 6;
+            value.m_type = object ? JsonValue::Type::Object : JsonValue::Type::Array;
+            input += object ? '{' : '[';
+            for (uint32_t n = NextRandom(state) % 4, i = 0; i < n; i++)
+            {
+                if (i)
+                    input += ',';
+                input += spaces[NextRandom(state) % 4];
+                if (object)
+                {
+                    value.m_keys.emplace_back();
+                    GenerateString(state, input, value.m_keys.back());
+                    input += spaces[NextRandom(state) % 4];
+                    input += ':';
+                }
+                value.m_items.emplace_back();
+                GenerateValue(state, depth + 1, input, value.m_items.back());
+            }
+            input += spaces[NextRandom(state) % 4];
+            input += object ? '}' : ']';
+            break;
+        }
+        }
+    }
+
+    // Text with near-misses of both tags, and well-formed segments, some with a closing tag
+    StructuredStream GenerateStructuredStream(uint32_t& state, const std::string& answer)
+    {
+        static const char* nearMisses[] = { "a < b ", "<", "<J ", "<JSO ", "<json> ", "x</JSON> ", "<b>", "<<" };
+        StructuredStream stream;
+        for (uint32_t pieces = 1 + NextRandom(state) % 12; pieces > 0; pieces--)
+        {
+            uint32_t kind = NextRandom(state) % 4;
+            if (kind == 0)
+            {
+                const char* text = nearMisses[NextRandom(state) % (sizeof(nearMisses) / sizeof(nearMisses[0]))];
+                stream.m_input += text;
+                stream.m_text += text;
+            }
+            else if (kind == 1)
+            {
+                JsonValue value;
+                stream.m_input += "<JSON>";
+                if (NextRandom(state) % 2)
+                {
+                    // The shape of a game action
+                    value.m_type = JsonValue::Type::Object;
+                    value.m_keys = { "action", "target" };
+                    value.m_items.resize(2);
+                    value.m_items[0].m_type = JsonValue::Type::String;
+                    value.m_items[0].m_string = "move_to";
+                    stream.m_input += "{\"action\": \"move_to\", \"target\": ";
+                    GenerateValue(state, 1, stream.m_input, value.m_items[1]);
+                    stream.m_input += "}";
+                }
+                else
+                {
+                    GenerateValue(state, 0, stream.m_input, value);
+                }
+                if (NextRandom(state) % 2)
+                    stream.m_input += NextRandom(state) % 2 ? "</JSON>" : " </JSON>";
+                // A bare number only ends at the next byte, and the text must not continue it
+                stream.m_input += ' ';
+                stream.m_text += ' ';
+                stream.m_events.push_back(value.ToJSON());
+            }
+            else
+            {
+                size_t start = NextRandom(state) % answer.size();
+                std::string text = answer.substr(start, 1 + NextRandom(state) % 80);
+                stream.m_input += text;
+                stream.m_text += text;
+            }
+        }
+        return stream;
+    }
+
+    // Damages a stream: truncates, drops or repeats a byte, or splices in random bytes
+    void CorruptStructuredStream(uint32_t& state, std::string& input)
+    {
+        static const char bytes[] = "{}[]\":,\\u0123456789.eE+-tfnrl <>/JSON \n";
+        size_t at = NextRandom(state) % (input.size() + 1);
+        switch (NextRandom(state) % 4)
+        {
+        case 0:
+            input.resize(at);
+            break;
+        case 1:
+            if (at < input.size())
+                input.erase(at, 1);
+            break;
+        case 2:
+            if (at < input.size())
+                input.insert(at, 1, input[at]);
+            break;
+        default:
+            for (uint32_t n = 1 + NextRandom(state) % 16; n > 0; n--)
+                input.insert(input.begin() + at, bytes[NextRandom(state) % (sizeof(bytes) - 1)]);
+            break;
+        }
+    }
+
+    // Parses input in chunks of random size (1 for byte by byte); events are written as type:json
+    void ParseStructuredStream(const std::string& input, uint32_t& state, size_t maxChunk, std::string& text, std::vector<std::string>& events)
+    {
+        StructuredOutputParser parser;
+        std::vector<StructuredEvent> parsed;
+        for (size_t pos = 0; pos < input.size();)
+        {
+            size_t size = std::min<size_t>(input.size() - pos, 1 + NextRandom(state) % maxChunk);
+            parser.Feed(std::string_view(input).substr(pos, size), text, parsed);
+            pos += size;
+        }
+        parser.Finish(text, parsed);
+        for (const auto& event : parsed)
+        {
+            if (event.m_type == StructuredEvent::Type::Error)
+                events.push_back("error:" + event.m_error);
+            else
+                events.push_back(event.m_value.ToJSON());
+        }
+    }
+
+    std::string EscapeJSON(const std::string& text)
+    {
+        std::string out;
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            out += c;
+        }
+        return out;
+    }
+
+    bool WriteJSON(FILE* file, const Options& options, const std::vector<Result>& results)
+    {
+#if defined(_MSC_VER)
+        const char* compiler = "msvc";
+#elif defined(__clang__)
+        const char* compiler = "clang";
+#elif defined(__GNUC__)
+        const char* compiler = "gcc";
+#else
+        const char* compiler = "unknown";
+#endif
+#ifdef NDEBUG
+        const char* build = "release";
+#else
+        const char* build = "debug";
+#endif
+        fprintf(file, "{\n  \"context\": {\"compiler\": \"%s\", \"build\": \"%s\", \"min_time_s\": %g, \"repetitions\": %d},\n",
+            compiler, build, options.m_minTime, options.m_repetitions);
+        fprintf(file, "  \"benchmarks\": [\n");
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const Result& r = results[i];
+            double rate = r.m_medianNs > 0.0 ? r.m_itemsPerOp * 1e9 / r.m_medianNs : 0.0;
+            fprintf(file, "    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, \"min_ns_per_op\": %.3f, \"max_ns_per_op\": %.3f, "
+                "\"%s_per_op\": %g, \"%s_per_second\": %.1f",
+                EscapeJSON(r.m_name).c_str(), (unsigned long long)r.m_iterations, r.m_medianNs, r.m_minNs, r.m_maxNs,
+                r.m_itemName, r.m_itemsPerOp, r.m_itemName, rate);
+            for (const auto& metric : r.m_metrics)
+                fprintf(file, ", \"%s\": %g", EscapeJSON(metric.first).c_str(), metric.second);
+            fprintf(file, "}%s\n", i + 1 < results.size() ? "," : "");
+        }
+        fprintf(file, "  ]\n}\n");
+        return ferror(file) == 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+#ifdef NVIGI_BENCH_INFERENCE_HOST
+    if (argc == 3 && !strcmp(argv[1], "-inferenceHost"))
+    {
+        SetUnpacedSyntheticConfig();
+        return InferenceHost::RunServer(argv[2], ResolveSynthetic);
+    }
+#endif
+
+    Options options;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-out") && i + 1 < argc)
+            options.m_out = argv[++i];
+        else if (!strcmp(argv[i], "-filter") && i + 1 < argc)
+            options.m_filter = argv[++i];
+        else if (!strcmp(argv[i], "-minTime") && i + 1 < argc)
+            options.m_minTime = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-repetitions") && i + 1 < argc)
+            options.m_repetitions = std::max(1, atoi(argv[++i]));
+        else
+        {
+            fprintf(stderr, "Usage: %s [-out <file.json>] [-filter <substring>] [-minTime <seconds>] [-repetitions <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    // Set by the benchmarks that also check their results
+    int exitCode = 0;
+    // Returns the result to attach metrics to, or null when the benchmark is filtered out
+    auto bench = [&](const std::string& name, double itemsPerOp, const char* itemName, const std::function<void()>& op)->Result*
+        {
+            if (!options.m_filter.empty() && name.find(options.m_filter) == std::string::npos)
+                return nullptr;
+            results.push_back(Run(options, name, itemsPerOp, itemName, op));
+            fprintf(stderr, "%-32s %12.1f ns/op\n", name.c_str(), results.back().m_medianNs);
+            return &results.back();
+        };
+
+    // GetAudioFile: one second of 16 kHz microphone audio at each supported bit depth
+    {
+        constexpr unsigned int kSamples = 16000;
+        std::vector<uint8_t> pcm(kSamples * 4);
+        uint32_t state = 1;
+        for (auto& b : pcm)
+            b = (uint8_t)NextRandom(state);
+        std::vector<float> out(kSamples);
+        for (uint16_t bits : { 8, 16, 32 })
+        {
+            bench("pcm_to_float/" + std::to_string(bits) + "bit", kSamples, "samples", [&, bits]()
+                {
+                    ConvertPCMToFloat(pcm.data(), kSamples, bits, out.data());
+                    Consume(out[kSamples / 2] != 0.0f);
+                });
+        }
+    }
+
+    // waveInProc: ten seconds of 16 kHz 16-bit capture arriving in 4 KB buffers
+    {
+        constexpr size_t kBufferSize = 4096;
+        constexpr size_t kBuffers = 16000 * 2 * 10 / kBufferSize;
+        std::vector<uint8_t> buffer(kBufferSize, 0x5a);
+        std::vector<uint8_t> recording;
+        bench("capture_append/10s", kBuffers * kBufferSize, "bytes", [&]()
+            {
+                recording.clear();
+                recording.shrink_to_fit();
+                size_t bytesWritten = 0;
+                for (size_t i = 0; i < kBuffers; i++)
+                    AudioRecordingHelper::AppendCapturedAudio(recording, bytesWritten, buffer.data(), kBufferSize);
+                Consume(bytesWritten);
+            });
+    }
+
+    // AppendTTSText: one answer streamed a token at a time
+    {
+        std::string answer = MakeAnswer();
+        std::vector<std::string> tokens = SplitTokens(answer);
+        TTSChunker chunker;
+        std::string chunk;
+        bench("tts_chunker/answer", (double)answer.size(), "bytes", [&]()
+            {
+                size_t chunks = 0;
+                for (size_t i = 0; i < tokens.size(); i++)
+                    chunks += chunker.Append(tokens[i], i + 1 == tokens.size(), chunk);
+                Consume(chunks);
+            });
+    }
+
+    // LaunchTTS: preprocessing of each chunk before it is synthesized
+    {
+        std::string answer = MakeAnswer();
+        std::vector<std::string> chunks;
+        TTSChunker chunker;
+        std::string chunk;
+        for (const auto& token : SplitTokens(answer))
+            if (chunker.Append(token, false, chunk))
+                chunks.push_back(chunk);
+        if (chunker.Append("", true, chunk))
+            chunks.push_back(chunk);
+
+        bench("tts_preprocess/answer", (double)answer.size(), "bytes", [&]()
+            {
+                size_t size = 0;
+                for (const auto& c : chunks)
+                    size += PreprocessTTSText(c).size();
+                Consume(size);
+            });
+    }
+
+    // ttsCallback: copying each synthesized chunk (about 3 s at 22050 Hz) for an answer of 16 chunks
+    {
+        constexpr size_t kChunkSamples = 22050 * 3;
+        constexpr size_t kChunks = 16;
+        std::vector<int16_t> synthesized(kChunkSamples);
+        uint32_t state = 3;
+        for (auto& s : synthesized)
+            s = (int16_t)NextRandom(state);
+        std::vector<int16_t> answer;
+        bench("tts_audio_copy/answer", kChunks * kChunkSamples, "samples", [&]()
+            {
+                answer.clear();
+                for (size_t i = 0; i < kChunks; i++)
+                {
+                    std::vector<int16_t> chunk;
+                    AppendTTSAudio(synthesized.data(), synthesized.size(), answer, chunk);
+                    Consume(chunk.size());
+                }
+            });
+    }
+
+    // gptCallback -> BuildChatUI: the chat's part of one frame while a producer thread streams tokens,
+    // with the shared lock the chat used to take and with the token queue
+    {
+        std::vector<std::string> tokens = SplitTokens(MakeAnswer());
+        {
+            ChatFixture chat;
+            std::mutex mutex;
+            TokenProducer producer(tokens, [&](const std::string& token)
+                {
+                    std::scoped_lock lock(mutex);
+                    chat.Append(token);
+                });
+            bench("token_handoff/mutex", 1.0, "frames", [&]()
+                {
+                    std::scoped_lock lock(mutex);
+                    Consume(chat.Walk());
+                });
+        }
+        {
+            ChatFixture chat;
+            TokenQueue queue;
+            TokenProducer producer(tokens, [&](const std::string& token) { queue.Push(token); });
+            bench("token_handoff/queue", 1.0, "frames", [&]()
+                {
+                    queue.Drain([&chat](std::string_view text) { chat.Append(text); });
+                    Consume(chat.Walk());
+                });
+            if (queue.GetOverflowCount())
+                fprintf(stderr, "token_handoff/queue: %llu fragments overflowed\n", (unsigned long long)queue.GetOverflowCount());
+        }
+    }
+
+    // Ordering check: the consumer only drains once the ring has filled up, so the producer keeps
+    // switching to the overflow list and back, and the sequence numbers it pushes must come out in
+    // order.  Failures fail the run.
+    {
+        constexpr uint32_t kFragments = (uint32_t)TokenQueue::kCapacity * 8;
+        uint64_t overflowed = 0;
+        uint64_t mismatches = 0;
+        Result* result = bench("token_handoff/overflow_order", kFragments, "fragments", [&]()
+            {
+                auto queue = std::make_unique<TokenQueue>();
+                std::atomic<bool> done = false;
+                std::thread producer([&]()
+                    {
+                        char text[16];
+                        for (uint32_t i = 0; i < kFragments; i++)
+                        {
+                            int length = snprintf(text, sizeof(text), "%u,", i);
+                            queue->Push(std::string_view(text, (size_t)length));
+                        }
+                        done = true;
+                    });
+
+                uint32_t expected = 0;
+                bool ok = true;
+                std::string pending;
+                auto sink = [&](std::string_view text)
+                    {
+                        pending.append(text);
+                        size_t comma;
+                        while ((comma = pending.find(',')) != std::string::npos)
+                        {
+                            ok &= strtoul(pending.c_str(), nullptr, 10) == expected++;
+                            pending.erase(0, comma + 1);
+                        }
+                    };
+                uint64_t seen = 0;
+                while (!done)
+                {
+                    if (queue->GetOverflowCount() == seen)
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    seen = queue->GetOverflowCount();
+                    queue->Drain(sink);
+                }
+                producer.join();
+                queue->Drain(sink);
+
+                ok &= expected == kFragments && pending.empty();
+                overflowed += queue->GetOverflowCount();
+                if (!ok && mismatches++ == 0)
+                    fprintf(stderr, "token_handoff/overflow_order: fragments out of order (%u of %u seen)\n", expected, kFragments);
+            });
+        if (result)
+        {
+            result->m_metrics = { { "overflowed", (double)overflowed }, { "mismatches", (double)mismatches } };
+            fprintf(stderr, "%-32s %12llu overflowed, %llu mismatches\n", "", (unsigned long long)overflowed, (unsigned long long)mismatches);
+            if (mismatches)
+                exitCode = 1;
+        }
+    }
+
+    // BuildChatUI: one frame of a 10k message chat while an answer streams in, re-wrapping every message
+    // as ImGui::TextColored did, and with the cached layout drawing only the messages in view
+    {
+        constexpr size_t kMessages = 10000;
+        constexpr float kWrapWidth = 600.0f;
+        constexpr float kViewHeight = 800.0f;
+        constexpr float kSpacing = 4.0f;
+        // Stand-in for ImGui::CalcTextSize: fixed-width glyphs, wrapping at spaces
+        auto measure = [](std::string_view text, float width)->float
+            {
+                constexpr float kGlyph = 7.0f;
+                constexpr float kLine = 16.0f;
+                float lines = 1.0f;
+                float x = 0.0f;
+                size_t wordStart = 0;
+                for (size_t i = 0; i < text.size(); i++)
+                {
+                    x += kGlyph;
+                    if (text[i] == ' ')
+                        wordStart = i + 1;
+                    else if (text[i] == '\n' || x > width)
+                    {
+                        lines += 1.0f;
+                        x = text[i] == '\n' ? 0.0f : (i + 1 - wordStart) * kGlyph;
+                    }
+                }
+                return lines * kLine;
+            };
+
+        std::string answer = MakeAnswer();
+        std::vector<std::string> tokens = SplitTokens(answer);
+        ChatLog log;
+        uint32_t state = 5;
+        for (size_t i = 0; i < kMessages; i++)
+        {
+            size_t length = 40 + NextRandom(state) % 400;
+            log.Append(i % 2 ? ChatLog::Role::Answer : ChatLog::Role::Question, std::string_view(answer).substr(0, length));
+        }
+
+        // Answers stream one token per frame and end at the length of a typical answer
+        size_t token = 0;
+        auto streamToken = [&]()
+            {
+                if (token == tokens.size())
+                {
+                    log.Append(ChatLog::Role::Question, "Tell me more.");
+                    token = 0;
+                }
+                log.AppendAnswer(tokens[token++]);
+            };
+        bench("chat_layout/10k_all", kMessages, "messages", [&]()
+            {
+                streamToken();
+                float height = 0.0f;
+                for (size_t i = 0; i < log.Size(); i++)
+                    height += measure(log.GetText(i), kWrapWidth) + kSpacing;
+                Consume(height);
+            });
+        bench("chat_layout/10k_cached", kMessages, "messages", [&]()
+            {
+                streamToken();
+                log.UpdateLayout(kWrapWidth, kSpacing, measure);
+                size_t first = 0;
+                size_t last = 0;
+                log.GetVisibleRange(log.GetTotalHeight() - kViewHeight, kViewHeight, first, last);
+                float height = 0.0f;
+                for (size_t i = first; i < last; i++)
+                    height += measure(log.GetText(i), kWrapWidth);
+                Consume(height);
+            });
+    }
+
+    // FramerateLimit: frames of 2 ms of work paced to 60 and 144 FPS by the original whole-millisecond sleep
+    // and by sleep + spin; the op time is the frame interval, and the metrics its jitter
+    {
+        constexpr double kWorkMs = 2.0;
+        for (auto mode : { FramePacer::Mode::Sleep, FramePacer::Mode::Hybrid })
+        {
+            for (int fps : { 60, 144 })
+            {
+                FramePacer pacer;
+                pacer.SetMode(mode);
+                double intervalMs = 1000.0 / fps;
+                std::string name = std::string("frame_pacer/") + FramePacer::GetModeName(mode) + "_" + std::to_string(fps);
+                Result* result = bench(name, 1.0, "frames", [&]()
+                    {
+                        auto end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(kWorkMs));
+                        while (Clock::now() < end)
+                            ;
+                        pacer.Wait(intervalMs);
+                    });
+                if (!result)
+                    continue;
+
+                const auto& stats = pacer.GetStats();
+                result->m_metrics = {
+                    { "interval_mean_ms", stats.m_intervals.m_mean },
+                    { "interval_stddev_ms", stats.m_intervals.GetStddev() },
+                    { "interval_max_error_ms", stats.m_maxErrorMs },
+                    { "spin_ms_per_frame", stats.m_intervals.m_count ? stats.m_spinMs / stats.m_intervals.m_count : 0.0 },
+                };
+                fprintf(stderr, "%-32s %12.3f ms target, %.3f +/- %.3f ms, max error %.3f ms\n", "", intervalMs,
+                    stats.m_intervals.m_mean, stats.m_intervals.GetStddev(), stats.m_maxErrorMs);
+            }
+        }
+    }
+
+    // LaunchGPT: the history bookkeeping of a turn, over a session long enough to keep the window full, and
+    // building the system prompt that restores the context after a reload
+    {
+        std::string answer = MakeAnswer().substr(0, 800);
+        std::vector<std::string> tokens = SplitTokens(answer);
+        ConversationHistory history;
+        history.SetSystemPrompt("You are a helpful AI agent. Your goal is to provide information about queries.");
+        history.SetBudget(3072, 200);
+        std::string context;
+        bench("conversation_history/turn", (double)tokens.size(), "tokens", [&]()
+            {
+                if (history.PrepareTurn("Tell me more about the palace and the people who live there.", true, context))
+                    history.RecordRebuild(1.0);
+                for (const auto& token : tokens)
+                    history.AppendAnswer(token);
+                history.EndTurn(true, 1.0);
+            });
+        uint64_t generation = 0;
+        bench("conversation_history/rebuild_context", ConversationHistory::EstimateTokens(history.BuildContext(generation)), "tokens", [&]()
+            {
+                Consume(history.BuildContext(generation).size());
+            });
+    }
+
+    // gptCallback and asrCallback: streamed tokens through the <JSON> segment parser, as plain text and
+    // with a game action after every few sentences
+    {
+        std::string answer = MakeAnswer();
+        std::string tagged;
+        size_t sentence = 0;
+        for (size_t start = 0; start < answer.size(); sentence++)
+        {
+            size_t end = answer.find_first_of(".?!", start);
+            end = end == std::string::npos ? answer.size() : end + 1;
+            tagged += answer.substr(start, end - start);
+            if (sentence % 3 == 2)
+                tagged += "<JSON>{\"action\": \"play_animation\", \"target\": \"guard\", \"name\": \"wave\", \"duration\": 1.5}</JSON>";
+            start = end;
+        }
+
+        for (const auto& [name, text] : { std::pair<const char*, const std::string&>("plain", answer), std::pair<const char*, const std::string&>("mixed", tagged) })
+        {
+            std::vector<std::string> tokens = SplitTokens(text);
+            StructuredOutputParser parser;
+            std::string visible;
+            std::vector<StructuredEvent> events;
+            bench(std::string("structured_output/") + name, (double)text.size(), "bytes", [&]()
+                {
+                    parser.Reset();
+                    visible.clear();
+                    events.clear();
+                    for (const auto& token : tokens)
+                        parser.Feed(token, visible, events);
+                    parser.Finish(visible, events);
+                    Consume(visible.size() + events.size());
+                });
+        }
+    }
+
+    // Fuzz check: random streams of text and segments parse to what was generated, and any stream, also
+    // a corrupted one, parses the same however it is split into tokens.  Failures fail the run.
+    {
+        std::string answer = MakeAnswer();
+        uint32_t state = 12345;
+        uint64_t streams = 0;
+        uint64_t mismatches = 0;
+        Result* result = bench("structured_output/fuzz", 1.0, "streams", [&]()
+            {
+                StructuredStream stream = GenerateStructuredStream(state, answer);
+                std::string text;
+                std::vector<std::string> events;
+                ParseStructuredStream(stream.m_input, state, stream.m_input.size() + 1, text, events);
+                bool ok = text == stream.m_text && events == stream.m_events;
+
+                if (NextRandom(state) % 2)
+                    CorruptStructuredStream(state, stream.m_input);
+                std::string wholeText;
+                std::vector<std::string> wholeEvents;
+                uint32_t unused = 0;
+                ParseStructuredStream(stream.m_input, unused, 1u << 30, wholeText, wholeEvents);
+                for (size_t maxChunk : { (size_t)1, (size_t)2, (size_t)8 })
+                {
+                    std::string splitText;
+                    std::vector<std::string> splitEvents;
+                    ParseStructuredStream(stream.m_input, state, maxChunk, splitText, splitEvents);
+                    ok &= splitText == wholeText && splitEvents == wholeEvents;
+                }
+
+                streams++;
+                if (!ok && mismatches++ == 0)
+                    fprintf(stderr, "structured_output/fuzz: mismatch on input '%s'\n", stream.m_input.c_str());
+            });
+        if (result)
+        {
+            result->m_metrics = { { "streams", (double)streams }, { "mismatches", (double)mismatches } };
+            fprintf(stderr, "%-32s %12llu streams, %llu mismatches\n", "", (unsigned long long)streams, (unsigned long long)mismatches);
+            if (mismatches)
+                exitCode = 1;
+        }
+    }
+
+    // ModelsComboBox: one frame of the open combo, in automatic and manual mode
+    {
+        CatalogFixture fixture;
+        const ModelCatalog& catalog = fixture.m_catalog;
+        bench("catalog_combo/automatic", catalog.Groups().size(), "groups", [&]()
+            {
+                size_t selectable = 0;
+                for (const auto& group : catalog.Groups())
+                {
+                    for (const nvigi::PluginID& id : { fixture.m_nvdaID, fixture.m_gpuID })
+                    {
+                        ModelHandle h = catalog.Find(group, id);
+                        if (h == kInvalidModel)
+                            continue;
+                        const PluginModelInfo& info = catalog.Get(h);
+                        if (info.m_modelStatus == ModelStatus::AVAILABLE_LOCALLY && fixture.m_vramBudget >= info.m_vram)
+                        {
+                            selectable += info.m_modelName.size();
+                            break;
+                        }
+                    }
+                }
+                Consume(selectable);
+            });
+        bench("catalog_combo/manual", catalog.Size(), "models", [&]()
+            {
+                size_t selectable = 0;
+                for (ModelHandle h = 0; h < catalog.Size(); h++)
+                {
+                    const PluginModelInfo& info = catalog.Get(h);
+                    if (info.m_modelStatus == ModelStatus::AVAILABLE_LOCALLY || info.m_modelStatus == ModelStatus::AVAILABLE_CLOUD)
+                        selectable += info.m_caption.size();
+                }
+                Consume(selectable);
+            });
+    }
+
+    // Shared-memory IPC: a message to another thread through one ring and the same message back
+    // through the other, for a token-sized and an audio-chunk-sized payload
+    {
+        constexpr size_t kRingSize = 1 << 20;
+        SharedMemory memory;
+        std::string name = "bench." + std::to_string(Clock::now().time_since_epoch().count());
+        if (memory.Create(name, 2 * SharedRing::GetRequiredSize(kRingSize)))
+        {
+            auto base = (uint8_t*)memory.GetData();
+            SharedRing ping;
+            SharedRing pong;
+            ping.Attach(base, kRingSize, name + ".ping", true);
+            pong.Attach(base + SharedRing::GetRequiredSize(kRingSize), kRingSize, name + ".pong", true);
+
+            // Echoes until it receives an empty message
+            std::thread echo([&]()
+                {
+                    uint32_t type = 0;
+                    std::vector<uint8_t> payload;
+                    for (;;)
+                    {
+                        if (!ping.Read(type, payload, 1000))
+                            continue;
+                        if (payload.empty())
+                            break;
+                        pong.Write(type, payload.data(), payload.size(), 1000);
+                    }
+                });
+
+            for (size_t size : { 64, 16384 })
+            {
+                std::vector<uint8_t> message(size, 1);
+                std::vector<uint8_t> reply;
+                bench("shared_ring/round_trip_" + std::to_string(size), 2.0 * size, "bytes", [&]()
+                    {
+                        uint32_t type = 0;
+                        ping.Write(1, message.data(), message.size(), 1000);
+                        while (!pong.Read(type, reply, 1000))
+                            ;
+                        Consume(reply.size());
+                    });
+            }
+
+            ping.Write(0, nullptr, 0, 1000);
+            echo.join();
+        }
+        else
+        {
+            fprintf(stderr, "Could not create shared memory; skipping shared_ring\n");
+        }
+    }
+
+#ifdef NVIGI_BENCH_INFERENCE_HOST
+    // -outOfProcess: a whole GPT answer and a whole TTS sentence from an unpaced synthetic backend,
+    // in-process and through the inference host; the difference per token or audio chunk is the IPC cost
+    struct HostStage
+    {
+        const char* m_name;
+        const char* m_itemName;
+        const char* m_unit;
+        SyntheticBackend::Stage m_stage;
+    };
+    const HostStage hostStages[] = {
+        { "gpt", "tokens", "token", SyntheticBackend::Stage::GPT },
+        { "tts", "chunks", "chunk", SyntheticBackend::Stage::TTS },
+    };
+    bool hostWanted = false;
+    for (const HostStage& stage : hostStages)
+        for (const char* side : { "_local", "_remote" })
+            for (const char* check : { "", "_callbacks" })
+                hostWanted |= (std::string("inference_host/") + stage.m_name + side + check).find(options.m_filter) != std::string::npos;
+    if (hostWanted)
+    {
+        SetUnpacedSyntheticConfig();
+        if (InferenceHost::Start({}, 10000))
+        {
+            for (const HostStage& stage : hostStages)
+            {
+                nvigi::PluginID id = SyntheticBackend::GetPluginID(stage.m_stage);
+                size_t modelCount = 0;
+                const SyntheticBackend::Model* models = SyntheticBackend::GetModels(stage.m_stage, modelCount);
+
+                nvigi::CommonCreationParameters common{};
+                common.modelGUID = models[0].m_guid;
+                common.utf8PathToModels = "";
+                common.numThreads = 1;
+                nvigi::GPTCreationParameters gptParams{};
+                nvigi::TTSCreationParameters ttsParams{};
+                nvigi::NVIGIParameter* params = nullptr;
+                if (stage.m_stage == SyntheticBackend::Stage::GPT)
+                {
+                    gptParams.chain(common);
+                    params = gptParams;
+                }
+                else
+                {
+                    ttsParams.chain(common);
+                    params = ttsParams;
+                }
+
+                // A prompt, or a few sentences of an answer to speak
+                std::string text = stage.m_stage == SyntheticBackend::Stage::GPT ? "Tell me about the palace." : MakeAnswer().substr(0, 400);
+                nvigi::InferenceDataTextSTLHelper input(text);
+                nvigi::InferenceDataSlot slots[] = { { stage.m_stage == SyntheticBackend::Stage::GPT ?
+                    nvigi::kGPTDataSlotUser : nvigi::kTTSDataSlotInputText, input } };
+                nvigi::InferenceDataSlotArray inputs = { 1, slots };
+                nvigi::GPTRuntimeParameters gptRuntime{};
+                gptRuntime.tokensToPredict = 200;
+
+                double localNsPerItem = 0.0;
+                for (bool remote : { false, true })
+                {
+                    nvigi::InferenceInterface* inference = remote ? InferenceHost::Wrap(id) : SyntheticBackend::GetInterface(id);
+                    nvigi::InferenceInstance* instance = nullptr;
+                    if (!inference || inference->createInstance(params, &instance) != nvigi::kResultOk)
+                    {
+                        fprintf(stderr, "Could not create the synthetic %s instance\n", stage.m_name);
+                        exitCode = 1;
+                        continue;
+                    }
+
+                    size_t outputs = 0;
+                    nvigi::InferenceExecutionContext ctx{};
+                    ctx.instance = instance;
+                    ctx.callback = CountOutputs;
+                    ctx.callbackUserData = &outputs;
+                    ctx.inputs = &inputs;
+                    if (stage.m_stage == SyntheticBackend::Stage::GPT)
+                        ctx.runtimeParameters = gptRuntime;
+                    // The item count of one evaluate, which is the same every time
+                    instance->evaluate(&ctx);
+                    double items = (double)std::max<size_t>(outputs, 1);
+
+                    std::string name = std::string("inference_host/") + stage.m_name + (remote ? "_remote" : "_local");
+                    uint32_t mismatches = 0;
+                    Result* check = bench(name + "_callbacks", 3, "evaluates", [&]()
+                        {
+                            CheckCallbackSequences(name.c_str(), instance, ctx, mismatches);
+                        });
+                    if (check)
+                    {
+                        check->m_metrics = { { "mismatches", (double)mismatches } };
+                        fprintf(stderr, "%-32s %12u mismatches\n", "", mismatches);
+                        if (mismatches)
+                            exitCode = 1;
+                    }
+
+                    Result* result = bench(name, items, stage.m_itemName, [&]()
+                        {
+                            instance->evaluate(&ctx);
+                        });
+                    inference->destroyInstance(instance);
+                    if (!result)
+                        continue;
+
+                    double nsPerItem = result->m_medianNs / items;
+                    if (!remote)
+                    {
+                        localNsPerItem = nsPerItem;
+                        continue;
+                    }
+                    result->m_metrics = { { std::string("overhead_ns_per_") + stage.m_unit, nsPerItem - localNsPerItem } };
+                    fprintf(stderr, "%-32s %12.1f ns IPC overhead per %s\n", "", nsPerItem - localNsPerItem, stage.m_unit);
+                }
+            }
+
+            auto stats = InferenceHost::GetStats();
+            InferenceHost::Stop();
+            if (stats.m_crashes || stats.m_stalls)
+                fprintf(stderr, "Inference host restarted during the run (%u crashed, %u stalled)\n", stats.m_crashes, stats.m_stalls);
+        }
+        else
+        {
+            fprintf(stderr, "Could not start the inference host; skipping inference_host\n");
+            exitCode = 1;
+        }
+    }
+#endif
+
+    FILE* file = stdout;
+    if (!options.m_out.empty())
+    {
+        file = fopen(options.m_out.c_str(), "w");
+        if (!file)
+        {
+            fprintf(stderr, "Could not open %s for writing\n", options.m_out.c_str());
+            return 1;
+        }
+    }
+    bool ok = WriteJSON(file, options, results);
+    if (file != stdout)
+        ok = fclose(file) == 0 && ok;
+    return ok ? exitCode : 1;
+}
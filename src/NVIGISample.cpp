@@ -3,6 +3,7 @@
 //
 
 #include "NVIGISample.h"
+#include "nvigi/Trace.h"
 #include <thread>
 
 #if USE_DX12
@@ -206,6 +207,8 @@ void NVIGISample::CreateRenderPasses(bool& exposureResetRequired, float lodBias)
 
 void NVIGISample::RenderScene(nvrhi::IFramebuffer* framebuffer)
 {
+    // CPU-side zones for the trace capture; each covers recording the pass into the command list
+    NVIGI_TRACE_ZONE("RenderScene");
 
     // INITIALISE
 
@@ -270,6 +273,7 @@ void NVIGISample::RenderScene(nvrhi::IFramebuffer* framebuffer)
     // SHADOW PASS
     if (m_ui.EnableShadows)
     {
+        NVIGI_TRACE_ZONE("ShadowMap");
         m_SunLight->shadowMap = m_ShadowMap;
         box3 sceneBounds = m_Scene->GetSceneGraph()->GetRootNode()->GetGlobalBoundingBox();
 
@@ -302,6 +306,7 @@ void NVIGISample::RenderScene(nvrhi::IFramebuffer* framebuffer)
 
     // Do CPU Load
     if (m_ui.CpuLoad != 0) {
+        NVIGI_TRACE_ZONE("CpuLoad");
         
         static std::random_device rd;
         static std::mt19937 mt(rd());
@@ -321,6 +326,7 @@ void NVIGISample::RenderScene(nvrhi::IFramebuffer* framebuffer)
     // Deffered Shading
     {
         // DO GBUFFER
+        NVIGI_TRACE_ZONE("DeferredShading");
         GBufferFillPass::Context gbufferContext;
 
         for (auto i = 0; i <= m_ui.GpuLoad; ++i) {
@@ -358,10 +364,17 @@ void NVIGISample::RenderScene(nvrhi::IFramebuffer* framebuffer)
     }
 
     if (m_ui.EnableProceduralSky)
+    {
+        NVIGI_TRACE_ZONE("Sky");
         m_SkyPass->Render(m_CommandList, *m_View, *m_SunLight, m_ui.SkyParams);
+    }
 
     // DO BLOOM
-    if (m_ui.EnableBloom) m_BloomPass->Render(m_CommandList, m_RenderTargets->HdrFramebuffer, *m_View, m_RenderTargets->HdrColor, m_ui.BloomSigma, m_ui.BloomAlpha);
+    if (m_ui.EnableBloom)
+    {
+        NVIGI_TRACE_ZONE("Bloom");
+        m_BloomPass->Render(m_CommandList, m_RenderTargets->HdrFramebuffer, *m_View, m_RenderTargets->HdrColor, m_ui.BloomSigma, m_ui.BloomAlpha);
+    }
 
     // ANTI-ALIASING
 
@@ -369,6 +382,7 @@ void NVIGISample::RenderScene(nvrhi::IFramebuffer* framebuffer)
         // DO TAA
         if (m_ui.AAMode == AntiAliasingMode::TEMPORAL)
         {
+            NVIGI_TRACE_ZONE("TemporalAA");
             m_TemporalAntiAliasingPass->TemporalResolve(m_CommandList, m_ui.TemporalAntiAliasingParams, m_PreviousViewsValid, *m_View, m_PreviousViewsValid ? *m_ViewPrevious : *m_View);
         }
 
@@ -385,6 +399,7 @@ void NVIGISample::RenderScene(nvrhi::IFramebuffer* framebuffer)
     nvrhi::ITexture* texToDisplay;
     if (m_ui.EnableToneMapping)
     {
+        NVIGI_TRACE_ZONE("ToneMapping");
         auto toneMappingParams = m_ui.ToneMappingParams;
         if (exposureResetRequired)
         {
@@ -408,7 +423,10 @@ void NVIGISample::RenderScene(nvrhi::IFramebuffer* framebuffer)
 
     // CLOSE COMMANDLIST
     m_CommandList->close();
-    GetDevice()->executeCommandList(m_CommandList);
+    {
+        NVIGI_TRACE_ZONE("ExecuteCommandList");
+        GetDevice()->executeCommandList(m_CommandList);
+    }
 
     // CLEANUP
     {
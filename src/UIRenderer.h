@@ -112,10 +112,14 @@ protected:
         ImGui::Text("FPS: %.0f ", fps);
 
         m_ui.Resolution = { 1920, 1080 };
+        NVIGIContext::Get().ApplySweepLoad(m_ui.CpuLoad, m_ui.GpuLoad);
 
         NVIGIContext::Get().BuildUI();
 
         ImGui::End();
         ImGui::PopFont();
+
+        if (NVIGIContext::Get().m_exitRequested)
+            glfwSetWindowShouldClose(GetDeviceManager()->GetWindow(), GLFW_TRUE);
     }
 };
\ No newline at end of file
@@ -44,6 +44,7 @@
 #include <taskflow/taskflow.hpp>
 #endif
 
+#include "nvigi/LogSink.h"
 #include "nvigi/NVIGIContext.h"
 #include "RenderTargets.h"
 #include "NVIGISample.h"
@@ -93,8 +94,9 @@ bool ProcessCommandLine(int argc, const char* const* argv, Parameters& params)
         {
             params.sceneName = argv[++i];
         }
-        else if (!strcmp(argv[i], "-ui_only"))
+        else if (!strcmp(argv[i], "-ui_only") || !strcmp(argv[i], "-script"))
         {
+            // Scripted runs measure the inference pipeline only
             params.renderScene = false;
         }
         else if (!strcmp(argv[i], "-fullscreen"))
@@ -136,6 +138,13 @@ int main(int __argc, const char* const* __argv)
         params.deviceParams.enableCopyQueue = true;
     }
 
+    // The parts of the sample that also build without donut log through LogSink
+    LogSink::Set([](LogSink::Severity severity, const char* message)
+        {
+            donut::log::Severity levels[] = { donut::log::Severity::Info, donut::log::Severity::Warning, donut::log::Severity::Error };
+            donut::log::message(levels[(int)severity], "%s", message);
+        });
+
     if (!ProcessCommandLine(__argc, __argv, params))
     {
         donut::log::error("Failed to process the command line.");
@@ -150,6 +159,10 @@ int main(int __argc, const char* const* __argv)
     if (!success)
         return 0;
 
+    // Started by an -outOfProcess parent to run its models; no window or device
+    if (NVIGIContext::Get().IsInferenceHost())
+        return NVIGIContext::Get().RunInferenceHost();
+
     DeviceManager* deviceManager = CreateDeviceManager(api);
 
     success = NVIGIContext::Get().Initialize_preDeviceCreate(deviceManager, params.deviceParams);
@@ -201,5 +214,5 @@ int main(int __argc, const char* const* __argv)
 
     delete deviceManager;
 
-    return 0;
+    return NVIGIContext::Get().m_exitCode;
 }
\ No newline at end of file
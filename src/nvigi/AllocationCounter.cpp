@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace
+{
+    std::atomic<uint64_t> s_total{ 0 };
+    std::atomic<uint64_t> s_frameStart{ 0 };
+    std::atomic<uint64_t> s_lastFrame{ 0 };
+}
+
+#ifdef NVIGI_COUNT_ALLOCATIONS
+
+namespace
+{
+    // Over-aligned types (alignas above the default new alignment) come through the align_val_t overloads
+    void* AlignedAlloc(size_t size, std::align_val_t alignment)
+    {
+        s_total.fetch_add(1, std::memory_order_relaxed);
+#ifdef _WIN32
+        return _aligned_malloc(size ? size : 1, (size_t)alignment);
+#else
+        void* ptr = nullptr;
+        return posix_memalign(&ptr, (size_t)alignment, size ? size : 1) == 0 ? ptr : nullptr;
+#endif
+    }
+
+    void AlignedFree(void* ptr)
+    {
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+void* operator new(size_t size)
+{
+    s_total.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    s_total.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+    return ::operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    if (void* ptr = AlignedAlloc(size, alignment))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AlignedAlloc(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AlignedAlloc(size, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept { AlignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { AlignedFree(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { AlignedFree(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { AlignedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(ptr); }
+
+#endif
+
+namespace AllocationCounter
+{
+    bool IsEnabled()
+    {
+#ifdef NVIGI_COUNT_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void EndFrame()
+    {
+        uint64_t total = s_total.load(std::memory_order_relaxed);
+        s_lastFrame.store(total - s_frameStart.exchange(total, std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    uint64_t GetLastFrame()
+    {
+        return s_lastFrame.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetTotal()
+    {
+        return s_total.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,22 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <cstdint>
+
+// Per-frame heap allocation counter, used to keep the UI and frame loop allocation-free.
+//
+// Counting is only compiled in when NVIGI_COUNT_ALLOCATIONS is defined (CMake option
+// NVIGI_COUNT_ALLOCATIONS), since it replaces the global operator new/delete.  Otherwise every
+// call is a no-op and IsEnabled() returns false.
+namespace AllocationCounter
+{
+    bool IsEnabled();
+
+    // Latches the allocations made since the previous call; call once per frame
+    void EndFrame();
+
+    uint64_t GetLastFrame();
+    uint64_t GetTotal();
+}
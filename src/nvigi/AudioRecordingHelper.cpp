@@ -23,7 +23,7 @@ namespace AudioRecordingHelper
     struct RecordingInfo
     {
         std::vector<uint8_t> audioBuffer = {};
-        DWORD bytesWritten = 0;
+        size_t bytesWritten = 0;
         HWAVEIN hwi;
         WAVEHDR headers[NUM_BUFFERS];
         WAVEFORMATEX waveFormat{};
@@ -38,9 +38,7 @@ namespace AudioRecordingHelper
                 RecordingInfo& info = *((RecordingInfo*)dwInstance);
 
                 LPWAVEHDR waveHeader = reinterpret_cast<LPWAVEHDR>(dwParam1);
-                info.audioBuffer.resize(info.bytesWritten + waveHeader->dwBytesRecorded);
-                memcpy(info.audioBuffer.data() + info.bytesWritten, (char*)waveHeader->lpData, waveHeader->dwBytesRecorded);
-                info.bytesWritten += waveHeader->dwBytesRecorded;
+                AppendCapturedAudio(info.audioBuffer, info.bytesWritten, waveHeader->lpData, waveHeader->dwBytesRecorded);
 
                 // Reuse the buffer for the next recording
                 waveInUnprepareHeader(hwi, waveHeader, sizeof(WAVEHDR));
@@ -145,7 +143,7 @@ namespace AudioRecordingHelper
 
         waveInClose(info.hwi);
 
-        DWORD dataSize = info.bytesWritten + 36;
+        DWORD dataSize = (DWORD)info.bytesWritten + 36;
 
         static size_t s_written = 0;
         static std::vector<uint8_t> s_buffer;
@@ -3,6 +3,10 @@
 //
 #pragma once
 
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
 namespace nvigi
 {
 	struct InferenceDataAudio;
@@ -14,4 +18,12 @@ namespace AudioRecordingHelper
 
 	RecordingInfo* StartRecordingAudio();
 	bool StopRecordingAudio(RecordingInfo* infoPtr, nvigi::InferenceDataAudio* wavData);
+
+	// Appends one filled capture buffer to the recording; runs on the waveIn callback thread
+	inline void AppendCapturedAudio(std::vector<uint8_t>& recording, size_t& bytesWritten, const void* data, size_t bytes)
+	{
+		recording.resize(bytesWritten + bytes);
+		memcpy(recording.data() + bytesWritten, data, bytes);
+		bytesWritten += bytes;
+	}
 };
@@ -6,6 +6,9 @@
 #include <string>
 #include <fstream>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 
 using std::cin;
 using std::cout;
@@ -31,7 +34,7 @@ struct WavHeader {
 };
 #pragma pack(pop)
 
-int getFileSize(FILE* inFile)
+inline int getFileSize(FILE* inFile)
 {
     int fileSize = 0;
     fseek(inFile, 0, SEEK_END);
@@ -42,7 +45,35 @@ int getFileSize(FILE* inFile)
     return fileSize;
 }
 
-bool GetAudioFile(string input_filename, float*& out_audio, unsigned int& out_audio_len)
+// Converts little-endian 8-bit unsigned, 16-bit or 32-bit signed PCM samples to floats in [-1, 1)
+inline bool ConvertPCMToFloat(const void* data, unsigned int count, uint16_t bitsPerSample, float* out)
+{
+    if (bitsPerSample == 8)
+    {
+        const uint8_t* in = (const uint8_t*)data;
+        for (unsigned int i = 0; i < count; ++i)
+            out[i] = in[i] / 128.0f - 1.0f;
+    }
+    else if (bitsPerSample == 16)
+    {
+        const int16_t* in = (const int16_t*)data;
+        for (unsigned int i = 0; i < count; ++i)
+            out[i] = in[i] / 32768.0f;
+    }
+    else if (bitsPerSample == 32)
+    {
+        const int32_t* in = (const int32_t*)data;
+        for (unsigned int i = 0; i < count; ++i)
+            out[i] = in[i] / 2147483648.0f;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+inline bool GetAudioFile(string input_filename, float*& out_audio, unsigned int& out_audio_len)
 {
     const char* filename = input_filename.c_str();
 
@@ -91,44 +122,91 @@ bool GetAudioFile(string input_filename, float*& out_audio, unsigned int& out_au
     //}
     
     // Assuming little-endian representation for all cases
-    if (header.bitsPerSample == 8)          // uint8
+    if (header.bitsPerSample == 8 || header.bitsPerSample == 16 || header.bitsPerSample == 32)
     {
-        out_audio_len = fileSize;        // every byte of file data represents one value
-        uint8_t* dyn_buffer = (uint8_t*)malloc(fileSize);
+        out_audio_len = (unsigned int)fileSize / (header.bitsPerSample / 8);
+        void* dyn_buffer = malloc(fileSize);
         file.read((char*)dyn_buffer, fileSize);
         out_audio = (float*)malloc(sizeof(float) * out_audio_len);
-        for (int i = 0; i < out_audio_len; ++i)
-        {
-            out_audio[i] = (uint8_t)dyn_buffer[i] / 128.0f - 1.0f;
-        }
+        ConvertPCMToFloat(dyn_buffer, out_audio_len, header.bitsPerSample, out_audio);
         free(dyn_buffer);
     }
-    else if (header.bitsPerSample == 16)    // int16
+
+    file.close();
+
+    return true;
+}
+
+// Reads the PCM samples of a WAV file, skipping any chunks other than "fmt " and "data"
+inline bool ReadWavFile(const string& filename, std::vector<uint8_t>& samples, uint16_t& channels, uint32_t& sampleRate, uint16_t& bitsPerSample)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    char riff[12];
+    if (!file.read(riff, sizeof(riff)) || std::string(riff, 4) != "RIFF" || std::string(riff + 8, 4) != "WAVE")
+        return false;
+
+    bool haveFormat = false;
+    char chunkId[4];
+    uint32_t chunkSize = 0;
+    while (file.read(chunkId, 4) && file.read(reinterpret_cast<char*>(&chunkSize), sizeof(chunkSize)))
     {
-        out_audio_len = fileSize / 2;    // every two bytes of file data represents one value
-        int16_t* dyn_buffer = (int16_t*)malloc(fileSize);
-        file.read((char*)dyn_buffer, fileSize);
-        out_audio = (float*)malloc(sizeof(float) * out_audio_len);
-        for (int i = 0; i < out_audio_len; ++i)
+        std::string id(chunkId, 4);
+        if (id == "fmt " && chunkSize >= 16)
         {
-            out_audio[i] = (int16_t)dyn_buffer[i] / 32768.0f;
+            uint16_t audioFormat = 0;
+            uint32_t byteRate = 0;
+            uint16_t blockAlign = 0;
+            file.read(reinterpret_cast<char*>(&audioFormat), sizeof(audioFormat));
+            file.read(reinterpret_cast<char*>(&channels), sizeof(channels));
+            file.read(reinterpret_cast<char*>(&sampleRate), sizeof(sampleRate));
+            file.read(reinterpret_cast<char*>(&byteRate), sizeof(byteRate));
+            file.read(reinterpret_cast<char*>(&blockAlign), sizeof(blockAlign));
+            file.read(reinterpret_cast<char*>(&bitsPerSample), sizeof(bitsPerSample));
+            // 1 is integer PCM
+            if (audioFormat != 1)
+                return false;
+            haveFormat = true;
+            file.seekg(chunkSize - 16 + (chunkSize & 1), std::ios::cur);
         }
-        free(dyn_buffer);
-    }
-    else if (header.bitsPerSample == 32)   // int32
-    {
-        out_audio_len = fileSize / 4;     // every four bytes of file data represents one value
-        int32_t* dyn_buffer = (int32_t*)malloc(fileSize);
-        file.read((char*)dyn_buffer, fileSize);
-        out_audio = (float*)malloc(sizeof(float) * out_audio_len);
-        for (int i = 0; i < out_audio_len; ++i)
+        else if (id == "data" && haveFormat)
         {
-            out_audio[i] = (int32_t)dyn_buffer[i] / 2147483648.0f;
+            samples.resize(chunkSize);
+            return (bool)file.read(reinterpret_cast<char*>(samples.data()), chunkSize);
+        }
+        else
+        {
+            file.seekg(chunkSize + (chunkSize & 1), std::ios::cur);
         }
-        free(dyn_buffer);
     }
+    return false;
+}
 
-    file.close();
+inline bool WriteWavFile(const string& filename, const int16_t* samples, size_t count, uint32_t sampleRate)
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return false;
 
-    return true;
+    uint32_t dataSize = (uint32_t)(count * sizeof(int16_t));
+    WavHeader header;
+    memcpy(header.chunkId, "RIFF", 4);
+    header.chunkSize = 36 + dataSize;
+    memcpy(header.format, "WAVE", 4);
+    memcpy(header.subchunk1Id, "fmt ", 4);
+    header.subchunk1Size = 16;
+    header.audioFormat = 1;
+    header.numChannels = 1;
+    header.sampleRate = sampleRate;
+    header.byteRate = sampleRate * sizeof(int16_t);
+    header.blockAlign = sizeof(int16_t);
+    header.bitsPerSample = 16;
+    memcpy(header.subchunk2Id, "data", 4);
+    header.subchunk2Size = dataSize;
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(samples), dataSize);
+    return file.good();
 }
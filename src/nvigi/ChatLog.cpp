@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "ChatLog.h"
+
+#include <algorithm>
+
+size_t ChatLog::Append(Role role, std::string_view text)
+{
+    Entry entry;
+    entry.m_role = role;
+    entry.m_text = GetPrefix(role);
+    entry.m_text += text;
+    m_entries.push_back(std::move(entry));
+    m_dirtyFrom = std::min(m_dirtyFrom, m_entries.size() - 1);
+    return m_entries.size() - 1;
+}
+
+void ChatLog::AppendAnswer(std::string_view text)
+{
+    if (m_entries.empty() || m_entries.back().m_role != Role::Answer)
+        Append(Role::Answer, "");
+    m_entries.back().m_text.append(text);
+    m_dirtyFrom = std::min(m_dirtyFrom, m_entries.size() - 1);
+}
+
+void ChatLog::Clear()
+{
+    m_entries.clear();
+    m_offsets.assign(1, 0.0f);
+    m_dirtyFrom = 0;
+}
+
+void ChatLog::UpdateLayout(float wrapWidth, float spacing, const Measure& measure)
+{
+    if (wrapWidth != m_wrapWidth || spacing != m_spacing)
+    {
+        m_wrapWidth = wrapWidth;
+        m_spacing = spacing;
+        for (auto& entry : m_entries)
+            entry.m_measuredSize = kUnmeasured;
+        m_dirtyFrom = 0;
+    }
+
+    m_lastMeasureCount = 0;
+    m_offsets.resize(m_entries.size() + 1);
+    for (size_t i = m_dirtyFrom; i < m_entries.size(); i++)
+    {
+        Entry& entry = m_entries[i];
+        if (entry.m_measuredSize != entry.m_text.size())
+        {
+            entry.m_height = measure(entry.m_text, wrapWidth);
+            entry.m_measuredSize = entry.m_text.size();
+            m_lastMeasureCount++;
+        }
+        m_offsets[i + 1] = m_offsets[i] + entry.m_height + spacing;
+    }
+    m_dirtyFrom = m_entries.size();
+}
+
+void ChatLog::GetVisibleRange(float top, float height, size_t& first, size_t& last) const
+{
+    // Offsets are only valid up to the last layout
+    size_t laidOut = m_offsets.size() - 1;
+    auto begin = m_offsets.begin() + 1;
+    auto end = m_offsets.begin() + 1 + laidOut;
+    // First message whose bottom is below the top of the view, then the first one starting below its bottom
+    first = std::upper_bound(begin, end, top) - begin;
+    last = std::lower_bound(m_offsets.begin() + first, m_offsets.begin() + laidOut, top + height) - m_offsets.begin();
+    last = std::max(first, last);
+}
@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Message store behind the chat window, with cached layout for virtualized drawing.
+//
+// Messages are only ever appended, and text is only appended to the last one, so indices stay valid
+// until Clear().  Text is stored as displayed, after a "Q: " or "A: " prefix.  The height of each
+// wrapped message is cached and measured again only when its text grows or the wrap width changes;
+// the offsets of the messages are kept as a prefix sum, so finding the messages inside the scrolled
+// view is a binary search and a frame lays out only those.
+class ChatLog
+{
+public:
+    enum class Role : uint8_t
+    {
+        Question,
+        Answer
+    };
+
+    // Height of the text when wrapped at the given width
+    using Measure = std::function<float(std::string_view text, float wrapWidth)>;
+
+    static const char* GetPrefix(Role role) { return role == Role::Question ? "Q: " : "A: "; }
+
+    size_t Append(Role role, std::string_view text);
+    // Extends the last answer, starting one if the last message is a question
+    void AppendAnswer(std::string_view text);
+    void Clear();
+
+    size_t Size() const { return m_entries.size(); }
+    Role GetRole(size_t index) const { return m_entries[index].m_role; }
+    const std::string& GetText(size_t index) const { return m_entries[index].m_text; }
+
+    // Measures what changed since the last call; spacing is the gap below every message
+    void UpdateLayout(float wrapWidth, float spacing, const Measure& measure);
+    float GetOffset(size_t index) const { return m_offsets[index]; }
+    float GetTotalHeight() const { return m_offsets.back(); }
+    // Messages [first, last) that intersect the band [top, top + height), as of the last UpdateLayout
+    void GetVisibleRange(float top, float height, size_t& first, size_t& last) const;
+
+    // Messages measured by the last UpdateLayout
+    size_t GetLastMeasureCount() const { return m_lastMeasureCount; }
+
+private:
+    static constexpr size_t kUnmeasured = ~size_t(0);
+
+    struct Entry
+    {
+        Role m_role = Role::Answer;
+        std::string m_text;
+        // Text size when the height was measured
+        size_t m_measuredSize = kUnmeasured;
+        float m_height = 0.0f;
+    };
+
+    std::vector<Entry> m_entries;
+    // m_offsets[i] is the top of message i; the extra last element is the total height
+    std::vector<float> m_offsets = { 0.0f };
+    float m_wrapWidth = -1.0f;
+    float m_spacing = 0.0f;
+    // First message whose offset may be stale
+    size_t m_dirtyFrom = 0;
+    size_t m_lastMeasureCount = 0;
+};
@@ -0,0 +1,263 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "ConversationHistory.h"
+
+#include <fstream>
+
+namespace
+{
+    constexpr size_t kBytesPerToken = 4;
+    // The "User: " and "Assistant: " labels and line breaks around a turn
+    constexpr uint32_t kTurnOverheadTokens = 6;
+    constexpr uint32_t kBucketLimits[ConversationHistory::kBucketCount] = { 256, 512, 1024, 2048, 4096, 0 };
+
+    void AppendTurn(std::string& text, const std::string& prompt, const std::string& answer)
+    {
+        text += "User: ";
+        text += prompt;
+        text += "\nAssistant: ";
+        text += answer;
+        text += "\n";
+    }
+}
+
+uint32_t ConversationHistory::EstimateTokens(std::string_view text)
+{
+    return (uint32_t)((text.size() + kBytesPerToken - 1) / kBytesPerToken);
+}
+
+uint32_t ConversationHistory::GetTurnTokens(const Turn& turn)
+{
+    return EstimateTokens(turn.m_prompt) + EstimateTokens(turn.m_answer) + kTurnOverheadTokens;
+}
+
+void ConversationHistory::SetBudget(uint32_t tokens, uint32_t answerTokens)
+{
+    std::scoped_lock lock(m_mutex);
+    m_budget = tokens;
+    m_answerTokens = answerTokens;
+}
+
+void ConversationHistory::SetSystemPrompt(const std::string& prompt)
+{
+    std::scoped_lock lock(m_mutex);
+    m_systemPrompt = prompt;
+}
+
+void ConversationHistory::Clear()
+{
+    std::scoped_lock lock(m_mutex);
+    m_turns.clear();
+    m_summary.clear();
+    m_historyTokens = 0;
+    m_contextTokens = 0;
+    m_inTurn = false;
+    m_generation++;
+    m_lastActivity = Clock::now();
+}
+
+size_t ConversationHistory::GetTurnsToDrop(uint32_t promptTokens, uint32_t target) const
+{
+    uint32_t total = EstimateTokens(m_systemPrompt) + EstimateTokens(m_summary) + kTurnOverheadTokens + promptTokens + m_answerTokens + m_historyTokens;
+    size_t drop = 0;
+    while (drop < m_turns.size() && total > target)
+        total -= m_turns[drop++].m_tokens;
+    return drop;
+}
+
+std::string ConversationHistory::BuildContextLocked() const
+{
+    std::string context = m_systemPrompt;
+    if (!m_summary.empty())
+        context += "\n\nSummary of the conversation so far: " + m_summary;
+    if (!m_turns.empty())
+    {
+        context += "\n\n";
+        for (const Turn& turn : m_turns)
+            AppendTurn(context, turn.m_prompt, turn.m_answer);
+    }
+    return context;
+}
+
+bool ConversationHistory::PrepareTurn(const std::string& prompt, bool contextValid, std::string& context)
+{
+    std::scoped_lock lock(m_mutex);
+    uint32_t promptTokens = EstimateTokens(prompt);
+    bool rebuild = !contextValid || (m_budget && m_contextTokens + promptTokens + m_answerTokens > m_budget);
+    if (rebuild)
+    {
+        if (m_budget)
+        {
+            size_t drop = GetTurnsToDrop(promptTokens, m_budget * 3 / 4);
+            for (size_t i = 0; i < drop; i++)
+            {
+                m_historyTokens -= m_turns.front().m_tokens;
+                m_turns.pop_front();
+            }
+            m_stats.m_droppedTurns += (uint32_t)drop;
+            if (drop)
+                m_generation++;
+        }
+        context = BuildContextLocked();
+        m_contextTokens = EstimateTokens(context);
+        m_rebuildContextTokens = m_contextTokens;
+    }
+
+    m_current = {};
+    m_current.m_prompt = prompt;
+    m_inTurn = true;
+    m_turnContextTokens = m_contextTokens;
+    m_contextTokens += promptTokens;
+    m_lastActivity = Clock::now();
+    return rebuild;
+}
+
+void ConversationHistory::RecordRebuild(double ms)
+{
+    std::scoped_lock lock(m_mutex);
+    RecordPrefill(m_rebuildContextTokens, ms, true);
+}
+
+void ConversationHistory::AppendAnswer(std::string_view text)
+{
+    std::scoped_lock lock(m_mutex);
+    if (m_inTurn)
+        m_current.m_answer.append(text);
+}
+
+void ConversationHistory::EndTurn(bool ok, double firstTokenMs)
+{
+    std::scoped_lock lock(m_mutex);
+    if (!m_inTurn)
+        return;
+    m_inTurn = false;
+    m_lastActivity = Clock::now();
+    // A failed prompt may still have been evaluated, so its tokens stay counted in the context
+    if (!ok)
+        return;
+
+    m_current.m_tokens = GetTurnTokens(m_current);
+    m_contextTokens = m_turnContextTokens + m_current.m_tokens;
+    m_historyTokens += m_current.m_tokens;
+    m_turns.push_back(std::move(m_current));
+    if (firstTokenMs > 0.0)
+        RecordPrefill(m_turnContextTokens, firstTokenMs, false);
+}
+
+bool ConversationHistory::HasIdleWork(bool contextValid, double idleMs) const
+{
+    std::scoped_lock lock(m_mutex);
+    if (m_inTurn || std::chrono::duration<double, std::milli>(Clock::now() - m_lastActivity).count() < idleMs)
+        return false;
+    if (!contextValid)
+        return !m_turns.empty() || !m_summary.empty();
+    return m_summaries && m_budget && m_contextTokens > m_budget / 2 && GetTurnsToDrop(0, m_budget / 2) > 0;
+}
+
+bool ConversationHistory::TakeSummaryRequest(SummaryRequest& request)
+{
+    std::scoped_lock lock(m_mutex);
+    // Whatever the outcome, the next attempt waits for another idle period
+    m_lastActivity = Clock::now();
+    size_t drop = m_budget ? GetTurnsToDrop(0, m_budget / 2) : 0;
+    if (!drop)
+        return false;
+
+    request.m_text.clear();
+    if (!m_summary.empty())
+        request.m_text = "Summary of the conversation so far: " + m_summary + "\n\n";
+    for (size_t i = 0; i < drop; i++)
+        AppendTurn(request.m_text, m_turns[i].m_prompt, m_turns[i].m_answer);
+    request.m_turns = drop;
+    request.m_generation = m_generation;
+    return true;
+}
+
+bool ConversationHistory::ApplySummary(const SummaryRequest& request, const std::string& summary)
+{
+    std::scoped_lock lock(m_mutex);
+    if (request.m_generation != m_generation || request.m_turns > m_turns.size() || summary.empty())
+        return false;
+
+    for (size_t i = 0; i < request.m_turns; i++)
+    {
+        m_historyTokens -= m_turns.front().m_tokens;
+        m_turns.pop_front();
+    }
+    m_summary = summary;
+    m_stats.m_summarizedTurns += (uint32_t)request.m_turns;
+    m_generation++;
+    return true;
+}
+
+std::string ConversationHistory::BuildContext(uint64_t& generation)
+{
+    std::scoped_lock lock(m_mutex);
+    std::string context = BuildContextLocked();
+    generation = m_generation;
+    m_rebuildContextTokens = EstimateTokens(context);
+    m_lastActivity = Clock::now();
+    return context;
+}
+
+bool ConversationHistory::RecordIdleRebuild(uint64_t generation, double ms)
+{
+    std::scoped_lock lock(m_mutex);
+    if (generation != m_generation)
+        return false;
+    m_contextTokens = m_rebuildContextTokens;
+    RecordPrefill(m_rebuildContextTokens, ms, true);
+    return true;
+}
+
+void ConversationHistory::RecordPrefill(uint32_t contextTokens, double ms, bool rebuild)
+{
+    uint32_t index = 0;
+    while (kBucketLimits[index] && contextTokens > kBucketLimits[index])
+        index++;
+    Bucket& bucket = m_stats.m_buckets[index];
+    if (rebuild)
+    {
+        bucket.m_rebuilds++;
+        bucket.m_rebuildMs += ms;
+        m_stats.m_rebuilds++;
+    }
+    else
+    {
+        bucket.m_prompts++;
+        bucket.m_promptMs += ms;
+    }
+}
+
+ConversationHistory::Stats ConversationHistory::GetStats() const
+{
+    std::scoped_lock lock(m_mutex);
+    Stats stats = m_stats;
+    stats.m_budget = m_budget;
+    stats.m_contextTokens = m_contextTokens;
+    stats.m_historyTokens = m_historyTokens;
+    stats.m_turns = (uint32_t)m_turns.size();
+    stats.m_summaryTokens = EstimateTokens(m_summary);
+    for (uint32_t i = 0; i < kBucketCount; i++)
+        stats.m_buckets[i].m_maxTokens = kBucketLimits[i];
+    return stats;
+}
+
+bool ConversationHistory::WriteCSV(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+        return false;
+
+    Stats stats = GetStats();
+    file << "context_tokens_max,prompts,prompt_prefill_avg_ms,rebuilds,rebuild_avg_ms\n";
+    for (const Bucket& bucket : stats.m_buckets)
+    {
+        if (bucket.m_maxTokens)
+            file << bucket.m_maxTokens;
+        file << "," << bucket.m_prompts << "," << (bucket.m_prompts ? bucket.m_promptMs / bucket.m_prompts : 0.0)
+            << "," << bucket.m_rebuilds << "," << (bucket.m_rebuilds ? bucket.m_rebuildMs / bucket.m_rebuilds : 0.0) << "\n";
+    }
+    return file.good();
+}
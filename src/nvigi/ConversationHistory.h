@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+// Bounds the GPT conversation context to a token budget.
+//
+// The interactive GPT instance appends every prompt and answer to its context.  This keeps a copy of
+// the turns with an estimate of their token counts, and of the tokens the context holds since it was
+// last started.  Before a prompt that would take the context over the budget (less the tokens kept for
+// the answer), the context is rebuilt: the oldest turns are dropped until the rest fills at most three
+// quarters of the budget, and the pinned system prompt, the summary of the dropped turns if any, and
+// the remaining turns are evaluated as one system prompt, in a single prefill.  The same rebuild
+// restores the conversation after the instance is reloaded.
+//
+// With summaries on, once the context is half full the turns that the next rebuild would drop are
+// handed out to be summarized while the chat is idle; the summary replaces them, and the context is
+// rebuilt right away so the next prompt does not pay for it.
+//
+// The prefill time of prompts (time to first token) and of rebuilds is recorded against the length of
+// the context they were evaluated on.
+class ConversationHistory
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr uint32_t kBucketCount = 6;
+
+    struct Bucket
+    {
+        // Contexts of up to this many tokens; the last bucket has no limit
+        uint32_t m_maxTokens = 0;
+        uint32_t m_prompts = 0;
+        double m_promptMs = 0.0;
+        uint32_t m_rebuilds = 0;
+        double m_rebuildMs = 0.0;
+    };
+
+    struct Stats
+    {
+        uint32_t m_budget = 0;
+        uint32_t m_contextTokens = 0;
+        uint32_t m_historyTokens = 0;
+        uint32_t m_turns = 0;
+        uint32_t m_droppedTurns = 0;
+        uint32_t m_summarizedTurns = 0;
+        uint32_t m_summaryTokens = 0;
+        uint32_t m_rebuilds = 0;
+        std::array<Bucket, kBucketCount> m_buckets{};
+    };
+
+    // Turns to summarize, and the history generation they were taken from
+    struct SummaryRequest
+    {
+        std::string m_text;
+        size_t m_turns = 0;
+        uint64_t m_generation = 0;
+    };
+
+    // Rough average for English text with the tokenizers used by the shipped models
+    static uint32_t EstimateTokens(std::string_view text);
+
+    // A budget of 0 leaves the context unbounded
+    void SetBudget(uint32_t tokens, uint32_t answerTokens);
+    void SetSystemPrompt(const std::string& prompt);
+    void SetSummaries(bool enabled) { m_summaries = enabled; }
+    bool GetSummaries() const { return m_summaries; }
+
+    // Forgets the turns and the summary, as when the chat is reset
+    void Clear();
+
+    // Before a prompt; contextValid is false when the instance has no conversation (first prompt, or
+    // after a reload).  Returns true with the text to evaluate as the system prompt if the context has
+    // to be (re)built first.
+    bool PrepareTurn(const std::string& prompt, bool contextValid, std::string& context);
+    void RecordRebuild(double ms);
+    // The answer of the current turn, as it streams
+    void AppendAnswer(std::string_view text);
+    // Ends the current turn; a failed one is not kept
+    void EndTurn(bool ok, double firstTokenMs);
+
+    // Idle work: true when the turns a rebuild would drop should be summarized now, or when the context
+    // was lost and there are turns to restore.  Only once the last turn has been idle for idleMs.
+    bool HasIdleWork(bool contextValid, double idleMs) const;
+    // The turns a rebuild would drop; an attempt that fails waits for another idle period
+    bool TakeSummaryRequest(SummaryRequest& request);
+    // Replaces the requested turns with the summary; ignored if the history changed in the meantime
+    bool ApplySummary(const SummaryRequest& request, const std::string& summary);
+    // The system prompt that restores the context, as PrepareTurn would build it
+    std::string BuildContext(uint64_t& generation);
+    // Records an idle rebuild started with BuildContext; false if the history changed in the meantime
+    bool RecordIdleRebuild(uint64_t generation, double ms);
+
+    Stats GetStats() const;
+    // One row per context length bucket with the prompt and rebuild prefill times
+    bool WriteCSV(const std::string& path) const;
+
+private:
+    struct Turn
+    {
+        std::string m_prompt;
+        std::string m_answer;
+        uint32_t m_tokens = 0;
+    };
+
+    static uint32_t GetTurnTokens(const Turn& turn);
+    // Oldest turns to drop so that the rest, with the prompt, fits in target tokens
+    size_t GetTurnsToDrop(uint32_t promptTokens, uint32_t target) const;
+    std::string BuildContextLocked() const;
+    void RecordPrefill(uint32_t contextTokens, double ms, bool rebuild);
+
+    mutable std::mutex m_mutex;
+    uint32_t m_budget = 0;
+    uint32_t m_answerTokens = 0;
+    bool m_summaries = false;
+    std::string m_systemPrompt;
+    std::string m_summary;
+    std::deque<Turn> m_turns;
+    uint32_t m_historyTokens = 0;
+    // Bumped by anything that changes the turns, so idle work started on an older history is discarded
+    uint64_t m_generation = 0;
+
+    // Tokens evaluated since the context was last started
+    uint32_t m_contextTokens = 0;
+    // The turn in progress, and the context length its prompt was evaluated on
+    Turn m_current;
+    bool m_inTurn = false;
+    uint32_t m_turnContextTokens = 0;
+    uint32_t m_rebuildContextTokens = 0;
+    Clock::time_point m_lastActivity = Clock::now();
+
+    Stats m_stats;
+};
@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "FrameCoordinator.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    // ProtectTtft only holds back work once the frame has used this much of its budget
+    constexpr double kAtRiskFraction = 0.75;
+
+    const char* kPolicyNames[] = { "off", "fps", "ttft" };
+}
+
+const char* FrameCoordinator::GetPolicyName(Policy policy)
+{
+    return (size_t)policy < (size_t)Policy::Count ? kPolicyNames[(size_t)policy] : "unknown";
+}
+
+bool FrameCoordinator::ParsePolicy(const char* name, Policy& policy)
+{
+    for (size_t i = 0; i < (size_t)Policy::Count; i++)
+    {
+        if (!strcmp(name, kPolicyNames[i]))
+        {
+            policy = (Policy)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void FrameCoordinator::SetPolicy(Policy policy)
+{
+    m_policy = policy;
+    // Release anything waiting under the previous policy
+    std::scoped_lock lock(m_mutex);
+    m_frameIndex++;
+    m_cv.notify_all();
+}
+
+void FrameCoordinator::BeginFrame()
+{
+    auto now = Clock::now();
+    {
+        std::scoped_lock lock(m_mutex);
+        if (m_hasLastFrame)
+            m_stats[(size_t)m_policy.load()].m_frames.Add(std::chrono::duration<double, std::milli>(now - m_lastFrameStart).count());
+        m_lastFrameStart = now;
+        m_hasLastFrame = true;
+    }
+    m_frameStartUs = std::chrono::duration_cast<std::chrono::microseconds>(now - m_epoch).count();
+    m_inFrame = true;
+}
+
+void FrameCoordinator::EndFrame()
+{
+    m_inFrame = false;
+    std::scoped_lock lock(m_mutex);
+    m_frameIndex++;
+    m_cv.notify_all();
+}
+
+double FrameCoordinator::Yield(Work work)
+{
+    Policy policy = m_policy;
+    if (policy == Policy::Off)
+        return 0.0;
+
+    double budgetMs = m_budgetMs;
+    double maxWaitMs = budgetMs;
+    if (policy == Policy::ProtectTtft)
+    {
+        if (work == Work::Prompt)
+            return 0.0;
+        maxWaitMs = budgetMs * 0.25;
+    }
+
+    auto start = Clock::now();
+    auto atRisk = [&]()
+        {
+            if (!m_inFrame)
+                return false;
+            if (policy == Policy::ProtectFps)
+                return true;
+            double elapsedMs = (std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_epoch).count() - m_frameStartUs) / 1000.0;
+            return elapsedMs > budgetMs * kAtRiskFraction;
+        };
+
+    std::unique_lock lock(m_mutex);
+    Stats& stats = m_stats[(size_t)policy];
+    stats.m_yields++;
+    if (!atRisk())
+        return 0.0;
+
+    // Wait for this frame to end, or give up so that inference always makes progress
+    uint64_t frame = m_frameIndex;
+    auto deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(maxWaitMs));
+    m_cv.wait_until(lock, deadline, [this, frame]() { return m_frameIndex != frame; });
+
+    double waitedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    stats.m_delayed++;
+    stats.m_delayMs += waitedMs;
+    return waitedMs;
+}
+
+FrameCoordinator::Stats FrameCoordinator::GetStats(Policy policy) const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_stats[(size_t)policy];
+}
+
+void FrameCoordinator::ResetStats()
+{
+    std::scoped_lock lock(m_mutex);
+    m_stats = {};
+    m_hasLastFrame = false;
+}
+
+bool FrameCoordinator::WriteCSV(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+        return false;
+
+    file << "policy,frames,mean_ms,stddev_ms,yields,delayed,delay_ms\n";
+    for (size_t i = 0; i < (size_t)Policy::Count; i++)
+    {
+        Stats stats = GetStats((Policy)i);
+        file << kPolicyNames[i] << "," << stats.m_frames.m_count << "," << stats.m_frames.m_mean << "," << stats.m_frames.GetStddev() << ","
+            << stats.m_yields << "," << stats.m_delayed << "," << stats.m_delayMs << "\n";
+    }
+    return file.good();
+}
@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Running mean and variance (Welford)
+struct RunningStats
+{
+    uint64_t m_count = 0;
+    double m_mean = 0.0;
+    double m_m2 = 0.0;
+
+    void Add(double value)
+    {
+        m_count++;
+        double delta = value - m_mean;
+        m_mean += delta / m_count;
+        m_m2 += delta * (value - m_mean);
+    }
+    double GetStddev() const { return m_count > 1 ? std::sqrt(m_m2 / (m_count - 1)) : 0.0; }
+};
+
+// Lets inference threads fit their GPU/CPU-heavy steps around the frame.
+//
+// The render thread marks the part of each frame it needs (BeginFrame after the framerate limiter,
+// EndFrame once the frame is presented); the rest of the frame budget is slack.  Inference threads
+// call Yield() before each step.  With ProtectFps every step waits for the slack, for at most one
+// frame budget, which throttles inference to the frame when there is no slack.  With ProtectTtft new
+// prompts are never held back, and decode steps and TTS chunks only wait when the frame has already
+// used most of its budget, for at most a quarter of it.
+class FrameCoordinator
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Policy
+    {
+        Off,
+        ProtectFps,
+        ProtectTtft,
+        Count
+    };
+
+    enum class Work
+    {
+        // ASR or GPT prompt processing, i.e. the start of a turn
+        Prompt,
+        // The next GPT decode step
+        Token,
+        // A TTS chunk
+        Synthesis
+    };
+
+    struct Stats
+    {
+        // Present-to-present interval while the policy was active
+        RunningStats m_frames;
+        uint64_t m_yields = 0;
+        uint64_t m_delayed = 0;
+        double m_delayMs = 0.0;
+    };
+
+    static const char* GetPolicyName(Policy policy);
+    // "off", "fps" or "ttft"
+    static bool ParsePolicy(const char* name, Policy& policy);
+
+    void SetPolicy(Policy policy);
+    Policy GetPolicy() const { return m_policy; }
+    void SetBudgetMs(double budgetMs) { m_budgetMs = budgetMs; }
+    double GetBudgetMs() const { return m_budgetMs; }
+
+    // Render thread
+    void BeginFrame();
+    void EndFrame();
+
+    // Inference threads; returns the time spent waiting in milliseconds
+    double Yield(Work work);
+
+    Stats GetStats(Policy policy) const;
+    void ResetStats();
+    // One row per policy
+    bool WriteCSV(const std::string& path) const;
+
+private:
+    std::atomic<Policy> m_policy = Policy::Off;
+    std::atomic<double> m_budgetMs = 1000.0 / 60.0;
+    std::atomic<bool> m_inFrame = false;
+    std::atomic<int64_t> m_frameStartUs = 0;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    uint64_t m_frameIndex = 0;
+    Clock::time_point m_epoch = Clock::now();
+    Clock::time_point m_lastFrameStart;
+    bool m_hasLastFrame = false;
+    std::array<Stats, (size_t)Policy::Count> m_stats;
+};
@@ -0,0 +1,167 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // The guard band covers the worst recent overshoot plus a margin, and loses 2% a frame after that
+    constexpr double kGuardMargin = 1.25;
+    constexpr double kGuardDecay = 0.98;
+    constexpr double kMinGuardMs = 0.2;
+    constexpr double kMaxGuardMs = 4.0;
+
+    const char* kModeNames[] = { "sleep", "hybrid" };
+
+    double ToMs(FramePacer::Clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    FramePacer::Clock::duration FromMs(double ms)
+    {
+        return std::chrono::duration_cast<FramePacer::Clock::duration>(std::chrono::duration<double, std::milli>(ms));
+    }
+
+    void CpuRelax()
+    {
+#if defined(_M_X64) || defined(__x86_64__)
+        _mm_pause();
+#endif
+    }
+}
+
+FramePacer::FramePacer()
+    : m_guardMs(kMinGuardMs)
+{
+#ifdef _WIN32
+    // Without the high resolution flag (Windows 10 1803 and later) sleeps have the 1-15.6 ms timer granularity
+    m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+#endif
+}
+
+FramePacer::~FramePacer()
+{
+#ifdef _WIN32
+    if (m_timer)
+        CloseHandle(m_timer);
+#endif
+}
+
+const char* FramePacer::GetModeName(Mode mode)
+{
+    return kModeNames[(int)mode];
+}
+
+bool FramePacer::ParseMode(const char* name, Mode& mode)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        if (!strcmp(name, kModeNames[i]))
+        {
+            mode = (Mode)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void FramePacer::SetMode(Mode mode)
+{
+    if (mode == m_mode)
+        return;
+    m_mode = mode;
+    m_hasDeadline = false;
+    ResetStats();
+}
+
+void FramePacer::ResetStats()
+{
+    m_stats = {};
+}
+
+void FramePacer::SleepUntil(Clock::time_point time)
+{
+#ifdef _WIN32
+    if (m_timer)
+    {
+        // Relative due time in 100 ns units
+        LARGE_INTEGER due;
+        due.QuadPart = -std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(time - Clock::now()).count() / 100);
+        if (SetWaitableTimer(m_timer, &due, 0, nullptr, nullptr, FALSE))
+        {
+            WaitForSingleObject(m_timer, INFINITE);
+            return;
+        }
+    }
+#endif
+    std::this_thread::sleep_until(time);
+}
+
+void FramePacer::Wait(double intervalMs)
+{
+    auto start = Clock::now();
+    if (intervalMs != m_lastIntervalMs)
+    {
+        m_lastIntervalMs = intervalMs;
+        m_hasDeadline = false;
+    }
+
+    if (m_hasDeadline)
+    {
+        if (m_mode == Mode::Sleep)
+        {
+            double leftoverTime = intervalMs - ToMs(start - m_lastRelease);
+            if (leftoverTime > 0.0)
+                std::this_thread::sleep_for(std::chrono::milliseconds((int)leftoverTime));
+            m_stats.m_sleepMs += ToMs(Clock::now() - start);
+        }
+        else
+        {
+            // A late frame is released at once and the cadence restarts from it
+            m_deadline = std::max(m_deadline + FromMs(intervalMs), start);
+            auto wake = m_deadline - FromMs(m_guardMs);
+            if (wake > start)
+            {
+                SleepUntil(wake);
+                double overshootMs = ToMs(Clock::now() - wake);
+                m_guardMs = std::clamp(std::max(overshootMs * kGuardMargin, m_guardMs * kGuardDecay), kMinGuardMs, kMaxGuardMs);
+            }
+            auto spinStart = Clock::now();
+            m_stats.m_sleepMs += ToMs(spinStart - start);
+            while (Clock::now() < m_deadline)
+                CpuRelax();
+            m_stats.m_spinMs += ToMs(Clock::now() - spinStart);
+        }
+    }
+
+    auto release = Clock::now();
+    if (m_hasDeadline)
+    {
+        double frameMs = ToMs(release - m_lastRelease);
+        m_stats.m_intervals.Add(frameMs);
+        m_stats.m_maxErrorMs = std::max(m_stats.m_maxErrorMs, std::abs(frameMs - intervalMs));
+    }
+    else
+    {
+        m_deadline = release;
+        m_hasDeadline = true;
+    }
+    m_lastRelease = release;
+}
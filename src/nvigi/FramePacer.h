@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "FrameCoordinator.h"
+
+// Holds each frame until its deadline for the framerate limiter.
+//
+// Hybrid mode sleeps until a guard band before the deadline and spins for the rest.  The guard band is
+// learned from how late the sleeps actually wake up: it jumps to cover the worst recent overshoot and
+// decays slowly, so a quiet system spins for a fraction of a millisecond and a busy one spins longer
+// rather than missing the deadline.  Deadlines advance by the interval from the previous deadline, not
+// from when the frame was released, so the cadence does not drift.  Sleep mode is the original limiter:
+// it sleeps for the whole milliseconds left in the frame, and is kept to compare against.
+class FramePacer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Mode
+    {
+        Sleep,
+        Hybrid
+    };
+
+    struct Stats
+    {
+        // Interval between released frames
+        RunningStats m_intervals;
+        // Largest distance of an interval from the target
+        double m_maxErrorMs = 0.0;
+        // Time spent sleeping and spinning
+        double m_sleepMs = 0.0;
+        double m_spinMs = 0.0;
+    };
+
+    FramePacer();
+    ~FramePacer();
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    void SetMode(Mode mode);
+    Mode GetMode() const { return m_mode; }
+    static const char* GetModeName(Mode mode);
+    // "sleep" or "hybrid"
+    static bool ParseMode(const char* name, Mode& mode);
+
+    // Returns once intervalMs has passed since the previous frame's deadline
+    void Wait(double intervalMs);
+    // Forgets the previous deadline, e.g. while the limiter is off
+    void Reset() { m_hasDeadline = false; }
+
+    double GetGuardMs() const { return m_guardMs; }
+    const Stats& GetStats() const { return m_stats; }
+    void ResetStats();
+
+private:
+    void SleepUntil(Clock::time_point time);
+
+    Mode m_mode = Mode::Hybrid;
+    double m_guardMs;
+    bool m_hasDeadline = false;
+    Clock::time_point m_deadline;
+    Clock::time_point m_lastRelease;
+    double m_lastIntervalMs = 0.0;
+    Stats m_stats;
+    // High resolution waitable timer on Windows
+    void* m_timer = nullptr;
+};
@@ -0,0 +1,379 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "FrameSweep.h"
+
+#include <nvigi.h>
+#include <nvigi_hwi_common.h>
+
+#include <donut/core/log.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    struct SchedulingModeName
+    {
+        const char* m_name;
+        uint32_t m_mode;
+    };
+
+    const SchedulingModeName kSchedulingModes[] =
+    {
+        { "graphics", nvigi::SchedulingMode::kPrioritizeGraphics },
+        { "inference", nvigi::SchedulingMode::kPrioritizeCompute },
+        { "balanced", nvigi::SchedulingMode::kBalance },
+        { "adaptive", FrameSweep::kAdaptiveScheduling },
+    };
+
+    std::string Trim(const std::string& text)
+    {
+        size_t begin = text.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos)
+            return "";
+        size_t end = text.find_last_not_of(" \t\r\n");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    bool ParseNumber(const std::string& token, double& value)
+    {
+        char* end = nullptr;
+        value = strtod(token.c_str(), &end);
+        return !token.empty() && *end == '\0' && value >= 0.0;
+    }
+
+    double FramesPerSecond(const LatencyHistogram::Summary& frames)
+    {
+        return frames.m_meanMs > 0.0 ? 1000.0 / frames.m_meanMs : 0.0;
+    }
+}
+
+const char* FrameSweep::GetSchedulingModeName(uint32_t mode)
+{
+    for (const auto& entry : kSchedulingModes)
+    {
+        if (entry.m_mode == mode)
+            return entry.m_name;
+    }
+    return "unknown";
+}
+
+bool FrameSweep::ParseSpec(const std::string& path, Spec& spec)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        donut::log::error("Unable to open sweep %s", path.c_str());
+        return false;
+    }
+
+    fs::path specDir = fs::path(path).parent_path();
+    std::string line;
+    for (int lineNumber = 1; std::getline(file, line); lineNumber++)
+    {
+        line = Trim(line.substr(0, line.find('#')));
+        if (line.empty())
+            continue;
+
+        std::istringstream tokens(line);
+        std::string command;
+        tokens >> command;
+        std::vector<std::string> values;
+        for (std::string value; tokens >> value;)
+            values.push_back(value);
+
+        if (values.empty())
+        {
+            donut::log::error("%s(%d): '%s' needs at least one value", path.c_str(), lineNumber, command.c_str());
+            return false;
+        }
+
+        if (command == "script")
+        {
+            fs::path scriptPath = Trim(line.substr(command.size()));
+            if (scriptPath.is_relative())
+                scriptPath = specDir / scriptPath;
+            spec.m_turns.clear();
+            if (!ScriptRunner::ParseScript(scriptPath.string(), spec.m_turns))
+                return false;
+            continue;
+        }
+        if (command == "backend")
+        {
+            spec.m_backends = values;
+            continue;
+        }
+        if (command == "scheduling")
+        {
+            spec.m_schedulingModes.clear();
+            for (const auto& value : values)
+            {
+                auto it = std::find_if(std::begin(kSchedulingModes), std::end(kSchedulingModes),
+                    [&value](const SchedulingModeName& entry) { return value == entry.m_name; });
+                if (it == std::end(kSchedulingModes))
+                {
+                    donut::log::error("%s(%d): unknown scheduling mode '%s'; expected graphics, inference, balanced or adaptive",
+                        path.c_str(), lineNumber, value.c_str());
+                    return false;
+                }
+                spec.m_schedulingModes.push_back(it->m_mode);
+            }
+            continue;
+        }
+        if (command == "coordinator")
+        {
+            spec.m_coordinators.clear();
+            for (const auto& value : values)
+            {
+                FrameCoordinator::Policy policy;
+                if (!FrameCoordinator::ParsePolicy(value.c_str(), policy))
+                {
+                    donut::log::error("%s(%d): unknown coordinator policy '%s'; expected off, fps or ttft",
+                        path.c_str(), lineNumber, value.c_str());
+                    return false;
+                }
+                spec.m_coordinators.push_back(policy);
+            }
+            continue;
+        }
+
+        std::vector<double> numbers;
+        for (const auto& value : values)
+        {
+            double number = 0.0;
+            if (!ParseNumber(value, number))
+            {
+                donut::log::error("%s(%d): invalid value '%s' for '%s'", path.c_str(), lineNumber, value.c_str(), command.c_str());
+                return false;
+            }
+            numbers.push_back(number);
+        }
+
+        if (command == "cpuLoad")
+        {
+            spec.m_cpuLoads.assign(numbers.begin(), numbers.end());
+        }
+        else if (command == "gpuLoad")
+        {
+            spec.m_gpuLoads.clear();
+            for (double number : numbers)
+                spec.m_gpuLoads.push_back((int)number);
+        }
+        else if (command == "fps")
+        {
+            spec.m_targetFps.clear();
+            for (double number : numbers)
+                spec.m_targetFps.push_back((int)number);
+        }
+        else if (command == "settle" && numbers.size() == 1)
+        {
+            spec.m_settleFrames = (int)numbers[0];
+        }
+        else if (command == "idle" && numbers.size() == 1)
+        {
+            spec.m_idleFrames = std::max(1, (int)numbers[0]);
+        }
+        else
+        {
+            donut::log::error("%s(%d): expected cpuLoad, gpuLoad, scheduling, coordinator, backend, fps, script, settle or idle", path.c_str(), lineNumber);
+            return false;
+        }
+    }
+
+    if (spec.m_turns.empty())
+    {
+        donut::log::error("Sweep %s has no script", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+void FrameSweep::Start(const Spec& spec, uint32_t currentSchedulingMode, FrameCoordinator::Policy currentCoordinator)
+{
+    m_spec = spec;
+    if (m_spec.m_cpuLoads.empty())
+        m_spec.m_cpuLoads = { 0.0f };
+    if (m_spec.m_gpuLoads.empty())
+        m_spec.m_gpuLoads = { 0 };
+    if (m_spec.m_schedulingModes.empty())
+        m_spec.m_schedulingModes = { currentSchedulingMode };
+    if (m_spec.m_coordinators.empty())
+        m_spec.m_coordinators = { currentCoordinator };
+    if (m_spec.m_backends.empty())
+        m_spec.m_backends = { "" };
+    if (m_spec.m_targetFps.empty())
+        m_spec.m_targetFps = { 0 };
+
+    m_points.clear();
+    for (const auto& backend : m_spec.m_backends)
+        for (uint32_t mode : m_spec.m_schedulingModes)
+            for (FrameCoordinator::Policy coordinator : m_spec.m_coordinators)
+                for (int fps : m_spec.m_targetFps)
+                    for (int gpuLoad : m_spec.m_gpuLoads)
+                        for (float cpuLoad : m_spec.m_cpuLoads)
+                            m_points.push_back({ cpuLoad, gpuLoad, mode, coordinator, backend, fps });
+
+    m_results.clear();
+    m_index = 0;
+    SetPhase(Phase::Apply);
+    donut::log::info("Sweep: %d point(s), %d turn(s) each", (int)m_points.size(), (int)m_spec.m_turns.size());
+}
+
+void FrameSweep::SetPhase(Phase phase)
+{
+    m_phase = phase;
+    m_phaseFrames = 0;
+    if (phase == Phase::Idle)
+    {
+        m_idleFrames.Reset();
+        m_idleStats = {};
+    }
+    else if (phase == Phase::Inference)
+    {
+        m_inferenceFrames.Reset();
+        m_inferenceStats = {};
+    }
+}
+
+bool FrameSweep::IsPhaseComplete() const
+{
+    switch (m_phase)
+    {
+    case Phase::Settle: return m_phaseFrames >= m_spec.m_settleFrames;
+    case Phase::Idle: return m_phaseFrames >= m_spec.m_idleFrames;
+    default: return false;
+    }
+}
+
+void FrameSweep::RecordFrame(double ms)
+{
+    if (m_phase == Phase::Idle)
+    {
+        m_idleFrames.RecordMs(ms);
+        m_idleStats.Add(ms);
+    }
+    else if (m_phase == Phase::Inference)
+    {
+        m_inferenceFrames.RecordMs(ms);
+        m_inferenceStats.Add(ms);
+    }
+    m_phaseFrames++;
+}
+
+void FrameSweep::FinishPoint(const std::string& backend, bool ok, const std::vector<ScriptTurnResult>& results)
+{
+    if (!IsActive())
+        return;
+
+    SweepPointResult row;
+    row.m_point = m_points[m_index];
+    row.m_backend = backend;
+    row.m_idleFrames = m_idleFrames.GetSummary();
+    row.m_inferenceFrames = m_inferenceFrames.GetSummary();
+    row.m_idleStddevMs = m_idleStats.GetStddev();
+    row.m_inferenceStddevMs = m_inferenceStats.GetStddev();
+    row.m_turns = results.size();
+
+    LatencyHistogram ttft;
+    LatencyHistogram turn;
+    uint64_t tokens = 0;
+    double gptSeconds = 0.0;
+    for (const auto& r : results)
+    {
+        if (!r.m_ok)
+        {
+            row.m_failedTurns++;
+            continue;
+        }
+        ttft.RecordMs(r.m_gptFirstTokenMs);
+        turn.RecordMs(r.m_turnMs);
+        tokens += r.m_tokens;
+        gptSeconds += r.m_gptMs / 1000.0;
+    }
+    row.m_ttftP50Ms = ttft.GetPercentileMs(50.0);
+    row.m_ttftP90Ms = ttft.GetPercentileMs(90.0);
+    row.m_turnP50Ms = turn.GetPercentileMs(50.0);
+    row.m_tokensPerSecond = gptSeconds > 0.0 ? tokens / gptSeconds : 0.0;
+    row.m_ok = ok && !results.empty() && row.m_failedTurns == 0;
+    m_results.push_back(row);
+
+    donut::log::info("Sweep: point %d/%d (cpu %.1f ms, gpu %d, %s, coordinator %s, %s, %d fps): frame p50 %.2f -> %.2f ms, p99 %.2f -> %.2f ms, stddev %.2f -> %.2f ms, TTFT p50 %.1f ms, %.1f tok/s",
+        (int)m_index + 1, (int)m_points.size(), row.m_point.m_cpuLoad, row.m_point.m_gpuLoad, GetSchedulingModeName(row.m_point.m_schedulingMode),
+        FrameCoordinator::GetPolicyName(row.m_point.m_coordinator), backend.c_str(), row.m_point.m_targetFps, row.m_idleFrames.m_p50Ms,
+        row.m_inferenceFrames.m_p50Ms, row.m_idleFrames.m_p99Ms, row.m_inferenceFrames.m_p99Ms, row.m_idleStddevMs, row.m_inferenceStddevMs,
+        row.m_ttftP50Ms, row.m_tokensPerSecond);
+
+    m_index++;
+    SetPhase(m_index < m_points.size() ? Phase::Apply : Phase::Done);
+}
+
+size_t FrameSweep::GetFailedPoints() const
+{
+    return std::count_if(m_results.begin(), m_results.end(), [](const SweepPointResult& r) { return !r.m_ok; });
+}
+
+bool FrameSweep::WriteReport(const std::string& basePath) const
+{
+    std::ofstream csv(basePath + ".csv", std::ios::trunc);
+    if (!csv)
+        return false;
+
+    csv << "cpu_load_ms,gpu_load,scheduling,coordinator,backend,target_fps,ok,"
+        "idle_frames,idle_fps,idle_p50_ms,idle_p99_ms,idle_stddev_ms,"
+        "inference_frames,inference_fps,inference_p50_ms,inference_p90_ms,inference_p99_ms,inference_max_ms,inference_stddev_ms,frame_p99_delta_ms,"
+        "turns,failed_turns,ttft_p50_ms,ttft_p90_ms,turn_p50_ms,tokens_per_s\n";
+    for (const auto& r : m_results)
+    {
+        csv << r.m_point.m_cpuLoad << "," << r.m_point.m_gpuLoad << "," << GetSchedulingModeName(r.m_point.m_schedulingMode) << ","
+            << FrameCoordinator::GetPolicyName(r.m_point.m_coordinator) << "," << r.m_backend << "," << r.m_point.m_targetFps << "," << (r.m_ok ? 1 : 0) << ","
+            << r.m_idleFrames.m_count << "," << FramesPerSecond(r.m_idleFrames) << "," << r.m_idleFrames.m_p50Ms << "," << r.m_idleFrames.m_p99Ms << ","
+            << r.m_idleStddevMs << ","
+            << r.m_inferenceFrames.m_count << "," << FramesPerSecond(r.m_inferenceFrames) << "," << r.m_inferenceFrames.m_p50Ms << ","
+            << r.m_inferenceFrames.m_p90Ms << "," << r.m_inferenceFrames.m_p99Ms << "," << r.m_inferenceFrames.m_maxMs << "," << r.m_inferenceStddevMs << ","
+            << r.m_inferenceFrames.m_p99Ms - r.m_idleFrames.m_p99Ms << ","
+            << r.m_turns << "," << r.m_failedTurns << "," << r.m_ttftP50Ms << "," << r.m_ttftP90Ms << "," << r.m_turnP50Ms << ","
+            << r.m_tokensPerSecond << "\n";
+    }
+    if (!csv.good())
+        return false;
+
+    auto writeFrames = [](std::ostream& out, const LatencyHistogram::Summary& s, double stddev)
+        {
+            out << "{ \"count\": " << s.m_count << ", \"fps\": " << FramesPerSecond(s) << ", \"mean\": " << s.m_meanMs
+                << ", \"stddev\": " << stddev << ", \"p50\": " << s.m_p50Ms << ", \"p90\": " << s.m_p90Ms << ", \"p99\": " << s.m_p99Ms << ", \"max\": " << s.m_maxMs << " }";
+        };
+
+    std::ofstream json(basePath + ".json", std::ios::trunc);
+    if (!json)
+        return false;
+
+    json << "{\n";
+    json << "  \"turns_per_point\": " << m_spec.m_turns.size() << ",\n";
+    json << "  \"settle_frames\": " << m_spec.m_settleFrames << ",\n";
+    json << "  \"idle_frames\": " << m_spec.m_idleFrames << ",\n";
+    json << "  \"points\": [\n";
+    for (size_t i = 0; i < m_results.size(); i++)
+    {
+        const auto& r = m_results[i];
+        json << "    { \"cpu_load_ms\": " << r.m_point.m_cpuLoad << ", \"gpu_load\": " << r.m_point.m_gpuLoad
+            << ", \"scheduling\": \"" << GetSchedulingModeName(r.m_point.m_schedulingMode)
+            << "\", \"coordinator\": \"" << FrameCoordinator::GetPolicyName(r.m_point.m_coordinator) << "\", \"backend\": \"" << r.m_backend
+            << "\", \"target_fps\": " << r.m_point.m_targetFps << ", \"ok\": " << (r.m_ok ? "true" : "false") << ",\n";
+        json << "      \"idle_frames\": ";
+        writeFrames(json, r.m_idleFrames, r.m_idleStddevMs);
+        json << ",\n      \"inference_frames\": ";
+        writeFrames(json, r.m_inferenceFrames, r.m_inferenceStddevMs);
+        json << ",\n      \"turns\": " << r.m_turns << ", \"failed_turns\": " << r.m_failedTurns << ", \"ttft_p50_ms\": " << r.m_ttftP50Ms
+            << ", \"ttft_p90_ms\": " << r.m_ttftP90Ms << ", \"turn_p50_ms\": " << r.m_turnP50Ms << ", \"tokens_per_s\": " << r.m_tokensPerSecond
+            << " }" << (i + 1 < m_results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n";
+    json << "}\n";
+    return json.good();
+}
@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "FrameCoordinator.h"
+#include "LatencyHistogram.h"
+#include "ScriptRunner.h"
+
+// One combination of simulated game load and inference settings
+struct SweepPoint
+{
+    // Maximum CPU busy-wait per frame (ms) and number of extra GBuffer passes, as in UIData
+    float m_cpuLoad = 0.0f;
+    int m_gpuLoad = 0;
+    uint32_t m_schedulingMode = 0;
+    FrameCoordinator::Policy m_coordinator = FrameCoordinator::Policy::Off;
+    // GPT plugin name (e.g. ggml.cuda); empty keeps the plugin that is loaded
+    std::string m_backend;
+    // 0 disables the framerate limiter
+    int m_targetFps = 0;
+};
+
+struct SweepPointResult
+{
+    SweepPoint m_point;
+    // Plugin that actually ran GPT
+    std::string m_backend;
+    bool m_ok = false;
+    // Frame times with the load applied, before and while the script runs
+    LatencyHistogram::Summary m_idleFrames;
+    LatencyHistogram::Summary m_inferenceFrames;
+    double m_idleStddevMs = 0.0;
+    double m_inferenceStddevMs = 0.0;
+    size_t m_turns = 0;
+    size_t m_failedTurns = 0;
+    double m_ttftP50Ms = 0.0;
+    double m_ttftP90Ms = 0.0;
+    double m_turnP50Ms = 0.0;
+    // Generated tokens over the time spent in GPT, summed across turns
+    double m_tokensPerSecond = 0.0;
+};
+
+// Frame-time vs. inference sweep over CPU load, GPU load, scheduling mode, frame coordinator policy,
+// GPT backend and target FPS.
+//
+// For every point the caller applies the settings, then the sweep lets the frame rate settle, measures
+// the idle frame times, and measures them again while a conversation script runs; the report puts the
+// frame time percentiles next to the TTFT and throughput of that run.  Frames are recorded from the
+// present callback and the phases are advanced from the UI, both on the main thread.
+class FrameSweep
+{
+public:
+    enum class Phase
+    {
+        Apply,
+        Settle,
+        Idle,
+        Inference,
+        Done
+    };
+
+    struct Spec
+    {
+        std::vector<float> m_cpuLoads;
+        std::vector<int> m_gpuLoads;
+        std::vector<uint32_t> m_schedulingModes;
+        std::vector<FrameCoordinator::Policy> m_coordinators;
+        std::vector<std::string> m_backends;
+        std::vector<int> m_targetFps;
+        std::vector<ScriptTurn> m_turns;
+        int m_settleFrames = 60;
+        int m_idleFrames = 240;
+    };
+
+    // One axis or setting per line, '#' starts a comment:
+    //   cpuLoad <ms>...            gpuLoad <passes>...
+    //   scheduling <graphics|inference|balanced|adaptive>...
+    //   coordinator <off|fps|ttft>...
+    //   backend <plugin>...        fps <target>...       (0 = unlimited)
+    //   script <path>              conversation run at every point, relative to the spec
+    //   settle <frames>            idle <frames>
+    // Missing axes keep their current value; the script is required.
+    static bool ParseSpec(const std::string& path, Spec& spec);
+
+    // Backends vary slowest since switching them reloads the model, CPU load fastest
+    void Start(const Spec& spec, uint32_t currentSchedulingMode, FrameCoordinator::Policy currentCoordinator);
+    bool IsActive() const { return !m_points.empty() && m_phase != Phase::Done; }
+    bool IsDone() const { return !m_points.empty() && m_phase == Phase::Done; }
+
+    Phase GetPhase() const { return m_phase; }
+    void SetPhase(Phase phase);
+    // True once the settle or idle phase has seen enough frames
+    bool IsPhaseComplete() const;
+    const SweepPoint* GetPoint() const { return IsActive() ? &m_points[m_index] : nullptr; }
+    size_t GetIndex() const { return m_index; }
+    size_t GetCount() const { return m_points.size(); }
+    const std::vector<ScriptTurn>& GetTurns() const { return m_spec.m_turns; }
+
+    void RecordFrame(double ms);
+    // Stores the row for the current point and moves on to the next (or to Done)
+    void FinishPoint(const std::string& backend, bool ok, const std::vector<ScriptTurnResult>& results);
+
+    const std::vector<SweepPointResult>& GetResults() const { return m_results; }
+    size_t GetFailedPoints() const;
+
+    // <base>.csv has one row per point, <base>.json the same data as an array
+    bool WriteReport(const std::string& basePath) const;
+
+    // Scheduling mode of points that leave it to the adaptive controller
+    static constexpr uint32_t kAdaptiveScheduling = ~0u;
+    static const char* GetSchedulingModeName(uint32_t mode);
+
+private:
+    Spec m_spec;
+    std::vector<SweepPoint> m_points;
+    std::vector<SweepPointResult> m_results;
+    size_t m_index = 0;
+    Phase m_phase = Phase::Done;
+    int m_phaseFrames = 0;
+    LatencyHistogram m_idleFrames;
+    LatencyHistogram m_inferenceFrames;
+    RunningStats m_idleStats;
+    RunningStats m_inferenceStats;
+};
@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "GPTStats.h"
+
+#include <fstream>
+
+namespace
+{
+    // Rough average for English text with the tokenizers used by the shipped models
+    constexpr size_t kBytesPerPromptToken = 4;
+
+    double ToMs(GPTStatsTable::Clock::duration d)
+    {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+
+    std::string QuoteCSV(const std::string& text)
+    {
+        std::string out = "\"";
+        for (char c : text)
+        {
+            if (c == '"')
+                out += '"';
+            out += c;
+        }
+        return out + "\"";
+    }
+}
+
+GPTStatsTable::Entry& GPTStatsTable::GetEntry(const std::string& plugin, const std::string& model, const std::string& schedulingMode)
+{
+    std::scoped_lock lock(m_mutex);
+    for (auto& entry : m_entries)
+    {
+        if (entry.m_plugin == plugin && entry.m_model == model && entry.m_schedulingMode == schedulingMode)
+            return entry;
+    }
+    auto& entry = m_entries.emplace_back();
+    entry.m_plugin = plugin;
+    entry.m_model = model;
+    entry.m_schedulingMode = schedulingMode;
+    return entry;
+}
+
+bool GPTStatsTable::WriteCSV(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+        return false;
+
+    file << "plugin,model,scheduling_mode,requests,prompt_tokens_est,generated_tokens,avg_tokens_per_s,"
+        "ttft_p50_ms,ttft_p99_ms,inter_token_p50_ms,inter_token_p99_ms,callback_p50_ms,callback_p99_ms\n";
+    ForEach([&](const Entry& e)
+        {
+            file << QuoteCSV(e.m_plugin) << "," << QuoteCSV(e.m_model) << "," << QuoteCSV(e.m_schedulingMode) << ","
+                << e.m_requests << "," << e.m_promptTokens << "," << e.m_generatedTokens << "," << e.GetAverageTokensPerSecond() << ","
+                << e.m_firstToken.GetPercentileMs(50.0) << "," << e.m_firstToken.GetPercentileMs(99.0) << ","
+                << e.m_interToken.GetPercentileMs(50.0) << "," << e.m_interToken.GetPercentileMs(99.0) << ","
+                << e.m_callback.GetPercentileMs(50.0) << "," << e.m_callback.GetPercentileMs(99.0) << "\n";
+        });
+    return file.good();
+}
+
+void GPTRequestStats::Begin(GPTStatsTable& table, GPTStatsTable::Entry& entry, size_t promptBytes)
+{
+    m_table = &table;
+    m_entry = &entry;
+    m_start = GPTStatsTable::Clock::now();
+    m_promptTokens = (uint32_t)((promptBytes + kBytesPerPromptToken - 1) / kBytesPerPromptToken);
+    m_generatedTokens = 0;
+}
+
+GPTRequestStats::Token GPTRequestStats::OnToken()
+{
+    Token token;
+    if (!m_entry)
+        return token;
+
+    auto now = GPTStatsTable::Clock::now();
+    token.m_first = m_generatedTokens == 0;
+    token.m_ms = ToMs(now - (token.m_first ? m_start : m_lastToken));
+    if (token.m_first)
+    {
+        m_firstToken = now;
+        m_entry->m_firstToken.RecordMs(token.m_ms);
+    }
+    else
+    {
+        m_entry->m_interToken.RecordMs(token.m_ms);
+    }
+    m_lastToken = now;
+    m_generatedTokens++;
+    return token;
+}
+
+void GPTRequestStats::AddCallbackTime(GPTStatsTable::Clock::time_point callbackStart)
+{
+    if (m_entry)
+        m_entry->m_callback.RecordMs(ToMs(GPTStatsTable::Clock::now() - callbackStart));
+}
+
+void GPTRequestStats::End()
+{
+    if (!m_entry)
+        return;
+
+    std::scoped_lock lock(m_table->m_mutex);
+    auto& entry = *m_entry;
+    entry.m_requests++;
+    entry.m_promptTokens += m_promptTokens;
+    entry.m_generatedTokens += m_generatedTokens;
+    if (m_generatedTokens > 1)
+    {
+        double seconds = ToMs(m_lastToken - m_firstToken) / 1000.0;
+        entry.m_decodeTokens += m_generatedTokens - 1;
+        entry.m_decodeSeconds += seconds;
+        if (seconds > 0.0)
+            entry.m_tokensPerSecond[entry.m_historyCount++ % GPTStatsTable::kHistorySize] = (float)((m_generatedTokens - 1) / seconds);
+    }
+    m_entry = nullptr;
+    m_table = nullptr;
+}
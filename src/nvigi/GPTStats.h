@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+
+#include "LatencyHistogram.h"
+
+// GPT throughput and latency, aggregated per (plugin, model, scheduling mode) so backends can be
+// compared against each other.
+//
+// Generated tokens are counted as callbacks that carry text; the local plugins call back once per
+// token, while cloud plugins may batch several.  The plugins do not report the prompt token count,
+// so it is estimated from the prompt length.
+class GPTStatsTable
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr uint32_t kHistorySize = 64;
+
+    struct Entry
+    {
+        std::string m_plugin;
+        std::string m_model;
+        std::string m_schedulingMode;
+
+        // Updated when a request ends; read under the table lock
+        uint64_t m_requests = 0;
+        uint64_t m_promptTokens = 0;
+        uint64_t m_generatedTokens = 0;
+        // Tokens after the first one, and the time from the first token to the last
+        uint64_t m_decodeTokens = 0;
+        double m_decodeSeconds = 0.0;
+        // Ring of the decode rate of recent requests; once full, m_historyCount % kHistorySize is the oldest
+        std::array<float, kHistorySize> m_tokensPerSecond{};
+        uint32_t m_historyCount = 0;
+
+        // Recorded while a request runs
+        LatencyHistogram m_firstToken;
+        LatencyHistogram m_interToken;
+        LatencyHistogram m_callback;
+
+        double GetAverageTokensPerSecond() const { return m_decodeSeconds > 0.0 ? m_decodeTokens / m_decodeSeconds : 0.0; }
+        float GetLastTokensPerSecond() const { return m_historyCount ? m_tokensPerSecond[(m_historyCount - 1) % kHistorySize] : 0.0f; }
+    };
+
+    // Entries are never removed, so the reference stays valid for the lifetime of the table
+    Entry& GetEntry(const std::string& plugin, const std::string& model, const std::string& schedulingMode);
+
+    // Calls fn(const Entry&) for each entry with the table locked
+    template <typename F> void ForEach(F fn) const
+    {
+        std::scoped_lock lock(m_mutex);
+        for (auto& entry : m_entries)
+            fn(entry);
+    }
+
+    // One row per entry with the request counts, token rates and latency percentiles
+    bool WriteCSV(const std::string& path) const;
+
+private:
+    friend class GPTRequestStats;
+    mutable std::mutex m_mutex;
+    std::list<Entry> m_entries;
+};
+
+// Measurements for one GPT evaluation, filled in from the GPT callback
+class GPTRequestStats
+{
+public:
+    struct Token
+    {
+        bool m_first = false;
+        // Time to first token, or the gap since the previous token
+        double m_ms = 0.0;
+    };
+
+    void Begin(GPTStatsTable& table, GPTStatsTable::Entry& entry, size_t promptBytes);
+    Token OnToken();
+    void AddCallbackTime(GPTStatsTable::Clock::time_point callbackStart);
+    void End();
+
+    bool IsActive() const { return m_entry != nullptr; }
+    uint32_t GetGeneratedTokens() const { return m_generatedTokens; }
+
+private:
+    GPTStatsTable* m_table = nullptr;
+    GPTStatsTable::Entry* m_entry = nullptr;
+    GPTStatsTable::Clock::time_point m_start;
+    GPTStatsTable::Clock::time_point m_firstToken;
+    GPTStatsTable::Clock::time_point m_lastToken;
+    uint32_t m_promptTokens = 0;
+    uint32_t m_generatedTokens = 0;
+};
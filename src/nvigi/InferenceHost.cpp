@@ -0,0 +1,1511 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "InferenceHost.h"
+#include "LogSink.h"
+#include "SharedRing.h"
+#include "ThreadRegistry.h"
+
+#include <nvigi.h>
+#include <nvigi_ai.h>
+#include <nvigi_asr_whisper.h>
+#include <nvigi_cloud.h>
+#include <nvigi_gpt.h>
+#include <nvigi_stl_helpers.h>
+#include <nvigi_tts.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <csignal>
+#include <spawn.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Room for a minute of 16kHz recorded audio one way, and a few seconds of synthesized audio the other
+    constexpr size_t kCommandRingSize = 4u << 20;
+    constexpr size_t kEventRingSize = 4u << 20;
+    constexpr int kHeartbeatMs = 50;
+    constexpr int kStartTimeoutMs = 60000;
+    constexpr int kStopTimeoutMs = 2000;
+    constexpr int kWriteTimeoutMs = 5000;
+    constexpr int kRelaunchDelayMs = 2000;
+    constexpr size_t kMaxPlugins = 16;
+
+    enum Command : uint32_t
+    {
+        kCommandCreate = 1,
+        kCommandDestroy,
+        kCommandEvaluate,
+        kCommandCancel,
+        kCommandShutdown
+    };
+
+    enum Event : uint32_t
+    {
+        kEventCreated = 1,
+        kEventOutput,
+        kEventFinished
+    };
+
+    // Structs present in a creation parameter chain
+    constexpr uint32_t kParamsGPT = 1;
+    constexpr uint32_t kParamsASR = 2;
+    constexpr uint32_t kParamsTTS = 4;
+    constexpr uint32_t kParamsASqFlow = 8;
+    constexpr uint32_t kParamsREST = 16;
+
+    // Runtime parameter structs present
+    constexpr uint32_t kRuntimeGPT = 1;
+    constexpr uint32_t kRuntimeTTS = 2;
+
+    enum SlotKind : uint32_t
+    {
+        kSlotText,
+        kSlotAudio,
+        kSlotBytes
+    };
+
+    // Start of the shared block, followed by the command ring and the event ring
+    struct Control
+    {
+        alignas(64) std::atomic<uint64_t> m_heartbeat;
+        std::atomic<uint32_t> m_ready;
+    };
+
+    size_t GetBlockSize()
+    {
+        return sizeof(Control) + SharedRing::GetRequiredSize(kCommandRingSize) + SharedRing::GetRequiredSize(kEventRingSize);
+    }
+
+    bool AttachBlock(SharedMemory& memory, const std::string& name, bool create, Control*& control, SharedRing& commands, SharedRing& events)
+    {
+        uint8_t* base = (uint8_t*)memory.GetData();
+        control = create ? new (base) Control() : (Control*)base;
+        base += sizeof(Control);
+        if (!commands.Attach(base, kCommandRingSize, name + ".commands", create))
+            return false;
+        base += SharedRing::GetRequiredSize(kCommandRingSize);
+        return events.Attach(base, kEventRingSize, name + ".events", create);
+    }
+
+    // Messages are flat little-endian fields; every request and event starts with the request ID
+    class Writer
+    {
+    public:
+        void U32(uint32_t value) { Raw(&value, sizeof(value)); }
+        void U64(uint64_t value) { Raw(&value, sizeof(value)); }
+        void Raw(const void* data, size_t size)
+        {
+            auto bytes = (const uint8_t*)data;
+            m_data.insert(m_data.end(), bytes, bytes + size);
+        }
+        // A null string stays distinct from an empty one
+        void String(const char* text)
+        {
+            if (!text)
+            {
+                U32(~0u);
+                return;
+            }
+            size_t length = strlen(text);
+            U32((uint32_t)length);
+            Raw(text, length);
+        }
+        void Blob(const void* data, size_t size)
+        {
+            U32((uint32_t)size);
+            if (size)
+                Raw(data, size);
+        }
+
+        std::vector<uint8_t> m_data;
+    };
+
+    class Reader
+    {
+    public:
+        Reader(const std::vector<uint8_t>& data) : m_data(data.data()), m_size(data.size()) {}
+
+        uint32_t U32()
+        {
+            uint32_t value = 0;
+            Raw(&value, sizeof(value));
+            return value;
+        }
+        uint64_t U64()
+        {
+            uint64_t value = 0;
+            Raw(&value, sizeof(value));
+            return value;
+        }
+        void Raw(void* out, size_t size)
+        {
+            if (!m_ok || size > m_size - m_pos)
+            {
+                m_ok = false;
+                return;
+            }
+            memcpy(out, m_data + m_pos, size);
+            m_pos += size;
+        }
+        // False for a null string
+        bool String(std::string& text)
+        {
+            uint32_t length = U32();
+            text.clear();
+            if (length == ~0u)
+                return false;
+            if (!m_ok || length > m_size - m_pos)
+            {
+                m_ok = false;
+                return false;
+            }
+            text.assign((const char*)m_data + m_pos, length);
+            m_pos += length;
+            return true;
+        }
+        // Points into the message
+        const uint8_t* Blob(size_t& size)
+        {
+            size = U32();
+            if (!m_ok || size > m_size - m_pos)
+            {
+                m_ok = false;
+                size = 0;
+                return nullptr;
+            }
+            const uint8_t* data = m_data + m_pos;
+            m_pos += size;
+            return data;
+        }
+        bool Ok() const { return m_ok; }
+
+    private:
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_pos = 0;
+        bool m_ok = true;
+    };
+
+    bool WriteCreationParams(Writer& writer, const nvigi::NVIGIParameter* params)
+    {
+        auto common = nvigi::findStruct<nvigi::CommonCreationParameters>(params);
+        auto gpt = nvigi::findStruct<nvigi::GPTCreationParameters>(params);
+        auto asr = nvigi::findStruct<nvigi::ASRWhisperCreationParameters>(params);
+        auto tts = nvigi::findStruct<nvigi::TTSCreationParameters>(params);
+        auto asqflow = nvigi::findStruct<nvigi::TTSASqFlowCreationParameters>(params);
+        auto rest = nvigi::findStruct<nvigi::RESTParameters>(params);
+        if (!common || (!gpt && !asr && !tts))
+            return false;
+
+        uint32_t flags = (gpt ? kParamsGPT : 0) | (asr ? kParamsASR : 0) | (tts ? kParamsTTS : 0) |
+            (asqflow ? kParamsASqFlow : 0) | (rest ? kParamsREST : 0);
+        writer.U32(flags);
+        writer.U32((uint32_t)common->numThreads);
+        writer.U64((uint64_t)common->vramBudgetMB);
+        writer.String(common->utf8PathToModels);
+        writer.String(common->modelGUID);
+        if (gpt)
+        {
+            writer.U32((uint32_t)gpt->seed);
+            writer.U32((uint32_t)gpt->maxNumTokensToPredict);
+            writer.U32((uint32_t)gpt->contextSize);
+        }
+        if (rest)
+        {
+            writer.String(rest->url);
+            writer.String(rest->authenticationToken);
+            writer.U32(rest->verboseMode ? 1 : 0);
+        }
+        return true;
+    }
+
+    // Creation parameters rebuilt in the host; chained in place, so never moved
+    struct CreationParams
+    {
+        nvigi::CommonCreationParameters m_common{};
+        nvigi::GPTCreationParameters m_gpt{};
+        nvigi::ASRWhisperCreationParameters m_asr{};
+        nvigi::TTSCreationParameters m_tts{};
+        nvigi::TTSASqFlowCreationParameters m_asqflow{};
+        nvigi::RESTParameters m_rest{};
+        std::string m_path;
+        std::string m_guid;
+        std::string m_url;
+        std::string m_token;
+        uint32_t m_flags = 0;
+
+        CreationParams() = default;
+        CreationParams(const CreationParams&) = delete;
+        CreationParams& operator=(const CreationParams&) = delete;
+
+        bool Read(Reader& reader)
+        {
+            m_flags = reader.U32();
+            m_common.numThreads = (decltype(m_common.numThreads))reader.U32();
+            m_common.vramBudgetMB = (decltype(m_common.vramBudgetMB))reader.U64();
+            m_common.utf8PathToModels = reader.String(m_path) ? m_path.c_str() : nullptr;
+            m_common.modelGUID = reader.String(m_guid) ? m_guid.c_str() : nullptr;
+            if (m_flags & kParamsGPT)
+            {
+                m_gpt.seed = (decltype(m_gpt.seed))reader.U32();
+                m_gpt.maxNumTokensToPredict = (decltype(m_gpt.maxNumTokensToPredict))reader.U32();
+                m_gpt.contextSize = (decltype(m_gpt.contextSize))reader.U32();
+            }
+            if (m_flags & kParamsREST)
+            {
+                m_rest.url = reader.String(m_url) ? m_url.c_str() : nullptr;
+                m_rest.authenticationToken = reader.String(m_token) ? m_token.c_str() : nullptr;
+                m_rest.verboseMode = reader.U32() != 0;
+            }
+            if (!reader.Ok())
+                return false;
+
+            if (m_flags & kParamsGPT)
+            {
+                if (m_gpt.chain(m_common) != nvigi::kResultOk)
+                    return false;
+                if ((m_flags & kParamsREST) && m_gpt.chain(m_rest) != nvigi::kResultOk)
+                    return false;
+                return true;
+            }
+            if (m_flags & kParamsASR)
+                return m_asr.chain(m_common) == nvigi::kResultOk;
+            if (m_flags & kParamsTTS)
+            {
+                if (m_tts.chain(m_common) != nvigi::kResultOk)
+                    return false;
+                if ((m_flags & kParamsASqFlow) && m_tts.chain(m_asqflow) != nvigi::kResultOk)
+                    return false;
+                return true;
+            }
+            return false;
+        }
+
+        nvigi::Result Create(nvigi::InferenceInterface* iface, nvigi::InferenceInstance** instance)
+        {
+            if (m_flags & kParamsGPT)
+                return iface->createInstance(m_gpt, instance);
+            if (m_flags & kParamsASR)
+                return iface->createInstance(m_asr, instance);
+            return iface->createInstance(m_tts, instance);
+        }
+    };
+
+    void WriteRuntimeParams(Writer& writer, const nvigi::NVIGIParameter* params)
+    {
+        auto gpt = params ? nvigi::findStruct<nvigi::GPTRuntimeParameters>(params) : nullptr;
+        auto tts = params ? nvigi::findStruct<nvigi::TTSASqFlowRuntimeParameters>(params) : nullptr;
+        writer.U32((gpt ? kRuntimeGPT : 0) | (tts ? kRuntimeTTS : 0));
+        if (gpt)
+        {
+            writer.U32((uint32_t)gpt->seed);
+            writer.U32((uint32_t)gpt->tokensToPredict);
+            writer.U32(gpt->interactive ? 1 : 0);
+            writer.String(gpt->reversePrompt);
+        }
+        if (tts)
+            writer.U32((uint32_t)tts->n_timesteps);
+    }
+
+    struct RuntimeParams
+    {
+        nvigi::GPTRuntimeParameters m_gpt{};
+        nvigi::TTSASqFlowRuntimeParameters m_tts{};
+        std::string m_reversePrompt;
+        uint32_t m_flags = 0;
+
+        bool Read(Reader& reader)
+        {
+            m_flags = reader.U32();
+            if (m_flags & kRuntimeGPT)
+            {
+                m_gpt.seed = (decltype(m_gpt.seed))reader.U32();
+                m_gpt.tokensToPredict = (decltype(m_gpt.tokensToPredict))reader.U32();
+                m_gpt.interactive = reader.U32() != 0;
+                m_gpt.reversePrompt = reader.String(m_reversePrompt) ? m_reversePrompt.c_str() : nullptr;
+            }
+            if (m_flags & kRuntimeTTS)
+                m_tts.n_timesteps = (decltype(m_tts.n_timesteps))reader.U32();
+            return reader.Ok();
+        }
+
+        const nvigi::NVIGIParameter* Get()
+        {
+            if (m_flags & kRuntimeGPT)
+                return m_gpt;
+            if (m_flags & kRuntimeTTS)
+                return m_tts;
+            return nullptr;
+        }
+    };
+
+    // Recorded audio goes in as audio, synthesized audio comes back as bytes, everything else is text
+    bool WriteSlots(Writer& writer, const nvigi::InferenceDataSlotArray* slots)
+    {
+        size_t count = slots ? slots->count : 0;
+        writer.U32((uint32_t)count);
+        for (size_t i = 0; i < count; i++)
+        {
+            const char* key = slots->items[i].key;
+            writer.String(key);
+            if (!strcmp(key, nvigi::kASRWhisperDataSlotAudio))
+            {
+                const nvigi::InferenceDataAudio* audio{};
+                if (!slots->findAndValidateSlot(key, &audio) || !audio)
+                    return false;
+                // Audio already on the GPU cannot be forwarded
+                const nvigi::CpuData* cpuBuffer = nvigi::castTo<nvigi::CpuData>(audio->audio);
+                if (!cpuBuffer)
+                    return false;
+                writer.U32(kSlotAudio);
+                writer.U32((uint32_t)audio->bitsPerSample);
+                writer.U32((uint32_t)audio->samplingRate);
+                writer.U32((uint32_t)audio->channels);
+                writer.Blob(cpuBuffer->buffer, cpuBuffer->sizeInBytes);
+            }
+            else if (!strcmp(key, nvigi::kTTSDataSlotOutputAudio))
+            {
+                const nvigi::InferenceDataByteArray* bytes{};
+                if (!slots->findAndValidateSlot(key, &bytes) || !bytes)
+                    return false;
+                const nvigi::CpuData* cpuBuffer = nvigi::castTo<nvigi::CpuData>(bytes->bytes);
+                if (!cpuBuffer)
+                    return false;
+                writer.U32(kSlotBytes);
+                writer.Blob(cpuBuffer->buffer, cpuBuffer->sizeInBytes);
+            }
+            else
+            {
+                const nvigi::InferenceDataText* text{};
+                if (!slots->findAndValidateSlot(key, &text) || !text)
+                    return false;
+                writer.U32(kSlotText);
+                writer.String((const char*)text->getUTF8Text());
+            }
+        }
+        return true;
+    }
+
+    // Slots rebuilt on the other side, in the same form the plugins and callbacks expect
+    struct SlotSet
+    {
+        struct Data
+        {
+            std::string m_key;
+            std::vector<uint8_t> m_bytes;
+            nvigi::CpuData m_cpuBuffer;
+            std::unique_ptr<nvigi::InferenceDataAudio> m_audio;
+            std::unique_ptr<nvigi::InferenceDataTextSTLHelper> m_text;
+            std::unique_ptr<nvigi::InferenceDataByteArraySTLHelper> m_byteArray;
+        };
+
+        std::vector<std::unique_ptr<Data>> m_data;
+        std::vector<nvigi::InferenceDataSlot> m_slots;
+        nvigi::InferenceDataSlotArray m_array{};
+
+        bool Read(Reader& reader)
+        {
+            uint32_t count = reader.U32();
+            for (uint32_t i = 0; i < count && reader.Ok(); i++)
+            {
+                auto data = std::make_unique<Data>();
+                reader.String(data->m_key);
+                uint32_t kind = reader.U32();
+                if (kind == kSlotAudio)
+                {
+                    int32_t bitsPerSample = (int32_t)reader.U32();
+                    int32_t samplingRate = (int32_t)reader.U32();
+                    int32_t channels = (int32_t)reader.U32();
+                    size_t size = 0;
+                    const uint8_t* bytes = reader.Blob(size);
+                    data->m_bytes.assign(bytes, bytes + size);
+                    data->m_cpuBuffer = nvigi::CpuData(data->m_bytes.size(), data->m_bytes.data());
+                    data->m_audio = std::make_unique<nvigi::InferenceDataAudio>(data->m_cpuBuffer);
+                    data->m_audio->bitsPerSample = bitsPerSample;
+                    data->m_audio->samplingRate = samplingRate;
+                    data->m_audio->channels = channels;
+                }
+                else if (kind == kSlotBytes)
+                {
+                    size_t size = 0;
+                    const uint8_t* bytes = reader.Blob(size);
+                    data->m_bytes.assign(bytes, bytes + size);
+                    data->m_byteArray = std::make_unique<nvigi::InferenceDataByteArraySTLHelper>(data->m_bytes);
+                }
+                else
+                {
+                    std::string text;
+                    reader.String(text);
+                    data->m_text = std::make_unique<nvigi::InferenceDataTextSTLHelper>(text);
+                }
+                m_data.push_back(std::move(data));
+            }
+            if (!reader.Ok())
+                return false;
+
+            for (auto& data : m_data)
+            {
+                if (data->m_audio)
+                    m_slots.push_back({ data->m_key.c_str(), *data->m_audio });
+                else if (data->m_byteArray)
+                    m_slots.push_back({ data->m_key.c_str(), *data->m_byteArray });
+                else
+                    m_slots.push_back({ data->m_key.c_str(), *data->m_text });
+            }
+            m_array = { m_slots.size(), m_slots.data() };
+            return true;
+        }
+    };
+
+    // Parent side
+
+    struct Request
+    {
+        uint64_t m_id = 0;
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::deque<std::pair<uint32_t, std::vector<uint8_t>>> m_events;
+        bool m_failed = false;
+        // Evaluations count as stalled after going the stall time without an event
+        bool m_watched = false;
+        Clock::time_point m_lastEvent;
+    };
+
+    class Client
+    {
+    public:
+        static Client& Get()
+        {
+            static Client s_client;
+            return s_client;
+        }
+
+        bool Start(const std::vector<std::string>& args, int stallMs);
+        void Stop();
+        void RequestRestart() { m_restartRequested = true; }
+        bool IsStarted();
+        InferenceHost::Stats GetStats();
+
+        // Generation of the running host once it is not being restarted, or 0 if it is not running
+        uint32_t WaitForHost();
+        uint32_t GetGeneration();
+
+        // Sends a command whose first field is left for the request ID; null if the host is not running
+        std::shared_ptr<Request> Send(uint32_t type, Writer& writer, bool watched, uint32_t& generation);
+        // A command without a reply
+        bool Post(uint32_t type, const Writer& writer);
+        // Next event of the request; false once the request has failed
+        bool Wait(Request& request, uint32_t& type, std::vector<uint8_t>& payload);
+        void Release(const Request& request);
+
+    private:
+        void Monitor();
+        void Dispatch(uint32_t type, std::vector<uint8_t>& payload);
+        bool CheckHealth(uint64_t& heartbeat, Clock::time_point& heartbeatTime);
+        void Recover(const char* reason);
+        void FailRequests();
+        bool Launch();
+        bool Spawn(const std::vector<std::string>& args);
+        bool IsAlive();
+        void Kill();
+        void Close();
+
+        std::mutex m_mutex;
+        std::condition_variable m_stateCV;
+        bool m_started = false;
+        bool m_running = false;
+        bool m_launching = false;
+        std::atomic<bool> m_stopping = false;
+        std::atomic<bool> m_restartRequested = false;
+        uint32_t m_generation = 0;
+        uint32_t m_launches = 0;
+        std::vector<std::string> m_args;
+        int m_stallMs = 10000;
+
+        SharedMemory m_memory;
+        SharedRing m_commands;
+        SharedRing m_events;
+        Control* m_control = nullptr;
+        std::map<uint64_t, std::shared_ptr<Request>> m_requests;
+        uint64_t m_nextRequest = 1;
+        InferenceHost::Stats m_stats;
+        std::thread m_monitor;
+#ifdef _WIN32
+        HANDLE m_process = nullptr;
+        HANDLE m_job = nullptr;
+#else
+        pid_t m_pid = 0;
+#endif
+    };
+
+    bool Client::Start(const std::vector<std::string>& args, int stallMs)
+    {
+        std::unique_lock lock(m_mutex);
+        if (m_started)
+            return true;
+        m_args = args;
+        m_stallMs = std::max(kHeartbeatMs * 4, stallMs);
+        m_stopping = false;
+        lock.unlock();
+
+        if (!Launch())
+            return false;
+
+        lock.lock();
+        m_started = true;
+        m_running = true;
+        m_generation++;
+        m_monitor = std::thread(&Client::Monitor, this);
+        return true;
+    }
+
+    void Client::Stop()
+    {
+        {
+            std::scoped_lock lock(m_mutex);
+            if (!m_started)
+                return;
+            m_stopping = true;
+        }
+        m_stateCV.notify_all();
+        if (m_monitor.joinable())
+            m_monitor.join();
+
+        std::scoped_lock lock(m_mutex);
+        FailRequests();
+        if (m_running)
+        {
+            m_commands.Write(kCommandShutdown, nullptr, 0, kHeartbeatMs);
+            auto deadline = Clock::now() + std::chrono::milliseconds(kStopTimeoutMs);
+            while (IsAlive() && Clock::now() < deadline)
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        Kill();
+        Close();
+        m_running = false;
+        m_started = false;
+        m_stateCV.notify_all();
+    }
+
+    bool Client::IsStarted()
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_started;
+    }
+
+    InferenceHost::Stats Client::GetStats()
+    {
+        std::scoped_lock lock(m_mutex);
+        InferenceHost::Stats stats = m_stats;
+        stats.m_running = m_running;
+        return stats;
+    }
+
+    uint32_t Client::WaitForHost()
+    {
+        std::unique_lock lock(m_mutex);
+        m_stateCV.wait(lock, [this]() { return !m_launching || m_stopping; });
+        return m_running && !m_stopping ? m_generation : 0;
+    }
+
+    uint32_t Client::GetGeneration()
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_running ? m_generation : 0;
+    }
+
+    std::shared_ptr<Request> Client::Send(uint32_t type, Writer& writer, bool watched, uint32_t& generation)
+    {
+        auto request = std::make_shared<Request>();
+        request->m_watched = watched;
+        request->m_lastEvent = Clock::now();
+
+        std::scoped_lock lock(m_mutex);
+        if (!m_running || m_stopping)
+            return nullptr;
+        request->m_id = m_nextRequest++;
+        memcpy(writer.m_data.data(), &request->m_id, sizeof(request->m_id));
+        // Registered first, so that a quick reply finds it
+        m_requests[request->m_id] = request;
+        if (!m_commands.Write(type, writer.m_data.data(), writer.m_data.size(), kWriteTimeoutMs))
+        {
+            LogSink::Error("Inference host: unable to send a %zu byte request", writer.m_data.size());
+            m_requests.erase(request->m_id);
+            return nullptr;
+        }
+        m_stats.m_commands++;
+        m_stats.m_bytes += writer.m_data.size();
+        generation = m_generation;
+        return request;
+    }
+
+    bool Client::Post(uint32_t type, const Writer& writer)
+    {
+        std::scoped_lock lock(m_mutex);
+        if (!m_running || m_stopping)
+            return false;
+        if (!m_commands.Write(type, writer.m_data.data(), writer.m_data.size(), kWriteTimeoutMs))
+            return false;
+        m_stats.m_commands++;
+        m_stats.m_bytes += writer.m_data.size();
+        return true;
+    }
+
+    bool Client::Wait(Request& request, uint32_t& type, std::vector<uint8_t>& payload)
+    {
+        std::unique_lock lock(request.m_mutex);
+        request.m_cv.wait(lock, [&request]() { return !request.m_events.empty() || request.m_failed; });
+        if (request.m_events.empty())
+            return false;
+        type = request.m_events.front().first;
+        payload = std::move(request.m_events.front().second);
+        request.m_events.pop_front();
+        return true;
+    }
+
+    void Client::Release(const Request& request)
+    {
+        std::scoped_lock lock(m_mutex);
+        m_requests.erase(request.m_id);
+    }
+
+    void Client::Monitor()
+    {
+        ThreadRegistry::Register("Inference Host Monitor", ThreadRegistry::Role::Inference);
+        uint64_t heartbeat = 0;
+        auto heartbeatTime = Clock::now();
+        auto lastCheck = heartbeatTime;
+        auto lastLaunch = heartbeatTime;
+        std::vector<uint8_t> payload;
+        for (;;)
+        {
+            bool running;
+            {
+                std::scoped_lock lock(m_mutex);
+                if (m_stopping)
+                    break;
+                running = m_running;
+            }
+
+            if (!running)
+            {
+                // The host failed to start again; keep trying, as a plugin may have been fixed meanwhile
+                std::this_thread::sleep_for(std::chrono::milliseconds(kHeartbeatMs));
+                if (Clock::now() - lastLaunch < std::chrono::milliseconds(kRelaunchDelayMs))
+                    continue;
+                lastLaunch = Clock::now();
+                Recover(nullptr);
+                heartbeat = 0;
+                heartbeatTime = Clock::now();
+                continue;
+            }
+
+            uint32_t type = 0;
+            if (m_events.Read(type, payload, kHeartbeatMs))
+                Dispatch(type, payload);
+
+            auto now = Clock::now();
+            if (now - lastCheck < std::chrono::milliseconds(kHeartbeatMs))
+                continue;
+            lastCheck = now;
+            if (!CheckHealth(heartbeat, heartbeatTime))
+            {
+                lastLaunch = Clock::now();
+                heartbeat = 0;
+                heartbeatTime = Clock::now();
+            }
+        }
+    }
+
+    void Client::Dispatch(uint32_t type, std::vector<uint8_t>& payload)
+    {
+        uint64_t id = 0;
+        if (payload.size() < sizeof(id))
+            return;
+        memcpy(&id, payload.data(), sizeof(id));
+
+        std::shared_ptr<Request> request;
+        {
+            std::scoped_lock lock(m_mutex);
+            m_stats.m_events++;
+            m_stats.m_bytes += payload.size();
+            auto it = m_requests.find(id);
+            if (it != m_requests.end())
+                request = it->second;
+        }
+        // Outputs of a request that has been given up on are dropped
+        if (!request)
+            return;
+
+        std::scoped_lock lock(request->m_mutex);
+        request->m_events.emplace_back(type, std::move(payload));
+        request->m_lastEvent = Clock::now();
+        request->m_cv.notify_one();
+        payload = {};
+    }
+
+    // False if the host had to be replaced
+    bool Client::CheckHealth(uint64_t& heartbeat, Clock::time_point& heartbeatTime)
+    {
+        auto now = Clock::now();
+        auto stall = std::chrono::milliseconds(m_stallMs);
+        const char* failure = nullptr;
+        bool crashed = false;
+        bool stalled = false;
+
+        if (!IsAlive())
+        {
+            failure = "host exited";
+            crashed = true;
+        }
+        else if (m_restartRequested.exchange(false))
+        {
+            failure = "restart requested";
+        }
+        else
+        {
+            uint64_t beat = m_control->m_heartbeat.load(std::memory_order_relaxed);
+            if (beat != heartbeat)
+            {
+                heartbeat = beat;
+                heartbeatTime = now;
+            }
+            if (now - heartbeatTime > stall)
+                failure = "no heartbeat";
+
+            std::scoped_lock lock(m_mutex);
+            for (auto& [id, request] : m_requests)
+            {
+                std::scoped_lock requestLock(request->m_mutex);
+                if (!failure && request->m_watched && !request->m_failed && now - request->m_lastEvent > stall)
+                    failure = "evaluate made no progress";
+            }
+            stalled = failure != nullptr;
+        }
+        if (!failure)
+            return true;
+
+        {
+            std::scoped_lock lock(m_mutex);
+            m_stats.m_crashes += crashed ? 1 : 0;
+            m_stats.m_stalls += stalled ? 1 : 0;
+        }
+        Recover(failure);
+        return false;
+    }
+
+    // Fails what is in flight, then replaces the host; a null reason retries a failed start
+    void Client::Recover(const char* reason)
+    {
+        if (reason)
+            LogSink::Warning("Inference host: %s, restarting it", reason);
+        {
+            std::scoped_lock lock(m_mutex);
+            FailRequests();
+            m_running = false;
+            m_launching = true;
+            Kill();
+            Close();
+        }
+
+        bool launched = Launch();
+        {
+            std::scoped_lock lock(m_mutex);
+            m_launching = false;
+            m_running = launched;
+            if (launched)
+                m_generation++;
+        }
+        m_stateCV.notify_all();
+        if (!launched && reason)
+            LogSink::Error("Inference host: unable to restart; evaluations fail until it starts");
+    }
+
+    void Client::FailRequests()
+    {
+        for (auto& [id, request] : m_requests)
+        {
+            std::scoped_lock lock(request->m_mutex);
+            request->m_failed = true;
+            request->m_cv.notify_one();
+        }
+        m_requests.clear();
+    }
+
+    bool Client::Launch()
+    {
+#ifdef _WIN32
+        uint32_t pid = GetCurrentProcessId();
+#else
+        uint32_t pid = (uint32_t)getpid();
+#endif
+        std::string name = "host." + std::to_string(pid) + "." + std::to_string(m_launches++);
+        if (!m_memory.Create(name, GetBlockSize()) || !AttachBlock(m_memory, name, true, m_control, m_commands, m_events))
+        {
+            LogSink::Error("Inference host: unable to create shared memory %s", name.c_str());
+            Close();
+            return false;
+        }
+
+        std::vector<std::string> args = { "-inferenceHost", name };
+        args.insert(args.end(), m_args.begin(), m_args.end());
+        if (!Spawn(args))
+        {
+            LogSink::Error("Inference host: unable to start the host process");
+            Close();
+            return false;
+        }
+
+        // Loading the NVIGI core and enumerating plugins takes a moment
+        auto deadline = Clock::now() + std::chrono::milliseconds(kStartTimeoutMs);
+        while (!m_control->m_ready.load(std::memory_order_acquire))
+        {
+            if (!IsAlive() || Clock::now() > deadline || m_stopping)
+            {
+                LogSink::Error("Inference host: the host process did not start");
+                Kill();
+                Close();
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        m_memory.Unlink();
+        std::scoped_lock lock(m_mutex);
+        m_stats.m_starts++;
+        return true;
+    }
+
+#ifdef _WIN32
+    std::wstring ToWide(const std::string& text)
+    {
+        int length = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), (int)text.size(), nullptr, 0);
+        std::wstring wide(length, L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, text.c_str(), (int)text.size(), wide.data(), length);
+        return wide;
+    }
+
+    bool Client::Spawn(const std::vector<std::string>& args)
+    {
+        // The host goes down with the job, i.e. with this process
+        if (!m_job)
+        {
+            m_job = CreateJobObjectW(nullptr, nullptr);
+            JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits = {};
+            limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+            if (m_job)
+                SetInformationJobObject(m_job, JobObjectExtendedLimitInformation, &limits, sizeof(limits));
+        }
+
+        wchar_t path[MAX_PATH] = {};
+        GetModuleFileNameW(nullptr, path, MAX_PATH);
+        std::wstring commandLine = L"\"" + std::wstring(path) + L"\"";
+        for (const auto& arg : args)
+        {
+            std::wstring wide = ToWide(arg);
+            // A trailing backslash would escape the closing quote
+            if (!wide.empty() && wide.back() == L'\\')
+                wide += L'\\';
+            commandLine += L" \"" + wide + L"\"";
+        }
+
+        STARTUPINFOW startup = {};
+        startup.cb = sizeof(startup);
+        PROCESS_INFORMATION info = {};
+        if (!CreateProcessW(path, commandLine.data(), nullptr, nullptr, FALSE, CREATE_SUSPENDED, nullptr, nullptr, &startup, &info))
+            return false;
+        if (m_job)
+            AssignProcessToJobObject(m_job, info.hProcess);
+        ResumeThread(info.hThread);
+        CloseHandle(info.hThread);
+        m_process = info.hProcess;
+        return true;
+    }
+
+    bool Client::IsAlive()
+    {
+        return m_process && WaitForSingleObject(m_process, 0) == WAIT_TIMEOUT;
+    }
+
+    void Client::Kill()
+    {
+        if (!m_process)
+            return;
+        if (IsAlive())
+        {
+            TerminateProcess(m_process, 1);
+            WaitForSingleObject(m_process, kStopTimeoutMs);
+        }
+        CloseHandle(m_process);
+        m_process = nullptr;
+    }
+#else
+    bool Client::Spawn(const std::vector<std::string>& args)
+    {
+        std::string path = "/proc/self/exe";
+        std::vector<char*> argv = { path.data() };
+        std::vector<std::string> copies = args;
+        for (auto& arg : copies)
+            argv.push_back(arg.data());
+        argv.push_back(nullptr);
+        pid_t pid = 0;
+        if (posix_spawn(&pid, path.c_str(), nullptr, nullptr, argv.data(), environ) != 0)
+            return false;
+        m_pid = pid;
+        return true;
+    }
+
+    bool Client::IsAlive()
+    {
+        if (m_pid <= 0)
+            return false;
+        if (waitpid(m_pid, nullptr, WNOHANG) == 0)
+            return true;
+        // Reaped
+        m_pid = -m_pid;
+        return false;
+    }
+
+    void Client::Kill()
+    {
+        if (m_pid > 0)
+        {
+            kill(m_pid, SIGKILL);
+            waitpid(m_pid, nullptr, 0);
+        }
+        m_pid = 0;
+    }
+#endif
+
+    void Client::Close()
+    {
+        m_commands.Detach();
+        m_events.Detach();
+        m_memory.Close();
+        m_control = nullptr;
+    }
+
+    struct ProxyInstance
+    {
+        nvigi::InferenceInstance m_instance{};
+        nvigi::PluginID m_id{};
+        // Serialized creation parameters, to create the instance again in a restarted host
+        std::vector<uint8_t> m_params;
+        std::mutex m_mutex;
+        uint64_t m_remote = 0;
+        uint32_t m_generation = 0;
+    };
+
+    nvigi::Result CreateRemote(ProxyInstance& proxy)
+    {
+        Writer writer;
+        writer.U64(0);
+        writer.Raw(&proxy.m_id, sizeof(proxy.m_id));
+        writer.Blob(proxy.m_params.data(), proxy.m_params.size());
+
+        Client& client = Client::Get();
+        uint32_t generation = 0;
+        auto request = client.Send(kCommandCreate, writer, false, generation);
+        if (!request)
+            return nvigi::kResultInvalidState;
+
+        nvigi::Result result = nvigi::kResultInvalidState;
+        uint32_t type = 0;
+        std::vector<uint8_t> payload;
+        if (client.Wait(*request, type, payload) && type == kEventCreated)
+        {
+            Reader reader(payload);
+            reader.U64();
+            result = (nvigi::Result)reader.U32();
+            proxy.m_remote = reader.U64();
+            proxy.m_generation = generation;
+        }
+        client.Release(*request);
+        return result;
+    }
+
+    nvigi::Result EvaluateProxy(nvigi::InferenceExecutionContext* ctx)
+    {
+        if (!ctx || !ctx->instance || !ctx->instance->data)
+            return nvigi::kResultInvalidParameter;
+        ProxyInstance& proxy = *(ProxyInstance*)ctx->instance->data;
+        std::scoped_lock proxyLock(proxy.m_mutex);
+
+        Client& client = Client::Get();
+        uint32_t generation = client.WaitForHost();
+        if (!generation)
+            return nvigi::kResultInvalidState;
+        if (proxy.m_generation != generation)
+        {
+            LogSink::Info("Inference host: creating instance again in the restarted host");
+            if (CreateRemote(proxy) != nvigi::kResultOk)
+                return nvigi::kResultInvalidState;
+        }
+
+        Writer writer;
+        writer.U64(0);
+        writer.U64(proxy.m_remote);
+        if (!WriteSlots(writer, ctx->inputs))
+            return nvigi::kResultInvalidParameter;
+        WriteRuntimeParams(writer, ctx->runtimeParameters);
+        auto request = client.Send(kCommandEvaluate, writer, true, generation);
+        if (!request)
+            return nvigi::kResultInvalidState;
+
+        // The callbacks run here, on the evaluating thread, as they would in-process
+        const nvigi::InferenceDataSlotArray* callerOutputs = ctx->outputs;
+        nvigi::Result result = nvigi::kResultInvalidState;
+        bool cancelled = false;
+        uint32_t type = 0;
+        std::vector<uint8_t> payload;
+        while (client.Wait(*request, type, payload))
+        {
+            Reader reader(payload);
+            reader.U64();
+            if (type == kEventFinished)
+            {
+                result = (nvigi::Result)reader.U32();
+                break;
+            }
+
+            auto state = (nvigi::InferenceExecutionState)reader.U32();
+            SlotSet outputs;
+            if (type != kEventOutput || !outputs.Read(reader) || cancelled || !ctx->callback)
+                continue;
+            ctx->outputs = &outputs.m_array;
+            nvigi::InferenceExecutionState res = ctx->callback(ctx, state, ctx->callbackUserData);
+            ctx->outputs = callerOutputs;
+            if (res == nvigi::kInferenceExecutionStateCancel)
+            {
+                cancelled = true;
+                Writer cancel;
+                cancel.U64(request->m_id);
+                client.Post(kCommandCancel, cancel);
+            }
+        }
+        client.Release(*request);
+        return result;
+    }
+
+    nvigi::Result CreateProxy(const nvigi::PluginID& id, const nvigi::NVIGIParameter* params, nvigi::InferenceInstance** instance)
+    {
+        if (!instance)
+            return nvigi::kResultInvalidParameter;
+        Writer writer;
+        if (!WriteCreationParams(writer, params))
+            return nvigi::kResultInvalidParameter;
+
+        auto proxy = std::make_unique<ProxyInstance>();
+        proxy->m_id = id;
+        proxy->m_params = std::move(writer.m_data);
+        proxy->m_instance.data = (nvigi::InferenceInstanceData*)proxy.get();
+        proxy->m_instance.evaluate = EvaluateProxy;
+
+        if (!Client::Get().WaitForHost())
+            return nvigi::kResultInvalidState;
+        nvigi::Result result = CreateRemote(*proxy);
+        if (result != nvigi::kResultOk)
+            return result;
+        *instance = &proxy.release()->m_instance;
+        return nvigi::kResultOk;
+    }
+
+    nvigi::Result DestroyProxy(const nvigi::InferenceInstance* instance)
+    {
+        if (!instance || !instance->data)
+            return nvigi::kResultInvalidParameter;
+        auto proxy = (ProxyInstance*)instance->data;
+        {
+            std::scoped_lock lock(proxy->m_mutex);
+            // An instance from before a restart went down with its host
+            if (proxy->m_generation == Client::Get().GetGeneration())
+            {
+                Writer writer;
+                writer.U64(0);
+                writer.U64(proxy->m_remote);
+                Client::Get().Post(kCommandDestroy, writer);
+            }
+        }
+        delete proxy;
+        return nvigi::kResultOk;
+    }
+
+    nvigi::Result GetProxyCaps(nvigi::NVIGIParameter**, const nvigi::NVIGIParameter*)
+    {
+        return nvigi::kResultInvalidState;
+    }
+
+    // createInstance carries no interface pointer, so each wrapped plugin gets its own entry point
+    struct ProxyInterface
+    {
+        nvigi::PluginID m_id{};
+        nvigi::InferenceInterface m_interface{};
+        bool m_used = false;
+    };
+
+    ProxyInterface s_proxies[kMaxPlugins];
+    std::mutex s_proxiesMutex;
+
+    template <size_t N>
+    nvigi::Result CreateProxyInstance(const nvigi::NVIGIParameter* params, nvigi::InferenceInstance** instance)
+    {
+        return CreateProxy(s_proxies[N].m_id, params, instance);
+    }
+
+    template <size_t... N>
+    void InitProxies(std::index_sequence<N...>)
+    {
+        ((s_proxies[N].m_interface.createInstance = CreateProxyInstance<N>), ...);
+        for (auto& proxy : s_proxies)
+        {
+            proxy.m_interface.destroyInstance = DestroyProxy;
+            proxy.m_interface.getCapsAndRequirements = GetProxyCaps;
+        }
+    }
+
+    // Child side
+
+    class Server
+    {
+    public:
+        int Run(const std::string& name, const InferenceHost::Resolver& resolver);
+
+    private:
+        struct Hosted
+        {
+            nvigi::InferenceInterface* m_interface = nullptr;
+            nvigi::InferenceInstance* m_instance = nullptr;
+            std::unique_ptr<CreationParams> m_params;
+        };
+
+        struct Evaluation
+        {
+            Server* m_server = nullptr;
+            uint64_t m_request = 0;
+            std::atomic<bool> m_cancel = false;
+        };
+
+        struct Task
+        {
+            std::thread m_thread;
+            std::atomic<bool> m_done = false;
+        };
+
+        void Create(uint64_t request, std::vector<uint8_t> payload);
+        void Destroy(uint64_t remote);
+        void Evaluate(uint64_t request, std::vector<uint8_t> payload);
+        void Post(uint32_t type, const Writer& writer);
+        void Spawn(std::function<void()> work);
+        void Reap(bool all);
+        static nvigi::InferenceExecutionState Callback(const nvigi::InferenceExecutionContext* ctx, nvigi::InferenceExecutionState state, void* data);
+
+        InferenceHost::Resolver m_resolver;
+        SharedMemory m_memory;
+        SharedRing m_commands;
+        SharedRing m_events;
+        Control* m_control = nullptr;
+        std::mutex m_eventsMutex;
+        std::mutex m_mutex;
+        std::map<uint64_t, Hosted> m_instances;
+        uint64_t m_nextInstance = 1;
+        std::map<uint64_t, std::shared_ptr<Evaluation>> m_evaluations;
+        std::list<Task> m_tasks;
+    };
+
+    int Server::Run(const std::string& name, const InferenceHost::Resolver& resolver)
+    {
+#ifndef _WIN32
+        // Goes down with the parent, as the job object does it on Windows
+        pid_t parent = getppid();
+        prctl(PR_SET_PDEATHSIG, SIGKILL);
+        if (getppid() != parent)
+            return 1;
+#endif
+        ThreadRegistry::Register("Inference Host", ThreadRegistry::Role::Inference);
+        m_resolver = resolver;
+        if (!m_memory.Open(name, GetBlockSize()) || !AttachBlock(m_memory, name, false, m_control, m_commands, m_events))
+        {
+            LogSink::Error("Inference host: unable to open shared memory %s", name.c_str());
+            return 1;
+        }
+
+        std::atomic<bool> stop = false;
+        std::thread heartbeat([this, &stop]()
+            {
+                ThreadRegistry::Register("Inference Host Heartbeat", ThreadRegistry::Role::Inference);
+                while (!stop)
+                {
+                    m_control->m_heartbeat.fetch_add(1, std::memory_order_relaxed);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(kHeartbeatMs));
+                }
+            });
+        m_control->m_ready.store(1, std::memory_order_release);
+        LogSink::Info("Inference host: serving %s", name.c_str());
+
+        std::vector<uint8_t> payload;
+        for (;;)
+        {
+            uint32_t type = 0;
+            Reap(false);
+            if (!m_commands.Read(type, payload, 100))
+                continue;
+            if (type == kCommandShutdown)
+                break;
+
+            Reader reader(payload);
+            uint64_t id = reader.U64();
+            if (type == kCommandCreate)
+            {
+                Spawn([this, id, data = std::move(payload)]() mutable { Create(id, std::move(data)); });
+            }
+            else if (type == kCommandEvaluate)
+            {
+                Spawn([this, id, data = std::move(payload)]() mutable { Evaluate(id, std::move(data)); });
+            }
+            else if (type == kCommandDestroy)
+            {
+                Destroy(reader.U64());
+            }
+            else if (type == kCommandCancel)
+            {
+                std::scoped_lock lock(m_mutex);
+                auto it = m_evaluations.find(id);
+                if (it != m_evaluations.end())
+                    it->second->m_cancel = true;
+            }
+            payload = {};
+        }
+
+        {
+            std::scoped_lock lock(m_mutex);
+            for (auto& [id, evaluation] : m_evaluations)
+                evaluation->m_cancel = true;
+        }
+        Reap(true);
+        for (auto& [id, hosted] : m_instances)
+            hosted.m_interface->destroyInstance(hosted.m_instance);
+        m_instances.clear();
+        stop = true;
+        heartbeat.join();
+        return 0;
+    }
+
+    void Server::Create(uint64_t request, std::vector<uint8_t> payload)
+    {
+        ThreadRegistry::Register("Inference Host Create", ThreadRegistry::Role::Loading);
+        Reader reader(payload);
+        reader.U64();
+        nvigi::PluginID id{};
+        reader.Raw(&id, sizeof(id));
+        size_t size = 0;
+        const uint8_t* blob = reader.Blob(size);
+
+        nvigi::Result result = nvigi::kResultInvalidParameter;
+        uint64_t remote = 0;
+        auto params = std::make_unique<CreationParams>();
+        std::vector<uint8_t> paramBytes(blob, blob + size);
+        Reader paramReader(paramBytes);
+        nvigi::InferenceInterface* iface = nullptr;
+        if (reader.Ok() && params->Read(paramReader))
+            result = m_resolver(id, &iface);
+        nvigi::InferenceInstance* instance = nullptr;
+        if (result == nvigi::kResultOk)
+            result = params->Create(iface, &instance);
+        if (result == nvigi::kResultOk)
+        {
+            std::scoped_lock lock(m_mutex);
+            remote = m_nextInstance++;
+            m_instances[remote] = { iface, instance, std::move(params) };
+        }
+
+        Writer writer;
+        writer.U64(request);
+        writer.U32((uint32_t)result);
+        writer.U64(remote);
+        Post(kEventCreated, writer);
+    }
+
+    void Server::Destroy(uint64_t remote)
+    {
+        Hosted hosted;
+        {
+            std::scoped_lock lock(m_mutex);
+            auto it = m_instances.find(remote);
+            if (it == m_instances.end())
+                return;
+            hosted = std::move(it->second);
+            m_instances.erase(it);
+        }
+        hosted.m_interface->destroyInstance(hosted.m_instance);
+    }
+
+    void Server::Evaluate(uint64_t request, std::vector<uint8_t> payload)
+    {
+        ThreadRegistry::Register("Inference Host Evaluate", ThreadRegistry::Role::Inference);
+        Reader reader(payload);
+        reader.U64();
+        uint64_t remote = reader.U64();
+        SlotSet inputs;
+        RuntimeParams runtime;
+        bool valid = inputs.Read(reader) && runtime.Read(reader);
+
+        auto evaluation = std::make_shared<Evaluation>();
+        evaluation->m_server = this;
+        evaluation->m_request = request;
+        nvigi::InferenceInstance* instance = nullptr;
+        {
+            std::scoped_lock lock(m_mutex);
+            auto it = m_instances.find(remote);
+            if (it != m_instances.end())
+                instance = it->second.m_instance;
+            m_evaluations[request] = evaluation;
+        }
+
+        nvigi::Result result = nvigi::kResultInvalidParameter;
+        if (valid && instance)
+        {
+            nvigi::InferenceExecutionContext ctx{};
+            ctx.instance = instance;
+            ctx.callback = Callback;
+            ctx.callbackUserData = evaluation.get();
+            ctx.inputs = &inputs.m_array;
+            ctx.runtimeParameters = runtime.Get();
+            result = instance->evaluate(&ctx);
+        }
+
+        {
+            std::scoped_lock lock(m_mutex);
+            m_evaluations.erase(request);
+        }
+        Writer writer;
+        writer.U64(request);
+        writer.U32((uint32_t)result);
+        Post(kEventFinished, writer);
+    }
+
+    nvigi::InferenceExecutionState Server::Callback(const nvigi::InferenceExecutionContext* ctx, nvigi::InferenceExecutionState state, void* data)
+    {
+        auto evaluation = (Evaluation*)data;
+        Writer writer;
+        writer.U64(evaluation->m_request);
+        writer.U32((uint32_t)state);
+        if (WriteSlots(writer, ctx ? ctx->outputs : nullptr))
+            evaluation->m_server->Post(kEventOutput, writer);
+        else
+            LogSink::Warning("Inference host: dropped an output that could not be forwarded");
+        return evaluation->m_cancel ? nvigi::kInferenceExecutionStateCancel : state;
+    }
+
+    void Server::Post(uint32_t type, const Writer& writer)
+    {
+        std::scoped_lock lock(m_eventsMutex);
+        if (!m_events.Write(type, writer.m_data.data(), writer.m_data.size(), kWriteTimeoutMs))
+            LogSink::Error("Inference host: unable to send a %zu byte event", writer.m_data.size());
+    }
+
+    void Server::Spawn(std::function<void()> work)
+    {
+        m_tasks.emplace_back();
+        Task& task = m_tasks.back();
+        task.m_thread = std::thread([&task, work = std::move(work)]()
+            {
+                work();
+                task.m_done = true;
+            });
+    }
+
+    void Server::Reap(bool all)
+    {
+        for (auto it = m_tasks.begin(); it != m_tasks.end();)
+        {
+            if (all || it->m_done)
+            {
+                it->m_thread.join();
+                it = m_tasks.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+}
+
+bool InferenceHost::Start(const std::vector<std::string>& args, int stallMs)
+{
+    return Client::Get().Start(args, stallMs);
+}
+
+void InferenceHost::Stop()
+{
+    Client::Get().Stop();
+}
+
+void InferenceHost::Restart()
+{
+    Client::Get().RequestRestart();
+}
+
+bool InferenceHost::IsStarted()
+{
+    return Client::Get().IsStarted();
+}
+
+InferenceHost::Stats InferenceHost::GetStats()
+{
+    return Client::Get().GetStats();
+}
+
+nvigi::InferenceInterface* InferenceHost::Wrap(const nvigi::PluginID& id)
+{
+    std::scoped_lock lock(s_proxiesMutex);
+    static bool s_initialized = false;
+    if (!s_initialized)
+    {
+        InitProxies(std::make_index_sequence<kMaxPlugins>());
+        s_initialized = true;
+    }
+    for (auto& proxy : s_proxies)
+    {
+        if (proxy.m_used && proxy.m_id == id)
+            return &proxy.m_interface;
+    }
+    for (auto& proxy : s_proxies)
+    {
+        if (!proxy.m_used)
+        {
+            proxy.m_used = true;
+            proxy.m_id = id;
+            return &proxy.m_interface;
+        }
+    }
+    return nullptr;
+}
+
+int InferenceHost::RunServer(const std::string& name, const Resolver& resolver)
+{
+    Server server;
+    return server.Run(name, resolver);
+}
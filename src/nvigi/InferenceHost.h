@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <nvigi_struct.h>
+
+namespace nvigi
+{
+    struct InferenceInterface;
+}
+
+// Runs the GPT, ASR and TTS instances in a child process.
+//
+// The child is the same executable started with -inferenceHost <name>; it loads the plugins itself
+// and serves instance creation and evaluation over two SharedRings in a named shared-memory block,
+// commands one way and callback outputs (text and audio) the other.  In the parent, Wrap() returns an
+// InferenceInterface whose instances forward to the host, so callers use them exactly as in-process
+// ones: evaluate blocks and the callbacks run on the calling thread.
+//
+// The parent restarts the host when it exits, stops its heartbeat, or leaves an evaluate without any
+// output for the stall time.  Requests in flight fail with kResultInvalidState (outputs already
+// delivered stand), and each instance is created again in the new host on its next evaluate.
+//
+// Only the creation and runtime parameters the sample sets are forwarded.  The graphics device and
+// queues are not, so plugins that need the application's device fail to create in the host; the
+// CUDA, CPU, cloud and synthetic plugins work.
+class InferenceHost
+{
+public:
+    struct Stats
+    {
+        bool m_running = false;
+        uint32_t m_starts = 0;
+        uint32_t m_crashes = 0;
+        uint32_t m_stalls = 0;
+        uint64_t m_commands = 0;
+        uint64_t m_events = 0;
+        uint64_t m_bytes = 0;
+    };
+
+    using Resolver = std::function<nvigi::Result(nvigi::PluginID, nvigi::InferenceInterface**)>;
+
+    // Parent side.  Starts the host with the given extra arguments and waits for it to be ready.
+    static bool Start(const std::vector<std::string>& args, int stallMs);
+    static void Stop();
+    // Restarts the host as if it had failed
+    static void Restart();
+    static bool IsStarted();
+    static Stats GetStats();
+
+    // Interface whose instances live in the host; null if no more plugins can be wrapped.  Only
+    // instance creation goes through it; capabilities still come from the in-process interface.
+    static nvigi::InferenceInterface* Wrap(const nvigi::PluginID& id);
+
+    // Child side.  Serves the parent until it sends shutdown or goes away, then returns the exit code.
+    static int RunServer(const std::string& name, const Resolver& resolver);
+};
@@ -0,0 +1,223 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "LatencyHistogram.h"
+
+#include <fstream>
+#include <limits>
+
+namespace
+{
+    uint32_t HighestBit(uint64_t value)
+    {
+        uint32_t bit = 0;
+        for (uint32_t step = 32; step > 0; step >>= 1)
+        {
+            if (value >> step)
+            {
+                value >>= step;
+                bit += step;
+            }
+        }
+        return bit;
+    }
+
+    void AtomicMin(std::atomic<uint64_t>& target, uint64_t value)
+    {
+        uint64_t current = target.load(std::memory_order_relaxed);
+        while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void AtomicMax(std::atomic<uint64_t>& target, uint64_t value)
+    {
+        uint64_t current = target.load(std::memory_order_relaxed);
+        while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // Names are fixed identifiers from the app, but keep the JSON valid regardless
+    std::string EscapeJSON(const char* text)
+    {
+        std::string out;
+        for (const char* c = text; *c; c++)
+        {
+            if (*c == '"' || *c == '\\')
+                out += '\\';
+            if ((unsigned char)*c >= 0x20)
+                out += *c;
+        }
+        return out;
+    }
+}
+
+uint32_t LatencyHistogram::GetBucketIndex(uint64_t micros)
+{
+    if (micros < 2 * kSubBucketCount)
+        return (uint32_t)micros;
+
+    uint32_t shift = HighestBit(micros) - kSubBucketBits;
+    if (shift > kMaxShift)
+        return kBucketCount - 1;
+
+    return (shift + 1) * kSubBucketCount + (uint32_t)(micros >> shift) - kSubBucketCount;
+}
+
+uint64_t LatencyHistogram::GetBucketLowerBound(uint32_t index)
+{
+    if (index < 2 * kSubBucketCount)
+        return index;
+
+    uint32_t shift = index / kSubBucketCount - 1;
+    uint64_t subBucket = index % kSubBucketCount + kSubBucketCount;
+    return subBucket << shift;
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(uint32_t index)
+{
+    if (index < 2 * kSubBucketCount)
+        return index;
+
+    uint32_t shift = index / kSubBucketCount - 1;
+    return GetBucketLowerBound(index) + (uint64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t micros)
+{
+    m_buckets[GetBucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(micros, std::memory_order_relaxed);
+    AtomicMin(m_min, micros);
+    AtomicMax(m_max, micros);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+    uint64_t count = other.GetCount();
+    if (count == 0)
+        return;
+
+    for (uint32_t i = 0; i < kBucketCount; i++)
+    {
+        uint64_t bucket = other.GetBucketCount(i);
+        if (bucket)
+            m_buckets[i].fetch_add(bucket, std::memory_order_relaxed);
+    }
+    m_sum.fetch_add(other.m_sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    AtomicMin(m_min, other.m_min.load(std::memory_order_relaxed));
+    AtomicMax(m_max, other.m_max.load(std::memory_order_relaxed));
+    m_count.fetch_add(count, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Reset()
+{
+    for (auto& bucket : m_buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::GetPercentileMs(double percentile) const
+{
+    // Sum the buckets rather than trusting m_count, which a concurrent Record() may have bumped already
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < kBucketCount; i++)
+        total += GetBucketCount(i);
+    if (total == 0)
+        return 0.0;
+
+    if (percentile < 0.0)
+        percentile = 0.0;
+    if (percentile > 100.0)
+        percentile = 100.0;
+
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)total + 0.5);
+    if (rank < 1)
+        rank = 1;
+
+    uint64_t seen = 0;
+    uint64_t max = m_max.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < kBucketCount; i++)
+    {
+        seen += GetBucketCount(i);
+        if (seen >= rank)
+        {
+            uint64_t value = GetBucketUpperBound(i);
+            return (value < max ? value : max) / 1000.0;
+        }
+    }
+    return max / 1000.0;
+}
+
+LatencyHistogram::Summary LatencyHistogram::GetSummary() const
+{
+    Summary summary;
+    summary.m_count = GetCount();
+    if (summary.m_count == 0)
+        return summary;
+
+    summary.m_minMs = m_min.load(std::memory_order_relaxed) / 1000.0;
+    summary.m_meanMs = (double)m_sum.load(std::memory_order_relaxed) / (double)summary.m_count / 1000.0;
+    summary.m_p50Ms = GetPercentileMs(50.0);
+    summary.m_p90Ms = GetPercentileMs(90.0);
+    summary.m_p99Ms = GetPercentileMs(99.0);
+    summary.m_maxMs = GetMaxMs();
+    return summary;
+}
+
+bool WriteLatencyCSV(const std::string& path, const std::vector<NamedLatencyHistogram>& histograms)
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+        return false;
+
+    file << "name,count,min_ms,mean_ms,p50_ms,p90_ms,p99_ms,max_ms\n";
+    for (auto& named : histograms)
+    {
+        auto s = named.m_histogram->GetSummary();
+        file << named.m_name << "," << s.m_count << "," << s.m_minMs << "," << s.m_meanMs << ","
+            << s.m_p50Ms << "," << s.m_p90Ms << "," << s.m_p99Ms << "," << s.m_maxMs << "\n";
+    }
+    return file.good();
+}
+
+bool WriteLatencyJSON(const std::string& path, const std::vector<NamedLatencyHistogram>& histograms)
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+        return false;
+
+    file << "{\n  \"histograms\": [";
+    for (size_t h = 0; h < histograms.size(); h++)
+    {
+        auto& histogram = *histograms[h].m_histogram;
+        auto s = histogram.GetSummary();
+        file << (h ? ",\n" : "\n") << "    {\n"
+            << "      \"name\": \"" << EscapeJSON(histograms[h].m_name) << "\",\n"
+            << "      \"count\": " << s.m_count << ",\n"
+            << "      \"min_ms\": " << s.m_minMs << ",\n"
+            << "      \"mean_ms\": " << s.m_meanMs << ",\n"
+            << "      \"p50_ms\": " << s.m_p50Ms << ",\n"
+            << "      \"p90_ms\": " << s.m_p90Ms << ",\n"
+            << "      \"p99_ms\": " << s.m_p99Ms << ",\n"
+            << "      \"max_ms\": " << s.m_maxMs << ",\n"
+            << "      \"buckets_us\": [";
+        bool first = true;
+        for (uint32_t i = 0; i < LatencyHistogram::kBucketCount; i++)
+        {
+            uint64_t count = histogram.GetBucketCount(i);
+            if (!count)
+                continue;
+            file << (first ? "" : ", ") << "[" << LatencyHistogram::GetBucketLowerBound(i) << ", "
+                << LatencyHistogram::GetBucketUpperBound(i) << ", " << count << "]";
+            first = false;
+        }
+        file << "]\n    }";
+    }
+    file << "\n  ]\n}\n";
+    return file.good();
+}
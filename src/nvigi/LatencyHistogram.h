@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Latency histogram with log-linear buckets, in the style of HdrHistogram.
+//
+// Values are recorded in microseconds.  Below 64us every value has its own bucket; above that each
+// power-of-two range is split into 32 buckets, so any reported value is within ~3% of the recorded
+// one.  Record() is lock-free and may be called from any thread; readers see a consistent enough
+// view for display without stopping the writers.  Histograms with the same layout can be merged.
+class LatencyHistogram
+{
+public:
+    static constexpr uint32_t kSubBucketBits = 5;
+    static constexpr uint32_t kSubBucketCount = 1u << kSubBucketBits;
+    // Values below 2^42 us (about 50 days) are tracked; larger values land in the last bucket
+    static constexpr uint32_t kMaxShift = 36;
+    static constexpr uint32_t kBucketCount = (kMaxShift + 2) * kSubBucketCount;
+
+    struct Summary
+    {
+        uint64_t m_count = 0;
+        double m_minMs = 0.0;
+        double m_meanMs = 0.0;
+        double m_p50Ms = 0.0;
+        double m_p90Ms = 0.0;
+        double m_p99Ms = 0.0;
+        double m_maxMs = 0.0;
+    };
+
+    LatencyHistogram() { Reset(); }
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void Record(uint64_t micros);
+    void RecordMs(double ms) { Record(ms > 0.0 ? (uint64_t)(ms * 1000.0 + 0.5) : 0); }
+    void Merge(const LatencyHistogram& other);
+    void Reset();
+
+    uint64_t GetCount() const { return m_count.load(std::memory_order_relaxed); }
+    // Value at or below which the given percentage (0-100) of the samples fall, in milliseconds
+    double GetPercentileMs(double percentile) const;
+    double GetMaxMs() const { return m_max.load(std::memory_order_relaxed) / 1000.0; }
+    Summary GetSummary() const;
+
+    static uint32_t GetBucketIndex(uint64_t micros);
+    static uint64_t GetBucketLowerBound(uint32_t index);
+    static uint64_t GetBucketUpperBound(uint32_t index);
+    uint64_t GetBucketCount(uint32_t index) const { return m_buckets[index].load(std::memory_order_relaxed); }
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> m_buckets;
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_min;
+    std::atomic<uint64_t> m_max;
+};
+
+struct NamedLatencyHistogram
+{
+    const char* m_name;
+    const LatencyHistogram* m_histogram;
+};
+
+// One summary row per histogram (name, count, min, mean, p50, p90, p99, max in ms)
+bool WriteLatencyCSV(const std::string& path, const std::vector<NamedLatencyHistogram>& histograms);
+// Summaries plus the non-empty buckets as [lower us, upper us, count], so runs can be merged offline
+bool WriteLatencyJSON(const std::string& path, const std::vector<NamedLatencyHistogram>& histograms);
@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "LoadTask.h"
+#include "ThreadRegistry.h"
+
+const char* GetLoadPhaseName(LoadPhase phase)
+{
+    switch (phase)
+    {
+    case LoadPhase::Idle: return "Idle";
+    case LoadPhase::Queued: return "Waiting for previous load";
+    case LoadPhase::Uploading: return "Creating instance";
+    case LoadPhase::WarmingUp: return "Warming up";
+    case LoadPhase::Ready: return "Ready";
+    case LoadPhase::Reverted: return "Reverted to previous model";
+    case LoadPhase::Failed: return "Failed to load";
+    case LoadPhase::Cancelled: return "Cancelled";
+    }
+    return "Unknown";
+}
+
+void LoadTask::Start(Job job)
+{
+    std::unique_lock lock(m_mutex);
+    if (m_stop)
+        return;
+
+    // A newer selection wins over whatever is pending or in flight
+    m_pending = std::move(job);
+    m_cancel = m_running;
+    if (!m_running)
+        SetPhase(LoadPhase::Queued);
+
+    if (!m_thread.joinable())
+        m_thread = std::thread(&LoadTask::Run, this);
+    m_cv.notify_all();
+}
+
+void LoadTask::Cancel()
+{
+    std::unique_lock lock(m_mutex);
+    if (m_pending && !m_running)
+        SetPhase(LoadPhase::Cancelled);
+    m_pending = nullptr;
+    m_cancel = true;
+    // Wait() may only have been waiting for the dropped job
+    m_cv.notify_all();
+}
+
+void LoadTask::Wait()
+{
+    std::unique_lock lock(m_mutex);
+    m_cv.wait(lock, [this]() { return !m_running && !m_pending; });
+}
+
+void LoadTask::Shutdown()
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_stop = true;
+        m_pending = nullptr;
+        m_cancel = true;
+        m_cv.notify_all();
+    }
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+bool LoadTask::IsBusy() const
+{
+    std::unique_lock lock(m_mutex);
+    return m_running || m_pending;
+}
+
+void LoadTask::Run()
+{
+    ThreadRegistry::Register("Model Loader", ThreadRegistry::Role::Loading);
+    std::unique_lock lock(m_mutex);
+    for (;;)
+    {
+        m_cv.wait(lock, [this]() { return m_stop || m_pending; });
+        if (m_stop)
+            break;
+
+        Job job = std::move(m_pending);
+        m_pending = nullptr;
+        m_running = true;
+        m_cancel = false;
+        m_reverted = false;
+        SetPhase(LoadPhase::Queued);
+        lock.unlock();
+
+        bool ok = job(*this);
+        job = nullptr;
+
+        lock.lock();
+        m_running = false;
+        SetPhase(m_cancel ? LoadPhase::Cancelled : (ok ? (m_reverted ? LoadPhase::Reverted : LoadPhase::Ready) : LoadPhase::Failed));
+        m_cv.notify_all();
+    }
+    m_running = false;
+    m_cv.notify_all();
+}
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+enum class LoadPhase
+{
+    Idle,
+    Queued,
+    Uploading,
+    WarmingUp,
+    Ready,
+    Reverted,
+    Failed,
+    Cancelled
+};
+
+const char* GetLoadPhaseName(LoadPhase phase);
+
+// Background loader for one stage (ASR, GPT or TTS).
+//
+// Jobs run one at a time on the task's own thread.  Starting a job supersedes the previous one:
+// a running job is asked to cancel and checks IsCancelled() at its safe points, and a job that
+// has not started yet is dropped.  The job returns whether it succeeded; the final phase
+// (Ready, Reverted, Failed or Cancelled) is set by the task.
+class LoadTask
+{
+public:
+    using Job = std::function<bool(LoadTask& task)>;
+
+    LoadTask() = default;
+    ~LoadTask() { Shutdown(); }
+    LoadTask(const LoadTask&) = delete;
+    LoadTask& operator=(const LoadTask&) = delete;
+
+    void Start(Job job);
+    void Cancel();
+    // Blocks until no job is running or pending
+    void Wait();
+    // Cancels everything and stops the thread; Start() may not be called afterwards
+    void Shutdown();
+
+    bool IsBusy() const;
+    LoadPhase GetPhase() const { return m_phase; }
+
+    // For use by the job
+    bool IsCancelled() const { return m_cancel; }
+    void SetPhase(LoadPhase phase) { m_phase = phase; }
+    // The job fell back to the previous model; a success then ends as Reverted instead of Ready
+    void SetReverted() { m_reverted = true; }
+
+private:
+    void Run();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::thread m_thread;
+    Job m_pending;
+    bool m_running = false;
+    bool m_stop = false;
+
+    std::atomic<bool> m_cancel = false;
+    std::atomic<bool> m_reverted = false;
+    std::atomic<LoadPhase> m_phase = LoadPhase::Idle;
+};
@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "LogSink.h"
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+
+namespace
+{
+    std::atomic<LogSink::Sink> s_sink = nullptr;
+
+    void Write(LogSink::Severity severity, const char* format, va_list args)
+    {
+        char message[1024];
+        vsnprintf(message, sizeof(message), format, args);
+
+        if (LogSink::Sink sink = s_sink.load())
+        {
+            sink(severity, message);
+            return;
+        }
+        static const char* labels[] = { "INFO", "WARNING", "ERROR" };
+        fprintf(stderr, "%s: %s\n", labels[(int)severity], message);
+    }
+}
+
+void LogSink::Set(Sink sink)
+{
+    s_sink = sink;
+}
+
+void LogSink::Info(const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    Write(Severity::Info, format, args);
+    va_end(args);
+}
+
+void LogSink::Warning(const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    Write(Severity::Warning, format, args);
+    va_end(args);
+}
+
+void LogSink::Error(const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    Write(Severity::Error, format, args);
+    va_end(args);
+}
@@ -0,0 +1,27 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+// Logging for the parts of the sample that also build without donut, such as the synthetic backend
+// and the inference host in the standalone benchmarks.  Messages go to stderr until the app installs
+// a sink, which forwards them to donut's log.
+class LogSink
+{
+public:
+    enum class Severity
+    {
+        Info,
+        Warning,
+        Error
+    };
+
+    using Sink = void (*)(Severity severity, const char* message);
+
+    // Null goes back to stderr
+    static void Set(Sink sink);
+
+    static void Info(const char* format, ...);
+    static void Warning(const char* format, ...);
+    static void Error(const char* format, ...);
+};
@@ -0,0 +1,167 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "MemorySampler.h"
+
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr double kBytesPerMB = 1024.0 * 1024.0;
+
+    std::string QuoteCSV(const std::string& text)
+    {
+        std::string out = "\"";
+        for (char c : text)
+        {
+            if (c == '"')
+                out += '"';
+            out += c;
+        }
+        return out + "\"";
+    }
+}
+
+uint64_t MemorySampler::QueryProcessRSS()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.WorkingSetSize;
+    return 0;
+#else
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size = 0, resident = 0;
+    if (statm >> size >> resident)
+        return resident * (uint64_t)sysconf(_SC_PAGESIZE);
+    return 0;
+#endif
+}
+
+void MemorySampler::Start(VRAMQuery queryVRAM, int intervalMs)
+{
+    Stop();
+    m_queryVRAM = std::move(queryVRAM);
+    m_intervalMs = intervalMs;
+    {
+        std::scoped_lock lock(m_mutex);
+        m_samples.assign(kMaxSamples, Sample{});
+        m_sampleCount = 0;
+        m_stop = false;
+    }
+    if (intervalMs > 0)
+        m_thread = std::thread(&MemorySampler::Run, this);
+}
+
+void MemorySampler::Stop()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void MemorySampler::Run()
+{
+    std::unique_lock lock(m_mutex);
+    while (!m_stop)
+    {
+        lock.unlock();
+        Sample sample;
+        sample.m_seconds = Now();
+        sample.m_vram = m_queryVRAM ? m_queryVRAM() : 0;
+        sample.m_rss = QueryProcessRSS();
+        lock.lock();
+
+        m_samples[m_sampleCount % kMaxSamples] = sample;
+        m_sampleCount++;
+        m_cv.wait_for(lock, std::chrono::milliseconds(m_intervalMs), [this]() { return m_stop; });
+    }
+}
+
+MemorySampler::Scope MemorySampler::BeginEvent() const
+{
+    Scope scope;
+    scope.m_vram = m_queryVRAM ? m_queryVRAM() : 0;
+    scope.m_rss = QueryProcessRSS();
+    return scope;
+}
+
+void MemorySampler::EndEvent(const Scope& before, const std::string& label, uint64_t declaredMB)
+{
+    Scope after = BeginEvent();
+    Event event;
+    event.m_seconds = Now();
+    event.m_label = label;
+    event.m_declaredMB = declaredMB;
+    event.m_vramDelta = (int64_t)after.m_vram - (int64_t)before.m_vram;
+    event.m_rssDelta = (int64_t)after.m_rss - (int64_t)before.m_rss;
+
+    std::scoped_lock lock(m_mutex);
+    if (m_events.size() >= kMaxEvents)
+        m_events.erase(m_events.begin());
+    m_events.push_back(std::move(event));
+}
+
+size_t MemorySampler::CopySeriesMB(float* vram, float* rss) const
+{
+    std::scoped_lock lock(m_mutex);
+    size_t count = m_sampleCount < kMaxSamples ? m_sampleCount : kMaxSamples;
+    size_t first = m_sampleCount - count;
+    for (size_t i = 0; i < count; i++)
+    {
+        const Sample& sample = m_samples[(first + i) % kMaxSamples];
+        vram[i] = (float)(sample.m_vram / kBytesPerMB);
+        rss[i] = (float)(sample.m_rss / kBytesPerMB);
+    }
+    return count;
+}
+
+MemorySampler::Sample MemorySampler::GetLatest() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_sampleCount ? m_samples[(m_sampleCount - 1) % kMaxSamples] : Sample{};
+}
+
+std::vector<MemorySampler::Event> MemorySampler::GetEvents() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_events;
+}
+
+bool MemorySampler::WriteCSV(const std::string& basePath) const
+{
+    std::scoped_lock lock(m_mutex);
+
+    std::ofstream samples(basePath + ".csv", std::ios::trunc);
+    if (!samples)
+        return false;
+    samples << "seconds,vram_mb,rss_mb\n";
+    size_t count = m_sampleCount < kMaxSamples ? m_sampleCount : kMaxSamples;
+    for (size_t i = m_sampleCount - count; i < m_sampleCount; i++)
+    {
+        const Sample& sample = m_samples[i % kMaxSamples];
+        samples << sample.m_seconds << "," << sample.m_vram / kBytesPerMB << "," << sample.m_rss / kBytesPerMB << "\n";
+    }
+
+    std::ofstream events(basePath + ".events.csv", std::ios::trunc);
+    if (!events)
+        return false;
+    events << "seconds,event,declared_vram_mb,vram_delta_mb,rss_delta_mb\n";
+    for (auto& event : m_events)
+    {
+        events << event.m_seconds << "," << QuoteCSV(event.m_label) << "," << event.m_declaredMB << ","
+            << event.m_vramDelta / kBytesPerMB << "," << event.m_rssDelta / kBytesPerMB << "\n";
+    }
+    return samples.good() && events.good();
+}
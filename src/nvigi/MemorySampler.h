@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Background sampler of VRAM and process resident memory.
+//
+// Samples go into a fixed-size ring at a configurable interval.  Model loads and unloads are
+// recorded as events with the memory measured just before and after, so each model's actual
+// footprint can be compared against the VRAM it declares.
+class MemorySampler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    // Returns the current VRAM usage in bytes
+    using VRAMQuery = std::function<uint64_t()>;
+
+    static constexpr size_t kMaxSamples = 2048;
+    static constexpr size_t kMaxEvents = 256;
+
+    struct Sample
+    {
+        double m_seconds = 0.0;
+        uint64_t m_vram = 0;
+        uint64_t m_rss = 0;
+    };
+
+    struct Event
+    {
+        double m_seconds = 0.0;
+        std::string m_label;
+        // Declared VRAM in MB, or 0 if not known
+        uint64_t m_declaredMB = 0;
+        // Change across the event (after - before), in bytes
+        int64_t m_vramDelta = 0;
+        int64_t m_rssDelta = 0;
+    };
+
+    // Memory before a load or unload; returned by BeginEvent() and passed to EndEvent()
+    struct Scope
+    {
+        uint64_t m_vram = 0;
+        uint64_t m_rss = 0;
+    };
+
+    MemorySampler() : m_start(Clock::now()) {}
+    ~MemorySampler() { Stop(); }
+
+    // With intervalMs <= 0 no background sampling happens, but load events are still measured
+    void Start(VRAMQuery queryVRAM, int intervalMs);
+    void Stop();
+    bool IsRunning() const { return m_thread.joinable(); }
+    int GetIntervalMs() const { return m_intervalMs; }
+
+    Scope BeginEvent() const;
+    void EndEvent(const Scope& before, const std::string& label, uint64_t declaredMB);
+
+    // Copies the samples in chronological order into the caller's arrays (in MB, for plotting);
+    // returns the number copied.  The arrays must hold kMaxSamples values.
+    size_t CopySeriesMB(float* vram, float* rss) const;
+    Sample GetLatest() const;
+    std::vector<Event> GetEvents() const;
+
+    // "<path>.csv" holds the samples and "<path>.events.csv" the load/unload events
+    bool WriteCSV(const std::string& basePath) const;
+
+    static uint64_t QueryProcessRSS();
+
+private:
+    void Run();
+    double Now() const { return std::chrono::duration<double>(Clock::now() - m_start).count(); }
+
+    Clock::time_point m_start;
+    VRAMQuery m_queryVRAM;
+    int m_intervalMs = 100;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+    std::thread m_thread;
+
+    std::vector<Sample> m_samples;
+    size_t m_sampleCount = 0;
+    std::vector<Event> m_events;
+};
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "ModelCatalog.h"
+
+#include <algorithm>
+#include <assert.h>
+
+InternedString StringPool::Intern(std::string_view str)
+{
+    auto it = m_lookup.find(str);
+    if (it != m_lookup.end())
+        return it->second;
+
+    size_t needed = str.size() + 1;
+    char* dest = nullptr;
+    if (needed > kBlockSize)
+    {
+        // Oversized strings get a block of their own at the front; the back block stays open for small ones
+        m_blocks.insert(m_blocks.begin(), std::make_unique<char[]>(needed));
+        dest = m_blocks.front().get();
+    }
+    else
+    {
+        if (m_blockUsed + needed > kBlockSize)
+        {
+            m_blocks.push_back(std::make_unique<char[]>(kBlockSize));
+            m_blockUsed = 0;
+        }
+        dest = m_blocks.back().get() + m_blockUsed;
+        m_blockUsed += needed;
+    }
+
+    memcpy(dest, str.data(), str.size());
+    dest[str.size()] = '\0';
+
+    InternedString interned(dest, str.size());
+    m_lookup.emplace(interned.view(), interned);
+    return interned;
+}
+
+void ModelCatalog::Add(const ModelDesc& desc)
+{
+    assert(!m_finalized);
+
+    PluginModelInfo info{};
+    info.m_modelName = m_strings.Intern(desc.m_modelName);
+    info.m_pluginName = m_strings.Intern(desc.m_pluginName);
+    info.m_caption = m_strings.Intern(std::string(desc.m_pluginName) + " : " + std::string(desc.m_modelName));
+    info.m_guid = m_strings.Intern(desc.m_guid);
+    info.m_modelRoot = m_strings.Intern(desc.m_modelRoot);
+    info.m_url = m_strings.Intern(desc.m_url);
+    info.m_vram = desc.m_vram;
+    info.m_featureID = desc.m_featureID;
+    info.m_modelStatus = desc.m_modelStatus;
+    m_models.push_back(info);
+}
+
+void ModelCatalog::Finalize()
+{
+    if (m_finalized)
+        return;
+
+    // Same ordering the UI had with a map keyed by GUID: sorted by GUID, enumeration order within a GUID
+    std::stable_sort(m_models.begin(), m_models.end(), [](const PluginModelInfo& a, const PluginModelInfo& b)
+        {
+            return a.m_guid.view() < b.m_guid.view();
+        });
+
+    m_groups.clear();
+    for (ModelHandle i = 0; i < m_models.size(); i++)
+    {
+        if (m_groups.empty() || m_groups.back().m_guid != m_models[i].m_guid)
+            m_groups.push_back({ m_models[i].m_guid, i, 0 });
+        m_groups.back().m_count++;
+    }
+
+    m_models.shrink_to_fit();
+    m_groups.shrink_to_fit();
+    m_finalized = true;
+}
+
+ModelHandle ModelCatalog::Find(const nvigi::PluginID& featureID, std::string_view guid) const
+{
+    if (const Group* group = FindGroup(guid))
+        return Find(*group, featureID);
+    return kInvalidModel;
+}
+
+ModelHandle ModelCatalog::Find(const Group& group, const nvigi::PluginID& featureID) const
+{
+    for (ModelHandle h = group.begin(); h != group.end(); h++)
+    {
+        if (m_models[h].m_featureID == featureID)
+            return h;
+    }
+    return kInvalidModel;
+}
+
+const ModelCatalog::Group* ModelCatalog::FindGroup(std::string_view guid) const
+{
+    auto it = std::lower_bound(m_groups.begin(), m_groups.end(), guid, [](const Group& group, std::string_view value)
+        {
+            return group.m_guid.view() < value;
+        });
+    if (it == m_groups.end() || it->m_guid.view() != guid)
+        return nullptr;
+    return &*it;
+}
+
+void ModelCatalog::SetStatus(ModelHandle handle, ModelStatus status)
+{
+    if (handle < m_models.size())
+        m_models[handle].m_modelStatus = status;
+}
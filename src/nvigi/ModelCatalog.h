@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <nvigi_struct.h>
+
+enum ModelStatus {
+    AVAILABLE_LOCALLY,
+    AVAILABLE_CLOUD,
+    AVAILABLE_DOWNLOADER, // Listed in the download manifest, can be fetched by ModelDownloader
+    AVAILABLE_DOWNLOADING,
+    AVAILABLE_MANUAL_DOWNLOAD,
+    UNAVAILABLE
+};
+
+// Null-terminated string owned by a StringPool.  Copying it is copying a pointer.
+class InternedString
+{
+public:
+    InternedString() = default;
+
+    const char* c_str() const { return m_str; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    std::string_view view() const { return std::string_view(m_str, m_size); }
+    operator std::string_view() const { return view(); }
+
+    // Strings from the same pool compare by pointer; the fallback handles strings from different pools
+    bool operator==(const InternedString& other) const { return m_str == other.m_str || view() == other.view(); }
+    bool operator!=(const InternedString& other) const { return !(*this == other); }
+
+private:
+    friend class StringPool;
+    InternedString(const char* str, size_t size) : m_str(str), m_size(size) {}
+
+    const char* m_str = "";
+    size_t m_size = 0;
+};
+
+// Append-only arena of unique strings.  Returned strings stay valid for the lifetime of the pool,
+// including across moves of the pool itself.
+class StringPool
+{
+public:
+    InternedString Intern(std::string_view str);
+
+private:
+    static constexpr size_t kBlockSize = 4096;
+
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    size_t m_blockUsed = kBlockSize;
+    std::unordered_map<std::string_view, InternedString> m_lookup;
+};
+
+struct PluginModelInfo
+{
+    InternedString m_modelName;
+    InternedString m_pluginName;
+    InternedString m_caption; // plugin AND model
+    InternedString m_guid;
+    InternedString m_modelRoot;
+    InternedString m_url;
+    size_t m_vram;
+    nvigi::PluginID m_featureID;
+    ModelStatus m_modelStatus;
+};
+
+// Index of a model in a stage's ModelCatalog
+using ModelHandle = uint32_t;
+constexpr ModelHandle kInvalidModel = ~0u;
+
+// Contiguous list of every plugin/model pairing available to one stage (ASR, GPT, TTS).
+//
+// Models are added during plugin enumeration, then Finalize() sorts them by model GUID (keeping
+// plugin enumeration order within a GUID) and builds one group per GUID.  After that the catalog
+// is immutable apart from each model's status, and handles remain valid for the life of the app.
+class ModelCatalog
+{
+public:
+    struct Group
+    {
+        InternedString m_guid;
+        ModelHandle m_first = 0;
+        uint32_t m_count = 0;
+
+        ModelHandle begin() const { return m_first; }
+        ModelHandle end() const { return m_first + m_count; }
+    };
+
+    struct ModelDesc
+    {
+        std::string_view m_modelName;
+        std::string_view m_pluginName;
+        std::string_view m_guid;
+        std::string_view m_modelRoot;
+        std::string_view m_url;
+        size_t m_vram = 0;
+        nvigi::PluginID m_featureID{};
+        ModelStatus m_modelStatus = ModelStatus::UNAVAILABLE;
+    };
+
+    void Add(const ModelDesc& desc);
+    void Finalize();
+    bool IsFinalized() const { return m_finalized; }
+
+    uint32_t Size() const { return (uint32_t)m_models.size(); }
+    const PluginModelInfo& Get(ModelHandle handle) const { return m_models[handle]; }
+    const PluginModelInfo* Find(ModelHandle handle) const { return handle < m_models.size() ? &m_models[handle] : nullptr; }
+    ModelHandle Find(const nvigi::PluginID& featureID, std::string_view guid) const;
+    ModelHandle Find(const Group& group, const nvigi::PluginID& featureID) const;
+
+    // Groups are sorted by model GUID, so iterating them gives the UI a stable, sorted view
+    const std::vector<Group>& Groups() const { return m_groups; }
+    const Group* FindGroup(std::string_view guid) const;
+
+    // The only mutation allowed after Finalize(), e.g. when a download completes
+    void SetStatus(ModelHandle handle, ModelStatus status);
+
+private:
+    StringPool m_strings;
+    std::vector<PluginModelInfo> m_models;
+    std::vector<Group> m_groups;
+    bool m_finalized = false;
+};
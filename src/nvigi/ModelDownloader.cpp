@@ -0,0 +1,934 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "ModelDownloader.h"
+#include "Sha256.h"
+#include "ThreadRegistry.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+#ifdef _WIN32
+    using SocketHandle = SOCKET;
+    constexpr SocketHandle kInvalidSocket = INVALID_SOCKET;
+    void CloseSocket(SocketHandle s) { closesocket(s); }
+    bool SeekFile(FILE* file, uint64_t offset) { return _fseeki64(file, (int64_t)offset, SEEK_SET) == 0; }
+#else
+    using SocketHandle = int;
+    constexpr SocketHandle kInvalidSocket = -1;
+    void CloseSocket(SocketHandle s) { close(s); }
+    bool SeekFile(FILE* file, uint64_t offset) { return fseeko(file, (off_t)offset, SEEK_SET) == 0; }
+#endif
+
+    constexpr uint64_t kNoRange = ~0ull;
+    constexpr uint64_t kMinChunkSize = 8ull * 1024 * 1024;
+    // Also the most a state file may list
+    constexpr uint64_t kMaxChunks = 256;
+    constexpr size_t kIOBufferSize = 256 * 1024;
+    constexpr int kMaxAttempts = 4;
+    constexpr auto kStallTimeout = std::chrono::seconds(30);
+    constexpr auto kStateSaveInterval = std::chrono::seconds(1);
+
+    // Decimal digits only, as in a Content-Length header or a manifest size
+    bool ParseSize(const std::string& text, uint64_t& value)
+    {
+        if (text.empty() || !isdigit((unsigned char)text[0]))
+            return false;
+        char* end = nullptr;
+        errno = 0;
+        unsigned long long parsed = strtoull(text.c_str(), &end, 10);
+        if (errno == ERANGE || *end != '\0')
+            return false;
+        value = parsed;
+        return true;
+    }
+
+    void InitSockets()
+    {
+#ifdef _WIN32
+        static std::once_flag s_once;
+        std::call_once(s_once, []()
+            {
+                WSADATA data{};
+                WSAStartup(MAKEWORD(2, 2), &data);
+            });
+#endif
+    }
+
+    bool IEquals(std::string_view a, std::string_view b)
+    {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y)
+            {
+                return tolower((unsigned char)x) == tolower((unsigned char)y);
+            });
+    }
+
+    struct Url
+    {
+        std::string m_host;
+        std::string m_port = "80";
+        std::string m_path = "/";
+    };
+
+    bool ParseUrl(const std::string& url, Url& out, std::string& error)
+    {
+        const std::string scheme = "http://";
+        if (url.compare(0, scheme.size(), scheme) != 0)
+        {
+            error = "Only http:// URLs are supported: " + url;
+            return false;
+        }
+
+        size_t hostStart = scheme.size();
+        size_t pathStart = url.find('/', hostStart);
+        std::string hostPort = url.substr(hostStart, pathStart == std::string::npos ? std::string::npos : pathStart - hostStart);
+        if (pathStart != std::string::npos)
+            out.m_path = url.substr(pathStart);
+
+        size_t colon = hostPort.rfind(':');
+        if (colon != std::string::npos && hostPort.find(']', colon) == std::string::npos)
+        {
+            out.m_host = hostPort.substr(0, colon);
+            out.m_port = hostPort.substr(colon + 1);
+        }
+        else
+        {
+            out.m_host = hostPort;
+        }
+
+        if (out.m_host.size() > 2 && out.m_host.front() == '[' && out.m_host.back() == ']')
+            out.m_host = out.m_host.substr(1, out.m_host.size() - 2);
+
+        if (out.m_host.empty())
+        {
+            error = "Malformed URL: " + url;
+            return false;
+        }
+        return true;
+    }
+
+    // One HTTP/1.1 request on its own connection ("Connection: close"), with the body streamed by Read()
+    class HttpStream
+    {
+    public:
+        ~HttpStream() { Close(); }
+
+        bool Open(const std::string& method, const std::string& url, uint64_t rangeBegin, uint64_t rangeEnd,
+            const std::atomic<bool>& cancel, std::string& error)
+        {
+            m_url = url;
+            for (int redirects = 0; redirects < 5; redirects++)
+            {
+                if (!OpenOnce(method, m_url, rangeBegin, rangeEnd, cancel, error))
+                    return false;
+                if (m_status < 300 || m_status >= 400 || m_location.empty())
+                    return true;
+
+                // Follow redirects, resolving host-relative locations against the current URL
+                Close();
+                if (m_location[0] == '/')
+                {
+                    size_t pathStart = m_url.find('/', std::string("http://").size());
+                    m_url = m_url.substr(0, pathStart) + m_location;
+                }
+                else
+                {
+                    m_url = m_location;
+                }
+            }
+            error = "Too many redirects: " + url;
+            return false;
+        }
+
+        // Bytes read, 0 at the end of the body, -1 on error or cancellation
+        int64_t Read(void* buffer, size_t size, const std::atomic<bool>& cancel)
+        {
+            if (m_remaining == 0)
+                return 0;
+            size = (size_t)std::min<uint64_t>(size, m_remaining);
+
+            if (!m_pending.empty())
+            {
+                size_t count = std::min(size, m_pending.size());
+                memcpy(buffer, m_pending.data(), count);
+                m_pending.erase(0, count);
+                m_remaining -= count;
+                return (int64_t)count;
+            }
+
+            if (!WaitReadable(cancel))
+                return -1;
+            int received = recv(m_socket, (char*)buffer, (int)std::min<size_t>(size, 1 << 30), 0);
+            if (received <= 0)
+                return -1;
+            m_remaining -= received;
+            return received;
+        }
+
+        void Close()
+        {
+            if (m_socket != kInvalidSocket)
+                CloseSocket(m_socket);
+            m_socket = kInvalidSocket;
+        }
+
+        int m_status = 0;
+        std::string m_url;
+        std::string m_location;
+        int64_t m_contentLength = -1;
+        bool m_acceptRanges = false;
+        uint64_t m_rangeStart = 0;
+
+    private:
+        bool WaitReadable(const std::atomic<bool>& cancel)
+        {
+            auto start = std::chrono::steady_clock::now();
+            while (!cancel)
+            {
+                fd_set readSet;
+                FD_ZERO(&readSet);
+                FD_SET(m_socket, &readSet);
+                timeval timeout{ 0, 250 * 1000 };
+                int ready = select((int)m_socket + 1, &readSet, nullptr, nullptr, &timeout);
+                if (ready > 0)
+                    return true;
+                if (ready < 0 || std::chrono::steady_clock::now() - start > kStallTimeout)
+                    return false;
+            }
+            return false;
+        }
+
+        bool OpenOnce(const std::string& method, const std::string& url, uint64_t rangeBegin, uint64_t rangeEnd,
+            const std::atomic<bool>& cancel, std::string& error)
+        {
+            m_status = 0;
+            m_location.clear();
+            m_contentLength = -1;
+            m_acceptRanges = false;
+            m_rangeStart = 0;
+            m_pending.clear();
+
+            Url parsed;
+            if (!ParseUrl(url, parsed, error))
+                return false;
+
+            InitSockets();
+            addrinfo hints{};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            addrinfo* addresses = nullptr;
+            if (getaddrinfo(parsed.m_host.c_str(), parsed.m_port.c_str(), &hints, &addresses) != 0)
+            {
+                error = "Unable to resolve " + parsed.m_host;
+                return false;
+            }
+            for (addrinfo* addr = addresses; addr && m_socket == kInvalidSocket; addr = addr->ai_next)
+            {
+                m_socket = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+                if (m_socket != kInvalidSocket && connect(m_socket, addr->ai_addr, (int)addr->ai_addrlen) != 0)
+                    Close();
+            }
+            freeaddrinfo(addresses);
+            if (m_socket == kInvalidSocket)
+            {
+                error = "Unable to connect to " + parsed.m_host + ":" + parsed.m_port;
+                return false;
+            }
+
+            std::string request = method + " " + parsed.m_path + " HTTP/1.1\r\n";
+            request += "Host: " + parsed.m_host + (parsed.m_port == "80" ? "" : ":" + parsed.m_port) + "\r\n";
+            request += "User-Agent: NVIGISample\r\nAccept-Encoding: identity\r\nConnection: close\r\n";
+            if (rangeBegin != kNoRange)
+                request += "Range: bytes=" + std::to_string(rangeBegin) + "-" + std::to_string(rangeEnd) + "\r\n";
+            request += "\r\n";
+            for (size_t sent = 0; sent < request.size();)
+            {
+                int count = send(m_socket, request.data() + sent, (int)(request.size() - sent), 0);
+                if (count <= 0)
+                {
+                    error = "Connection lost sending request to " + parsed.m_host;
+                    return false;
+                }
+                sent += count;
+            }
+
+            // Read until the end of the headers; anything past them is the start of the body
+            std::string headers;
+            size_t headerEnd = std::string::npos;
+            char buffer[4096];
+            while (headerEnd == std::string::npos)
+            {
+                if (headers.size() > 64 * 1024 || !WaitReadable(cancel))
+                {
+                    error = cancel ? "Cancelled" : "No response from " + parsed.m_host;
+                    return false;
+                }
+                int received = recv(m_socket, buffer, sizeof(buffer), 0);
+                if (received <= 0)
+                {
+                    error = "Connection closed by " + parsed.m_host;
+                    return false;
+                }
+                headers.append(buffer, received);
+                headerEnd = headers.find("\r\n\r\n");
+            }
+            m_pending = headers.substr(headerEnd + 4);
+            headers.resize(headerEnd);
+
+            std::istringstream lines(headers);
+            std::string line;
+            std::getline(lines, line);
+            if (sscanf(line.c_str(), "HTTP/%*d.%*d %d", &m_status) != 1)
+            {
+                error = "Malformed HTTP response from " + parsed.m_host;
+                return false;
+            }
+
+            bool chunked = false;
+            while (std::getline(lines, line))
+            {
+                if (!line.empty() && line.back() == '\r')
+                    line.pop_back();
+                size_t colon = line.find(':');
+                if (colon == std::string::npos)
+                    continue;
+                std::string_view name(line.data(), colon);
+                size_t valueStart = line.find_first_not_of(' ', colon + 1);
+                std::string value = (valueStart == std::string::npos) ? "" : line.substr(valueStart);
+
+                if (IEquals(name, "Content-Length"))
+                {
+                    uint64_t length = 0;
+                    if (!ParseSize(value, length) || length > (uint64_t)INT64_MAX)
+                    {
+                        error = "Malformed Content-Length '" + value + "' from " + url;
+                        return false;
+                    }
+                    m_contentLength = (int64_t)length;
+                }
+                else if (IEquals(name, "Accept-Ranges"))
+                    m_acceptRanges = value.find("bytes") != std::string::npos;
+                else if (IEquals(name, "Content-Range"))
+                    sscanf(value.c_str(), "bytes %llu", (unsigned long long*)&m_rangeStart);
+                else if (IEquals(name, "Location"))
+                    m_location = value;
+                else if (IEquals(name, "Transfer-Encoding"))
+                    chunked = value.find("chunked") != std::string::npos;
+            }
+
+            if (method == "HEAD")
+            {
+                m_remaining = 0;
+            }
+            else if (chunked || m_contentLength < 0)
+            {
+                if (m_status == 200 || m_status == 206)
+                {
+                    error = "Server response has no Content-Length: " + url;
+                    return false;
+                }
+                m_remaining = 0;
+            }
+            else
+            {
+                m_remaining = (uint64_t)m_contentLength;
+            }
+            return true;
+        }
+
+        SocketHandle m_socket = kInvalidSocket;
+        std::string m_pending;
+        uint64_t m_remaining = 0;
+    };
+
+    struct Chunk
+    {
+        uint64_t m_begin = 0;
+        uint64_t m_end = 0; // exclusive
+        uint64_t m_received = 0;
+    };
+
+    // Shared state for the connections downloading one file
+    struct Transfer
+    {
+        std::string m_url;
+        std::string m_partPath;
+        std::string m_statePath;
+        uint64_t m_size = 0;
+        bool m_ranged = false;
+
+        std::mutex m_mutex;
+        std::vector<Chunk> m_chunks;
+
+        // The hash always covers [0, m_hashed).  Whoever sets m_hashing owns the hasher until it clears it.
+        Sha256 m_hasher;
+        uint64_t m_hashed = 0;
+        bool m_hashing = false;
+        FILE* m_reader = nullptr;
+        std::vector<uint8_t> m_hashBuffer;
+
+        // Bytes on disk starting at offset that have not been hashed yet; must hold m_mutex
+        uint64_t ContiguousAt(uint64_t offset) const
+        {
+            for (auto& chunk : m_chunks)
+            {
+                if (offset >= chunk.m_begin && offset < chunk.m_end)
+                    return chunk.m_begin + chunk.m_received - offset;
+            }
+            return 0;
+        }
+
+        bool LoadState()
+        {
+            std::ifstream file(m_statePath);
+            std::string magic, url;
+            uint64_t size = 0;
+            size_t count = 0;
+            if (!(file >> magic) || magic != "NVIGI_DOWNLOAD_1" || !(file >> url >> size >> count) ||
+                url != m_url || size != m_size || count == 0 || count > kMaxChunks)
+                return false;
+
+            std::vector<Chunk> chunks(count);
+            for (auto& chunk : chunks)
+            {
+                if (!(file >> chunk.m_begin >> chunk.m_end >> chunk.m_received) ||
+                    chunk.m_end > size || chunk.m_begin + chunk.m_received > chunk.m_end)
+                    return false;
+            }
+
+            std::error_code ec;
+            if (fs::file_size(m_partPath, ec) != size || ec)
+                return false;
+
+            m_chunks = std::move(chunks);
+            return true;
+        }
+
+        void SaveState()
+        {
+            if (!m_ranged)
+                return;
+
+            std::ostringstream state;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                state << "NVIGI_DOWNLOAD_1\n" << m_url << "\n" << m_size << "\n" << m_chunks.size() << "\n";
+                for (auto& chunk : m_chunks)
+                    state << chunk.m_begin << " " << chunk.m_end << " " << chunk.m_received << "\n";
+            }
+
+            std::string tempPath = m_statePath + ".tmp";
+            {
+                std::ofstream file(tempPath, std::ios::trunc);
+                file << state.str();
+                if (!file.good())
+                    return;
+            }
+            std::error_code ec;
+            fs::rename(tempPath, m_statePath, ec);
+        }
+
+        // Hashes whatever has landed on disk right after the hashed prefix, reading it back from the part file
+        void CatchUpHash()
+        {
+            for (;;)
+            {
+                uint64_t from = 0;
+                size_t count = 0;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (m_hashing)
+                        return;
+                    count = (size_t)std::min<uint64_t>(ContiguousAt(m_hashed), m_hashBuffer.size());
+                    if (count == 0)
+                        return;
+                    m_hashing = true;
+                    from = m_hashed;
+                }
+
+                bool ok = SeekFile(m_reader, from) && fread(m_hashBuffer.data(), 1, count, m_reader) == count;
+                if (ok)
+                    m_hasher.Update(m_hashBuffer.data(), count);
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (ok)
+                    m_hashed += count;
+                m_hashing = false;
+                if (!ok)
+                    return;
+            }
+        }
+
+        // Records data written at offset; if it extends the hashed prefix it is hashed straight from memory
+        void OnWritten(Chunk& chunk, uint64_t offset, const uint8_t* data, size_t size)
+        {
+            bool hashInline = false;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                chunk.m_received += size;
+                if (!m_hashing && m_hashed == offset)
+                {
+                    m_hashing = true;
+                    hashInline = true;
+                }
+            }
+
+            if (hashInline)
+            {
+                m_hasher.Update(data, size);
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_hashed += size;
+                m_hashing = false;
+            }
+
+            CatchUpHash();
+        }
+    };
+
+    bool DownloadChunk(Transfer& transfer, Chunk& chunk, std::atomic<uint64_t>& jobReceived,
+        const std::atomic<bool>& cancel, std::string& error)
+    {
+        FILE* out = fopen(transfer.m_partPath.c_str(), "r+b");
+        if (!out)
+        {
+            error = "Unable to open " + transfer.m_partPath;
+            return false;
+        }
+
+        std::vector<uint8_t> buffer(kIOBufferSize);
+        bool done = false;
+        for (int attempt = 0; attempt < kMaxAttempts && !done && !cancel; attempt++)
+        {
+            if (attempt > 0)
+                std::this_thread::sleep_for(std::chrono::seconds(attempt));
+
+            uint64_t from = 0;
+            {
+                std::unique_lock<std::mutex> lock(transfer.m_mutex);
+                if (!transfer.m_ranged && chunk.m_received)
+                {
+                    while (transfer.m_hashing)
+                    {
+                        lock.unlock();
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                        lock.lock();
+                    }
+
+                    // No ranges means no resume: start the single stream over, hash included
+                    jobReceived -= chunk.m_received;
+                    chunk.m_received = 0;
+                    transfer.m_hasher.Reset();
+                    transfer.m_hashed = 0;
+                }
+                from = chunk.m_begin + chunk.m_received;
+            }
+            if (from == chunk.m_end)
+            {
+                done = true;
+                break;
+            }
+
+            HttpStream stream;
+            if (!stream.Open("GET", transfer.m_url, transfer.m_ranged ? from : kNoRange, chunk.m_end - 1, cancel, error))
+                continue;
+            if (transfer.m_ranged ? (stream.m_status != 206 || stream.m_rangeStart != from) : stream.m_status != 200)
+            {
+                error = "Unexpected HTTP status " + std::to_string(stream.m_status) + " for " + transfer.m_url;
+                continue;
+            }
+            if (!SeekFile(out, from))
+            {
+                error = "Unable to seek in " + transfer.m_partPath;
+                break;
+            }
+
+            uint64_t offset = from;
+            while (offset < chunk.m_end)
+            {
+                int64_t count = stream.Read(buffer.data(), (size_t)std::min<uint64_t>(buffer.size(), chunk.m_end - offset), cancel);
+                if (count <= 0)
+                    break;
+                // Flush before publishing progress, so the state file and the hash read-back never run ahead of the data
+                if (fwrite(buffer.data(), 1, (size_t)count, out) != (size_t)count || fflush(out) != 0)
+                {
+                    error = "Unable to write " + transfer.m_partPath;
+                    fclose(out);
+                    return false;
+                }
+                transfer.OnWritten(chunk, offset, buffer.data(), (size_t)count);
+                jobReceived += count;
+                offset += count;
+            }
+
+            done = offset == chunk.m_end;
+            if (!done)
+                error = cancel ? "Cancelled" : "Connection lost downloading " + transfer.m_url;
+        }
+
+        fclose(out);
+        return done;
+    }
+}
+
+bool ModelDownloader::LoadManifest(const std::string& path, const std::string& modelRoot)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+        return false;
+
+    m_manifest.clear();
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream fields(line);
+        std::string guid, url, dest, size, sha256;
+        if (!(fields >> guid >> url >> dest))
+            continue;
+        fields >> size >> sha256;
+
+        File entry;
+        entry.m_url = url;
+        entry.m_path = (fs::path(modelRoot) / fs::path(dest)).lexically_normal().string();
+        if (!size.empty() && size != "-" && !ParseSize(size, entry.m_size))
+            entry.m_error = "Malformed size '" + size + "' in the manifest entry for " + url;
+        entry.m_sha256 = (sha256 == "-") ? "" : sha256;
+        m_manifest.push_back({ guid, entry });
+    }
+    return true;
+}
+
+bool ModelDownloader::HasModel(std::string_view guid) const
+{
+    for (auto& entry : m_manifest)
+    {
+        if (IEquals(entry.first, guid))
+            return true;
+    }
+    return false;
+}
+
+bool ModelDownloader::Start(std::string_view guid, std::string_view name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& job : m_jobs)
+    {
+        if (IEquals(job->m_guid, guid))
+            return false;
+    }
+
+    auto job = std::make_unique<Job>();
+    job->m_guid = guid;
+    job->m_name = name;
+    for (auto& entry : m_manifest)
+    {
+        if (IEquals(entry.first, guid))
+        {
+            job->m_files.push_back(entry.second);
+            job->m_total += entry.second.m_size;
+        }
+    }
+    if (job->m_files.empty())
+        return false;
+
+    Job& ref = *job;
+    m_jobs.push_back(std::move(job));
+    ref.m_thread = std::thread(&ModelDownloader::RunJob, this, std::ref(ref));
+    return true;
+}
+
+void ModelDownloader::Cancel(std::string_view guid)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& job : m_jobs)
+    {
+        if (IEquals(job->m_guid, guid))
+            job->m_cancel = true;
+    }
+}
+
+void ModelDownloader::Shutdown()
+{
+    std::list<std::unique_ptr<Job>> jobs;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& job : m_jobs)
+            job->m_cancel = true;
+        jobs.swap(m_jobs);
+        m_finished = {};
+    }
+
+    for (auto& job : jobs)
+    {
+        if (job->m_thread.joinable())
+            job->m_thread.join();
+    }
+}
+
+size_t ModelDownloader::GetActiveCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::count_if(m_jobs.begin(), m_jobs.end(), [](const std::unique_ptr<Job>& job)
+        {
+            return job->m_state == State::Queued || job->m_state == State::Downloading;
+        });
+}
+
+bool ModelDownloader::GetActive(size_t index, Progress& progress) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& job : m_jobs)
+    {
+        State state = job->m_state;
+        if (state != State::Queued && state != State::Downloading)
+            continue;
+        if (index-- == 0)
+        {
+            progress.m_guid = job->m_guid;
+            progress.m_name = job->m_name;
+            progress.m_received = job->m_received;
+            progress.m_total = job->m_total;
+            progress.m_state = state;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ModelDownloader::TakeFinished(std::string& guid, std::string& error)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_finished.empty())
+        return false;
+
+    Job* job = m_finished.front();
+    m_finished.pop();
+    job->m_thread.join();
+
+    guid = job->m_guid;
+    error = (job->m_state == State::Done) ? "" : (job->m_error.empty() ? "Cancelled" : job->m_error);
+    m_jobs.remove_if([job](const std::unique_ptr<Job>& j) { return j.get() == job; });
+    return true;
+}
+
+void ModelDownloader::RunJob(Job& job)
+{
+    ThreadRegistry::Register("Model Download", ThreadRegistry::Role::Loading);
+    job.m_state = State::Downloading;
+
+    std::string error;
+    bool ok = true;
+    for (auto& file : job.m_files)
+    {
+        ok = DownloadFile(job, file, error);
+        if (!ok)
+            break;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    job.m_error = error;
+    job.m_state = ok ? State::Done : (job.m_cancel ? State::Cancelled : State::Failed);
+    m_finished.push(&job);
+}
+
+bool ModelDownloader::DownloadFile(Job& job, const File& file, std::string& error)
+{
+    if (!file.m_error.empty())
+    {
+        error = file.m_error;
+        return false;
+    }
+
+    std::error_code ec;
+    if (fs::exists(file.m_path, ec))
+    {
+        // Left complete by an earlier run (files only get their final name once complete and, if pinned, verified)
+        uint64_t size = fs::file_size(file.m_path, ec);
+        if (!ec && (file.m_size == 0 || size == file.m_size))
+        {
+            job.m_received += size;
+            if (file.m_size == 0)
+                job.m_total += size;
+            return true;
+        }
+    }
+    fs::create_directories(fs::path(file.m_path).parent_path(), ec);
+
+    HttpStream probe;
+    if (!probe.Open("HEAD", file.m_url, kNoRange, 0, job.m_cancel, error))
+        return false;
+    if (probe.m_status != 200 || probe.m_contentLength < 0)
+    {
+        error = "Unable to query " + file.m_url + " (HTTP " + std::to_string(probe.m_status) + ")";
+        return false;
+    }
+    if (file.m_size && (uint64_t)probe.m_contentLength != file.m_size)
+    {
+        error = "Size of " + file.m_url + " does not match the manifest";
+        return false;
+    }
+    if (!file.m_size)
+        job.m_total += probe.m_contentLength;
+    probe.Close();
+
+    // Nothing to transfer, but the manifest may still pin the digest of the empty file
+    if (probe.m_contentLength == 0)
+    {
+        std::string digest = Sha256().FinishHex();
+        if (!file.m_sha256.empty() && !IEquals(digest, file.m_sha256))
+        {
+            error = "SHA-256 mismatch for " + file.m_url + " (got " + digest + ")";
+            return false;
+        }
+        std::ofstream create(file.m_path, std::ios::binary | std::ios::trunc);
+        if (!create)
+        {
+            error = "Unable to create " + file.m_path;
+            return false;
+        }
+        return true;
+    }
+
+    Transfer transfer;
+    transfer.m_url = probe.m_url;
+    transfer.m_partPath = file.m_path + ".part";
+    transfer.m_statePath = transfer.m_partPath + ".state";
+    transfer.m_size = (uint64_t)probe.m_contentLength;
+    transfer.m_ranged = probe.m_acceptRanges;
+    transfer.m_hashBuffer.resize(kIOBufferSize);
+
+    if (!transfer.m_ranged || !transfer.LoadState())
+    {
+        // Fresh start: lay out one chunk per connection over a preallocated part file
+        uint64_t connections = transfer.m_ranged ? std::max<uint64_t>(1, std::min<uint64_t>({ (uint64_t)m_connections, transfer.m_size / kMinChunkSize, kMaxChunks })) : 1;
+        uint64_t chunkSize = (transfer.m_size + connections - 1) / connections;
+        transfer.m_chunks.clear();
+        for (uint64_t begin = 0; begin < transfer.m_size; begin += chunkSize)
+            transfer.m_chunks.push_back({ begin, std::min(begin + chunkSize, transfer.m_size), 0 });
+
+        {
+            std::ofstream create(transfer.m_partPath, std::ios::binary | std::ios::trunc);
+        }
+        fs::resize_file(transfer.m_partPath, transfer.m_size, ec);
+        if (ec)
+        {
+            error = "Unable to create " + transfer.m_partPath;
+            return false;
+        }
+        transfer.SaveState();
+    }
+
+    for (auto& chunk : transfer.m_chunks)
+        job.m_received += chunk.m_received;
+
+    transfer.m_reader = fopen(transfer.m_partPath.c_str(), "rb");
+    if (!transfer.m_reader)
+    {
+        error = "Unable to read " + transfer.m_partPath;
+        return false;
+    }
+
+    std::vector<std::string> errors(transfer.m_chunks.size());
+    std::atomic<size_t> running = transfer.m_chunks.size();
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < transfer.m_chunks.size(); i++)
+    {
+        threads.emplace_back([&, i]()
+            {
+                DownloadChunk(transfer, transfer.m_chunks[i], job.m_received, job.m_cancel, errors[i]);
+                running--;
+            });
+    }
+
+    // A resumed download still has to hash what is already on disk; do it here while the connections run
+    transfer.CatchUpHash();
+
+    auto lastSave = std::chrono::steady_clock::now();
+    while (running)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (std::chrono::steady_clock::now() - lastSave > kStateSaveInterval)
+        {
+            transfer.SaveState();
+            lastSave = std::chrono::steady_clock::now();
+        }
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    transfer.CatchUpHash();
+    fclose(transfer.m_reader);
+    transfer.m_reader = nullptr;
+
+    bool complete = std::all_of(transfer.m_chunks.begin(), transfer.m_chunks.end(), [](const Chunk& chunk)
+        {
+            return chunk.m_begin + chunk.m_received == chunk.m_end;
+        });
+    if (!complete)
+    {
+        transfer.SaveState();
+        for (auto& chunkError : errors)
+        {
+            if (!chunkError.empty())
+            {
+                error = chunkError;
+                break;
+            }
+        }
+        if (error.empty())
+            error = job.m_cancel ? "Cancelled" : "Incomplete download of " + file.m_url;
+        return false;
+    }
+
+    if (transfer.m_hashed != transfer.m_size)
+    {
+        error = "Unable to hash " + transfer.m_partPath;
+        return false;
+    }
+
+    std::string digest = transfer.m_hasher.FinishHex();
+    if (!file.m_sha256.empty() && !IEquals(digest, file.m_sha256))
+    {
+        // Corrupt data is not worth resuming
+        fs::remove(transfer.m_partPath, ec);
+        fs::remove(transfer.m_statePath, ec);
+        error = "SHA-256 mismatch for " + file.m_url + " (got " + digest + ")";
+        return false;
+    }
+
+    fs::rename(transfer.m_partPath, file.m_path, ec);
+    if (ec)
+    {
+        error = "Unable to rename " + transfer.m_partPath;
+        return false;
+    }
+    fs::remove(transfer.m_statePath, ec);
+    return true;
+}
@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Background downloader for models that plugins report as requiring a download.
+//
+// The files for each model GUID come from a plain-text manifest, one file per line:
+//
+//     <model GUID> <http URL> <destination path relative to the models root> <size in bytes> <sha256 hex>
+//
+// Lines starting with '#' are ignored, and size/sha256 may be given as '-' when unknown.
+// Each file is fetched over HTTP/1.1 with several parallel Range requests into "<dest>.part".
+// Progress is recorded in "<dest>.part.state" so an interrupted download resumes where it left
+// off.  The SHA-256 is computed while the data arrives, and the file is only renamed to its final
+// name once the digest matches.  Servers that ignore Range requests are handled with a single
+// connection (without resume).  HTTPS is not supported.
+class ModelDownloader
+{
+public:
+    enum class State
+    {
+        Queued,
+        Downloading,
+        Done,
+        Failed,
+        Cancelled
+    };
+
+    struct Progress
+    {
+        std::string_view m_guid;
+        std::string_view m_name;
+        uint64_t m_received = 0;
+        uint64_t m_total = 0;
+        State m_state = State::Queued;
+    };
+
+    ~ModelDownloader() { Shutdown(); }
+
+    bool LoadManifest(const std::string& path, const std::string& modelRoot);
+    bool HasModel(std::string_view guid) const;
+    void SetConnections(int connections) { m_connections = connections < 1 ? 1 : connections; }
+
+    // Starts downloading every manifest file for the GUID on a background thread
+    bool Start(std::string_view guid, std::string_view name);
+    void Cancel(std::string_view guid);
+    // Cancels all downloads and waits for them; partial files are kept for the next run
+    void Shutdown();
+
+    // Only jobs that are queued or downloading are listed; the views are valid until the next TakeFinished()
+    size_t GetActiveCount() const;
+    bool GetActive(size_t index, Progress& progress) const;
+
+    // Pops one finished download; error is empty on success.  To be polled from the main thread
+    bool TakeFinished(std::string& guid, std::string& error);
+
+private:
+    struct File
+    {
+        std::string m_url;
+        std::string m_path;
+        uint64_t m_size = 0;
+        std::string m_sha256;
+        // Set if the manifest entry could not be read; the download of the file fails with it
+        std::string m_error;
+    };
+
+    struct Job
+    {
+        std::string m_guid;
+        std::string m_name;
+        std::vector<File> m_files;
+        std::atomic<uint64_t> m_received = 0;
+        std::atomic<uint64_t> m_total = 0;
+        std::atomic<State> m_state = State::Queued;
+        std::atomic<bool> m_cancel = false;
+        std::string m_error;
+        std::thread m_thread;
+    };
+
+    void RunJob(Job& job);
+    bool DownloadFile(Job& job, const File& file, std::string& error);
+
+    std::vector<std::pair<std::string, File>> m_manifest;
+    int m_connections = 4;
+
+    mutable std::mutex m_mutex;
+    std::list<std::unique_ptr<Job>> m_jobs;
+    std::queue<Job*> m_finished;
+};
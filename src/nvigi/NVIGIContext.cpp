@@ -4,6 +4,8 @@
 #define _SILENCE_CXX17_CODECVT_HEADER_DEPRECATION_WARNING 1
 
 #include "NVIGIContext.h"
+#include "AllocationCounter.h"
+#include "PluginCapsCache.h"
 
 #include <donut/core/math/math.h>
 #include <donut/core/math/basics.h>
@@ -32,10 +34,11 @@
 
 #include <assert.h>
 #include <atomic>
+#include <cfloat>
 #include <codecvt>
 #include <filesystem>
 #include <mutex>
-#include <regex>
+#include <random>
 #include <string>
 #include <thread>
 #include <memory>
@@ -54,18 +57,6 @@ extern "C" __declspec(dllexport) const char* D3D12SDKPath = ".\\D3D12\\";
 
 namespace fs = std::filesystem;
 
-struct Message {
-    enum class Type {
-        Question,
-        Answer
-    } type;
-    std::string text;
-};
-
-static std::vector<Message> messages =
-{
-};
-
 constexpr ImU32 TITLE_COL = IM_COL32(0, 255, 0, 255);
 
 // NVIGI core functions
@@ -117,6 +108,17 @@ static std::wstring GetNVIGICoreDllPath() {
     return basePath;
 }
 
+static const char* GetSchedulingModeName(uint32_t mode)
+{
+    switch (mode)
+    {
+    case nvigi::SchedulingMode::kPrioritizeGraphics: return "Prioritize Graphics";
+    case nvigi::SchedulingMode::kPrioritizeCompute: return "Prioritize Inference";
+    case nvigi::SchedulingMode::kBalance: return "Balanced";
+    default: return "Unknown";
+    }
+}
+
 std::vector<std::string> GetPossibleTargetVoices(const std::wstring& directory) {
     std::vector<std::string> binFiles;
     for (const auto& entry : fs::directory_iterator(directory)) {
@@ -138,11 +140,42 @@ NVIGIContext& NVIGIContext::Get() {
 
 void NVIGIContext::PresentEnd(donut::app::DeviceManager& manager)
 {
-    Get().FramerateLimit();
+    AllocationCounter::EndFrame();
+    Trace::EndFrame();
+
+    // Present-to-present interval, including any time spent in the framerate limiter
+    auto& nvigi = Get();
+    if (nvigi.m_frameTimer.running)
+    {
+        nvigi.m_frameTimer.Stop();
+        double frameMs = nvigi.m_frameTimer.GetElapsedMiliseconds();
+        nvigi.m_frameLatency.RecordMs(frameMs);
+        if (nvigi.m_sweep.IsActive())
+            nvigi.m_sweep.RecordFrame(frameMs);
+
+        nvigi.m_schedulingController.SetFrameTargetMs(nvigi.GetFrameTargetMs());
+        uint32_t mode = nvigi.m_schedulingMode;
+        if (nvigi.m_schedulingController.Update(frameMs, mode))
+        {
+            nvigi.m_schedulingMode = mode;
+            nvigi.m_sessionRecorder.RecordSchedulingMode(mode);
+        }
+    }
+    nvigi.m_frameTimer.Start();
+
+    // The limiter's sleep is slack that inference can use
+    nvigi.m_frameCoordinator.EndFrame();
+    nvigi.m_frameCoordinator.SetBudgetMs(nvigi.GetFrameTargetMs());
+    nvigi.FramerateLimit();
+    nvigi.m_frameCoordinator.BeginFrame();
 }
 
 bool NVIGIContext::CheckPluginCompat(nvigi::PluginID id, const std::string& name)
 {
+    // Without the NVIGI core only the synthetic plugins are available
+    if (!m_pluginInfo)
+        return false;
+
     const nvigi::AdapterSpec* adapterInfo = (m_adapter >= 0) ? m_pluginInfo->detectedAdapters[m_adapter] : nullptr;
 
     // find the plugin - make sure it is even there and can be supported...
@@ -185,10 +218,95 @@ bool NVIGIContext::CheckPluginCompat(nvigi::PluginID id, const std::string& name
     return false;
 }
 
+PluginCapsCache::Key NVIGIContext::GetCapsCacheKey(nvigi::PluginID id, const std::string& modelRoot)
+{
+    PluginCapsCache::Key key;
+    key.m_featureID = id;
+    key.m_modelRoot = modelRoot;
+    key.m_modelsStamp = m_capsCache.GetDirectoryTreeStamp(modelRoot);
+
+    for (int i = 0; i < m_pluginInfo->numDetectedPlugins; i++)
+    {
+        auto& plugin = m_pluginInfo->detectedPlugins[i];
+        if (plugin->id == id)
+        {
+#ifdef _WIN32
+            const char* binaryExt = ".dll";
+#else
+            const char* binaryExt = ".so";
+#endif
+            fs::path binaryPath = fs::path(m_appUtf8path) / (std::string(plugin->pluginName) + binaryExt);
+            uint64_t stamp = PluginCapsCache::GetFileStamp(binaryPath.string());
+            stamp = PluginCapsCache::HashBytes(&plugin->pluginVersion, sizeof(plugin->pluginVersion), stamp);
+            key.m_binaryStamp = stamp;
+            break;
+        }
+    }
+
+    return key;
+}
+
+bool NVIGIContext::AddCachedPluginModels(StageInfo& stage, nvigi::PluginID id, const std::string& name, const std::string& modelRoot)
+{
+    if (!m_useCapsCache || m_rebuildCapsCache)
+        return false;
+
+    std::vector<PluginCapsCache::Model> models;
+    if (!m_capsCache.Find(GetCapsCacheKey(id, modelRoot), models))
+    {
+        m_capsCacheMisses++;
+        return false;
+    }
+
+    for (auto& model : models)
+    {
+        ModelCatalog::ModelDesc desc;
+        desc.m_featureID = id;
+        desc.m_modelName = model.m_modelName;
+        desc.m_pluginName = name;
+        desc.m_guid = model.m_guid;
+        desc.m_modelRoot = modelRoot;
+        desc.m_url = model.m_url;
+        desc.m_vram = (size_t)model.m_vram;
+        desc.m_modelStatus = (ModelStatus)model.m_status;
+        stage.m_catalog.Add(desc);
+    }
+
+    m_capsCacheHits++;
+    return true;
+}
+
+void NVIGIContext::CachePluginModels(const StageInfo& stage, nvigi::PluginID id, const std::string& modelRoot)
+{
+    if (!m_useCapsCache)
+        return;
+
+    std::vector<PluginCapsCache::Model> models;
+    for (ModelHandle h = 0; h < stage.m_catalog.Size(); h++)
+    {
+        const PluginModelInfo& info = stage.m_catalog.Get(h);
+        if (info.m_featureID == id && info.m_modelRoot.view() == modelRoot)
+        {
+            PluginCapsCache::Model model;
+            model.m_modelName = info.m_modelName.c_str();
+            model.m_guid = info.m_guid.c_str();
+            model.m_url = info.m_url.c_str();
+            model.m_vram = info.m_vram;
+            model.m_status = (uint8_t)info.m_modelStatus;
+            models.push_back(model);
+        }
+    }
+
+    m_capsCache.Store(GetCapsCacheKey(id, modelRoot), models);
+}
+
 bool NVIGIContext::AddGPTPlugin(nvigi::PluginID id, const std::string& name, const std::string& modelRoot)
 {
     if (CheckPluginCompat(id, name))
     {
+        if (AddCachedPluginModels(m_gpt, id, name, modelRoot))
+            return true;
+
         nvigi::IGeneralPurposeTransformer* igpt{};
         nvigi::Result nvigiRes = nvigiGetInterfaceDynamic(id, &igpt, m_nvigiLoadInterface);
         if (nvigiRes != nvigi::kResultOk)
@@ -209,21 +327,21 @@ bool NVIGIContext::AddGPTPlugin(nvigi::PluginID id, const std::string& name, con
 
         for (uint32_t i = 0; i < models->numSupportedModels; i++)
         {
-            PluginModelInfo* info = new PluginModelInfo;
-            info->m_featureID = id;
-            info->m_modelName = models->supportedModelNames[i];
-            info->m_pluginName = name;
-            info->m_caption = name + " : " + models->supportedModelNames[i];
-            info->m_guid = models->supportedModelGUIDs[i];
-            info->m_modelRoot = modelRoot;
-            info->m_vram = models->modelMemoryBudgetMB[i];
-            info->m_modelStatus = (models->modelFlags[i] & nvigi::kModelFlagRequiresDownload)
+            ModelCatalog::ModelDesc desc;
+            desc.m_featureID = id;
+            desc.m_modelName = models->supportedModelNames[i];
+            desc.m_pluginName = name;
+            desc.m_guid = models->supportedModelGUIDs[i];
+            desc.m_modelRoot = modelRoot;
+            desc.m_vram = models->modelMemoryBudgetMB[i];
+            desc.m_modelStatus = (models->modelFlags[i] & nvigi::kModelFlagRequiresDownload)
                 ? ModelStatus::AVAILABLE_MANUAL_DOWNLOAD : ModelStatus::AVAILABLE_LOCALLY;
-            m_gpt.m_pluginModelsMap[info->m_guid].push_back(info);
+            m_gpt.m_catalog.Add(desc);
         }
 
         m_nvigiUnloadInterface(id, igpt);
         FreeCreationParams(params1);
+        CachePluginModels(m_gpt, id, modelRoot);
         return true;
     }
 
@@ -237,6 +355,9 @@ bool NVIGIContext::AddGPTCloudPlugin()
 
     if (CheckPluginCompat(id, name))
     {
+        if (AddCachedPluginModels(m_gpt, id, name, m_shippedModelsPath))
+            return true;
+
         nvigi::IGeneralPurposeTransformer* igpt{};
         nvigi::Result nvigiRes = nvigiGetInterfaceDynamic(id, &igpt, m_nvigiLoadInterface);
         if (nvigiRes != nvigi::kResultOk)
@@ -270,22 +391,22 @@ bool NVIGIContext::AddGPTCloudPlugin()
             nvigi::getCapsAndRequirements(igpt, *params1, &models);
             auto cloudCaps = nvigi::findStruct<nvigi::CloudCapabilities>(*models);
 
-            PluginModelInfo* info = new PluginModelInfo;
-            info->m_featureID = id;
-            info->m_modelName = modelName;
-            info->m_pluginName = name;
-            info->m_caption = name + " : " + modelName;
-            info->m_guid = guid;
-            info->m_modelRoot = m_shippedModelsPath;
-            info->m_vram = 0;
-            info->m_modelStatus = ModelStatus::AVAILABLE_CLOUD;
-            info->m_url = cloudCaps->url;
-            m_gpt.m_pluginModelsMap[info->m_guid].push_back(info);
+            ModelCatalog::ModelDesc desc;
+            desc.m_featureID = id;
+            desc.m_modelName = modelName;
+            desc.m_pluginName = name;
+            desc.m_guid = guid;
+            desc.m_modelRoot = m_shippedModelsPath;
+            desc.m_vram = 0;
+            desc.m_modelStatus = ModelStatus::AVAILABLE_CLOUD;
+            desc.m_url = cloudCaps->url;
+            m_gpt.m_catalog.Add(desc);
 
         }
 
         m_nvigiUnloadInterface(id, igpt);
         FreeCreationParams(params1);
+        CachePluginModels(m_gpt, id, m_shippedModelsPath);
         return true;
     }
 
@@ -297,6 +418,9 @@ bool NVIGIContext::AddASRPlugin(nvigi::PluginID id, const std::string& name, con
 {
     if (CheckPluginCompat(id, name))
     {
+        if (AddCachedPluginModels(m_asr, id, name, modelRoot))
+            return true;
+
         nvigi::IAutoSpeechRecognition* iasr{};
         nvigi::Result nvigiRes = nvigiGetInterfaceDynamic(id, &iasr, m_nvigiLoadInterface);
         if (nvigiRes != nvigi::kResultOk)
@@ -318,21 +442,21 @@ bool NVIGIContext::AddASRPlugin(nvigi::PluginID id, const std::string& name, con
         nvigi::CommonCapabilitiesAndRequirements& models = *(caps->common);
         for (uint32_t i = 0; i < models.numSupportedModels; i++)
         {
-            PluginModelInfo* info = new PluginModelInfo;
-            info->m_featureID = id;
-            info->m_modelName = models.supportedModelNames[i];
-            info->m_pluginName = name;
-            info->m_caption = name + " : " + models.supportedModelNames[i];
-            info->m_guid = models.supportedModelGUIDs[i];
-            info->m_modelRoot = modelRoot;
-            info->m_vram = models.modelMemoryBudgetMB[i];
-            info->m_modelStatus = (models.modelFlags[i] & nvigi::kModelFlagRequiresDownload)
+            ModelCatalog::ModelDesc desc;
+            desc.m_featureID = id;
+            desc.m_modelName = models.supportedModelNames[i];
+            desc.m_pluginName = name;
+            desc.m_guid = models.supportedModelGUIDs[i];
+            desc.m_modelRoot = modelRoot;
+            desc.m_vram = models.modelMemoryBudgetMB[i];
+            desc.m_modelStatus = (models.modelFlags[i] & nvigi::kModelFlagRequiresDownload)
                 ? ModelStatus::AVAILABLE_MANUAL_DOWNLOAD : ModelStatus::AVAILABLE_LOCALLY;
-            m_asr.m_pluginModelsMap[info->m_guid].push_back(info);
+            m_asr.m_catalog.Add(desc);
         }
 
         m_nvigiUnloadInterface(id, iasr);
         FreeCreationParams(params1);
+        CachePluginModels(m_asr, id, modelRoot);
         return true;
     }
 
@@ -343,6 +467,9 @@ bool NVIGIContext::AddTTSPlugin(nvigi::PluginID id, const std::string& name, con
 {
     if (CheckPluginCompat(id, name))
     {
+        if (AddCachedPluginModels(m_tts, id, name, modelRoot))
+            return true;
+
         nvigi::ITextToSpeech* itts{};
         nvigi::Result nvigiRes = nvigiGetInterfaceDynamic(id, &itts, m_nvigiLoadInterface);
         if (nvigiRes != nvigi::kResultOk)
@@ -364,27 +491,111 @@ bool NVIGIContext::AddTTSPlugin(nvigi::PluginID id, const std::string& name, con
         nvigi::CommonCapabilitiesAndRequirements& models = *(caps->common);
         for (uint32_t i = 0; i < models.numSupportedModels; i++)
         {
-            PluginModelInfo* info = new PluginModelInfo;
-            info->m_featureID = id;
-            info->m_modelName = models.supportedModelNames[i];
-            info->m_pluginName = name;
-            info->m_caption = name + " : " + models.supportedModelNames[i];
-            info->m_guid = models.supportedModelGUIDs[i];
-            info->m_modelRoot = modelRoot;
-            info->m_vram = models.modelMemoryBudgetMB[i];
-            info->m_modelStatus = (models.modelFlags[i] & nvigi::kModelFlagRequiresDownload)
+            ModelCatalog::ModelDesc desc;
+            desc.m_featureID = id;
+            desc.m_modelName = models.supportedModelNames[i];
+            desc.m_pluginName = name;
+            desc.m_guid = models.supportedModelGUIDs[i];
+            desc.m_modelRoot = modelRoot;
+            desc.m_vram = models.modelMemoryBudgetMB[i];
+            desc.m_modelStatus = (models.modelFlags[i] & nvigi::kModelFlagRequiresDownload)
                 ? ModelStatus::AVAILABLE_MANUAL_DOWNLOAD : ModelStatus::AVAILABLE_LOCALLY;
-            m_tts.m_pluginModelsMap[info->m_guid].push_back(info);
+            m_tts.m_catalog.Add(desc);
         }
 
         m_nvigiUnloadInterface(id, itts);
         FreeCreationParams(params1);
+        CachePluginModels(m_tts, id, modelRoot);
         return true;
     }
 
     return false;
 }
 
+void NVIGIContext::AddSyntheticPlugin(StageInfo& stage, SyntheticBackend::Stage kind)
+{
+    size_t count = 0;
+    const SyntheticBackend::Model* models = SyntheticBackend::GetModels(kind, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        ModelCatalog::ModelDesc desc;
+        desc.m_featureID = SyntheticBackend::GetPluginID(kind);
+        desc.m_modelName = models[i].m_name;
+        desc.m_pluginName = SyntheticBackend::GetPluginName();
+        desc.m_guid = models[i].m_guid;
+        desc.m_modelRoot = m_shippedModelsPath;
+        desc.m_vram = models[i].m_vramMB;
+        desc.m_modelStatus = ModelStatus::AVAILABLE_LOCALLY;
+        stage.m_catalog.Add(desc);
+    }
+}
+
+nvigi::Result NVIGIContext::GetStageInterface(nvigi::PluginID id, nvigi::InferenceInterface** iface)
+{
+    if (m_outOfProcess)
+    {
+        *iface = InferenceHost::Wrap(id);
+        return *iface ? nvigi::kResultOk : nvigi::kResultInvalidState;
+    }
+    if (SyntheticBackend::IsSynthetic(id))
+    {
+        *iface = SyntheticBackend::GetInterface(id);
+        return *iface ? nvigi::kResultOk : nvigi::kResultItemNotFound;
+    }
+    if (!m_nvigiLoadInterface)
+        return nvigi::kResultInvalidState;
+    return nvigiGetInterfaceDynamic(id, iface, m_nvigiLoadInterface);
+}
+
+ModelHandle NVIGIContext::SelectInitialModel(const StageInfo& stage, bool allowCpu)
+{
+    // Runs on the synthetic backend start on it, so they do not depend on which GPU plugins are present
+    if (m_syntheticBackend)
+    {
+        for (ModelHandle h = 0; h < stage.m_catalog.Size(); h++)
+        {
+            if (SyntheticBackend::IsSynthetic(stage.m_catalog.Get(h).m_featureID))
+                return h;
+        }
+    }
+
+    // Prefer the first model (in GUID order) with a local NVDA backend, or failing that a local generic GPU backend
+    for (auto& group : stage.m_catalog.Groups())
+    {
+        ModelHandle selected = kInvalidModel;
+        for (ModelHandle h = group.begin(); h != group.end(); h++)
+        {
+            const PluginModelInfo& info = stage.m_catalog.Get(h);
+            if (info.m_modelStatus == ModelStatus::AVAILABLE_LOCALLY)
+            {
+                if ((stage.m_choices.m_nvdaFeatureID == info.m_featureID) ||
+                    (selected == kInvalidModel && stage.m_choices.m_gpuFeatureID == info.m_featureID))
+                    selected = h;
+            }
+        }
+        if (selected != kInvalidModel)
+            return selected;
+    }
+
+    if (allowCpu)
+    {
+        for (auto& group : stage.m_catalog.Groups())
+        {
+            ModelHandle selected = kInvalidModel;
+            for (ModelHandle h = group.begin(); h != group.end(); h++)
+            {
+                const PluginModelInfo& info = stage.m_catalog.Get(h);
+                if (info.m_modelStatus == ModelStatus::AVAILABLE_LOCALLY && stage.m_choices.m_cpuFeatureID == info.m_featureID)
+                    selected = h;
+            }
+            if (selected != kInvalidModel)
+                return selected;
+        }
+    }
+
+    return kInvalidModel;
+}
+
 bool NVIGIContext::Initialize_preDeviceManager(nvrhi::GraphicsAPI api, int argc, const char* const* argv)
 {
     m_api = api;
@@ -404,6 +615,14 @@ bool NVIGIContext::Initialize_preDeviceManager(nvrhi::GraphicsAPI api, int argc,
         else if (!strcmp(argv[i], "-systemPromptGPT")) {
             m_systemPromptGPT = argv[++i];
         }
+        else if (!strcmp(argv[i], "-historyTokens"))
+        {
+            m_historyTokens = (uint32_t)std::max(0, atoi(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-historySummaries"))
+        {
+            m_history.SetSummaries(true);
+        }
         else if (!strcmp(argv[i], "-noSigCheck"))
         {
             checkSig = false;
@@ -416,6 +635,215 @@ bool NVIGIContext::Initialize_preDeviceManager(nvrhi::GraphicsAPI api, int argc,
         {
             m_useCiG = false;
         }
+        else if (!strcmp(argv[i], "-noCapsCache"))
+        {
+            m_useCapsCache = false;
+        }
+        else if (!strcmp(argv[i], "-rebuildCapsCache"))
+        {
+            m_rebuildCapsCache = true;
+        }
+        else if (!strcmp(argv[i], "-warmup"))
+        {
+            m_warmupModels = true;
+        }
+        else if (!strcmp(argv[i], "-downloadManifest"))
+        {
+            m_downloadManifestPath = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-downloadConnections"))
+        {
+            m_downloader.SetConnections(atoi(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-latencyReport"))
+        {
+            m_latencyReportPath = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-traceFrames"))
+        {
+            m_traceFrames = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-traceFile"))
+        {
+            m_tracePath = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-memorySampleMs"))
+        {
+            m_memorySampleMs = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-syntheticBackend"))
+        {
+            m_syntheticBackend = true;
+        }
+        else if (!strcmp(argv[i], "-syntheticConfig"))
+        {
+            SyntheticBackend::Config config = SyntheticBackend::GetConfig();
+            if (!SyntheticBackend::ParseConfig(argv[++i], config))
+                return false;
+            SyntheticBackend::SetConfig(config);
+            m_syntheticBackend = true;
+        }
+        else if (!strcmp(argv[i], "-script"))
+        {
+            m_scriptPath = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-scriptConcurrency"))
+        {
+            m_scriptOptions.m_concurrency = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-scriptThinkMs"))
+        {
+            m_scriptOptions.m_thinkMs = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-scriptOutput"))
+        {
+            m_scriptOptions.m_outputDir = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-recordSession"))
+        {
+            m_recordSessionPath = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-replaySession"))
+        {
+            m_replaySessionPath = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-replaySpeed"))
+        {
+            m_replaySpeed = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-frameCoordinator"))
+        {
+            FrameCoordinator::Policy policy;
+            if (!FrameCoordinator::ParsePolicy(argv[++i], policy))
+            {
+                donut::log::error("-frameCoordinator expects off, fps or ttft");
+                return false;
+            }
+            m_frameCoordinator.SetPolicy(policy);
+        }
+        else if (!strcmp(argv[i], "-frameBudgetMs"))
+        {
+            m_frameBudgetMs = std::max(1.0, atof(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-adaptiveScheduling"))
+        {
+            m_schedulingController.SetEnabled(true);
+        }
+        else if (!strcmp(argv[i], "-ttftTargetMs"))
+        {
+            m_schedulingController.SetTTFTTargetMs(std::max(1.0, atof(argv[++i])));
+        }
+        else if (!strcmp(argv[i], "-tokenTargetMs"))
+        {
+            m_schedulingController.SetTokenTargetMs(std::max(1.0, atof(argv[++i])));
+        }
+        else if (!strcmp(argv[i], "-adaptiveTTS"))
+        {
+            m_ttsQuality.SetEnabled(true);
+        }
+        else if (!strcmp(argv[i], "-threadAffinity"))
+        {
+            if (!ThreadRegistry::ParseAffinity(argv[++i]))
+            {
+                donut::log::error("-threadAffinity expects role=mask pairs, e.g. render=0x3,inference=0xfc");
+                return false;
+            }
+        }
+        else if (!strcmp(argv[i], "-threadPriority"))
+        {
+            if (!ThreadRegistry::ParsePriority(argv[++i]))
+            {
+                donut::log::error("-threadPriority expects role=priority pairs, e.g. audio=realtime,loading=low");
+                return false;
+            }
+        }
+        else if (!strcmp(argv[i], "-outOfProcess"))
+        {
+            m_outOfProcess = true;
+        }
+        else if (!strcmp(argv[i], "-hostStallMs"))
+        {
+            m_hostStallMs = std::max(100, atoi(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-inferenceHost"))
+        {
+            m_inferenceHostName = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-targetFps"))
+        {
+            m_targetFramerate = std::clamp(atoi(argv[++i]), 1, kMaxTargetFramerate);
+            m_framerateLimiting = true;
+        }
+        else if (!strcmp(argv[i], "-framePacer"))
+        {
+            FramePacer::Mode mode;
+            if (!FramePacer::ParseMode(argv[++i], mode))
+            {
+                donut::log::error("-framePacer expects sleep or hybrid");
+                return false;
+            }
+            m_framePacer.SetMode(mode);
+        }
+        else if (!strcmp(argv[i], "-sweep"))
+        {
+            m_sweepPath = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-sweepOutput"))
+        {
+            m_sweepReportPath = argv[++i];
+        }
+    }
+
+    if (!m_scriptPath.empty() && !ScriptRunner::ParseScript(m_scriptPath, m_scriptTurns))
+        return false;
+
+    m_history.SetSystemPrompt(m_systemPromptGPT);
+    m_history.SetBudget(m_historyTokens, kGPTTokensToPredict);
+
+    // The host gets the settings that decide which plugins load and how its threads run
+    m_outOfProcess &= !IsInferenceHost();
+    for (int i = 1; m_outOfProcess && i < argc; i++)
+    {
+        bool hasValue = !strcmp(argv[i], "-syntheticConfig") || !strcmp(argv[i], "-threadAffinity") || !strcmp(argv[i], "-threadPriority");
+        if (hasValue && i + 1 < argc)
+        {
+            m_hostArgs.push_back(argv[i]);
+            m_hostArgs.push_back(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-noSigCheck") || !strcmp(argv[i], "-syntheticBackend"))
+        {
+            m_hostArgs.push_back(argv[i]);
+        }
+    }
+
+    if (!m_sweepPath.empty())
+    {
+        // The sweep drives the models and the scene load itself
+        if (!m_scriptPath.empty() || !m_replaySessionPath.empty())
+        {
+            donut::log::error("-sweep cannot be combined with -script or -replaySession");
+            return false;
+        }
+        if (!FrameSweep::ParseSpec(m_sweepPath, m_sweepSpec))
+            return false;
+    }
+
+    // Started before the initial model selection so that it is part of the session; a replay is recorded
+    // in memory (or to -recordSession) with the seed of the original
+    if (!m_replaySessionPath.empty() || !m_recordSessionPath.empty())
+    {
+        uint64_t seed = std::random_device()();
+        if (!m_replaySessionPath.empty() && !ReadSessionLog(m_replaySessionPath, seed, m_replayEvents))
+        {
+            donut::log::error("Unable to read session log %s", m_replaySessionPath.c_str());
+            return false;
+        }
+        if (!m_sessionRecorder.Start(m_recordSessionPath, seed))
+        {
+            donut::log::error("Unable to create session log %s", m_recordSessionPath.c_str());
+            return false;
+        }
+        m_sessionRecorder.RecordSchedulingMode(m_schedulingMode);
     }
 
     auto pathNVIGIDll = GetNVIGICoreDllLocation();
@@ -430,11 +858,13 @@ bool NVIGIContext::Initialize_preDeviceManager(nvrhi::GraphicsAPI api, int argc,
     }
     nvigiCore = LoadLibraryW(pathNVIGIDll.c_str());
 
-    if (!nvigiCore)
+    if (!nvigiCore && !m_syntheticBackend)
     {
         donut::log::error("Unable to load NVIGI core");
         return false;
     }
+    if (!nvigiCore)
+        donut::log::warning("Unable to load NVIGI core; only the synthetic backend is available");
 
     if (m_shippedModelsPath.empty())
     {
@@ -445,10 +875,13 @@ bool NVIGIContext::Initialize_preDeviceManager(nvrhi::GraphicsAPI api, int argc,
         m_shippedModelsPath = converter.to_bytes(GetNVIGICoreDllPath()) + "\\..\\..\\nvigi.models";
     }
 
-    m_nvigiInit = (PFun_nvigiInit*)GetProcAddress(nvigiCore, "nvigiInit");
-    m_nvigiShutdown = (PFun_nvigiShutdown*)GetProcAddress(nvigiCore, "nvigiShutdown");
-    m_nvigiLoadInterface = (PFun_nvigiLoadInterface*)GetProcAddress(nvigiCore, "nvigiLoadInterface");
-    m_nvigiUnloadInterface = (PFun_nvigiUnloadInterface*)GetProcAddress(nvigiCore, "nvigiUnloadInterface");
+    if (nvigiCore)
+    {
+        m_nvigiInit = (PFun_nvigiInit*)GetProcAddress(nvigiCore, "nvigiInit");
+        m_nvigiShutdown = (PFun_nvigiShutdown*)GetProcAddress(nvigiCore, "nvigiShutdown");
+        m_nvigiLoadInterface = (PFun_nvigiLoadInterface*)GetProcAddress(nvigiCore, "nvigiLoadInterface");
+        m_nvigiUnloadInterface = (PFun_nvigiUnloadInterface*)GetProcAddress(nvigiCore, "nvigiUnloadInterface");
+    }
 
     {
         wchar_t path[PATH_MAX] = { 0 };
@@ -456,13 +889,21 @@ bool NVIGIContext::Initialize_preDeviceManager(nvrhi::GraphicsAPI api, int argc,
         auto basePath = std::filesystem::path(path).parent_path();
         static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> convert;
         m_appUtf8path = convert.to_bytes(basePath);
+        if (m_latencyReportPath.empty())
+            m_latencyReportPath = (basePath / "nvigi.latency").string();
+        if (m_tracePath.empty())
+            m_tracePath = (basePath / "nvigi.trace.json").string();
+        if (m_scriptOptions.m_outputDir.empty())
+            m_scriptOptions.m_outputDir = (basePath / "nvigi.script").string();
+        if (m_sweepReportPath.empty())
+            m_sweepReportPath = (basePath / "nvigi.sweep").string();
         nvigi::Preferences nvigiPref;
         const char* paths[] =
         {
            m_appUtf8path.c_str(),
         };
         nvigiPref.logLevel = nvigi::LogLevel::eVerbose;
-        nvigiPref.showConsole = true;
+        nvigiPref.showConsole = !IsInferenceHost();
         nvigiPref.numPathsToPlugins = _countof(paths);
         nvigiPref.utf8PathsToPlugins = paths;
 
@@ -480,11 +921,22 @@ bool NVIGIContext::Initialize_preDeviceManager(nvrhi::GraphicsAPI api, int argc,
             nvigiPref.utf8PathToLogsAndData = m_LogFilename.c_str();
         }
 
-        auto result = m_nvigiInit(nvigiPref, &m_pluginInfo, nvigi::kSDKVersion);
+        if (m_nvigiInit)
+            m_nvigiInit(nvigiPref, &m_pluginInfo, nvigi::kSDKVersion);
+    }
+
+    // The host only creates and evaluates instances; the models and plugins are chosen by the parent
+    if (IsInferenceHost())
+        return true;
+
+    if (m_outOfProcess && !InferenceHost::Start(m_hostArgs, m_hostStallMs))
+    {
+        donut::log::warning("Unable to start the inference host; running inference in-process");
+        m_outOfProcess = false;
     }
 
     uint32_t nvdaArch = 0;
-    for (int i = 0; i < m_pluginInfo->numDetectedAdapters; i++)
+    for (int i = 0; m_pluginInfo && i < m_pluginInfo->numDetectedAdapters; i++)
     {
         auto& adapter = m_pluginInfo->detectedAdapters[i];
         if (adapter->vendor == nvigi::VendorId::eNVDA && nvdaArch < adapter->architecture)
@@ -494,13 +946,33 @@ bool NVIGIContext::Initialize_preDeviceManager(nvrhi::GraphicsAPI api, int argc,
         }
     }
 
-    if (m_adapter < 0)
+    if (m_adapter < 0 && m_pluginInfo)
     {
         donut::log::warning("No NVIDIA adapters found.  GPU plugins will not be available\n");
         if (m_pluginInfo->numDetectedAdapters)
             m_adapter = 0;
     }
 
+    // Plugin enumeration is timed as a whole so cold (-rebuildCapsCache) and warm starts can be compared
+    SimpleTimer enumerationTimer;
+    enumerationTimer.Start();
+
+    if (m_useCapsCache)
+    {
+        const nvigi::AdapterSpec* adapterInfo = (m_adapter >= 0) ? m_pluginInfo->detectedAdapters[m_adapter] : nullptr;
+        uint64_t systemStamp = PluginCapsCache::HashBytes(&nvigi::kSDKVersion, sizeof(nvigi::kSDKVersion));
+        if (adapterInfo)
+        {
+            systemStamp = PluginCapsCache::HashBytes(&adapterInfo->vendor, sizeof(adapterInfo->vendor), systemStamp);
+            systemStamp = PluginCapsCache::HashBytes(&adapterInfo->architecture, sizeof(adapterInfo->architecture), systemStamp);
+            systemStamp = PluginCapsCache::HashBytes(&adapterInfo->driverVersion, sizeof(adapterInfo->driverVersion), systemStamp);
+        }
+
+        // With -rebuildCapsCache every lookup misses, so each plugin is queried and its entry rewritten
+        m_capsCachePath = (fs::path(m_appUtf8path) / "nvigi.caps.cache").string();
+        m_capsCache.Load(m_capsCachePath, systemStamp);
+    }
+
     m_gpt.m_vramBudget = 8500;
 
     m_gpt.m_choices = {
@@ -522,26 +994,11 @@ bool NVIGIContext::Initialize_preDeviceManager(nvrhi::GraphicsAPI api, int argc,
         AddGPTPlugin(nvigi::plugin::gpt::ggml::vulkan::kId, "ggml.vk", m_shippedModelsPath);
     }
     AddGPTCloudPlugin();
+    if (m_syntheticBackend)
+        AddSyntheticPlugin(m_gpt, SyntheticBackend::Stage::GPT);
 
-    {
-        // Select initial plugin m_gpt.m_info...  Or we set it to null?
-        m_gpt.m_info = nullptr;
-        for (auto& m : m_gpt.m_pluginModelsMap)
-        {
-            for (auto& info : m.second)
-            {
-                ModelStatus status = info->m_modelStatus;
-                if (status == ModelStatus::AVAILABLE_LOCALLY)
-                {
-                    if ((m_gpt.m_choices.m_nvdaFeatureID == info->m_featureID) ||
-                        (m_gpt.m_info == nullptr && m_gpt.m_choices.m_gpuFeatureID == info->m_featureID))
-                        m_gpt.m_info = info;
-                }
-            }
-            if (m_gpt.m_info)
-                break;
-        }
-    }
+    m_gpt.m_catalog.Finalize();
+    m_gpt.m_model = SelectInitialModel(m_gpt, false);
 
     m_asr.m_vramBudget = 3000;
 
@@ -564,43 +1021,11 @@ bool NVIGIContext::Initialize_preDeviceManager(nvrhi::GraphicsAPI api, int argc,
         AddASRPlugin(nvigi::plugin::asr::ggml::vulkan::kId, "ggml.vk", m_shippedModelsPath);
     }
     AddASRPlugin(nvigi::plugin::asr::ggml::cpu::kId, "ggml.cpu", m_shippedModelsPath);
+    if (m_syntheticBackend)
+        AddSyntheticPlugin(m_asr, SyntheticBackend::Stage::ASR);
 
-    {
-        // Select initial plugin m_asr.m_info...  Or we set it to null?
-        m_asr.m_info = nullptr;
-        for (auto& m : m_asr.m_pluginModelsMap)
-        {
-            for (auto& info : m.second)
-            {
-                ModelStatus status = info->m_modelStatus;
-                if (status == ModelStatus::AVAILABLE_LOCALLY)
-                {
-                    if ((m_asr.m_choices.m_nvdaFeatureID == info->m_featureID) ||
-                        (m_asr.m_info == nullptr && m_asr.m_choices.m_gpuFeatureID == info->m_featureID))
-                        m_asr.m_info = info;
-                }
-            }
-            if (m_asr.m_info)
-                break;
-        }
-        if (!m_asr.m_info)
-        {
-            for (auto& m : m_asr.m_pluginModelsMap)
-            {
-                for (auto& info : m.second)
-                {
-                    ModelStatus status = info->m_modelStatus;
-                    if (status == ModelStatus::AVAILABLE_LOCALLY)
-                    {
-                        if (m_asr.m_choices.m_cpuFeatureID == info->m_featureID)
-                            m_asr.m_info = info;
-                    }
-                }
-                if (m_asr.m_info)
-                    break;
-            }
-        }
-    }
+    m_asr.m_catalog.Finalize();
+    m_asr.m_model = SelectInitialModel(m_asr, true);
 
     m_tts.m_vramBudget = 8500;
 
@@ -621,30 +1046,41 @@ bool NVIGIContext::Initialize_preDeviceManager(nvrhi::GraphicsAPI api, int argc,
     {
         AddTTSPlugin(nvigi::plugin::tts::asqflow_ggml::cuda::kId, "asqflow-ggml-cuda", m_shippedModelsPath);
     }
+    if (m_syntheticBackend)
+        AddSyntheticPlugin(m_tts, SyntheticBackend::Stage::TTS);
+
+    m_tts.m_catalog.Finalize();
+    m_tts.m_model = SelectInitialModel(m_tts, false);
+
+    enumerationTimer.Stop();
+    donut::log::info("Plugin enumeration time: %.2f ms (caps cache %s: %d hits, %d misses)", enumerationTimer.GetElapsedMiliseconds(),
+        m_useCapsCache ? (m_rebuildCapsCache ? "rebuilt" : "enabled") : "disabled", m_capsCacheHits, m_capsCacheMisses);
+
+    if (m_useCapsCache && m_capsCache.IsDirty())
+    {
+        if (!m_capsCache.Save(m_capsCachePath))
+            donut::log::warning("Unable to write plugin capabilities cache to %s", m_capsCachePath.c_str());
+    }
 
+    // Models the plugins report as needing a download can be fetched in-app if the manifest lists them
+    if (m_downloadManifestPath.empty())
+        m_downloadManifestPath = m_shippedModelsPath + "/nvigi.models.downloads.txt";
+    if (m_downloader.LoadManifest(m_downloadManifestPath, m_shippedModelsPath))
     {
-        // Set the TTS to unselected initially, as not everyone will want to use it
-        m_tts.m_info = nullptr;
-        for (auto& m : m_tts.m_pluginModelsMap)
+        for (StageInfo* stage : { &m_asr, &m_gpt, &m_tts })
         {
-            for (auto& info : m.second)
+            for (ModelHandle h = 0; h < stage->m_catalog.Size(); h++)
             {
-                ModelStatus status = info->m_modelStatus;
-                if (status == ModelStatus::AVAILABLE_LOCALLY)
-                {
-                    if ((m_tts.m_choices.m_nvdaFeatureID == info->m_featureID) ||
-                        (m_tts.m_info == nullptr && m_tts.m_choices.m_gpuFeatureID == info->m_featureID))
-                        m_tts.m_info = info;
-                }
+                const PluginModelInfo& info = stage->m_catalog.Get(h);
+                if (info.m_modelStatus == ModelStatus::AVAILABLE_MANUAL_DOWNLOAD && m_downloader.HasModel(info.m_guid))
+                    stage->m_catalog.SetStatus(h, ModelStatus::AVAILABLE_DOWNLOADER);
             }
-            if (m_tts.m_info)
-                break;
         }
     }
 
     m_gpt.m_callbackState.store(nvigi::kInferenceExecutionStateInvalid);
 
-    messages.push_back({ Message::Type::Answer, "Type a query or record audio to interact!" });
+    m_chatLog.Append(ChatLog::Role::Answer, "Type a query or record audio to interact!");
 
 
     return true;
@@ -719,6 +1155,11 @@ bool NVIGIContext::Initialize_preDeviceCreate(donut::app::DeviceManager* deviceM
 
 bool NVIGIContext::Initialize_postDevice()
 {
+    // Started before the models load so the capture shows them alongside the first frames
+    ThreadRegistry::Register("Main", ThreadRegistry::Role::Render);
+    if (m_traceFrames > 0)
+        Trace::StartCapture(m_tracePath, m_traceFrames);
+
     auto readFile = [](const char* fname)->std::vector<uint8_t>
         {
             fs::path p(fname);
@@ -730,7 +1171,7 @@ bool NVIGIContext::Initialize_postDevice()
         };
 
     // Setup CiG
-    if (m_useCiG)
+    if (m_useCiG && m_nvigiLoadInterface)
     {
         // Because of a current bug, we can't create and
         // destroy the CIG context many times in one app (yet). The CIG context is owned by
@@ -771,84 +1212,27 @@ bool NVIGIContext::Initialize_postDevice()
     GetVRAMStats(currentVRAM, m_maxVRAM);
     m_maxVRAM /= (1024 * 1024);
 
-    //! Load A2T script    
-    auto loadASR = [this]()->HRESULT
+    // Started before the initial loads so their footprint shows up in the timeline
+    m_memorySampler.Start([this]()
         {
-            PluginModelInfo* gptInfo = m_gpt.m_info;
+            size_t current = 0, budget = 0;
+            GetVRAMStats(current, budget);
+            return (uint64_t)current;
+        }, m_memorySampleMs);
 
-            if (gptInfo)
-            {
-                nvigi::GPTCreationParameters* params1 = GetGPTCreationParams(false);
-                nvigi::Result nvigiRes = nvigiGetInterfaceDynamic(gptInfo->m_featureID, &m_igpt, m_nvigiLoadInterface);
-                if (nvigiRes == nvigi::kResultOk)
-                    nvigiRes = m_igpt->createInstance(*params1, &m_gpt.m_inst);
-                if (nvigiRes != nvigi::kResultOk)
-                {
-                    donut::log::error("Unable to create GPT instance/model.  See log for details.  Most common issue is incorrect path to models");
-                }
-
-                m_gpt.m_ready.store(nvigiRes == nvigi::kResultOk);
-                FreeCreationParams(params1);
-            }
-            else
-            {
-                m_gpt.m_ready.store(false);
-            }
-
-            PluginModelInfo* asrInfo = m_asr.m_info;
-
-            if (asrInfo)
-            {
-                nvigi::ASRWhisperCreationParameters* params2 = GetASRCreationParams(false);
-                nvigi::Result nvigiRes = nvigiGetInterfaceDynamic(asrInfo->m_featureID, &m_iasr, m_nvigiLoadInterface);
-                if (nvigiRes == nvigi::kResultOk)
-                    nvigiRes = m_iasr->createInstance(*params2, &m_asr.m_inst);
-                if (nvigiRes != nvigi::kResultOk)
-                {
-                    donut::log::error("Unable to create ASR instance/model.  See log for details.  Most common issue is incorrect path to models");
-                }
-
-                m_asr.m_ready.store(nvigiRes == nvigi::kResultOk);
-                FreeCreationParams(params2);
-            }
-            else
-            {
-                m_asr.m_ready.store(false);
-            }
-
-            PluginModelInfo* ttsInfo = m_tts.m_info;
-
-            std::vector<std::string> targetVoices = GetPossibleTargetVoices(GetNVIGICoreDllPath());
-            // The initial value of the selected voice, if non-empty, was the voice we'd prefer if it is available
-            if (std::find(targetVoices.begin(), targetVoices.end(), m_ttsInferenceCtx.m_selectedTargetVoice) == targetVoices.end())
-            {
-                // We could not find that voice, so pick the first valid one...
-                if (!targetVoices.empty())
-                    m_ttsInferenceCtx.m_selectedTargetVoice = targetVoices[0];
-            }
-
-            if (ttsInfo)
-            {
-                nvigi::TTSCreationParameters* params2 = GetTTSCreationParams(false);
-                nvigi::Result nvigiRes = nvigiGetInterfaceDynamic(ttsInfo->m_featureID, &m_itts, m_nvigiLoadInterface);
-                if (nvigiRes == nvigi::kResultOk)
-                    nvigiRes = m_itts->createInstance(*params2, &m_tts.m_inst);
-                if (nvigiRes != nvigi::kResultOk)
-                {
-                    donut::log::error("Unable to create TTS instance/model.  See log for details.  Most common issue is incorrect path to models");
-                }
-
-                m_tts.m_ready.store(nvigiRes == nvigi::kResultOk);
-                FreeCreationParams(params2);
-            }
-            else
-            {
-                m_tts.m_ready.store(false);
-            }
+    std::vector<std::string> targetVoices = GetPossibleTargetVoices(GetNVIGICoreDllPath());
+    // The initial value of the selected voice, if non-empty, was the voice we'd prefer if it is available
+    if (std::find(targetVoices.begin(), targetVoices.end(), m_ttsInferenceCtx.m_selectedTargetVoice) == targetVoices.end())
+    {
+        // We could not find that voice, so pick the first valid one...
+        if (!targetVoices.empty())
+            m_ttsInferenceCtx.m_selectedTargetVoice = targetVoices[0];
+    }
 
-            return S_OK;
-        };
-    m_loadingThread = new std::thread{ loadASR };
+    // Initial models load in the background like any later selection; creation is still one stage at a time
+    ReloadGPTModel(m_gpt.m_model);
+    ReloadASRModel(m_asr.m_model);
+    ReloadTTSModel(m_tts.m_model);
 
     return true;
 }
@@ -866,10 +1250,37 @@ void NVIGIContext::SetDevice_nvrhi(nvrhi::IDevice* device)
 
 void NVIGIContext::Shutdown()
 {
-    //    t1->join();
-    m_loadingThread->join();
-    //  delete t1;
-    delete m_loadingThread;
+    // Closing the window cuts a script or replay short; report the turns that completed
+    if (m_scriptStarted && !m_scriptDone)
+    {
+        m_scriptRunner.Cancel();
+        FinishScript();
+    }
+    if (m_sweep.IsActive())
+    {
+        m_scriptRunner.Cancel();
+        m_scriptRunner.Wait();
+        FinishSweep();
+    }
+    FlushInferenceThread();
+    if (m_replayStarted && !m_replayDone)
+        FinishReplay();
+    m_sessionRecorder.Stop();
+
+    Trace::StopCapture();
+    m_downloader.Shutdown();
+    WriteLatencyReport();
+
+    m_memorySampler.Stop();
+    std::string memoryPath = m_latencyReportPath + ".memory";
+    if (!m_latencyReportPath.empty() && !m_memorySampler.WriteCSV(memoryPath))
+        donut::log::warning("Unable to write memory timeline to %s.csv", memoryPath.c_str());
+
+    // Supersede any load in flight and wait for it to reach a safe point
+    m_gpt.m_loadTask.Shutdown();
+    m_asr.m_loadTask.Shutdown();
+    m_tts.m_loadTask.Shutdown();
+    InferenceHost::Stop();
 
     if (m_d3d12Params)
     {
@@ -882,10 +1293,20 @@ void NVIGIContext::Shutdown()
         m_vkParams = nullptr;
     }
 
-    m_nvigiUnloadInterface(nvigi::plugin::hwi::cuda::kId, m_cig);
+    if (m_nvigiUnloadInterface && m_cig)
+        m_nvigiUnloadInterface(nvigi::plugin::hwi::cuda::kId, m_cig);
     m_cig = nullptr;
 }
 
+int NVIGIContext::RunInferenceHost()
+{
+    int exitCode = InferenceHost::RunServer(m_inferenceHostName,
+        [this](nvigi::PluginID id, nvigi::InferenceInterface** iface) { return GetStageInterface(id, iface); });
+    if (m_nvigiShutdown)
+        m_nvigiShutdown();
+    return exitCode;
+}
+
 template <typename T> void NVIGIContext::FreeCreationParams(T* params)
 {
     if (!params)
@@ -899,12 +1320,12 @@ template <typename T> void NVIGIContext::FreeCreationParams(T* params)
     }
 }
 
-nvigi::BaseStructure* NVIGIContext::Get3DInfo(PluginModelInfo* info)
+nvigi::BaseStructure* NVIGIContext::Get3DInfo(const PluginModelInfo* info)
 {
     if (info == nullptr)
         return nullptr;
 
-    bool isD3D12Pluign = info->m_pluginName.find("d3d12") != std::string::npos;
+    bool isD3D12Pluign = info->m_pluginName.view().find("d3d12") != std::string::npos;
 
     if (m_api == nvrhi::GraphicsAPI::D3D12)
     {
@@ -932,11 +1353,11 @@ nvigi::BaseStructure* NVIGIContext::Get3DInfo(PluginModelInfo* info)
 
 nvigi::GPTCreationParameters* NVIGIContext::GetGPTCreationParams(bool genericInit, const std::string* modelRoot)
 {
-    PluginModelInfo* info = nullptr;
+    const PluginModelInfo* info = nullptr;
 
     if (!genericInit)
     {
-        info = m_gpt.m_info;
+        info = m_gpt.Info();
         if (!info)
             return nullptr;
     }
@@ -955,7 +1376,7 @@ nvigi::GPTCreationParameters* NVIGIContext::GetGPTCreationParams(bool genericIni
 
     nvigi::GPTCreationParameters* params1 = new nvigi::GPTCreationParameters;
 
-    if (nvigi::BaseStructure* apiParams = Get3DInfo(m_gpt.m_info))
+    if (nvigi::BaseStructure* apiParams = Get3DInfo(m_gpt.Info()))
     {
         if (NVIGI_FAILED(res, params1->chain(apiParams)))
             donut::log::error("Internal error chaining structs: %s: %s", __FILE__, __LINE__);
@@ -996,11 +1417,11 @@ nvigi::GPTCreationParameters* NVIGIContext::GetGPTCreationParams(bool genericIni
 
 nvigi::ASRWhisperCreationParameters* NVIGIContext::GetASRCreationParams(bool genericInit, const std::string* modelRoot)
 {
-    PluginModelInfo* info = nullptr;
+    const PluginModelInfo* info = nullptr;
 
     if (!genericInit)
     {
-        info = m_asr.m_info;
+        info = m_asr.Info();
         if (!info)
             return nullptr;
     }
@@ -1017,7 +1438,7 @@ nvigi::ASRWhisperCreationParameters* NVIGIContext::GetASRCreationParams(bool gen
 
     nvigi::ASRWhisperCreationParameters* params1 = new nvigi::ASRWhisperCreationParameters;
 
-    if (nvigi::BaseStructure* apiParams = Get3DInfo(m_asr.m_info))
+    if (nvigi::BaseStructure* apiParams = Get3DInfo(m_asr.Info()))
     {
         if (NVIGI_FAILED(res, params1->chain(apiParams)))
             donut::log::error("Internal error chaining structs: %s: %s", __FILE__, __LINE__);
@@ -1036,11 +1457,11 @@ nvigi::ASRWhisperCreationParameters* NVIGIContext::GetASRCreationParams(bool gen
 
 nvigi::TTSCreationParameters* NVIGIContext::GetTTSCreationParams(bool genericInit, const std::string* modelRoot)
 {
-    PluginModelInfo* info = nullptr;
+    const PluginModelInfo* info = nullptr;
 
     if (!genericInit)
     {
-        info = m_tts.m_info;
+        info = m_tts.Info();
         if (!info)
             return nullptr;
     }
@@ -1061,7 +1482,7 @@ nvigi::TTSCreationParameters* NVIGIContext::GetTTSCreationParams(bool genericIni
 
     if (!info || info->m_featureID != nvigi::plugin::tts::asqflow_ggml::vulkan::kId)
     {
-        if (nvigi::BaseStructure* apiParams = Get3DInfo(m_tts.m_info))
+        if (nvigi::BaseStructure* apiParams = Get3DInfo(m_tts.Info()))
         {
             if (NVIGI_FAILED(res, params1->chain(apiParams)))
                 donut::log::error("Internal error chaining structs: %s: %s", __FILE__, __LINE__);
@@ -1083,172 +1504,191 @@ nvigi::TTSCreationParameters* NVIGIContext::GetTTSCreationParams(bool genericIni
     return params1;
 }
 
-void NVIGIContext::ReloadGPTModel(PluginModelInfo* newGptInfo)
+template <typename T> bool NVIGIContext::CreateStageInstance(LoadTask& task, StageInfo& stage, nvigi::InferenceInterface*& iface,
+    const PluginModelInfo& info, T* params, bool redirectLog)
+{
+    NVIGI_TRACE_ZONE("Model Load");
+    if (task.IsCancelled())
+        return false;
+
+    task.SetPhase(LoadPhase::Uploading);
+    nvigi::Result nvigiRes = nvigi::kResultOk;
+    {
+        // Instance creation is serialized across stages, as the single loading thread used to do
+        std::scoped_lock lock(m_createMutex);
+        NVIGI_TRACE_ZONE("Model Create Instance");
+        std::unique_ptr<cerr_redirect> ggmlLog(redirectLog ? new cerr_redirect : nullptr);
+        auto memoryBefore = m_memorySampler.BeginEvent();
+        nvigiRes = GetStageInterface(info.m_featureID, &iface);
+        if (nvigiRes == nvigi::kResultOk)
+            nvigiRes = iface->createInstance(*params, &stage.m_inst);
+        if (nvigiRes == nvigi::kResultOk)
+        {
+            // Creation is serialized, so the change is attributable to this model
+            stage.m_loadedInfo = &info;
+            m_memorySampler.EndEvent(memoryBefore, std::string(GetStageName(stage)) + " load " + info.m_modelName.c_str() + " (" + info.m_pluginName.c_str() + ")", info.m_vram);
+        }
+    }
+    if (nvigiRes != nvigi::kResultOk)
+        return false;
+
+    // Superseded while creating: this instance is no longer wanted
+    if (task.IsCancelled())
+    {
+        DestroyStageInstance(stage, iface);
+        return false;
+    }
+
+    if (m_warmupModels)
+        task.SetPhase(LoadPhase::WarmingUp);
+    OnModelLoaded(stage);
+    return true;
+}
+
+void NVIGIContext::DestroyStageInstance(StageInfo& stage, nvigi::InferenceInterface* iface)
 {
-    if (m_loadingThread)
+    stage.m_ready.store(false);
+    if (iface && stage.m_inst)
     {
-        m_loadingThread->join();
-        delete m_loadingThread;
-        m_loadingThread = nullptr;
+        std::scoped_lock lock(m_createMutex);
+        auto memoryBefore = m_memorySampler.BeginEvent();
+        iface->destroyInstance(stage.m_inst);
+        if (stage.m_loadedInfo)
+            m_memorySampler.EndEvent(memoryBefore, std::string(GetStageName(stage)) + " unload " + stage.m_loadedInfo->m_modelName.c_str(), stage.m_loadedInfo->m_vram);
     }
+    stage.m_inst = {};
+    stage.m_loadedInfo = nullptr;
+}
 
+void NVIGIContext::ReloadGPTModel(ModelHandle newGptModel)
+{
     m_conversationInitialized = false;
 
-    PluginModelInfo* prevGptInfo = m_gpt.m_info;
+    ModelHandle prevGptModel = m_gpt.m_model;
+    const PluginModelInfo* prevGptInfo = m_gpt.Info();
 
-    m_gpt.m_info = newGptInfo;
+    m_gpt.m_model = newGptModel;
+    const PluginModelInfo* newGptInfo = m_gpt.Info();
 
     nvigi::GPTCreationParameters* params1 = GetGPTCreationParams(false);
     // This will be null if there is an error OR if the new model is being downloaded
     if (!params1 && newGptInfo)
     {
-        m_gpt.m_info = prevGptInfo;
+        m_gpt.m_model = prevGptModel;
         return;
     }
 
     m_gpt.m_ready.store(false);
 
-    if (m_igpt)
-    {
-        m_igpt->destroyInstance(m_gpt.m_inst);
-        m_gpt.m_inst = {};
-    }
+    // Owned by the job, and freed even if a newer selection drops the job before it runs
+    std::shared_ptr<nvigi::GPTCreationParameters> params(params1, [this](nvigi::GPTCreationParameters* p) { FreeCreationParams(p); });
 
-    if (!newGptInfo)
+    // The fallback is prepared here too: the model and config state belong to the UI thread
+    std::shared_ptr<nvigi::GPTCreationParameters> prevParams;
+    if (prevGptInfo && prevGptInfo != newGptInfo)
     {
-        m_gpt.m_ready.store(false);
-        return;
+        m_gpt.m_model = prevGptModel;
+        prevParams.reset(GetGPTCreationParams(false), [this](nvigi::GPTCreationParameters* p) { FreeCreationParams(p); });
+        m_gpt.m_model = newGptModel;
     }
+    m_gpt.m_revertModel = prevGptModel;
 
-    auto loadModel = [this, prevGptInfo, newGptInfo, params1]()->void
+    auto loadModel = [this, prevGptInfo, newGptInfo, params, prevParams](LoadTask& task)->bool
         {
-            nvigi::GPTCreationParameters* params = params1;
-            if (params)
-            {
-                cerr_redirect ggmlLog;
-                nvigi::Result nvigiRes = nvigiGetInterfaceDynamic(newGptInfo->m_featureID, &m_igpt, m_nvigiLoadInterface);
-                if (nvigiRes == nvigi::kResultOk)
-                    nvigiRes = m_igpt->createInstance(*params, &m_gpt.m_inst);
-                if (nvigiRes != nvigi::kResultOk)
-                {
-                    FreeCreationParams(params);
-                    donut::log::error("Unable to create GPT instance/model.  See log for details.  Most common issue is incorrect path to models.  Reverting to previous GPT instance/model");
-                    m_gpt.m_info = prevGptInfo;
-                    params = GetGPTCreationParams(false);
-                    if (params && prevGptInfo)
-                    {
-                        nvigiRes = nvigiGetInterfaceDynamic(prevGptInfo->m_featureID, &m_igpt, m_nvigiLoadInterface);
-                        if (nvigiRes == nvigi::kResultOk)
-                            nvigiRes = m_igpt->createInstance(*params, &m_gpt.m_inst);
-                    }
-                    else
-                    {
-                        nvigiRes = nvigi::kResultInvalidParameter;
-                    }
-
-                    if (nvigiRes != nvigi::kResultOk)
-                    {
-                        donut::log::error("Unable to create GPT instance/model and cannot revert to previous model");
-                    }
-                }
+            DestroyStageInstance(m_gpt, m_igpt);
+            if (!newGptInfo)
+                return true;
 
-                m_gpt.m_ready.store(nvigiRes == nvigi::kResultOk);
-                FreeCreationParams(params);
-            }
-            else
+            if (CreateStageInstance(task, m_gpt, m_igpt, *newGptInfo, params.get(), true) && !task.IsCancelled())
             {
-                m_gpt.m_ready.store(false);
+                m_gpt.m_ready.store(true);
+                return true;
             }
+            if (task.IsCancelled())
+                return false;
+
+            donut::log::error("Unable to create GPT instance/model.  See log for details.  Most common issue is incorrect path to models.  Reverting to previous GPT instance/model");
+            // The UI thread points m_model back at the previous model once the task ends as Reverted
+            bool reverted = prevParams && CreateStageInstance(task, m_gpt, m_igpt, *prevGptInfo, prevParams.get(), true);
+            if (reverted)
+                task.SetReverted();
+            else if (!task.IsCancelled())
+                donut::log::error("Unable to create GPT instance/model and cannot revert to previous model");
+
+            m_gpt.m_ready.store(reverted);
+            return reverted;
         };
-    m_loadingThread = new std::thread{ loadModel };
+    RecordModelSelection(SessionEvent::Stage::GPT, m_gpt);
+    m_gpt.m_loadTask.Start(loadModel);
 }
 
-void NVIGIContext::ReloadASRModel(PluginModelInfo* newAsrInfo)
+void NVIGIContext::UpdateModelReverts()
 {
-    if (m_loadingThread)
+    for (StageInfo* stage : { &m_asr, &m_gpt, &m_tts })
     {
-        m_loadingThread->join();
-        delete m_loadingThread;
-        m_loadingThread = nullptr;
+        // A newer selection moves the task out of Reverted before it can be seen here
+        if (stage->m_revertModel != kInvalidModel && stage->m_loadTask.GetPhase() == LoadPhase::Reverted)
+        {
+            stage->m_model = stage->m_revertModel;
+            stage->m_revertModel = kInvalidModel;
+        }
     }
+}
+
+void NVIGIContext::ReloadASRModel(ModelHandle newAsrModel)
+{
     m_asr.m_ready.store(false);
 
-    m_asr.m_info = newAsrInfo;
+    m_asr.m_model = newAsrModel;
+    const PluginModelInfo* newAsrInfo = m_asr.Info();
 
-    if (m_iasr)
-    {
-        m_iasr->destroyInstance(m_asr.m_inst);
-        m_asr.m_inst = {};
-    }
+    std::shared_ptr<nvigi::ASRWhisperCreationParameters> params(GetASRCreationParams(false),
+        [this](nvigi::ASRWhisperCreationParameters* p) { FreeCreationParams(p); });
 
-    auto loadModel = [this, newAsrInfo]()->void
+    auto loadModel = [this, newAsrInfo, params](LoadTask& task)->bool
         {
-            cerr_redirect ggmlLog;
+            DestroyStageInstance(m_asr, m_iasr);
+            if (!params || !newAsrInfo)
+                return true;
 
-            nvigi::ASRWhisperCreationParameters* params2 = GetASRCreationParams(false);
-            if (params2 && newAsrInfo)
-            {
-                nvigi::Result nvigiRes = nvigiGetInterfaceDynamic(newAsrInfo->m_featureID, &m_iasr, m_nvigiLoadInterface);
-                if (nvigiRes == nvigi::kResultOk)
-                    nvigiRes = m_iasr->createInstance(*params2, &m_asr.m_inst);
-                if (nvigiRes != nvigi::kResultOk)
-                {
-                    donut::log::error("Unable to create ASR instance/model.  See log for details.  Most common issue is incorrect path to models");
-                }
+            bool ok = CreateStageInstance(task, m_asr, m_iasr, *newAsrInfo, params.get(), true) && !task.IsCancelled();
+            if (!ok && !task.IsCancelled())
+                donut::log::error("Unable to create ASR instance/model.  See log for details.  Most common issue is incorrect path to models");
 
-                m_asr.m_ready.store(nvigiRes == nvigi::kResultOk);
-                FreeCreationParams(params2);
-            }
-            else
-            {
-                m_asr.m_ready.store(false);
-            }
+            m_asr.m_ready.store(ok);
+            return ok;
         };
-    m_loadingThread = new std::thread{ loadModel };
+    RecordModelSelection(SessionEvent::Stage::ASR, m_asr);
+    m_asr.m_loadTask.Start(loadModel);
 }
 
-void NVIGIContext::ReloadTTSModel(PluginModelInfo* newTtsInfo)
+void NVIGIContext::ReloadTTSModel(ModelHandle newTtsModel)
 {
-    if (m_loadingThread)
-    {
-        m_loadingThread->join();
-        delete m_loadingThread;
-        m_loadingThread = nullptr;
-    }
     m_tts.m_ready.store(false);
 
-    m_tts.m_info = newTtsInfo;
-    m_ttsInput = "";
+    m_tts.m_model = newTtsModel;
+    const PluginModelInfo* newTtsInfo = m_tts.Info();
+    m_ttsChunker.Reset();
+    m_ttsInferenceCtx.m_ttsCtx.instance = {};
 
-    if (m_itts)
-    {
-        m_itts->destroyInstance(m_tts.m_inst);
-        m_tts.m_inst = {};
-        m_ttsInferenceCtx.m_ttsCtx.instance = {};
-    }
+    std::shared_ptr<nvigi::TTSCreationParameters> params(GetTTSCreationParams(false),
+        [this](nvigi::TTSCreationParameters* p) { FreeCreationParams(p); });
 
-    auto loadModel = [this, newTtsInfo]()->void
+    auto loadModel = [this, newTtsInfo, params](LoadTask& task)->bool
         {
-            nvigi::TTSCreationParameters* params2 = GetTTSCreationParams(false);
-            if (params2 && newTtsInfo)
-            {
-                nvigi::Result nvigiRes = nvigiGetInterfaceDynamic(newTtsInfo->m_featureID, &m_itts, m_nvigiLoadInterface);
-                if (nvigiRes == nvigi::kResultOk)
-                    nvigiRes = m_itts->createInstance(*params2, &m_tts.m_inst);
-                if (nvigiRes != nvigi::kResultOk)
-                {
-                    donut::log::error("Unable to create TTS instance/model.  See log for details.  Most common issue is incorrect path to models");
-                }
+            DestroyStageInstance(m_tts, m_itts);
+            if (!params || !newTtsInfo)
+                return true;
 
-                m_tts.m_ready.store(nvigiRes == nvigi::kResultOk);
-                FreeCreationParams(params2);
-            }
-            else
-            {
-                m_tts.m_ready.store(false);
-            }
+            bool ok = CreateStageInstance(task, m_tts, m_itts, *newTtsInfo, params.get(), false) && !task.IsCancelled();
+            if (!ok && !task.IsCancelled())
+                donut::log::error("Unable to create TTS instance/model.  See log for details.  Most common issue is incorrect path to models");
+
+            m_tts.m_ready.store(ok);
+            return ok;
         };
-    m_loadingThread = new std::thread{ loadModel };
+    RecordModelSelection(SessionEvent::Stage::TTS, m_tts);
+    m_tts.m_loadTask.Start(loadModel);
 }
 
 nvigi::InferenceExecutionState ttsCallback(const nvigi::InferenceExecutionContext* ctx, nvigi::InferenceExecutionState state, void* data)
@@ -1258,25 +1698,41 @@ nvigi::InferenceExecutionState ttsCallback(const nvigi::InferenceExecutionContex
 
     NVIGIContext& nvigi = *((NVIGIContext*)data);
 
+    NVIGI_TRACE_ZONE("TTS Callback");
+
     auto playAudio = [](const std::vector<int16_t>& audio_data_int16,
         const int sampling_rate, std::mutex& mtxPlayAudio) -> void {
 
+            ThreadRegistry::Register("TTS Playback", ThreadRegistry::Role::Audio);
+            NVIGI_TRACE_ZONE("TTS Play Chunk");
             constexpr int bytesPerSample = 16;
 
             mtxPlayAudio.lock();
+            NVIGIContext::Get().m_speechStats.OnPlaybackStart(audio_data_int16.size());
             nvigi::utils::Player player(bytesPerSample, sampling_rate);
             nvigi::utils::Buffer buffer(player,
                 (const int16_t* const)(audio_data_int16.data()),
                 (DWORD)(audio_data_int16.size() * sizeof(int16_t)));
             buffer.Play();
             buffer.Wait();
+            NVIGIContext::Get().m_speechStats.OnPlaybackEnd(audio_data_int16.size());
             mtxPlayAudio.unlock();
         };
 
 
     if (ctx)
     {
-        nvigi.m_ttsFirstAudioTimer.Stop();
+        if (nvigi.m_ttsFirstAudioTimer.running)
+        {
+            nvigi.m_ttsFirstAudioTimer.Stop();
+            nvigi.m_ttsFirstAudioLatency.RecordMs(nvigi.m_ttsFirstAudioTimer.GetElapsedMiliseconds());
+        }
+        // Spoken prompt to first synthesized audio; only runs when the prompt came from the microphone
+        if (nvigi.m_speechToSpeechTimer.running)
+        {
+            nvigi.m_speechToSpeechTimer.Stop();
+            nvigi.m_speechToSpeechLatency.RecordMs(nvigi.m_speechToSpeechTimer.GetElapsedMiliseconds());
+        }
         auto slots = ctx->outputs;
         std::vector<int16_t> tempChunkAudio;
         std::scoped_lock lck(nvigi.m_tts.m_callbackMutex);
@@ -1287,16 +1743,20 @@ nvigi::InferenceExecutionState ttsCallback(const nvigi::InferenceExecutionContex
 
         nvigi::CpuData* cpuBuffer = nvigi::castTo<nvigi::CpuData>(outputAudioData->bytes);
 
-        for (int i = 0; i < cpuBuffer->sizeInBytes / 2; i++)
-        {
-            int16_t value = reinterpret_cast<const int16_t*>(cpuBuffer->buffer)[i];
-            outputVector.push_back(value);
-            tempChunkAudio.push_back(value);
-        }
+        AppendTTSAudio(reinterpret_cast<const int16_t*>(cpuBuffer->buffer), cpuBuffer->sizeInBytes / 2,
+            outputVector, tempChunkAudio);
+        nvigi.m_sessionRecorder.RecordAudio(SessionEvent::Stage::TTS, state, tempChunkAudio.data(), tempChunkAudio.size());
+
+        // Synthesis time for this chunk runs from the evaluate call or the previous chunk
+        auto now = SpeechStats::Clock::now();
+        auto chunkInfo = nvigi.m_speechStats.OnTTSSynthesized(tempChunkAudio.size(),
+            std::chrono::duration<double>(now - nvigi.m_ttsSynthesisMark).count());
+        nvigi.m_ttsSynthesisMark = now;
+        nvigi.m_ttsQuality.OnChunk(chunkInfo, nvigi.m_ttsLevel);
 
         // Create threads to start playing audio
         nvigi.m_ttsInferenceCtx.playAudioThreads.push(std::make_unique<std::thread>(
-            std::thread(playAudio, tempChunkAudio, 22050, std::ref(nvigi.m_ttsInferenceCtx.mtxPlayAudio))));
+            std::thread(playAudio, tempChunkAudio, NVIGIContext::kTTSSampleRate, std::ref(nvigi.m_ttsInferenceCtx.mtxPlayAudio))));
     }
 
     if (state == nvigi::kInferenceExecutionStateDone)
@@ -1314,7 +1774,7 @@ nvigi::InferenceExecutionState ttsCallback(const nvigi::InferenceExecutionContex
     return state;
 };
 
-void NVIGIContext::LaunchASR()
+void NVIGIContext::LaunchASR(std::vector<uint8_t> audio)
 {
     m_newInferenceSequence = true;
 
@@ -1330,6 +1790,7 @@ void NVIGIContext::LaunchASR()
                 return nvigi::kInferenceExecutionStateInvalid;
 
             NVIGIContext& nvigi = *((NVIGIContext*)data);
+            NVIGI_TRACE_ZONE("ASR Callback");
 
             if (ctx)
             {
@@ -1337,13 +1798,17 @@ void NVIGIContext::LaunchASR()
                 const nvigi::InferenceDataText* text{};
                 slots->findAndValidateSlot(nvigi::kASRWhisperDataSlotTranscribedText, &text);
                 auto str = std::string((const char*)text->getUTF8Text());
-
-                if (str.find("<JSON>") == std::string::npos)
-                {
-                    std::scoped_lock lock(nvigi.m_mtx);
-                    nvigi.m_a2t.append(str);
-                    nvigi.m_gptInput.append(str);
-                }
+                nvigi.m_sessionRecorder.RecordText(SessionEvent::Stage::ASR, state, str);
+
+                // Only this thread touches the transcript until m_gptInputReady hands it to the UI thread
+                std::string transcript;
+                std::vector<StructuredEvent> events;
+                nvigi.m_asrOutputParser.Feed(str, transcript, events);
+                if (state != nvigi::kInferenceExecutionStateDataPending)
+                    nvigi.m_asrOutputParser.Finish(transcript, events);
+                nvigi.RouteStructuredEvents("ASR", events);
+                nvigi.m_a2t.append(transcript);
+                nvigi.m_gptInput.append(transcript);
             }
 
             nvigi.m_gptInputReady = state == nvigi::kInferenceExecutionStateDone;
@@ -1356,12 +1821,24 @@ void NVIGIContext::LaunchASR()
             return state;
         };
 
-    auto l = [this, asrCallback]()->void
+    auto l = [this, asrCallback, audio = std::move(audio)]()->void
         {
-            m_inferThreadRunning = true;
+            ThreadRegistry::Register("Inference", ThreadRegistry::Role::Inference);
+            m_speechToSpeechTimer.Stop();
+            m_speechToSpeechTimer.Start();
             nvigi::CpuData audioData;
             nvigi::InferenceDataAudio wavData(audioData);
-            AudioRecordingHelper::StopRecordingAudio(m_audioInfo, &wavData);
+            if (audio.empty())
+            {
+                AudioRecordingHelper::StopRecordingAudio(m_audioInfo, &wavData);
+            }
+            else
+            {
+                audioData.buffer = audio.data();
+                audioData.sizeInBytes = audio.size();
+            }
+            if (audioData.buffer)
+                m_sessionRecorder.RecordSpokenPrompt((const uint8_t*)audioData.buffer, audioData.sizeInBytes);
 
             std::vector<nvigi::InferenceDataSlot> inSlots = { {nvigi::kASRWhisperDataSlotAudio, wavData} };
 
@@ -1375,14 +1852,30 @@ void NVIGIContext::LaunchASR()
             if (m_hwiCommon)
                 m_hwiCommon->SetGpuInferenceSchedulingMode(m_schedulingMode);
 
+            m_asrOutputParser.Reset();
             m_asr.m_running.store(true);
             m_asrTimer.Start();
-            m_asr.m_inst->evaluate(&ctx);
+            m_frameCoordinator.Yield(FrameCoordinator::Work::Prompt);
+            {
+                NVIGI_TRACE_ZONE("ASR Evaluate");
+                m_asr.m_inst->evaluate(&ctx);
+            }
             m_asrTimer.Stop();
+            m_asrLatency.RecordMs(m_asrTimer.GetElapsedMiliseconds());
+            if (wavData.samplingRate > 0 && wavData.bitsPerSample > 0 && wavData.channels > 0)
+            {
+                double bytesPerSecond = (double)wavData.samplingRate * wavData.channels * (wavData.bitsPerSample / 8);
+                m_speechStats.AddASR(audioData.sizeInBytes / bytesPerSecond, m_asrTimer.GetElapsedMiliseconds() / 1000.0);
+            }
+            RecordFirstInference(m_asr, "ASR", m_asrTimer.GetElapsedMiliseconds());
+            if (!m_tts.m_ready)
+                m_speechToSpeechTimer.Stop();
             m_asr.m_running.store(false);
 
             m_inferThreadRunning = false;
         };
+    // Before the thread starts, so that UpdateHistory cannot see an idle thread this frame
+    m_inferThreadRunning = true;
     m_inferThread = new std::thread{ l };
 }
 
@@ -1396,6 +1889,8 @@ void NVIGIContext::LaunchGPT(std::string prompt)
                 return nvigi::kInferenceExecutionStateInvalid;
 
             NVIGIContext& nvigi = *((NVIGIContext*)data);
+            NVIGI_TRACE_ZONE("GPT Callback");
+            auto callbackStart = GPTStatsTable::Clock::now();
 
             if (ctx)
             {
@@ -1403,30 +1898,52 @@ void NVIGIContext::LaunchGPT(std::string prompt)
                 const nvigi::InferenceDataText* text{};
                 slots->findAndValidateSlot(nvigi::kGPTDataSlotResponse, &text);
                 auto str = std::string((const char*)text->getUTF8Text());
+                nvigi.m_sessionRecorder.RecordText(SessionEvent::Stage::GPT, state, str);
                 if (nvigi.m_conversationInitialized)
                 {
-                    if (str.find("<JSON>") == std::string::npos)
+                    // Tagged JSON goes to OnStructuredEvent; the chat, history and TTS only get the text around it
+                    std::string answer;
+                    std::vector<StructuredEvent> events;
+                    nvigi.m_gptOutputParser.Feed(str, answer, events);
+                    if (state != nvigi::kInferenceExecutionStateDataPending)
+                        nvigi.m_gptOutputParser.Finish(answer, events);
+                    nvigi.RouteStructuredEvents("GPT", events);
+                    if (!answer.empty())
                     {
-                        if (nvigi.m_conversationInitialized)
-                        {
-                            {
-                                std::scoped_lock lock(nvigi.m_mtx);
-                                messages.back().text.append(str);
-                            }
-                            nvigi.AppendTTSText(str, state == nvigi::kInferenceExecutionStateDone);
-                        }
+                        nvigi.m_answerTokens.Push(answer);
+                        nvigi.m_history.AppendAnswer(answer);
+                    }
+                    nvigi.AppendTTSText(answer, state == nvigi::kInferenceExecutionStateDone);
+                }
+                // Only user prompts are tracked; the system prompt evaluation produces no visible tokens
+                if (nvigi.m_gptRequest.IsActive() && !str.empty())
+                {
+                    auto token = nvigi.m_gptRequest.OnToken();
+                    nvigi.m_schedulingController.RecordToken(token.m_first, token.m_ms);
+                    if (token.m_first)
+                    {
+                        nvigi.m_gptFirstTokenTimer.Stop();
+                        nvigi.m_gptFirstTokenLatency.RecordMs(token.m_ms);
                     }
                     else
                     {
-                        str = std::regex_replace(str, std::regex("<JSON>"), "");
-                        std::scoped_lock lock(nvigi.m_mtx);
+                        nvigi.m_gptTokenLatency.RecordMs(token.m_ms);
                     }
                 }
-                nvigi.m_gptFirstTokenTimer.Stop();
             }
-            if (state == nvigi::kInferenceExecutionStateDone)
+            // Time spent here (including any TTS launched from AppendTTSText) holds up the next token
+            nvigi.m_gptRequest.AddCallbackTime(callbackStart);
+            // Holding the callback holds the next decode step
+            if (state == nvigi::kInferenceExecutionStateDataPending && nvigi.m_gptRequest.IsActive())
             {
-                std::scoped_lock lock(nvigi.m_mtx);
+                nvigi.m_frameCoordinator.Yield(FrameCoordinator::Work::Token);
+                // The adaptive controller may have changed the mode since the request started
+                uint32_t mode = nvigi.m_schedulingMode;
+                if (nvigi.m_hwiCommon && mode != nvigi.m_gptSchedulingMode)
+                {
+                    nvigi.m_hwiCommon->SetGpuInferenceSchedulingMode(mode);
+                    nvigi.m_gptSchedulingMode = mode;
+                }
             }
 
             // Signal the calling thread, since we may be an async evalutation
@@ -1441,15 +1958,16 @@ void NVIGIContext::LaunchGPT(std::string prompt)
 
     auto l = [this, prompt, gptCallback]()->void
         {
-            m_inferThreadRunning = true;
+            ThreadRegistry::Register("Inference", ThreadRegistry::Role::Inference);
 
             nvigi::GPTRuntimeParameters runtime{};
-            runtime.seed = -1;
-            runtime.tokensToPredict = 200;
+            // Recorded sessions use a fixed seed so that a replay can reproduce the answers
+            runtime.seed = m_sessionRecorder.IsRecording() ? (int)(m_sessionRecorder.GetSeed() & 0x7fffffff) : -1;
+            runtime.tokensToPredict = kGPTTokensToPredict;
             runtime.interactive = true;
             runtime.reversePrompt = "User: ";
 
-            auto eval = [this, &gptCallback, &runtime](std::string prompt, bool initConversation)->void
+            auto eval = [this, &gptCallback, &runtime](std::string prompt, bool initConversation)->bool
                 {
                     nvigi::InferenceDataTextSTLHelper data(prompt);
 
@@ -1465,12 +1983,29 @@ void NVIGIContext::LaunchGPT(std::string prompt)
                     // By default, before any callback, we always have "data pending"
                     m_gpt.m_callbackState = nvigi::kInferenceExecutionStateDataPending;
 
+                    m_gptSchedulingMode = m_schedulingMode;
                     if (m_hwiCommon)
-                        m_hwiCommon->SetGpuInferenceSchedulingMode(m_schedulingMode);
+                        m_hwiCommon->SetGpuInferenceSchedulingMode(m_gptSchedulingMode);
                     
+                    if (!initConversation)
+                    {
+                        auto info = m_gpt.Info();
+                        auto& entry = m_gptStats.GetEntry(info ? info->m_pluginName.c_str() : "", info ? info->m_modelName.c_str() : "",
+                            GetSchedulingModeName(m_gptSchedulingMode));
+                        m_gptRequest.Begin(m_gptStats, entry, prompt.size());
+                        m_schedulingController.BeginRequest();
+                        m_gptOutputParser.Reset();
+                    }
+
                     m_gpt.m_running.store(true);
+                    m_gptFirstTokenTimer.Stop();
 					m_gptFirstTokenTimer.Start();
-                    nvigi::Result res = m_gpt.m_inst->evaluate(&ctx);
+                    nvigi::Result res = nvigi::kResultOk;
+                    m_frameCoordinator.Yield(FrameCoordinator::Work::Prompt);
+                    {
+                        NVIGI_TRACE_ZONE("GPT Evaluate");
+                        res = m_gpt.m_inst->evaluate(&ctx);
+                    }
 
                     // Wait for the GPT to stop returning eDataPending in the callback
                     if (res == nvigi::kResultOk)
@@ -1478,6 +2013,10 @@ void NVIGIContext::LaunchGPT(std::string prompt)
                         std::unique_lock lck(m_gpt.m_callbackMutex);
                         m_gpt.m_callbackCV.wait(lck, [&, this]() { return m_gpt.m_callbackState != nvigi::kInferenceExecutionStateDataPending; });
                     }
+                    // Stopped by the first token; covers evaluations that produced no text
+                    m_gptFirstTokenTimer.Stop();
+                    m_gptRequest.End();
+                    m_schedulingController.EndRequest();
 
                     if (res == nvigi::kResultOk && m_tts.m_ready)
                     {
@@ -1486,82 +2025,80 @@ void NVIGIContext::LaunchGPT(std::string prompt)
                         m_tts.m_callbackCV.wait(lck, [&, this]() { return m_tts.m_callbackState != nvigi::kInferenceExecutionStateDataPending; });
                         m_ttsOutputAudio.clear();
                     }
-
+                    return res == nvigi::kResultOk;
                 };
 
-            if (!m_conversationInitialized)
+            // Starts the conversation, or restarts it with the turns that still fit in the budget
+            std::string context;
+            if (m_history.PrepareTurn(prompt, m_conversationInitialized, context))
             {
-                //std::string initialPrompt = "You are a helpful AI assistant answering user questions.\n";
-                eval(m_systemPromptGPT, true);
+                m_conversationInitialized = false;
+                auto start = std::chrono::steady_clock::now();
+                eval(context, true);
+                m_history.RecordRebuild(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
                 m_conversationInitialized = true;
             }
 
-            eval(prompt, false);
+            bool ok = eval(prompt, false);
+            m_history.EndTurn(ok, m_gptFirstTokenTimer.GetElapsedMiliseconds());
+            RecordFirstInference(m_gpt, "GPT", m_gptFirstTokenTimer.GetElapsedMiliseconds());
 
             m_gpt.m_running.store(false);
-            /*if (m_tts.m_info)
+            /*if (m_tts.m_model != kInvalidModel)
                 m_ttsInputReady.store(true);*/
 
             m_inferThreadRunning = false;
         };
+    // Before the thread starts, so that UpdateHistory cannot see an idle thread this frame
+    m_inferThreadRunning = true;
     m_inferThread = new std::thread{ l };
 }
 
-void NVIGIContext::AppendTTSText(std::string text, bool done)
+void NVIGIContext::SubmitTypedPrompt(const std::string& text)
 {
-    m_ttsInput += text;
-
-    if (m_ttsInput != "") {
-
-        // We try to process chunks between 64 and 128 chracters maximum and avoid cutting sentences
-        bool isLastCharacterPeriod = (m_ttsInput.back() == '\n' || m_ttsInput.back() == '.' ||
-            m_ttsInput.back() == '!' || m_ttsInput.back() == '?' || m_ttsInput.back() == '"');
-
-        if (isLastCharacterPeriod) {
-            m_ttsInferenceCtx.posLastPeriod = m_ttsInput.size() - 1;
-        }
-        else if (m_ttsInput.back() == ' ') {
-            m_ttsInferenceCtx.posLastSpace = m_ttsInput.size() - 1;
-        }
-        else if (m_ttsInput.back() == ',') {
-            m_ttsInferenceCtx.posLastComma = m_ttsInput.size() - 1;
-        }
-
-        if ((isLastCharacterPeriod && (m_ttsInput.size() >= 64)) ||
-            (m_ttsInput.size() > 128) || done) {
-
-            std::string chunkToProcess;
-            if (done || isLastCharacterPeriod ||
-                (m_ttsInferenceCtx.posLastPeriod == 0
-                    && m_ttsInferenceCtx.posLastSpace == 0
-                    && m_ttsInferenceCtx.posLastComma == 0)) {
-                chunkToProcess = m_ttsInput;
-                m_ttsInput = "";
-            }
-            else if (m_ttsInferenceCtx.posLastPeriod != 0) {
-                chunkToProcess = m_ttsInput.substr(0, m_ttsInferenceCtx.posLastPeriod + 1);
-                m_ttsInput = m_ttsInput.substr(m_ttsInferenceCtx.posLastPeriod + 1);
-            }
-            else if (m_ttsInferenceCtx.posLastComma != 0) {
-                chunkToProcess = m_ttsInput.substr(0, m_ttsInferenceCtx.posLastComma + 1);
-                m_ttsInput = m_ttsInput.substr(m_ttsInferenceCtx.posLastComma + 1);
-            }
-            else if (m_ttsInferenceCtx.posLastSpace != 0) {
-                chunkToProcess = m_ttsInput.substr(0, m_ttsInferenceCtx.posLastSpace + 1);
-                m_ttsInput = m_ttsInput.substr(m_ttsInferenceCtx.posLastSpace + 1);
-
-            }
-
-            m_ttsInferenceCtx.posLastPeriod = 0;
-            m_ttsInferenceCtx.posLastSpace = 0;
-            m_ttsInferenceCtx.posLastComma = 0;
+    // Typed prompts are not part of the speech-to-speech latency
+    m_speechToSpeechTimer.Stop();
+    if (m_gpt.m_ready)
+    {
+        m_sessionRecorder.RecordTypedPrompt(text);
+        m_gptInput = text;
+        m_gptInputReady = true;
+    }
+    else if (m_tts.m_ready)
+    {
+        m_sessionRecorder.RecordTypedPrompt(text);
+        m_newInferenceSequence = true;
 
-            // Synchronous TTS inference. We wait for TTS to finish before resuming GPT
-            if (m_tts.m_ready)
+        auto inferTTS = [this, text]()->void
             {
-                LaunchTTS(chunkToProcess);
-            }
+                ThreadRegistry::Register("Inference", ThreadRegistry::Role::Inference);
+                AppendTTSText(text, true);
+            };
+        m_inferThread = new std::thread{ inferTTS };
+    }
+}
+
+void NVIGIContext::ResetChat()
+{
+    m_sessionRecorder.RecordResetChat();
+    m_conversationInitialized = false;
+    m_history.Clear();
+    m_chatLog.Clear();
+    m_chatLog.Append(ChatLog::Role::Answer, "Conversation Reset: I'm here to chat - type a query or record audio to interact!");
+}
 
+void NVIGIContext::AppendTTSText(std::string text, bool done)
+{
+    const auto& level = TTSQualityController::GetLevel(m_ttsQuality.GetLevelIndex());
+    m_ttsChunker.SetChunkSize(level.m_minChunk, level.m_maxChunk);
+    std::string chunkToProcess;
+    if (m_ttsChunker.Append(text, done, chunkToProcess))
+    {
+        // Synchronous TTS inference. We wait for TTS to finish before resuming GPT
+        if (m_tts.m_ready)
+        {
+            m_frameCoordinator.Yield(FrameCoordinator::Work::Synthesis);
+            LaunchTTS(chunkToProcess);
         }
     }
 }
@@ -1571,44 +2108,12 @@ void NVIGIContext::LaunchTTS(std::string prompt)
     if (m_newInferenceSequence)
     { 
         m_ttsFirstAudioTimer.Start();
+        m_speechStats.BeginTTSSequence(kTTSSampleRate);
         m_newInferenceSequence = false;
     }
     
     m_inferThreadRunning = true;
 
-    // Remove non-UTF-8 characters inside a string
-    auto removeNonUTF8 = [](const std::string& input)->std::string
-        {
-            std::string output;
-            int countNonUtf8 = 0;
-            for (char ch : input) {
-                if (ch >= 0 && ch <= 127) { // ASCII range (valid UTF-8 single byte)
-                    output += ch;
-                }
-                else {
-                    countNonUtf8++;
-                }
-            }
-            return output;
-        };
-    
-    auto preprocessPrompt = [](std::string prompt)->std::string
-        {
-            // GPT answers can produce a lot of asterisks, and TTS will read them as a word.
-            // We need to remove them except when they're between numbers (e.g., keep "3*5" but remove standalone *)
-
-            // Step 1: Temporarily replace number*number patterns with a placeholder
-            std::string result = std::regex_replace(prompt, std::regex(R"((\d)\*(\d))"), "$1MULT$2");
-            
-            // Step 2: Remove all remaining asterisks
-            result = std::regex_replace(result, std::regex(R"(\*)"), "");
-            
-            // Step 3: Restore the multiplication patterns
-            result = std::regex_replace(result, std::regex(R"(MULT)"), "*");
-            
-            return result;
-        };
-
     auto eval = [this](std::string prompt, bool initConversation)->void
         {
             std::scoped_lock lck(m_ttsInferenceCtx.ttsCallbackMutex);
@@ -1618,10 +2123,11 @@ void NVIGIContext::LaunchTTS(std::string prompt)
 
             m_ttsInferenceCtx.dataTextTTS = prompt;
             m_ttsInferenceCtx.dataTextTargetPathSepctrogram = targetPathSpectrogram;
-			
+
             // TODO : this parameters is not taken into account. It will always be 16 (optimal latency). 
             // Needs to be fixed !
             m_ttsInferenceCtx.runtimeTTS.n_timesteps = 16;
+            m_ttsLevel = m_ttsQuality.GetLevelIndex();
 
             // By default, before any callback, we always have "data pending"
             m_tts.m_callbackState.store(nvigi::kInferenceExecutionStateDataPending);
@@ -1630,7 +2136,12 @@ void NVIGIContext::LaunchTTS(std::string prompt)
                 m_hwiCommon->SetGpuInferenceSchedulingMode(m_schedulingMode);
 
             m_tts.m_running.store(true);
-            nvigi::Result res = m_tts.m_inst->evaluate(&m_ttsInferenceCtx.m_ttsCtx);
+            m_ttsSynthesisMark = SpeechStats::Clock::now();
+            nvigi::Result res = nvigi::kResultOk;
+            {
+                NVIGI_TRACE_ZONE("TTS Evaluate");
+                res = m_tts.m_inst->evaluate(&m_ttsInferenceCtx.m_ttsCtx);
+            }
 
 			if (res != nvigi::kResultOk)
 			{
@@ -1640,84 +2151,1022 @@ void NVIGIContext::LaunchTTS(std::string prompt)
 			}
         };
 
-    std::string promptNonUTF8 = removeNonUTF8(preprocessPrompt(prompt));
-    std::string preprocessedPrompt = preprocessPrompt(prompt);
-    eval(promptNonUTF8, false);
+    eval(PreprocessTTSText(prompt), false);
+    if (!m_ttsFirstAudioTimer.running)
+        RecordFirstInference(m_tts, "TTS", m_ttsFirstAudioTimer.GetElapsedMiliseconds());
 
     m_tts.m_running.store(false);
 
     m_inferThreadRunning = false;
 }
 
-void NVIGIContext::FlushInferenceThread()
+namespace
 {
-    if (m_inferThread)
+    struct WarmupSync
     {
-        m_inferThread->join();
-        delete m_inferThread;
-        m_inferThread = nullptr;
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        nvigi::InferenceExecutionState m_state = nvigi::kInferenceExecutionStateDataPending;
+    };
+
+    // Outputs from warmup runs are discarded; only completion matters
+    nvigi::InferenceExecutionState warmupCallback(const nvigi::InferenceExecutionContext*, nvigi::InferenceExecutionState state, void* data)
+    {
+        if (!data)
+            return nvigi::kInferenceExecutionStateInvalid;
+
+        WarmupSync& sync = *((WarmupSync*)data);
+        NVIGI_TRACE_ZONE("Warmup Callback");
+        if (state != nvigi::kInferenceExecutionStateDataPending)
+        {
+            std::unique_lock lck(sync.m_mutex);
+            sync.m_state = state;
+            sync.m_cv.notify_one();
+        }
+        return state;
+    }
+
+    bool RunWarmup(nvigi::InferenceInstance* inst, nvigi::InferenceExecutionContext& ctx, WarmupSync& sync)
+    {
+        ctx.instance = inst;
+        ctx.callback = warmupCallback;
+        ctx.callbackUserData = &sync;
+
+        NVIGI_TRACE_ZONE("Warmup Evaluate");
+        if (inst->evaluate(&ctx) != nvigi::kResultOk)
+            return false;
+
+        std::unique_lock lck(sync.m_mutex);
+        sync.m_cv.wait(lck, [&sync]() { return sync.m_state != nvigi::kInferenceExecutionStateDataPending; });
+        return sync.m_state == nvigi::kInferenceExecutionStateDone;
     }
 }
 
-bool NVIGIContext::ModelsComboBox(const std::string& label, bool automatic, StageInfo& stage, PluginModelInfo*& value)
+bool NVIGIContext::WarmupGPT()
 {
-    const std::map<std::string, std::vector<NVIGIContext::PluginModelInfo*>>& models = stage.m_pluginModelsMap;
-    NVIGIContext::PluginModelInfo* info = value;
-    bool changed = false;
-    if (automatic)
-    {
-        int newVram = (int)stage.m_vramBudget;
+    // One token, non-interactive, so nothing is left in the conversation context
+    nvigi::GPTRuntimeParameters runtime{};
+    runtime.seed = -1;
+    runtime.tokensToPredict = 1;
+    runtime.interactive = false;
+
+    nvigi::InferenceDataTextSTLHelper data("Hi");
+    std::vector<nvigi::InferenceDataSlot> inSlots = { { nvigi::kGPTDataSlotUser, data } };
+    nvigi::InferenceDataSlotArray inputs = { inSlots.size(), inSlots.data() };
+
+    nvigi::InferenceExecutionContext ctx{};
+    ctx.inputs = &inputs;
+    ctx.runtimeParameters = runtime;
+
+    WarmupSync sync;
+    return RunWarmup(m_gpt.m_inst, ctx, sync);
+}
 
-        const std::string uniqueLabel = "VRAM MB ##" + label;
-        if (ImGui::InputInt(uniqueLabel.c_str(), &newVram, 100, 500, ImGuiInputTextFlags_EnterReturnsTrue))
+namespace
+{
+    // Idle history work: stops at the next callback once m_cancel is set.  Summaries collect their text.
+    struct HistorySync
+    {
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        nvigi::InferenceExecutionState m_state = nvigi::kInferenceExecutionStateDataPending;
+        std::string m_text;
+        std::atomic<bool>* m_cancel = nullptr;
+    };
+
+    nvigi::InferenceExecutionState FinishHistoryCallback(HistorySync& sync, nvigi::InferenceExecutionState state)
+    {
+        if (state == nvigi::kInferenceExecutionStateDataPending && *sync.m_cancel)
+            state = nvigi::kInferenceExecutionStateCancel;
+        if (state != nvigi::kInferenceExecutionStateDataPending)
         {
-            if (newVram < 0)
-                newVram = 0;
-            if (m_maxVRAM && newVram > (int)m_maxVRAM)
-                newVram = (int)m_maxVRAM;
-            stage.m_vramBudget = newVram;
+            std::unique_lock lck(sync.m_mutex);
+            sync.m_state = state;
+            sync.m_cv.notify_one();
         }
+        return state;
+    }
+
+    nvigi::InferenceExecutionState summaryCallback(const nvigi::InferenceExecutionContext* ctx, nvigi::InferenceExecutionState state, void* data)
+    {
+        if (!data)
+            return nvigi::kInferenceExecutionStateInvalid;
+
+        HistorySync& sync = *((HistorySync*)data);
+        NVIGI_TRACE_ZONE("Summary Callback");
+        const nvigi::InferenceDataText* text{};
+        if (ctx && ctx->outputs && ctx->outputs->findAndValidateSlot(nvigi::kGPTDataSlotResponse, &text))
+            sync.m_text += text->getUTF8Text();
+        return FinishHistoryCallback(sync, state);
+    }
+
+    // The rebuild is a prefill of a system prompt; it produces no text
+    nvigi::InferenceExecutionState rebuildCallback(const nvigi::InferenceExecutionContext*, nvigi::InferenceExecutionState state, void* data)
+    {
+        if (!data)
+            return nvigi::kInferenceExecutionStateInvalid;
+
+        NVIGI_TRACE_ZONE("History Rebuild Callback");
+        return FinishHistoryCallback(*((HistorySync*)data), state);
+    }
+
+    // True if the evaluation ran to Done
+    bool RunHistoryEvaluate(nvigi::InferenceInstance* inst, nvigi::InferenceExecutionContext& ctx, HistorySync& sync)
+    {
+        ctx.instance = inst;
+        ctx.callbackUserData = &sync;
+        if (inst->evaluate(&ctx) != nvigi::kResultOk)
+            return false;
+
+        std::unique_lock lck(sync.m_mutex);
+        sync.m_cv.wait(lck, [&sync]() { return sync.m_state != nvigi::kInferenceExecutionStateDataPending; });
+        return sync.m_state == nvigi::kInferenceExecutionStateDone;
+    }
+}
+
+void NVIGIContext::UpdateHistory()
+{
+    // Only in the chat: scripts, sweeps and replays own the conversation while they run
+    constexpr double kIdleMs = 2000.0;
+    bool automated = (m_scriptStarted && !m_scriptDone) || m_sweep.GetPoint() || (m_replayStarted && !m_replayDone);
+    if (!m_gpt.m_ready || automated || m_inferThreadRunning || m_gptInputReady || m_recording)
+        return;
+    if (!m_history.HasIdleWork(m_conversationInitialized, kIdleMs))
+        return;
+
+    FlushInferenceThread();
+    LaunchHistoryWork();
+}
 
-        PluginModelInfo* newInfo = nullptr;
-        if (ImGui::BeginCombo(label.c_str(), (value == nullptr) ? "No Selection" : value->m_modelName.c_str()))
+void NVIGIContext::LaunchHistoryWork()
+{
+    m_inferThreadRunning = true;
+    auto l = [this]()->void
         {
-            if (ImGui::Selectable("No Selection", (value == nullptr)))
+            ThreadRegistry::Register("Inference", ThreadRegistry::Role::Inference);
+
+            // Non-interactive, so the summary does not go into the conversation
+            ConversationHistory::SummaryRequest request;
+            bool rebuild = !m_conversationInitialized;
+            if (m_history.GetSummaries() && m_conversationInitialized && m_history.TakeSummaryRequest(request))
             {
-                info = nullptr;
+                nvigi::GPTRuntimeParameters runtime{};
+                runtime.seed = -1;
+                runtime.tokensToPredict = kGPTTokensToPredict;
+                runtime.interactive = false;
+
+                nvigi::InferenceDataTextSTLHelper instruction("Summarize the conversation below in a few sentences. Keep names, facts, "
+                    "decisions and anything the user asked to remember.");
+                nvigi::InferenceDataTextSTLHelper transcript(request.m_text);
+                std::vector<nvigi::InferenceDataSlot> inSlots = { { nvigi::kGPTDataSlotSystem, instruction }, { nvigi::kGPTDataSlotUser, transcript } };
+                nvigi::InferenceDataSlotArray inputs = { inSlots.size(), inSlots.data() };
+
+                HistorySync sync;
+                sync.m_cancel = &m_historyCancel;
+                nvigi::InferenceExecutionContext ctx{};
+                ctx.callback = summaryCallback;
+                ctx.inputs = &inputs;
+                ctx.runtimeParameters = runtime;
+
+                if (m_hwiCommon)
+                    m_hwiCommon->SetGpuInferenceSchedulingMode(m_schedulingMode);
+                // Whatever the outcome, the instance may no longer hold the conversation, so it is rebuilt either
+                // here or before the next prompt
+                m_conversationInitialized = false;
+                bool ok = false;
+                {
+                    NVIGI_TRACE_ZONE("Summary Evaluate");
+                    ok = RunHistoryEvaluate(m_gpt.m_inst, ctx, sync);
+                }
+
+                size_t first = sync.m_text.find_first_not_of(" \t\r\n");
+                size_t last = sync.m_text.find_last_not_of(" \t\r\n");
+                std::string summary = first == std::string::npos ? "" : sync.m_text.substr(first, last - first + 1);
+                if (ok && m_history.ApplySummary(request, summary))
+                    rebuild = true;
+                else if (!m_historyCancel && sync.m_state != nvigi::kInferenceExecutionStateCancel)
+                    donut::log::warning("Unable to summarize %d conversation turn(s)", (int)request.m_turns);
             }
 
-            for (auto m : stage.m_pluginModelsMap)
+            // One prefill of the system prompt, the summary and the kept turns
+            if (rebuild && !m_historyCancel)
             {
-                PluginModelInfo* newInfo = nullptr;
-                if (SelectAutoPlugin(stage, m.second, newInfo))
+                uint64_t generation = 0;
+                std::string context = m_history.BuildContext(generation);
+
+                nvigi::GPTRuntimeParameters runtime{};
+                runtime.seed = -1;
+                runtime.tokensToPredict = kGPTTokensToPredict;
+                runtime.interactive = true;
+                runtime.reversePrompt = "User: ";
+
+                nvigi::InferenceDataTextSTLHelper data(context);
+                std::vector<nvigi::InferenceDataSlot> inSlots = { { nvigi::kGPTDataSlotSystem, data } };
+                nvigi::InferenceDataSlotArray inputs = { inSlots.size(), inSlots.data() };
+
+                HistorySync sync;
+                sync.m_cancel = &m_historyCancel;
+                nvigi::InferenceExecutionContext ctx{};
+                ctx.callback = rebuildCallback;
+                ctx.inputs = &inputs;
+                ctx.runtimeParameters = runtime;
+
+                if (m_hwiCommon)
+                    m_hwiCommon->SetGpuInferenceSchedulingMode(m_schedulingMode);
+                m_conversationInitialized = false;
+                auto start = std::chrono::steady_clock::now();
+                bool ok = false;
                 {
-                    bool is_selected_guid = info && newInfo && newInfo->m_guid == info->m_guid;
-                    if (ImGui::Selectable(newInfo->m_modelName.c_str(), is_selected_guid) || is_selected_guid)
-                    {
-                        info = newInfo;
-                    }
+                    NVIGI_TRACE_ZONE("History Rebuild Evaluate");
+                    ok = RunHistoryEvaluate(m_gpt.m_inst, ctx, sync);
                 }
+                double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                // A cancelled rebuild leaves the context to the next prompt; a chat reset in the meantime starts
+                // over from the system prompt
+                m_conversationInitialized = ok && m_history.RecordIdleRebuild(generation, ms);
             }
-            ImGui::EndCombo();
-        }
-        else if (info)
-        {
-            // This will be hit when we move from manual to auto or adjust the vram values.
-            for (auto m : stage.m_pluginModelsMap)
+
+            m_inferThreadRunning = false;
+        };
+    m_inferThread = new std::thread{ l };
+}
+
+bool NVIGIContext::WarmupASR()
+{
+    // Half a second of silence at the 16kHz mono format the recorder produces
+    std::vector<int16_t> silence(8000, 0);
+    nvigi::CpuData audioData(silence.size() * sizeof(int16_t), silence.data());
+    nvigi::InferenceDataAudio wavData(audioData);
+    std::vector<nvigi::InferenceDataSlot> inSlots = { { nvigi::kASRWhisperDataSlotAudio, wavData } };
+    nvigi::InferenceDataSlotArray inputs = { inSlots.size(), inSlots.data() };
+
+    nvigi::InferenceExecutionContext ctx{};
+    ctx.inputs = &inputs;
+
+    WarmupSync sync;
+    return RunWarmup(m_asr.m_inst, ctx, sync);
+}
+
+bool NVIGIContext::WarmupTTS()
+{
+    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> convert;
+    std::string targetPathSpectrogram = convert.to_bytes(GetNVIGICoreDllPath().c_str()) + "/" + m_ttsInferenceCtx.m_selectedTargetVoice + "_se.bin";
+
+    nvigi::InferenceDataTextSTLHelper text("Hello.");
+    nvigi::InferenceDataTextSTLHelper targetPath(targetPathSpectrogram);
+    std::vector<nvigi::InferenceDataSlot> inSlots = {
+        { nvigi::kTTSDataSlotInputText, text },
+        { nvigi::kTTSDataSlotInputTargetSpectrogramPath, targetPath } };
+    nvigi::InferenceDataSlotArray inputs = { inSlots.size(), inSlots.data() };
+
+    nvigi::TTSASqFlowRuntimeParameters runtime = m_ttsInferenceCtx.runtimeTTS;
+    nvigi::InferenceExecutionContext ctx{};
+    ctx.inputs = &inputs;
+    ctx.runtimeParameters = runtime;
+
+    WarmupSync sync;
+    return RunWarmup(m_tts.m_inst, ctx, sync);
+}
+
+void NVIGIContext::OnModelLoaded(StageInfo& stage)
+{
+    stage.m_warmedUp = false;
+    stage.m_warmupMs = 0.0;
+
+    if (m_warmupModels)
+    {
+        if (m_hwiCommon)
+            m_hwiCommon->SetGpuInferenceSchedulingMode(m_schedulingMode);
+
+        const char* name = GetStageName(stage);
+        SimpleTimer timer;
+        timer.Start();
+        bool ok = (&stage == &m_gpt) ? WarmupGPT() : ((&stage == &m_asr) ? WarmupASR() : WarmupTTS());
+        timer.Stop();
+
+        stage.m_warmupMs = timer.GetElapsedMiliseconds();
+        stage.m_warmedUp = ok;
+        if (ok)
+            donut::log::info("%s warmup took %.2f ms", name, stage.m_warmupMs.load());
+        else
+            donut::log::warning("%s warmup failed; the first inference will be cold", name);
+    }
+
+    stage.m_awaitingFirstInference.store(true);
+}
+
+void NVIGIContext::RecordFirstInference(StageInfo& stage, const char* name, double ms)
+{
+    if (!stage.m_awaitingFirstInference.exchange(false))
+        return;
+
+    if (stage.m_warmedUp)
+        stage.m_warmFirstMs = ms;
+    else
+        stage.m_coldFirstMs = ms;
+    donut::log::info("%s first inference after load (%s): %.2f ms", name, stage.m_warmedUp ? "warm" : "cold", ms);
+}
+
+std::vector<NamedLatencyHistogram> NVIGIContext::GetLatencyHistograms() const
+{
+    return {
+        { "ASR Total", &m_asrLatency },
+        { "GPT First Token", &m_gptFirstTokenLatency },
+        { "GPT Inter-Token", &m_gptTokenLatency },
+        { "TTS First Audio", &m_ttsFirstAudioLatency },
+        { "Speech To Speech", &m_speechToSpeechLatency },
+        { "Frame Time", &m_frameLatency },
+    };
+}
+
+void NVIGIContext::BuildLatencyUI()
+{
+    if (ImGui::BeginTable("Latency", 6))
+    {
+        ImGui::TableSetupColumn("Stage");
+        ImGui::TableSetupColumn("Count");
+        ImGui::TableSetupColumn("p50 ms");
+        ImGui::TableSetupColumn("p90 ms");
+        ImGui::TableSetupColumn("p99 ms");
+        ImGui::TableSetupColumn("Max ms");
+        ImGui::TableHeadersRow();
+
+        for (auto& named : GetLatencyHistograms())
+        {
+            auto summary = named.m_histogram->GetSummary();
+            if (summary.m_count == 0)
+                continue;
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", named.m_name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)summary.m_count);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", summary.m_p50Ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", summary.m_p90Ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", summary.m_p99Ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", summary.m_maxMs);
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::SmallButton("Reset Latency Stats"))
+    {
+        m_asrLatency.Reset();
+        m_gptFirstTokenLatency.Reset();
+        m_gptTokenLatency.Reset();
+        m_ttsFirstAudioLatency.Reset();
+        m_speechToSpeechLatency.Reset();
+        m_frameLatency.Reset();
+    }
+}
+
+void NVIGIContext::BuildSpeechStatsUI()
+{
+    // Real-time factor: processing time over audio duration, so values above 1 cannot keep up with speech
+    auto speech = m_speechStats.GetSnapshot();
+    if (speech.m_asr.m_count)
+    {
+        ImGui::Text("ASR RTF: last %.3f, avg %.3f, max %.3f (%.1f s of audio)",
+            speech.m_asr.m_lastRTF, speech.m_asr.GetAverageRTF(), speech.m_asr.m_maxRTF, speech.m_asr.m_audioSeconds);
+    }
+    if (speech.m_tts.m_count)
+    {
+        ImGui::Text("TTS RTF: last chunk %.3f, avg %.3f, worst chunk %.3f (%.1f s of audio)",
+            speech.m_tts.m_lastRTF, speech.m_tts.GetAverageRTF(), speech.m_tts.m_maxRTF, speech.m_tts.m_audioSeconds);
+        ImGui::Text("TTS buffer lead: %.0f ms%s, lowest this answer %.0f ms", speech.m_leadMs, speech.m_playing ? " (playing)" : "", speech.m_minLeadMs);
+        if (speech.m_underruns)
+            ImGui::TextColored(ImVec4(1, 0.5f, 0, 1), "TTS playback gaps: %llu (%.0f ms total)", (unsigned long long)speech.m_underruns, speech.m_underrunMs);
+    }
+
+    bool adaptive = m_ttsQuality.IsEnabled();
+    if (ImGui::Checkbox("Adaptive TTS Quality", &adaptive))
+        m_ttsQuality.SetEnabled(adaptive);
+    const auto& level = TTSQualityController::GetLevel(m_ttsQuality.GetLevelIndex());
+    ImGui::Text("TTS chunks of %d-%d characters", (int)level.m_minChunk, (int)level.m_maxChunk);
+    for (bool enabled : { false, true })
+    {
+        auto stats = m_ttsQuality.GetStats(enabled);
+        if (stats.m_chunks)
+        {
+            ImGui::Text("Controller %s: %llu chunks, %llu gaps, avg lead %.0f ms, avg max chunk %.0f", enabled ? "on" : "off",
+                (unsigned long long)stats.m_chunks, (unsigned long long)stats.m_gaps, stats.GetAverageLeadMs(), stats.GetAverageMaxChunk());
+        }
+    }
+}
+
+void NVIGIContext::BuildMemoryUI()
+{
+    if (m_memoryPlotVRAM.empty())
+    {
+        m_memoryPlotVRAM.resize(MemorySampler::kMaxSamples);
+        m_memoryPlotRSS.resize(MemorySampler::kMaxSamples);
+    }
+
+    if (m_memorySampler.IsRunning())
+    {
+        int count = (int)m_memorySampler.CopySeriesMB(m_memoryPlotVRAM.data(), m_memoryPlotRSS.data());
+        auto latest = m_memorySampler.GetLatest();
+        char overlay[64];
+        snprintf(overlay, sizeof(overlay), "VRAM %.0f MB", latest.m_vram / (1024.0 * 1024.0));
+        ImGui::PlotLines("##VRAM", m_memoryPlotVRAM.data(), count, 0, overlay, 0.0f, FLT_MAX, ImVec2(0, 50));
+        snprintf(overlay, sizeof(overlay), "Process RSS %.0f MB", latest.m_rss / (1024.0 * 1024.0));
+        ImGui::PlotLines("##RSS", m_memoryPlotRSS.data(), count, 0, overlay, 0.0f, FLT_MAX, ImVec2(0, 50));
+        ImGui::Text("Sampled every %d ms, last %.0f s", m_memorySampler.GetIntervalMs(),
+            count * m_memorySampler.GetIntervalMs() / 1000.0);
+    }
+
+    // Measured change across each model load/unload next to what the model declares
+    for (auto& event : m_memorySampler.GetEvents())
+    {
+        ImGui::Text("%7.1f s  %s: VRAM %+.0f MB (declared %llu MB), RSS %+.0f MB", event.m_seconds, event.m_label.c_str(),
+            event.m_vramDelta / (1024.0 * 1024.0), (unsigned long long)event.m_declaredMB, event.m_rssDelta / (1024.0 * 1024.0));
+    }
+}
+
+void NVIGIContext::BuildThreadsUI()
+{
+    for (int i = 0; i < (int)ThreadRegistry::Role::Count; i++)
+    {
+        auto role = (ThreadRegistry::Role)i;
+        auto config = ThreadRegistry::GetRoleConfig(role);
+        ImGui::PushID(i);
+        ImGui::PushItemWidth(100);
+        if (ImGui::BeginCombo("##Priority", ThreadRegistry::GetPriorityName(config.m_priority)))
+        {
+            for (int p = 0; p < (int)ThreadRegistry::Priority::Count; p++)
+            {
+                if (ImGui::Selectable(ThreadRegistry::GetPriorityName((ThreadRegistry::Priority)p), (int)config.m_priority == p))
+                {
+                    config.m_priority = (ThreadRegistry::Priority)p;
+                    ThreadRegistry::SetRoleConfig(role, config);
+                }
+            }
+            ImGui::EndCombo();
+        }
+        ImGui::PopItemWidth();
+        ImGui::SameLine();
+        ImGui::Text("%s priority, affinity 0x%llx", ThreadRegistry::GetRoleName(role), (unsigned long long)config.m_affinityMask);
+        ImGui::PopID();
+    }
+
+    // CPU time against wall time since each thread registered; exited threads are summed by name
+    if (ImGui::BeginTable("Threads", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit))
+    {
+        for (const char* header : { "Thread", "Role", "Count", "CPU ms", "CPU %" })
+            ImGui::TableSetupColumn(header);
+        ImGui::TableHeadersRow();
+        for (const auto& thread : ThreadRegistry::GetThreads())
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::Text("%s%s%s", thread.m_name.c_str(), thread.m_live ? "" : " (exited)", thread.m_applied ? "" : " *");
+            ImGui::TableNextColumn(); ImGui::Text("%s", ThreadRegistry::GetRoleName(thread.m_role));
+            ImGui::TableNextColumn(); ImGui::Text("%u", thread.m_threads);
+            ImGui::TableNextColumn(); ImGui::Text("%.0f", thread.m_cpuMs);
+            ImGui::TableNextColumn(); ImGui::Text("%.1f", thread.GetUtilization() * 100.0);
+        }
+        ImGui::EndTable();
+    }
+}
+
+void NVIGIContext::BuildGPTStatsUI()
+{
+    m_gptStats.ForEach([](const GPTStatsTable::Entry& entry)
+        {
+            if (entry.m_requests == 0)
+                return;
+
+            ImGui::Separator();
+            ImGui::Text("%s / %s / %s", entry.m_plugin.c_str(), entry.m_model.c_str(), entry.m_schedulingMode.c_str());
+            ImGui::Text("%llu requests, %llu prompt tokens (est.), %llu generated tokens",
+                (unsigned long long)entry.m_requests, (unsigned long long)entry.m_promptTokens, (unsigned long long)entry.m_generatedTokens);
+            ImGui::Text("TTFT p50 %.1f ms, inter-token p50 %.1f / p99 %.1f ms, callback p50 %.2f / p99 %.2f ms",
+                entry.m_firstToken.GetPercentileMs(50.0), entry.m_interToken.GetPercentileMs(50.0), entry.m_interToken.GetPercentileMs(99.0),
+                entry.m_callback.GetPercentileMs(50.0), entry.m_callback.GetPercentileMs(99.0));
+
+            uint32_t count = entry.m_historyCount < GPTStatsTable::kHistorySize ? entry.m_historyCount : GPTStatsTable::kHistorySize;
+            uint32_t offset = entry.m_historyCount < GPTStatsTable::kHistorySize ? 0 : entry.m_historyCount % GPTStatsTable::kHistorySize;
+            char overlay[64];
+            snprintf(overlay, sizeof(overlay), "%.1f tok/s (avg %.1f)", entry.GetLastTokensPerSecond(), entry.GetAverageTokensPerSecond());
+            ImGui::PushID(&entry);
+            ImGui::PlotLines("##TokensPerSecond", entry.m_tokensPerSecond.data(), (int)count, (int)offset, overlay, 0.0f, FLT_MAX, ImVec2(0, 40));
+            ImGui::PopID();
+        });
+}
+
+void NVIGIContext::BuildHistoryUI()
+{
+    auto stats = m_history.GetStats();
+    if (stats.m_budget)
+        ImGui::Text("Context ~%u of %u tokens, %u turns kept (~%u tokens)", stats.m_contextTokens, stats.m_budget, stats.m_turns, stats.m_historyTokens);
+    else
+        ImGui::Text("Context ~%u tokens (unbounded), %u turns", stats.m_contextTokens, stats.m_turns);
+    ImGui::Text("%u turns dropped, %u summarized (summary ~%u tokens), %u rebuilds", stats.m_droppedTurns, stats.m_summarizedTurns,
+        stats.m_summaryTokens, stats.m_rebuilds);
+
+    // Prefill time against the length of the context it was evaluated on
+    if (ImGui::BeginTable("History", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit))
+    {
+        ImGui::TableSetupColumn("Context tokens");
+        ImGui::TableSetupColumn("Prompt TTFT");
+        ImGui::TableSetupColumn("Rebuild");
+        ImGui::TableHeadersRow();
+        for (const auto& bucket : stats.m_buckets)
+        {
+            if (!bucket.m_prompts && !bucket.m_rebuilds)
+                continue;
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            if (bucket.m_maxTokens)
+                ImGui::Text("<= %u", bucket.m_maxTokens);
+            else
+                ImGui::Text("more");
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f ms (%u)", bucket.m_prompts ? bucket.m_promptMs / bucket.m_prompts : 0.0, bucket.m_prompts);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f ms (%u)", bucket.m_rebuilds ? bucket.m_rebuildMs / bucket.m_rebuilds : 0.0, bucket.m_rebuilds);
+        }
+        ImGui::EndTable();
+    }
+}
+
+void NVIGIContext::BuildStructuredOutputUI()
+{
+    ImGui::Text("%u actions, %u data, %u errors", m_structuredActions, m_structuredData, m_structuredErrors);
+    if (ImGui::Button("Clear##StructuredOutput"))
+    {
+        m_recentEvents.clear();
+        m_structuredActions = m_structuredData = m_structuredErrors = 0;
+    }
+
+    // Most recent first
+    for (auto it = m_recentEvents.rbegin(); it != m_recentEvents.rend(); ++it)
+    {
+        const StructuredEvent& event = *it;
+        if (event.m_type == StructuredEvent::Type::Error)
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s error: %s", event.m_source, event.m_error.c_str());
+        else if (event.m_type == StructuredEvent::Type::Action)
+            ImGui::TextWrapped("%s %s: %s", event.m_source, event.m_action.c_str(), event.m_value.ToJSON().c_str());
+        else
+            ImGui::TextWrapped("%s data: %s", event.m_source, event.m_value.ToJSON().c_str());
+    }
+}
+
+void NVIGIContext::WriteLatencyReport()
+{
+    if (m_latencyReportPath.empty())
+        return;
+
+    auto histograms = GetLatencyHistograms();
+    std::string csvPath = m_latencyReportPath + ".csv";
+    std::string jsonPath = m_latencyReportPath + ".json";
+    if (WriteLatencyCSV(csvPath, histograms) && WriteLatencyJSON(jsonPath, histograms))
+        donut::log::info("Wrote latency histograms to %s and %s", csvPath.c_str(), jsonPath.c_str());
+    else
+        donut::log::warning("Unable to write latency histograms to %s", m_latencyReportPath.c_str());
+
+    std::string speechPath = m_latencyReportPath + ".speech.csv";
+    if (!m_speechStats.WriteCSV(speechPath))
+        donut::log::warning("Unable to write speech statistics to %s", speechPath.c_str());
+
+    std::string gptPath = m_latencyReportPath + ".gpt.csv";
+    if (!m_gptStats.WriteCSV(gptPath))
+        donut::log::warning("Unable to write GPT statistics to %s", gptPath.c_str());
+
+    std::string ttsPath = m_latencyReportPath + ".tts.csv";
+    if (!m_ttsQuality.WriteCSV(ttsPath))
+        donut::log::warning("Unable to write TTS quality statistics to %s", ttsPath.c_str());
+
+    std::string schedulingPath = m_latencyReportPath + ".scheduling.csv";
+    if (!m_schedulingController.WriteCSV(schedulingPath))
+        donut::log::warning("Unable to write scheduling decisions to %s", schedulingPath.c_str());
+
+    std::string framesPath = m_latencyReportPath + ".frames.csv";
+    if (!m_frameCoordinator.WriteCSV(framesPath))
+        donut::log::warning("Unable to write frame statistics to %s", framesPath.c_str());
+
+    std::string threadsPath = m_latencyReportPath + ".threads.csv";
+    if (!ThreadRegistry::WriteCSV(threadsPath))
+        donut::log::warning("Unable to write thread statistics to %s", threadsPath.c_str());
+
+    std::string historyPath = m_latencyReportPath + ".history.csv";
+    if (!m_history.WriteCSV(historyPath))
+        donut::log::warning("Unable to write conversation history statistics to %s", historyPath.c_str());
+}
+
+ScriptRunner::Stages NVIGIContext::GetScriptStages(bool resetConversation)
+{
+    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> convert;
+    ScriptRunner::Stages stages;
+    stages.m_asr = m_asr.m_ready ? m_asr.m_inst : nullptr;
+    stages.m_gpt = m_gpt.m_ready ? m_gpt.m_inst : nullptr;
+    stages.m_tts = m_tts.m_ready ? m_tts.m_inst : nullptr;
+    // Evaluating the system prompt starts a new conversation
+    if (resetConversation || !m_conversationInitialized)
+        stages.m_systemPrompt = m_systemPromptGPT;
+    stages.m_ttsRuntime = m_ttsInferenceCtx.runtimeTTS;
+    stages.m_ttsTargetPath = convert.to_bytes(GetNVIGICoreDllPath().c_str()) + "/" + m_ttsInferenceCtx.m_selectedTargetVoice + "_se.bin";
+    stages.m_ttsSampleRate = kTTSSampleRate;
+    stages.m_coordinator = &m_frameCoordinator;
+    stages.m_scheduler = &m_schedulingController;
+    stages.m_beforeEvaluate = [this]()
+        {
+            if (m_hwiCommon)
+                m_hwiCommon->SetGpuInferenceSchedulingMode(m_schedulingMode);
+        };
+    return stages;
+}
+
+void NVIGIContext::UpdateScript()
+{
+    if (m_scriptTurns.empty() || m_scriptDone)
+        return;
+
+    if (m_scriptStarted)
+    {
+        if (!m_scriptRunner.IsRunning())
+            FinishScript();
+        return;
+    }
+
+    // Wait for the initial model loads to succeed or fail
+    for (StageInfo* stage : { &m_asr, &m_gpt, &m_tts })
+    {
+        if (stage->m_model != kInvalidModel && stage->m_loadTask.IsBusy())
+            return;
+    }
+
+    ScriptRunner::Stages stages = GetScriptStages(false);
+    if (!stages.m_tts)
+        donut::log::warning("Script: no TTS model is loaded; answers will not be synthesized");
+
+    FlushInferenceThread();
+    m_scriptStarted = m_scriptRunner.Start(stages, m_scriptTurns, m_scriptOptions);
+    if (m_scriptStarted)
+    {
+        m_conversationInitialized = true;
+    }
+    else
+    {
+        m_scriptDone = true;
+        m_exitCode = 1;
+        m_exitRequested = true;
+    }
+}
+
+void NVIGIContext::FinishScript()
+{
+    m_scriptRunner.Wait();
+    m_scriptDone = true;
+
+    std::string reportPath = (fs::path(m_scriptOptions.m_outputDir) / "report").string();
+    if (m_scriptRunner.WriteReport(reportPath))
+        donut::log::info("Script: wrote the turn report to %s.csv and %s.json", reportPath.c_str(), reportPath.c_str());
+    else
+        donut::log::warning("Script: unable to write the turn report to %s", reportPath.c_str());
+
+    size_t failed = m_scriptRunner.GetFailedTurns();
+    size_t completed = m_scriptRunner.GetCompletedTurns();
+    donut::log::info("Script: %d of %d turn(s) completed, %d failed", (int)completed, (int)m_scriptRunner.GetTotalTurns(), (int)failed);
+    m_exitCode = (failed != 0 || completed != m_scriptRunner.GetTotalTurns()) ? 1 : 0;
+    m_exitRequested = true;
+}
+
+void NVIGIContext::RecordModelSelection(SessionEvent::Stage kind, const StageInfo& stage)
+{
+    if (const PluginModelInfo* info = stage.Info())
+        m_sessionRecorder.RecordModel(kind, info->m_featureID, info->m_guid.c_str());
+}
+
+void NVIGIContext::UpdateReplay()
+{
+    if (m_replaySessionPath.empty() || m_replayDone)
+        return;
+
+    // Inputs are never overlapped, as in the chat: wait for the previous one and any model load to finish
+    bool busy = m_gptInputReady || m_asr.m_running || m_gpt.m_running || m_tts.m_running;
+    for (StageInfo* stage : { &m_asr, &m_gpt, &m_tts })
+        busy |= stage->m_model != kInvalidModel && stage->m_loadTask.IsBusy();
+
+    if (!m_replayStarted)
+    {
+        if (busy)
+            return;
+        donut::log::info("Replaying %s at %.2fx", m_replaySessionPath.c_str(), m_replaySpeed);
+        m_sessionReplayer.Start(m_replayEvents, m_replaySpeed);
+        m_replayStarted = true;
+    }
+
+    if (m_sessionReplayer.IsFinished())
+    {
+        if (!busy)
+            FinishReplay();
+        return;
+    }
+
+    const SessionEvent* event = busy ? nullptr : m_sessionReplayer.GetDueInput(SessionReplayer::Clock::now());
+    if (!event)
+        return;
+
+    FlushInferenceThread();
+    switch (event->m_type)
+    {
+    case SessionEvent::Type::ModelSelect:
+    {
+        // The synthetic backend stands in for whatever models were recorded
+        if (m_syntheticBackend)
+            break;
+        StageInfo& stage = event->m_stage == SessionEvent::Stage::GPT ? m_gpt : (event->m_stage == SessionEvent::Stage::ASR ? m_asr : m_tts);
+        ModelHandle model = stage.m_catalog.Find(event->m_plugin, event->m_text);
+        if (model == kInvalidModel)
+            donut::log::warning("Replay: recorded %s model %s is not available; keeping the current one", GetStageName(stage), event->m_text.c_str());
+        else if (model != stage.m_model && &stage == &m_gpt)
+            ReloadGPTModel(model);
+        else if (model != stage.m_model && &stage == &m_asr)
+            ReloadASRModel(model);
+        else if (model != stage.m_model)
+            ReloadTTSModel(model);
+        break;
+    }
+    case SessionEvent::Type::SchedulingMode:
+        m_sessionRecorder.RecordSchedulingMode(event->m_value);
+        m_schedulingMode = event->m_value;
+        break;
+    case SessionEvent::Type::TypedPrompt:
+        SubmitTypedPrompt(event->m_text);
+        break;
+    case SessionEvent::Type::SpokenPrompt:
+        if (m_asr.m_ready)
+        {
+            m_a2t = "";
+            m_gptInput = "";
+            LaunchASR(event->m_audio);
+        }
+        break;
+    case SessionEvent::Type::ResetChat:
+        ResetChat();
+        break;
+    default:
+        break;
+    }
+    m_sessionReplayer.Advance();
+}
+
+void NVIGIContext::FinishReplay()
+{
+    m_replayDone = true;
+
+    std::string diffPath = m_replaySessionPath + ".diff.csv";
+    size_t mismatches = WriteSessionDiff(diffPath, m_replayEvents, m_sessionRecorder.GetEvents());
+    donut::log::info("Replay: %d turn(s) differ from the recording; see %s", (int)mismatches, diffPath.c_str());
+    m_exitCode = mismatches ? 1 : 0;
+    m_exitRequested = true;
+}
+
+void NVIGIContext::ApplySweepLoad(float& cpuLoad, int& gpuLoad) const
+{
+    if (const SweepPoint* point = m_sweep.GetPoint())
+    {
+        cpuLoad = point->m_cpuLoad;
+        gpuLoad = point->m_gpuLoad;
+    }
+}
+
+void NVIGIContext::UpdateSweep()
+{
+    if (m_sweepSpec.m_turns.empty() || m_sweep.IsDone())
+        return;
+
+    if (!m_sweep.IsActive())
+    {
+        // Wait for the initial model loads to succeed or fail
+        for (StageInfo* stage : { &m_asr, &m_gpt, &m_tts })
+        {
+            if (stage->m_model != kInvalidModel && stage->m_loadTask.IsBusy())
+                return;
+        }
+        m_sweep.Start(m_sweepSpec, m_schedulingController.IsEnabled() ? FrameSweep::kAdaptiveScheduling : (uint32_t)m_schedulingMode,
+            m_frameCoordinator.GetPolicy());
+    }
+
+    const SweepPoint& point = *m_sweep.GetPoint();
+    auto backendName = [this]() { return m_gpt.Info() ? std::string(m_gpt.Info()->m_pluginName.view()) : std::string(); };
+
+    switch (m_sweep.GetPhase())
+    {
+    case FrameSweep::Phase::Apply:
+    {
+        if (m_gpt.m_loadTask.IsBusy())
+            return;
+
+        // Same model on another plugin; a failed load reverts to the previous one
+        if (!point.m_backend.empty() && backendName() != point.m_backend)
+        {
+            ModelHandle handle = kInvalidModel;
+            const ModelCatalog::Group* group = m_gpt.Info() ? m_gpt.m_catalog.FindGroup(m_gpt.Info()->m_guid.view()) : nullptr;
+            for (ModelHandle h = group ? group->begin() : 0; group && h != group->end(); h++)
+            {
+                if (m_gpt.m_catalog.Get(h).m_pluginName.view() == point.m_backend)
+                    handle = h;
+            }
+
+            if (m_sweepReloadRequested || handle == kInvalidModel)
+            {
+                donut::log::warning("Sweep: unable to run the GPT model on backend %s; skipping the point", point.m_backend.c_str());
+                m_sweepReloadRequested = false;
+                m_sweep.FinishPoint(point.m_backend, false, {});
+                return;
+            }
+
+            FlushInferenceThread();
+            ReloadGPTModel(handle);
+            m_sweepReloadRequested = true;
+            return;
+        }
+        m_sweepReloadRequested = false;
+
+        if (!m_gpt.m_ready)
+        {
+            donut::log::warning("Sweep: no GPT model is loaded; skipping the point");
+            m_sweep.FinishPoint(backendName(), false, {});
+            return;
+        }
+
+        m_framerateLimiting = point.m_targetFps > 0;
+        if (m_framerateLimiting)
+            m_targetFramerate = point.m_targetFps;
+        m_schedulingController.SetEnabled(point.m_schedulingMode == FrameSweep::kAdaptiveScheduling);
+        if (!m_schedulingController.IsEnabled() && m_schedulingMode != point.m_schedulingMode)
+        {
+            m_schedulingMode = point.m_schedulingMode;
+            m_sessionRecorder.RecordSchedulingMode(m_schedulingMode);
+        }
+        m_frameCoordinator.SetPolicy(point.m_coordinator);
+        m_sweep.SetPhase(FrameSweep::Phase::Settle);
+        break;
+    }
+    case FrameSweep::Phase::Settle:
+        if (m_sweep.IsPhaseComplete())
+            m_sweep.SetPhase(FrameSweep::Phase::Idle);
+        break;
+    case FrameSweep::Phase::Idle:
+    {
+        if (!m_sweep.IsPhaseComplete())
+            break;
+
+        // Every point starts a fresh conversation so that TTFT does not grow with the context; no WAVs are
+        // written since the disk traffic would show up in the frame times
+        ScriptRunner::Options options = m_scriptOptions;
+        options.m_outputDir.clear();
+        FlushInferenceThread();
+        if (!m_scriptRunner.Start(GetScriptStages(true), m_sweep.GetTurns(), options))
+        {
+            m_sweep.FinishPoint(backendName(), false, {});
+            break;
+        }
+        m_conversationInitialized = true;
+        m_sweep.SetPhase(FrameSweep::Phase::Inference);
+        break;
+    }
+    case FrameSweep::Phase::Inference:
+        if (m_scriptRunner.IsRunning())
+            break;
+        m_scriptRunner.Wait();
+        m_sweep.FinishPoint(backendName(), true, m_scriptRunner.GetResults());
+        break;
+    default:
+        break;
+    }
+
+    if (m_sweep.IsDone())
+        FinishSweep();
+}
+
+void NVIGIContext::FinishSweep()
+{
+    if (m_sweep.WriteReport(m_sweepReportPath))
+        donut::log::info("Sweep: wrote the frame-time table to %s.csv and %s.json", m_sweepReportPath.c_str(), m_sweepReportPath.c_str());
+    else
+        donut::log::warning("Sweep: unable to write the frame-time table to %s", m_sweepReportPath.c_str());
+
+    size_t failed = m_sweep.GetFailedPoints();
+    size_t completed = m_sweep.GetResults().size();
+    donut::log::info("Sweep: %d of %d point(s) completed, %d failed", (int)completed, (int)m_sweep.GetCount(), (int)failed);
+    m_exitCode = (failed != 0 || completed != m_sweep.GetCount()) ? 1 : 0;
+    m_exitRequested = true;
+}
+
+void NVIGIContext::FlushInferenceThread()
+{
+    if (m_inferThread)
+    {
+        m_historyCancel = true;
+        m_inferThread->join();
+        m_historyCancel = false;
+        delete m_inferThread;
+        m_inferThread = nullptr;
+    }
+    // Everything the finished evaluation produced, before the caller changes the chat
+    DrainAnswerTokens();
+}
+
+void NVIGIContext::DrainAnswerTokens()
+{
+    m_answerTokens.Drain([this](std::string_view text) { m_chatLog.AppendAnswer(text); });
+    m_structuredEvents.Drain([this](StructuredEvent& event) { OnStructuredEvent(event); });
+}
+
+void NVIGIContext::RouteStructuredEvents(const char* source, std::vector<StructuredEvent>& events)
+{
+    for (auto& event : events)
+    {
+        event.m_source = source;
+        m_structuredEvents.Push(std::move(event));
+    }
+}
+
+void NVIGIContext::OnStructuredEvent(const StructuredEvent& event)
+{
+    constexpr size_t kRecentEvents = 32;
+    switch (event.m_type)
+    {
+    case StructuredEvent::Type::Action:
+        m_structuredActions++;
+        donut::log::info("%s action '%s': %s", event.m_source, event.m_action.c_str(), event.m_value.ToJSON().c_str());
+        break;
+    case StructuredEvent::Type::Data:
+        m_structuredData++;
+        break;
+    case StructuredEvent::Type::Error:
+        m_structuredErrors++;
+        donut::log::warning("%s structured output: %s", event.m_source, event.m_error.c_str());
+        break;
+    }
+    m_recentEvents.push_back(event);
+    if (m_recentEvents.size() > kRecentEvents)
+        m_recentEvents.pop_front();
+}
+
+bool NVIGIContext::ModelsComboBox(const std::string& label, bool automatic, StageInfo& stage, ModelHandle& value)
+{
+    const ModelCatalog& catalog = stage.m_catalog;
+    ModelHandle model = value;
+    const PluginModelInfo* info = catalog.Find(model);
+    bool changed = false;
+    if (automatic)
+    {
+        int newVram = (int)stage.m_vramBudget;
+
+        const std::string uniqueLabel = "VRAM MB ##" + label;
+        if (ImGui::InputInt(uniqueLabel.c_str(), &newVram, 100, 500, ImGuiInputTextFlags_EnterReturnsTrue))
+        {
+            if (newVram < 0)
+                newVram = 0;
+            if (m_maxVRAM && newVram > (int)m_maxVRAM)
+                newVram = (int)m_maxVRAM;
+            stage.m_vramBudget = newVram;
+        }
+
+        if (ImGui::BeginCombo(label.c_str(), (info == nullptr) ? "No Selection" : info->m_modelName.c_str()))
+        {
+            if (ImGui::Selectable("No Selection", (info == nullptr)))
+            {
+                model = kInvalidModel;
+                info = nullptr;
+            }
+
+            for (const auto& group : catalog.Groups())
             {
-                PluginModelInfo* newInfo = nullptr;
-                if (SelectAutoPlugin(stage, m.second, newInfo))
+                ModelHandle newModel = kInvalidModel;
+                if (SelectAutoPlugin(stage, group, newModel))
                 {
-                    if (newInfo && newInfo->m_guid == info->m_guid)
+                    const PluginModelInfo& newInfo = catalog.Get(newModel);
+                    bool is_selected_guid = info && newInfo.m_guid == info->m_guid;
+                    if (ImGui::Selectable(newInfo.m_modelName.c_str(), is_selected_guid) || is_selected_guid)
                     {
-                        info = newInfo;
-                        break;
+                        model = newModel;
+                        info = &newInfo;
                     }
                 }
             }
+            ImGui::EndCombo();
+        }
+        else if (info)
+        {
+            // This will be hit when we move from manual to auto or adjust the vram values.
+            if (const ModelCatalog::Group* group = catalog.FindGroup(info->m_guid))
+            {
+                ModelHandle newModel = kInvalidModel;
+                if (SelectAutoPlugin(stage, *group, newModel))
+                    model = newModel;
+            }
         }
 
-        changed = value != info;
+        changed = value != model;
     }
     else
     {
@@ -1725,122 +3174,125 @@ bool NVIGIContext::ModelsComboBox(const std::string& label, bool automatic, Stag
         {
             if (ImGui::Selectable("No Selection", (info == nullptr)))
             {
-                info = nullptr;
+                model = kInvalidModel;
                 changed = true;
             }
 
             // Available models
-            for (auto m : models)
+            for (ModelHandle h = 0; h < catalog.Size(); h++)
             {
-                for (auto it : m.second)
+                const PluginModelInfo& newInfo = catalog.Get(h);
+                bool is_selected = h == model;
+                const char* key = nullptr;
+                std::string apiKeyName = "";
+                bool cloudNotAvailable = (newInfo.m_modelStatus == ModelStatus::AVAILABLE_CLOUD) && !GetCloudModelAPIKey(newInfo, key, apiKeyName);
+                if (cloudNotAvailable)
                 {
-                    NVIGIContext::PluginModelInfo* newInfo = it;
-                    bool is_selected = newInfo == info;
-                    const char* key = nullptr;
-                    if (newInfo)
+                    // skip
+                }
+                else if (newInfo.m_modelStatus == ModelStatus::AVAILABLE_LOCALLY || newInfo.m_modelStatus == ModelStatus::AVAILABLE_CLOUD)
+                {
+                    if (ImGui::Selectable(newInfo.m_caption.c_str(), is_selected))
                     {
-                        std::string apiKeyName = "";
-                        bool cloudNotAvailable = (newInfo->m_modelStatus == ModelStatus::AVAILABLE_CLOUD) && !GetCloudModelAPIKey(*newInfo, key, apiKeyName);
-                        if (cloudNotAvailable)
-                        {
-                            // skip
-                        }
-                        else if (newInfo->m_modelStatus == ModelStatus::AVAILABLE_LOCALLY || newInfo->m_modelStatus == ModelStatus::AVAILABLE_CLOUD)
-                        {
-                            if (ImGui::Selectable(newInfo->m_caption.c_str(), is_selected))
-                            {
-                                changed = !is_selected;
-                                info = newInfo;
-                            }
-                        }
-                        if (is_selected) ImGui::SetItemDefaultFocus();
+                        changed = !is_selected;
+                        model = h;
                     }
                 }
+                if (is_selected) ImGui::SetItemDefaultFocus();
             }
             // Unavailable models
-            for (auto m : models)
+            for (ModelHandle h = 0; h < catalog.Size(); h++)
             {
-                for (auto it : m.second)
+                const PluginModelInfo& newInfo = catalog.Get(h);
+                const char* key = nullptr;
+                std::string apiKeyName = "";
+                bool cloudNotAvailable = (newInfo.m_modelStatus == ModelStatus::AVAILABLE_CLOUD) && !GetCloudModelAPIKey(newInfo, key, apiKeyName);
+                if (cloudNotAvailable)
                 {
-                    NVIGIContext::PluginModelInfo* newInfo = it;
-                    bool is_selected = newInfo == info;
-                    const char* key = nullptr;
-                    if (newInfo)
-                    {
-                        std::string apiKeyName = "";
-                        bool cloudNotAvailable = (newInfo->m_modelStatus == ModelStatus::AVAILABLE_CLOUD) && !GetCloudModelAPIKey(*newInfo, key, apiKeyName);
-                        if (cloudNotAvailable)
-                        {
-                            ImGui::TextDisabled((newInfo->m_pluginName + ": No " + apiKeyName + " API KEY " + newInfo->m_modelName).c_str());
-                        }
-                        else if (newInfo->m_modelStatus == ModelStatus::AVAILABLE_MANUAL_DOWNLOAD)
-                        {
-                            ImGui::TextDisabled((newInfo->m_caption + ": MANUAL DOWNLOAD").c_str());
-                        }
-                    }
+                    ImGui::TextDisabled("%s: No %s API KEY %s", newInfo.m_pluginName.c_str(), apiKeyName.c_str(), newInfo.m_modelName.c_str());
+                }
+                else if (newInfo.m_modelStatus == ModelStatus::AVAILABLE_MANUAL_DOWNLOAD)
+                {
+                    ImGui::TextDisabled("%s: MANUAL DOWNLOAD", newInfo.m_caption.c_str());
+                }
+                else if (newInfo.m_modelStatus == ModelStatus::AVAILABLE_DOWNLOADER)
+                {
+                    ImGui::PushID((int)h);
+                    ImGui::TextDisabled("%s:", newInfo.m_caption.c_str());
+                    ImGui::SameLine();
+                    if (ImGui::SmallButton("DOWNLOAD"))
+                        StartModelDownload(newInfo);
+                    ImGui::PopID();
+                }
+                else if (newInfo.m_modelStatus == ModelStatus::AVAILABLE_DOWNLOADING)
+                {
+                    ImGui::TextDisabled("%s: DOWNLOADING", newInfo.m_caption.c_str());
                 }
             }
             ImGui::EndCombo();
         }
     }
 
-    value = info;
+    value = model;
 
     return changed;
 }
 
-bool NVIGIContext::SelectAutoPlugin(const StageInfo& stage, const std::vector<PluginModelInfo*>& options, PluginModelInfo*& model)
+bool NVIGIContext::SelectAutoPlugin(const StageInfo& stage, const ModelCatalog::Group& options, ModelHandle& model)
 {
-    auto findOption = [options](nvigi::PluginID needId)->PluginModelInfo* {
+    const ModelCatalog& catalog = stage.m_catalog;
+    auto findOption = [&catalog, &options](nvigi::PluginID needId)->ModelHandle {
         if (needId == 0)
-            return nullptr;
-        for (auto info : options)
-            if (info->m_featureID == needId)
-                return info;
-
-        return nullptr;
+            return kInvalidModel;
+        return catalog.Find(options, needId);
         };
 
     // First, can we use the NV-specific plugin?
-    if (auto info = findOption(stage.m_choices.m_nvdaFeatureID))
+    ModelHandle option = findOption(stage.m_choices.m_nvdaFeatureID);
+    if (option != kInvalidModel)
     {
+        const PluginModelInfo& info = catalog.Get(option);
         // Only use if we have enough VRAM budgetted
-        if (info->m_modelStatus == ModelStatus::AVAILABLE_LOCALLY && stage.m_vramBudget >= info->m_vram)
+        if (info.m_modelStatus == ModelStatus::AVAILABLE_LOCALLY && stage.m_vramBudget >= info.m_vram)
         {
-            model = info;
+            model = option;
             return true;
         }
     }
 
     // Can we use a generic GPU plugin?
-    if (auto info = findOption(stage.m_choices.m_gpuFeatureID))
+    option = findOption(stage.m_choices.m_gpuFeatureID);
+    if (option != kInvalidModel)
     {
+        const PluginModelInfo& info = catalog.Get(option);
         // Only use if we have enough VRAM budgetted
-        if (info->m_modelStatus == ModelStatus::AVAILABLE_LOCALLY && stage.m_vramBudget >= info->m_vram)
+        if (info.m_modelStatus == ModelStatus::AVAILABLE_LOCALLY && stage.m_vramBudget >= info.m_vram)
         {
-            model = info;
+            model = option;
             return true;
         }
     }
 
     // Is cloud an option?
-    if (auto info = findOption(stage.m_choices.m_cloudFeatureID))
+    option = findOption(stage.m_choices.m_cloudFeatureID);
+    if (option != kInvalidModel)
     {
         const char* key = nullptr;
         std::string apiKeyName = "";
-        if (GetCloudModelAPIKey(*info, key, apiKeyName))
+        if (GetCloudModelAPIKey(catalog.Get(option), key, apiKeyName))
         {
-            model = info;
+            model = option;
             return true;
         }
     }
 
     // What about CPU?
-    if (auto info = findOption(stage.m_choices.m_cpuFeatureID))
+    option = findOption(stage.m_choices.m_cpuFeatureID);
+    if (option != kInvalidModel)
     {
-        if (info->m_modelStatus == ModelStatus::AVAILABLE_LOCALLY)
+        if (catalog.Get(option).m_modelStatus == ModelStatus::AVAILABLE_LOCALLY)
         {
-            model = info;
+            model = option;
             return true;
         }
     }
@@ -1849,6 +3301,49 @@ bool NVIGIContext::SelectAutoPlugin(const StageInfo& stage, const std::vector<Pl
     return false;
 }
 
+void NVIGIContext::BuildFrameCoordinatorUI()
+{
+    static const char* policies[] = { "Off", "Protect FPS", "Protect TTFT" };
+    auto current = m_frameCoordinator.GetPolicy();
+    if (ImGui::BeginCombo("Frame Coordinator", policies[(int)current]))
+    {
+        for (int i = 0; i < (int)FrameCoordinator::Policy::Count; i++)
+        {
+            if (ImGui::Selectable(policies[i], (int)current == i))
+                m_frameCoordinator.SetPolicy((FrameCoordinator::Policy)i);
+        }
+        ImGui::EndCombo();
+    }
+    if (!m_framerateLimiting)
+    {
+        float budget = (float)m_frameBudgetMs;
+        if (ImGui::InputFloat("Frame Budget (ms)", &budget, 0.5f, 1.0f, "%.1f", ImGuiInputTextFlags_EnterReturnsTrue))
+            m_frameBudgetMs = std::max(1.0f, budget);
+    }
+
+    // Frame time spread under each policy, to compare them over the same session
+    if (ImGui::BeginTable("FrameCoordinator", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit))
+    {
+        for (const char* header : { "Policy", "Frames", "Mean ms", "Stddev ms", "Delayed", "Delay ms" })
+            ImGui::TableSetupColumn(header);
+        ImGui::TableHeadersRow();
+        for (int i = 0; i < (int)FrameCoordinator::Policy::Count; i++)
+        {
+            auto stats = m_frameCoordinator.GetStats((FrameCoordinator::Policy)i);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::Text("%s", policies[i]);
+            ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)stats.m_frames.m_count);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", stats.m_frames.m_mean);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", stats.m_frames.GetStddev());
+            ImGui::TableNextColumn(); ImGui::Text("%llu/%llu", (unsigned long long)stats.m_delayed, (unsigned long long)stats.m_yields);
+            ImGui::TableNextColumn(); ImGui::Text("%.1f", stats.m_delayMs);
+        }
+        ImGui::EndTable();
+    }
+    if (ImGui::SmallButton("Reset Frame Stats"))
+        m_frameCoordinator.ResetStats();
+}
+
 bool NVIGIContext::BuildModelsSelectUI()
 {
     bool isOpen = false;
@@ -1867,6 +3362,9 @@ bool NVIGIContext::BuildModelsSelectUI()
 				break;
 			}
 
+        bool adaptive = m_schedulingController.IsEnabled();
+        if (adaptive)
+            ImGui::BeginDisabled();
         if (ImGui::BeginCombo("Scheduling Mode", value.c_str()))
         {
             for (auto m : schedulingModes)
@@ -1874,29 +3372,103 @@ bool NVIGIContext::BuildModelsSelectUI()
                 bool is_selected = m_schedulingMode == m.second;
                 if (ImGui::Selectable(m.first.c_str(), &is_selected) || is_selected)
                 {
+                    if (m_schedulingMode != m.second)
+                        m_sessionRecorder.RecordSchedulingMode(m.second);
                     m_schedulingMode = m.second;
                 }
             }
             ImGui::EndCombo();
         }
+        if (adaptive)
+            ImGui::EndDisabled();
+        if (ImGui::Checkbox("Adaptive Scheduling", &adaptive))
+            m_schedulingController.SetEnabled(adaptive);
+        if (adaptive)
+        {
+            float ttftTarget = (float)m_schedulingController.GetTTFTTargetMs();
+            if (ImGui::InputFloat("TTFT Target (ms)", &ttftTarget, 50.0f, 200.0f, "%.0f", ImGuiInputTextFlags_EnterReturnsTrue))
+                m_schedulingController.SetTTFTTargetMs(std::max(1.0f, ttftTarget));
+            float tokenTarget = (float)m_schedulingController.GetTokenTargetMs();
+            if (ImGui::InputFloat("Token Target (ms)", &tokenTarget, 5.0f, 20.0f, "%.0f", ImGuiInputTextFlags_EnterReturnsTrue))
+                m_schedulingController.SetTokenTargetMs(std::max(1.0f, tokenTarget));
+            ImGui::Text("Frame p95 %.2f ms", m_schedulingController.GetFrameP95Ms());
+            if (m_schedulingController.GetLatencyTargetMs() > 0.0)
+            {
+                ImGui::SameLine();
+                ImGui::Text(", latency %.0f / %.0f ms", m_schedulingController.GetLatencyMs(), m_schedulingController.GetLatencyTargetMs());
+            }
+            const auto& decisions = m_schedulingController.GetDecisions();
+            if (!decisions.empty())
+                ImGui::Text("Last change at %.1f s: %s", decisions.back().m_timeS, decisions.back().m_reason);
+        }
+        if (m_outOfProcess)
+        {
+            auto host = InferenceHost::GetStats();
+            ImGui::Text("Inference host %s, %u restarts (%u crashed, %u stalled)", host.m_running ? "running" : "down",
+                host.m_starts > 0 ? host.m_starts - 1 : 0, host.m_crashes, host.m_stalls);
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Restart Host"))
+                InferenceHost::Restart();
+        }
+        if (AllocationCounter::IsEnabled())
+            ImGui::Text("Allocations last frame: %llu", (unsigned long long)AllocationCounter::GetLastFrame());
+        if (Trace::IsEnabled())
+        {
+            if (Trace::GetFramesRemaining() > 0)
+                ImGui::Text("Capturing trace: %d frames left", Trace::GetFramesRemaining());
+            else
+                ImGui::Text("Capturing trace");
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Stop Trace"))
+                Trace::StopCapture();
+        }
+        else
+        {
+            if (ImGui::SmallButton("Capture Trace"))
+                Trace::StartCapture(m_tracePath, m_traceCaptureFrames);
+            ImGui::SameLine();
+            ImGui::PushItemWidth(100);
+            if (ImGui::InputInt("Frames (0 = until stopped)", &m_traceCaptureFrames) && m_traceCaptureFrames < 0)
+                m_traceCaptureFrames = 0;
+            ImGui::PopItemWidth();
+        }
         ImGui::Checkbox("Frame Rate Limiter", &m_framerateLimiting);
         if (m_framerateLimiting)
         {
             ImGui::Separator();
-            const int maxFPS = 300;
-            if (ImGui::InputInt("Target FPS", &m_targetFramerate, 1, maxFPS, ImGuiInputTextFlags_EnterReturnsTrue))
+            if (ImGui::InputInt("Target FPS", &m_targetFramerate, 1, kMaxTargetFramerate, ImGuiInputTextFlags_EnterReturnsTrue))
             {
                 if (m_targetFramerate < 1)
                     m_targetFramerate = 1;
-                if (m_targetFramerate > maxFPS)
-                    m_targetFramerate = maxFPS;
+                if (m_targetFramerate > kMaxTargetFramerate)
+                    m_targetFramerate = kMaxTargetFramerate;
             }
+
+            static const char* pacerModes[] = { "Sleep", "Sleep + Spin" };
+            auto mode = m_framePacer.GetMode();
+            if (ImGui::BeginCombo("Frame Pacer", pacerModes[(int)mode]))
+            {
+                for (int i = 0; i < 2; i++)
+                {
+                    if (ImGui::Selectable(pacerModes[i], (int)mode == i))
+                        m_framePacer.SetMode((FramePacer::Mode)i);
+                }
+                ImGui::EndCombo();
+            }
+            const auto& pacing = m_framePacer.GetStats();
+            ImGui::Text("Interval %.3f +/- %.3f ms, max error %.3f ms", pacing.m_intervals.m_mean, pacing.m_intervals.GetStddev(), pacing.m_maxErrorMs);
+            if (mode == FramePacer::Mode::Hybrid)
+                ImGui::Text("Guard band %.2f ms, slept %.0f ms, spun %.0f ms", m_framePacer.GetGuardMs(), pacing.m_sleepMs, pacing.m_spinMs);
+            if (ImGui::SmallButton("Reset Pacing Stats"))
+                m_framePacer.ResetStats();
         }
+        BuildFrameCoordinatorUI();
         isOpen = true;
     }
     if (ImGui::CollapsingHeader("Model Settings..."))
     {
         ImGui::Checkbox("Automatic Backend Selection", &m_automaticBackendSelection);
+        ImGui::Checkbox("Warm Up Models After Loading", &m_warmupModels);
         ImGui::Separator();
         {
             ImGui::BeginDisabled(m_recording || m_asr.m_running);
@@ -1904,9 +3476,9 @@ bool NVIGIContext::BuildModelsSelectUI()
             ImGui::Text("Automatic Speech Recognition");
             ImGui::PopStyleColor();
 
-            PluginModelInfo* newInfo = m_asr.m_info;
-            if (ModelsComboBox("##ASR", m_automaticBackendSelection, m_asr, newInfo))
-                ReloadASRModel(newInfo);
+            ModelHandle newModel = m_asr.m_model;
+            if (ModelsComboBox("##ASR", m_automaticBackendSelection, m_asr, newModel))
+                ReloadASRModel(newModel);
             ImGui::EndDisabled();
         }
 
@@ -1917,9 +3489,9 @@ bool NVIGIContext::BuildModelsSelectUI()
             ImGui::Text("GPT");
             ImGui::PopStyleColor();
 
-            PluginModelInfo* newInfo = m_gpt.m_info;
-            if (ModelsComboBox("##GPT", m_automaticBackendSelection, m_gpt, newInfo))
-                ReloadGPTModel(newInfo);
+            ModelHandle newModel = m_gpt.m_model;
+            if (ModelsComboBox("##GPT", m_automaticBackendSelection, m_gpt, newModel))
+                ReloadGPTModel(newModel);
             ImGui::EndDisabled();
         }
         ImGui::Separator();
@@ -1929,9 +3501,9 @@ bool NVIGIContext::BuildModelsSelectUI()
             ImGui::Text("TTS");
             ImGui::PopStyleColor();
 
-            PluginModelInfo* newInfo = m_tts.m_info;
-            if (ModelsComboBox("##TTS", m_automaticBackendSelection, m_tts, newInfo))
-                ReloadTTSModel(newInfo);
+            ModelHandle newModel = m_tts.m_model;
+            if (ModelsComboBox("##TTS", m_automaticBackendSelection, m_tts, newModel))
+                ReloadTTSModel(newModel);
 
             // Add comboBox for target voices files
             std::vector<std::string> targetVoices = GetPossibleTargetVoices(GetNVIGICoreDllPath());
@@ -1955,43 +3527,61 @@ bool NVIGIContext::BuildModelsSelectUI()
     return isOpen;
 }
 
+void NVIGIContext::BuildLoadStatusUI(const char* name, const StageInfo& stage)
+{
+    LoadPhase phase = stage.m_loadTask.GetPhase();
+    const char* modelName = stage.Info() ? stage.Info()->m_modelName.c_str() : "";
+    if (phase == LoadPhase::Failed || phase == LoadPhase::Cancelled)
+    {
+        ImGui::Text("%s: %s %s", name, GetLoadPhaseName(phase), modelName);
+        return;
+    }
+
+    ImGui::Text("%s: %s (%s)...", name, GetLoadPhaseName(phase), modelName);
+}
+
 void NVIGIContext::BuildModelsStatusUI()
 {
     ImGui::Separator();
 
+    ModelDownloader::Progress download;
+    for (size_t i = 0; m_downloader.GetActive(i, download); i++)
+    {
+        float fraction = download.m_total ? (float)((double)download.m_received / (double)download.m_total) : 0.0f;
+        ImGui::Text("Downloading %.*s: %.0f / %.0f MB", (int)download.m_name.size(), download.m_name.data(),
+            download.m_received / (1024.0 * 1024.0), download.m_total / (1024.0 * 1024.0));
+        ImGui::ProgressBar(fraction);
+    }
+
     if (m_asr.m_ready)
     {
-        std::string asr = "ASR: " + m_asr.m_info->m_caption;
-        ImGui::Text(asr.c_str());
+        ImGui::Text("ASR: %s", m_asr.Info()->m_caption.c_str());
     }
     else
     {
-        if (m_asr.m_info != nullptr)
-            ImGui::Text("ASR: Loading model please wait...");
+        if (m_asr.m_model != kInvalidModel)
+            BuildLoadStatusUI("ASR", m_asr);
         else
             ImGui::Text("ASR: No model selected ...");
     }
 
     if (m_gpt.m_ready)
     {
-        std::string gpt = "GPT: " + m_gpt.m_info->m_caption;
-        ImGui::Text(gpt.c_str());
+        ImGui::Text("GPT: %s", m_gpt.Info()->m_caption.c_str());
     }
     else
     {
-        if (m_gpt.m_info != nullptr)
-            ImGui::Text("GPT: Loading model please wait...");
+        if (m_gpt.m_model != kInvalidModel)
+            BuildLoadStatusUI("GPT", m_gpt);
         else
             ImGui::Text("GPT: No model selected ...");
     }
 
     if (m_tts.m_ready)
     {
-        std::string tts = "TTS: " + m_tts.m_info->m_caption;
-        ImGui::Text(tts.c_str());
+        ImGui::Text("TTS: %s", m_tts.Info()->m_caption.c_str());
 
-        std::string tts_voice = "TTS Voice: " + m_ttsInferenceCtx.m_selectedTargetVoice;
-        ImGui::Text(tts_voice.c_str());
+        ImGui::Text("TTS Voice: %s", m_ttsInferenceCtx.m_selectedTargetVoice.c_str());
 
         // We instantiate runtime context only once
         if (m_ttsInferenceCtx.m_ttsCtx.instance == nullptr) {
@@ -2015,8 +3605,8 @@ void NVIGIContext::BuildModelsStatusUI()
     }
     else
     {
-        if (m_tts.m_info != nullptr)
-            ImGui::Text("TTS: Loading model please wait...");
+        if (m_tts.m_model != kInvalidModel)
+            BuildLoadStatusUI("TTS", m_tts);
         else
             ImGui::Text("TTS: No model selected ...");
     }
@@ -2027,8 +3617,6 @@ void NVIGIContext::BuildChatUI()
 
     if (m_gpt.m_ready || m_tts.m_ready)
     {
-        std::scoped_lock lock(m_mtx);
-
         static char inputBuffer[512] = {};
 
         static bool setFocusOnPromptInput = false;
@@ -2044,14 +3632,33 @@ void NVIGIContext::BuildChatUI()
                 // Create a child window with a scrollbar for messages
                 if (ImGui::BeginChild("Messages", ImVec2(0, -5 * ImGui::GetFrameHeightWithSpacing()), true))
                 {
-                    ImGui::PushTextWrapPos(ImGui::GetCursorPos().x + child_size.x - 30);  // Wrapping text before the edge, added a small offset for aesthetics
+                    float wrapWidth = child_size.x - 30;  // Wrapping text before the edge, added a small offset for aesthetics
+                    ImGui::PushTextWrapPos(ImGui::GetCursorPos().x + wrapWidth);
 
-                    for (const auto& message : messages)
+                    // Only the messages inside the view are submitted; the rest are skipped using their cached heights
+                    float spacing = ImGui::GetStyle().ItemSpacing.y;
+                    m_chatLog.UpdateLayout(wrapWidth, spacing, [](std::string_view text, float width)
+                        {
+                            return ImGui::CalcTextSize(text.data(), text.data() + text.size(), false, width).y;
+                        });
+                    float top = ImGui::GetCursorPosY();
+                    size_t first = 0;
+                    size_t last = 0;
+                    m_chatLog.GetVisibleRange(ImGui::GetScrollY() - top, ImGui::GetWindowHeight(), first, last);
+                    ImGui::SetCursorPosY(top + m_chatLog.GetOffset(first));
+                    for (size_t i = first; i < last; i++)
+                    {
+                        const std::string& text = m_chatLog.GetText(i);
+                        bool question = m_chatLog.GetRole(i) == ChatLog::Role::Question;
+                        ImGui::PushStyleColor(ImGuiCol_Text, question ? ImVec4(1, 1, 0, 1) : ImVec4(0, 1, 0, 1));
+                        ImGui::TextUnformatted(text.data(), text.data() + text.size());
+                        ImGui::PopStyleColor();
+                    }
+                    // Extend the content to the bottom of the last message so the scrollbar covers the whole log
+                    if (m_chatLog.Size() != 0)
                     {
-                        if (message.type == Message::Type::Question)
-                            ImGui::TextColored(ImVec4(1, 1, 0, 1), "Q: %s", message.text.c_str());
-                        else
-                            ImGui::TextColored(ImVec4(0, 1, 0, 1), "A: %s", message.text.c_str());
+                        ImGui::SetCursorPosY(top + m_chatLog.GetTotalHeight() - spacing);
+                        ImGui::Dummy(ImVec2(1.0f, 0.0f));
                     }
 
                     ImGui::PopTextWrapPos();  // Reset wrapping position
@@ -2067,7 +3674,7 @@ void NVIGIContext::BuildChatUI()
                         // We need to reacquire focus on the prompt input
                         setFocusOnPromptInput = true;
                     }
-                    else if ((newScrollMaxY == 0.0f) && (lastMsgCount != messages.size()))
+                    else if ((newScrollMaxY == 0.0f) && (lastMsgCount != m_chatLog.Size()))
                     {
                         // New text was added, but there's not enough text to require a scrollbar yet, but we still need to set focus to the prompt input
                         setFocusOnPromptInput = true;
@@ -2075,7 +3682,7 @@ void NVIGIContext::BuildChatUI()
 
                     // Update maximum scroll position and message count to check against next frame
                     lastScrollMaxY = newScrollMaxY;
-                    lastMsgCount = messages.size();
+                    lastMsgCount = m_chatLog.Size();
                 }
                 ImGui::EndChild();
             }
@@ -2088,24 +3695,8 @@ void NVIGIContext::BuildChatUI()
             // Input text box and button to send messages
             if (ImGui::InputText("##Input", inputBuffer, sizeof(inputBuffer), ImGuiInputTextFlags_EnterReturnsTrue))
             {
-                if (m_gpt.m_ready)
-                {
-                    m_gptInput = inputBuffer;
-                    m_gptInputReady = true;
-                    inputBuffer[0] = '\0';  // Clear the buffer
-                }
-                else if (m_tts.m_ready)
-                {
-                    m_newInferenceSequence = true;
-
-					auto inferTTS = [this]()->void
-						{
-							AppendTTSText(inputBuffer, true);
-                            inputBuffer[0] = '\0';  // Clear the buffer
-
-						};
-                    m_inferThread = new std::thread{ inferTTS };
-                }
+                SubmitTypedPrompt(inputBuffer);
+                inputBuffer[0] = '\0';  // Clear the buffer
                 // Focus is lost when we hit enter, so we need to reacquire it to type another prompt
                 setFocusOnPromptInput = true;
             }
@@ -2147,28 +3738,65 @@ void NVIGIContext::BuildChatUI()
             {
                 ImGui::SameLine();
                 if (ImGui::Button("Reset Chat"))
-                {
-                    m_conversationInitialized = false;
-                    messages.clear();
-                    messages.push_back({ Message::Type::Answer, "Conversation Reset: I'm here to chat - type a query or record audio to interact!" });
-                }
+                    ResetChat();
             }
         }
         if (ImGui::BeginChild("Performance"))
         {
+            BuildLatencyUI();
+            BuildSpeechStatsUI();
+            if (ImGui::TreeNode("GPT Backends"))
+            {
+                BuildGPTStatsUI();
+                ImGui::TreePop();
+            }
+            if (ImGui::TreeNode("Conversation History"))
+            {
+                BuildHistoryUI();
+                ImGui::TreePop();
+            }
+            if (ImGui::TreeNode("Structured Output"))
+            {
+                BuildStructuredOutputUI();
+                ImGui::TreePop();
+            }
+            if (ImGui::TreeNode("Memory"))
+            {
+                BuildMemoryUI();
+                ImGui::TreePop();
+            }
+            if (ImGui::TreeNode("Threads"))
+            {
+                BuildThreadsUI();
+                ImGui::TreePop();
+            }
+
             if (m_asr.m_ready)
                 ImGui::Text("ASR Total: %.2f ms", m_asrTimer.GetElapsedMiliseconds());
             if (m_gpt.m_ready)
                 ImGui::Text("GPT First Token: %.2f ms", m_gptFirstTokenTimer.GetElapsedMiliseconds());
             if (m_tts.m_ready)
                 ImGui::Text("TTS First Audio: %.2f ms", m_ttsFirstAudioTimer.GetElapsedMiliseconds());
+
+            // First inference after each load, split by whether the model was warmed up first
+            auto firstInferenceUI = [](const char* name, const StageInfo& stage)
+                {
+                    if (stage.m_coldFirstMs > 0.0 || stage.m_warmFirstMs > 0.0)
+                    {
+                        ImGui::Text("%s First After Load: cold %.2f ms, warm %.2f ms (warmup %.2f ms)", name,
+                            stage.m_coldFirstMs.load(), stage.m_warmFirstMs.load(), stage.m_warmupMs.load());
+                    }
+                };
+            firstInferenceUI("ASR", m_asr);
+            firstInferenceUI("GPT", m_gpt);
+            firstInferenceUI("TTS", m_tts);
         }
         ImGui::EndChild();
         ImGui::EndChild();
     }
     else
     {
-        if (m_gpt.m_info == nullptr || m_asr.m_info == nullptr)
+        if (m_gpt.m_model == kInvalidModel || m_asr.m_model == kInvalidModel)
             ImGui::Text("Loading models please wait ...");
         else
             ImGui::Text("No models selected ...");
@@ -2177,25 +3805,107 @@ void NVIGIContext::BuildChatUI()
 
 void NVIGIContext::BuildUI()
 {
+    DrainAnswerTokens();
+    UpdateModelReverts();
+    UpdateModelDownloads();
+    UpdateScript();
+    UpdateReplay();
+    UpdateSweep();
 
     if (m_gptInputReady)
     {
         m_gptInputReady = false;
 
-        messages.push_back({ Message::Type::Question, m_gptInput });
+        // The previous answer's last tokens go to its own entry, before the new ones are added
+        if (m_gpt.m_ready)
+            FlushInferenceThread();
+
+        m_chatLog.Append(ChatLog::Role::Question, m_gptInput);
 
         if (m_gpt.m_ready) {
-            messages.push_back({ Message::Type::Answer, "" });
-            FlushInferenceThread();
+            m_chatLog.Append(ChatLog::Role::Answer, "");
             LaunchGPT(m_gptInput);
         }
     }
+    UpdateHistory();
 
     BuildModelsStatusUI();
+
+    // The script owns the model instances until it finishes
+    if (m_scriptStarted && !m_scriptDone)
+    {
+        ImGui::Text("Script: %d of %d turns", (int)m_scriptRunner.GetCompletedTurns(), (int)m_scriptRunner.GetTotalTurns());
+        return;
+    }
+    if (const SweepPoint* point = m_sweep.GetPoint())
+    {
+        static const char* phases[] = { "applying", "settling", "idle", "inference" };
+        ImGui::Text("Sweep: point %d of %d, %s", (int)m_sweep.GetIndex() + 1, (int)m_sweep.GetCount(), phases[(int)m_sweep.GetPhase()]);
+        ImGui::Text("CPU load %.1f ms, GPU load %d, %s, coordinator %s, %s, %d FPS", point->m_cpuLoad, point->m_gpuLoad,
+            FrameSweep::GetSchedulingModeName(point->m_schedulingMode), FrameCoordinator::GetPolicyName(point->m_coordinator), m_gpt.Info() ? m_gpt.Info()->m_pluginName.c_str() : "none", point->m_targetFps);
+        if (m_sweep.GetPhase() == FrameSweep::Phase::Inference)
+            ImGui::Text("Script: %d of %d turns", (int)m_scriptRunner.GetCompletedTurns(), (int)m_scriptRunner.GetTotalTurns());
+        return;
+    }
+    // Model selections and prompts come from the log while replaying
+    if (!m_replaySessionPath.empty() && !m_replayDone)
+    {
+        ImGui::Text("Replaying %s", m_replaySessionPath.c_str());
+        BuildChatUI();
+        return;
+    }
+
     m_modelSettingsOpen = BuildModelsSelectUI();
     BuildChatUI();
 }
 
+void NVIGIContext::SetModelStatus(std::string_view guid, ModelStatus status)
+{
+    // Every plugin that runs the model shares its files, so all of them change status together
+    for (StageInfo* stage : { &m_asr, &m_gpt, &m_tts })
+    {
+        if (const ModelCatalog::Group* group = stage->m_catalog.FindGroup(guid))
+        {
+            for (ModelHandle h = group->begin(); h != group->end(); h++)
+            {
+                if (stage->m_catalog.Get(h).m_modelStatus != ModelStatus::AVAILABLE_CLOUD)
+                    stage->m_catalog.SetStatus(h, status);
+            }
+        }
+    }
+}
+
+void NVIGIContext::StartModelDownload(const PluginModelInfo& info)
+{
+    if (m_downloader.Start(info.m_guid, info.m_modelName))
+    {
+        donut::log::info("Downloading model %s (%s)", info.m_modelName.c_str(), info.m_guid.c_str());
+        SetModelStatus(info.m_guid, ModelStatus::AVAILABLE_DOWNLOADING);
+    }
+    else
+    {
+        donut::log::warning("Unable to start the download of model %s", info.m_modelName.c_str());
+    }
+}
+
+void NVIGIContext::UpdateModelDownloads()
+{
+    std::string guid, error;
+    while (m_downloader.TakeFinished(guid, error))
+    {
+        if (error.empty())
+        {
+            donut::log::info("Model %s downloaded and verified", guid.c_str());
+            SetModelStatus(guid, ModelStatus::AVAILABLE_LOCALLY);
+        }
+        else
+        {
+            donut::log::error("Download of model %s failed: %s", guid.c_str(), error.c_str());
+            SetModelStatus(guid, ModelStatus::AVAILABLE_DOWNLOADER);
+        }
+    }
+}
+
 void NVIGIContext::GetVRAMStats(size_t& current, size_t& budget)
 {
     DXGI_QUERY_VIDEO_MEMORY_INFO videoMemoryInfo{};
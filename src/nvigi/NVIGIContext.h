@@ -8,6 +8,7 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <exception>
 #include <fstream>
 #include <future>
@@ -31,6 +32,30 @@
 #include <dxgi1_5.h>
 
 #include "AudioRecordingHelper.h"
+#include "ChatLog.h"
+#include "ConversationHistory.h"
+#include "FrameCoordinator.h"
+#include "FramePacer.h"
+#include "FrameSweep.h"
+#include "GPTStats.h"
+#include "InferenceHost.h"
+#include "LatencyHistogram.h"
+#include "LoadTask.h"
+#include "MemorySampler.h"
+#include "ModelCatalog.h"
+#include "ModelDownloader.h"
+#include "PluginCapsCache.h"
+#include "SchedulingController.h"
+#include "ScriptRunner.h"
+#include "SessionLog.h"
+#include "SpeechStats.h"
+#include "StructuredOutput.h"
+#include "SyntheticBackend.h"
+#include "ThreadRegistry.h"
+#include "TokenQueue.h"
+#include "Trace.h"
+#include "TTSQualityController.h"
+#include "TTSStream.h"
 
 struct Parameters
 {
@@ -98,26 +123,8 @@ struct SimpleTimer {
 
 struct NVIGIContext
 {
-    enum ModelStatus {
-        AVAILABLE_LOCALLY,
-        AVAILABLE_CLOUD,
-        AVAILABLE_DOWNLOADER, // Not yet supported
-        AVAILABLE_DOWNLOADING, // Not yet supported
-        AVAILABLE_MANUAL_DOWNLOAD,
-        UNAVAILABLE
-    };
-    struct PluginModelInfo
-    {
-        std::string m_modelName;
-        std::string m_pluginName;
-        std::string m_caption; // plugin AND model
-        std::string m_guid;
-        std::string m_modelRoot;
-        std::string m_url;
-        size_t m_vram;
-        nvigi::PluginID m_featureID;
-        ModelStatus m_modelStatus;
-    };
+    using ModelStatus = ::ModelStatus;
+    using PluginModelInfo = ::PluginModelInfo;
 
     struct PluginBackendChoices
     {
@@ -129,10 +136,10 @@ struct NVIGIContext
 
     struct StageInfo
     {
-        PluginModelInfo* m_info{};
+        ModelHandle m_model = kInvalidModel;
         nvigi::InferenceInstance* m_inst{};
-        // Model GUID to info maps (maps model GUIDs to a list of plugins that run it)
-        std::map<std::string, std::vector<PluginModelInfo*>> m_pluginModelsMap{};
+        // Every plugin/model pairing for the stage, grouped by model GUID (a GUID lists the plugins that run it)
+        ModelCatalog m_catalog;
         PluginBackendChoices m_choices{};
         std::atomic<bool> m_ready = false;
         std::atomic<bool> m_running = false;
@@ -140,6 +147,21 @@ struct NVIGIContext
         std::condition_variable m_callbackCV;
         std::atomic<nvigi::InferenceExecutionState> m_callbackState;
         size_t m_vramBudget{};
+        LoadTask m_loadTask;
+        // Model the current instance was created from; m_model may already name the next one
+        const PluginModelInfo* m_loadedInfo = nullptr;
+        // UI thread: the model to go back to if the load in flight ends as Reverted
+        ModelHandle m_revertModel = kInvalidModel;
+
+        // First real inference after a load; warm if the warmup pass ran successfully beforehand
+        std::atomic<bool> m_awaitingFirstInference = false;
+        // Written by the load and inference threads, shown by the UI
+        std::atomic<bool> m_warmedUp = false;
+        std::atomic<double> m_warmupMs = 0.0;
+        std::atomic<double> m_coldFirstMs = 0.0;
+        std::atomic<double> m_warmFirstMs = 0.0;
+
+        const PluginModelInfo* Info() const { return m_catalog.Find(m_model); }
     };
 
     NVIGIContext() {}
@@ -155,25 +177,46 @@ struct NVIGIContext
     bool Initialize_postDevice();
     void SetDevice_nvrhi(nvrhi::IDevice* device);
     void Shutdown();
+    // Started with -inferenceHost by an -outOfProcess parent: serves its instances instead of opening a window
+    bool IsInferenceHost() const { return !m_inferenceHostName.empty(); }
+    int RunInferenceHost();
 
     bool CheckPluginCompat(nvigi::PluginID id, const std::string& name);
     bool AddGPTPlugin(nvigi::PluginID id, const std::string& name, const std::string& modelRoot);
     bool AddGPTCloudPlugin();
     bool AddASRPlugin(nvigi::PluginID id, const std::string& name, const std::string& modelRoot);
     bool AddTTSPlugin(nvigi::PluginID id, const std::string& name, const std::string& modelRoot);
+    void AddSyntheticPlugin(StageInfo& stage, SyntheticBackend::Stage kind);
+    nvigi::Result GetStageInterface(nvigi::PluginID id, nvigi::InferenceInterface** iface);
+
+    PluginCapsCache::Key GetCapsCacheKey(nvigi::PluginID id, const std::string& modelRoot);
+    bool AddCachedPluginModels(StageInfo& stage, nvigi::PluginID id, const std::string& name, const std::string& modelRoot);
+    void CachePluginModels(const StageInfo& stage, nvigi::PluginID id, const std::string& modelRoot);
 
     void GetVRAMStats(size_t& current, size_t& budget);
 
-    void LaunchASR();
+    void SetModelStatus(std::string_view guid, ModelStatus status);
+    void StartModelDownload(const PluginModelInfo& info);
+    void UpdateModelDownloads();
+
+    // Without audio, the microphone recording is stopped and transcribed
+    void LaunchASR(std::vector<uint8_t> audio = {});
     void LaunchGPT(std::string prompt);
+    void SubmitTypedPrompt(const std::string& text);
+    void ResetChat();
+    // Summarizes old turns and rebuilds the GPT context while the chat is idle
+    void UpdateHistory();
+    void LaunchHistoryWork();
     void AppendTTSText(std::string text, bool done);
     void LaunchTTS(std::string prompt);
 
     bool ModelsComboBox(const std::string& label, bool automatic,
         StageInfo& stage,
-        NVIGIContext::PluginModelInfo*& value);
-    bool SelectAutoPlugin(const StageInfo& stage, const std::vector<PluginModelInfo*>& options, PluginModelInfo*& model);
+        ModelHandle& value);
+    bool SelectAutoPlugin(const StageInfo& stage, const ModelCatalog::Group& options, ModelHandle& model);
+    ModelHandle SelectInitialModel(const StageInfo& stage, bool allowCpu);
     bool BuildModelsSelectUI();
+    void BuildLoadStatusUI(const char* name, const StageInfo& stage);
     void BuildModelsStatusUI();
     void BuildChatUI();
     void BuildUI();
@@ -186,28 +229,70 @@ struct NVIGIContext
     virtual nvigi::ASRWhisperCreationParameters* GetASRCreationParams(bool genericInit, const std::string* modelRoot = nullptr);
     virtual nvigi::TTSCreationParameters* GetTTSCreationParams(bool genericInit, const std::string* modelRoot = nullptr);
 
-    void ReloadGPTModel(PluginModelInfo* newInfo);
-    void ReloadASRModel(PluginModelInfo* newInfo);
-    void ReloadTTSModel(PluginModelInfo* newInfo);
+    void ReloadGPTModel(ModelHandle newModel);
+    void ReloadASRModel(ModelHandle newModel);
+    void ReloadTTSModel(ModelHandle newModel);
+    // Points a stage whose load fell back to its previous model at that model again
+    void UpdateModelReverts();
     void FlushInferenceThread();
+    void DrainAnswerTokens();
+    // Queues the segments a parser found, for the UI thread to hand to OnStructuredEvent
+    void RouteStructuredEvents(const char* source, std::vector<StructuredEvent>& events);
+    // Where the game picks up the tagged JSON segments of the GPT and ASR output; logs them by default
+    virtual void OnStructuredEvent(const StructuredEvent& event);
+
+    // Warmup runs a tiny synthetic input on a freshly created instance, on the loading thread
+    bool WarmupGPT();
+    bool WarmupASR();
+    bool WarmupTTS();
+    template <typename T> bool CreateStageInstance(LoadTask& task, StageInfo& stage, nvigi::InferenceInterface*& iface,
+        const PluginModelInfo& info, T* params, bool redirectLog);
+    void DestroyStageInstance(StageInfo& stage, nvigi::InferenceInterface* iface);
+    void OnModelLoaded(StageInfo& stage);
+    const char* GetStageName(const StageInfo& stage) const { return (&stage == &m_gpt) ? "GPT" : ((&stage == &m_asr) ? "ASR" : "TTS"); }
+    void RecordFirstInference(StageInfo& stage, const char* name, double ms);
+
+    std::vector<NamedLatencyHistogram> GetLatencyHistograms() const;
+    void BuildLatencyUI();
+    void BuildSpeechStatsUI();
+    void BuildGPTStatsUI();
+    void BuildHistoryUI();
+    void BuildStructuredOutputUI();
+    void BuildMemoryUI();
+    void BuildThreadsUI();
+    void WriteLatencyReport();
+    ScriptRunner::Stages GetScriptStages(bool resetConversation);
+    void UpdateScript();
+    void FinishScript();
+    void RecordModelSelection(SessionEvent::Stage kind, const StageInfo& stage);
+    void UpdateReplay();
+    void FinishReplay();
+    void UpdateSweep();
+    void FinishSweep();
+    // Overrides the simulated game load with the current sweep point, if a sweep is running
+    void ApplySweepLoad(float& cpuLoad, int& gpuLoad) const;
 
     void FramerateLimit()
     {
         if (!m_framerateLimiting)
+        {
+            m_framePacer.Reset();
             return;
+        }
 
-        if (m_framerateTimer.running)
-        {
-            m_framerateTimer.Stop();
-            double leftoverTime = 1000.0 / (double)m_targetFramerate - m_framerateTimer.GetElapsedMiliseconds();
-			if (leftoverTime > 0.0)
-				std::this_thread::sleep_for(std::chrono::milliseconds((int)leftoverTime));
-		}
-        m_framerateTimer.Start();
+        NVIGI_TRACE_ZONE("FramerateLimit");
+        m_framePacer.Wait(1000.0 / (double)m_targetFramerate);
     }
+    static constexpr int kMaxTargetFramerate = 300;
     bool m_framerateLimiting = false;
     int m_targetFramerate = 60;
-	SimpleTimer m_framerateTimer;
+    FramePacer m_framePacer;
+
+    // Fits inference steps into the frame's slack; the budget is the limiter's target, or m_frameBudgetMs without it
+    FrameCoordinator m_frameCoordinator;
+    double m_frameBudgetMs = 1000.0 / 60.0;
+    double GetFrameTargetMs() const { return m_framerateLimiting ? 1000.0 / m_targetFramerate : m_frameBudgetMs; }
+    void BuildFrameCoordinatorUI();
 
     StageInfo m_asr;
     StageInfo m_gpt;
@@ -218,7 +303,7 @@ struct NVIGIContext
 
     bool GetCloudModelAPIKey(const PluginModelInfo& info, const char* & key, std::string& apiKeyName)
     {
-        if (info.m_url.find("integrate.api.nvidia.com") != std::string::npos)
+        if (info.m_url.view().find("integrate.api.nvidia.com") != std::string::npos)
         {
             if (m_nvdaKey.empty())
             {
@@ -236,7 +321,7 @@ struct NVIGIContext
             key = m_nvdaKey.c_str();
             return true;
         }
-        else if (info.m_url.find("openai.com") != std::string::npos)
+        else if (info.m_url.view().find("openai.com") != std::string::npos)
         {
             if (m_openAIKey.empty())
             {
@@ -276,10 +361,6 @@ struct NVIGIContext
 
         nvigi::InferenceExecutionContext m_ttsCtx{};
 
-        size_t posLastSpace = 0; // used to handle TTS input chunks
-        size_t posLastPeriod = 0; // used to handle TTS input chunks
-        size_t posLastComma = 0; // used to handle TTS input chunks
-
         ~TTSInferenceContext() {
             while (true) {
                 std::unique_ptr<std::thread> thread;
@@ -312,14 +393,31 @@ struct NVIGIContext
     bool m_useCiG = true;
 
     int m_adapter = -1;
-    nvigi::PluginAndSystemInformation* m_pluginInfo;
+    // Null when running on the synthetic backend without the NVIGI core
+    nvigi::PluginAndSystemInformation* m_pluginInfo{};
+    bool m_syntheticBackend = false;
+    // -outOfProcess: instances are created in a child process and reached through InferenceHost
+    bool m_outOfProcess = false;
+    int m_hostStallMs = 10000;
+    std::vector<std::string> m_hostArgs;
+    std::string m_inferenceHostName = "";
+
+    PluginCapsCache m_capsCache;
+    std::string m_capsCachePath = "";
+    bool m_useCapsCache = true;
+    bool m_rebuildCapsCache = false;
+    int m_capsCacheHits = 0;
+    int m_capsCacheMisses = 0;
+
+    ModelDownloader m_downloader;
+    std::string m_downloadManifestPath = "";
 
     nvigi::IGeneralPurposeTransformer* m_igpt{};
     nvigi::IAutoSpeechRecognition* m_iasr{};
     nvigi::ITextToSpeech* m_itts{};
     nvigi::IHWICuda* m_cig{};
     nvigi::IHWICommon* m_hwiCommon{};
-    std::string m_ttsInput;
+    TTSChunker m_ttsChunker;
 
     std::string grpcMetadata{};
     std::string nvcfToken{};
@@ -329,22 +427,40 @@ struct NVIGIContext
     std::atomic<bool> m_gptInputReady = false;
     std::string m_a2t;
     std::string m_gptInput;
-    std::mutex m_mtx;
+    // GPT answer text from the inference callbacks; the UI thread appends it to the chat once per frame
+    TokenQueue m_answerTokens;
+    // Split the tagged JSON segments out of the streamed text, on the inference thread
+    StructuredOutputParser m_gptOutputParser;
+    StructuredOutputParser m_asrOutputParser;
+    StructuredEventQueue m_structuredEvents;
+    // UI thread only
+    std::deque<StructuredEvent> m_recentEvents;
+    uint32_t m_structuredActions = 0;
+    uint32_t m_structuredData = 0;
+    uint32_t m_structuredErrors = 0;
+    ChatLog m_chatLog;
     std::vector<uint8_t> m_wavRecording;
-    bool m_conversationInitialized = false;
+    // Set once the GPT instance holds the conversation; m_history decides what it holds
+    std::atomic<bool> m_conversationInitialized = false;
+    static constexpr uint32_t kGPTTokensToPredict = 200;
+    ConversationHistory m_history;
+    uint32_t m_historyTokens = 3072;
+    // Idle history work in flight stops at its next callback
+    std::atomic<bool> m_historyCancel = false;
     std::atomic<bool> m_ttsInputReady = false;
 
     bool m_modelSettingsOpen = false;
     bool m_automaticBackendSelection = false;
+    bool m_warmupModels = false;
 
     std::thread* m_inferThread{};
     std::atomic<bool> m_inferThreadRunning = false;
-    std::thread* m_loadingThread{};
+    std::mutex m_createMutex;
 
     std::vector<int16_t> m_ttsOutputAudio;
     AudioRecordingHelper::RecordingInfo* m_audioInfo{};
 
-    nvigi::BaseStructure* Get3DInfo(PluginModelInfo* info);
+    nvigi::BaseStructure* Get3DInfo(const PluginModelInfo* info);
 
 #ifdef USE_DX12
     nvigi::D3D12Parameters* m_d3d12Params{};
@@ -355,11 +471,78 @@ struct NVIGIContext
 #endif
     nvrhi::GraphicsAPI m_api = nvrhi::GraphicsAPI::D3D12;
     size_t m_maxVRAM = 0;
-    uint32_t m_schedulingMode = nvigi::SchedulingMode::kPrioritizeCompute;
+    // Read by the inference threads before each evaluate and, with adaptive scheduling, between GPT tokens
+    std::atomic<uint32_t> m_schedulingMode = nvigi::SchedulingMode::kPrioritizeCompute;
+    SchedulingController m_schedulingController;
+    // Mode last handed to the plugins by the GPT thread
+    uint32_t m_gptSchedulingMode = 0;
 
 	SimpleTimer m_asrTimer;
     SimpleTimer m_gptFirstTokenTimer;
     SimpleTimer m_ttsFirstAudioTimer;
+    SimpleTimer m_speechToSpeechTimer;
+    SimpleTimer m_frameTimer;
+
+    // Distributions of the timers above; recorded from the inference threads and written out on shutdown
+    LatencyHistogram m_asrLatency;
+    LatencyHistogram m_gptFirstTokenLatency;
+    LatencyHistogram m_gptTokenLatency;
+    LatencyHistogram m_ttsFirstAudioLatency;
+    LatencyHistogram m_speechToSpeechLatency;
+    LatencyHistogram m_frameLatency;
+    std::string m_latencyReportPath = "";
+
+    // Per-backend GPT throughput; m_gptRequest is the evaluation in flight
+    GPTStatsTable m_gptStats;
+    GPTRequestStats m_gptRequest;
+
+    // ASR/TTS real-time factor and TTS playback lead; m_ttsSynthesisMark is when the current TTS chunk started
+    static constexpr int kTTSSampleRate = 22050;
+    SpeechStats m_speechStats;
+    SpeechStats::Clock::time_point m_ttsSynthesisMark;
+    // Chunk sizes for TTS; m_ttsLevel is the level of the evaluate in flight
+    TTSQualityController m_ttsQuality;
+    size_t m_ttsLevel = TTSQualityController::kDefaultLevel;
+
+    // VRAM/RSS timeline with model load events; 0 disables the background sampling
+    MemorySampler m_memorySampler;
+    int m_memorySampleMs = 100;
+    std::vector<float> m_memoryPlotVRAM;
+    std::vector<float> m_memoryPlotRSS;
+
+    // Chrome trace capture: -traceFrames captures from startup, the UI button captures on demand
+    std::string m_tracePath = "";
+    int m_traceFrames = 0;
+    int m_traceCaptureFrames = 300;
+
+    // Headless conversation script (-script); starts once the initial model loads settle and closes the app when done
+    ScriptRunner m_scriptRunner;
+    std::vector<ScriptTurn> m_scriptTurns;
+    ScriptRunner::Options m_scriptOptions;
+    std::string m_scriptPath = "";
+    bool m_scriptStarted = false;
+    bool m_scriptDone = false;
+    std::atomic<bool> m_exitRequested = false;
+    int m_exitCode = 0;
+
+    // Session record/replay: every pipeline input and callback output goes to m_sessionRecorder while it runs,
+    // and -replaySession feeds the inputs of a log back in, then diffs the outputs against it
+    SessionRecorder m_sessionRecorder;
+    SessionReplayer m_sessionReplayer;
+    std::vector<SessionEvent> m_replayEvents;
+    std::string m_recordSessionPath = "";
+    std::string m_replaySessionPath = "";
+    double m_replaySpeed = 1.0;
+    bool m_replayStarted = false;
+    bool m_replayDone = false;
+
+    // Frame-time sweep (-sweep): applies each point's load and inference settings, then measures frame times
+    // idle and while the spec's script runs; m_sweepReloadRequested is set while switching the GPT backend
+    FrameSweep m_sweep;
+    FrameSweep::Spec m_sweepSpec;
+    std::string m_sweepPath = "";
+    std::string m_sweepReportPath = "";
+    bool m_sweepReloadRequested = false;
 };
 
 struct cerr_redirect {
@@ -0,0 +1,252 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "PluginCapsCache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    constexpr uint32_t kCacheMagic = 0x4343474e; // 'NGCC'
+    constexpr uint32_t kCacheVersion = 1;
+
+    // Keeps entries from colliding when summed into an order-independent tree stamp
+    uint64_t Mix(uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+    struct Writer
+    {
+        std::ofstream& out;
+
+        template <typename T> void Pod(const T& value)
+        {
+            out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+        void String(const std::string& value)
+        {
+            Pod((uint32_t)value.size());
+            out.write(value.data(), value.size());
+        }
+    };
+
+    struct Reader
+    {
+        std::ifstream& in;
+
+        template <typename T> bool Pod(T& value)
+        {
+            in.read(reinterpret_cast<char*>(&value), sizeof(T));
+            return in.good();
+        }
+        bool String(std::string& value)
+        {
+            uint32_t size = 0;
+            // Guard against a truncated or corrupted file asking for a huge allocation
+            if (!Pod(size) || size > (1u << 20))
+                return false;
+            value.resize(size);
+            in.read(value.data(), size);
+            return in.good();
+        }
+    };
+}
+
+uint64_t PluginCapsCache::HashBytes(const void* data, size_t size, uint64_t seed)
+{
+    // FNV-1a
+    uint64_t hash = seed;
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint64_t PluginCapsCache::GetFileStamp(const std::string& path)
+{
+    std::error_code ec;
+    uint64_t size = fs::file_size(path, ec);
+    if (ec)
+        return 0;
+    int64_t time = fs::last_write_time(path, ec).time_since_epoch().count();
+    if (ec)
+        return 0;
+
+    uint64_t stamp = HashBytes(&size, sizeof(size));
+    return HashBytes(&time, sizeof(time), stamp);
+}
+
+uint64_t PluginCapsCache::GetDirectoryTreeStamp(const std::string& root)
+{
+    auto it = m_treeStamps.find(root);
+    if (it != m_treeStamps.end())
+        return it->second;
+
+    std::error_code ec;
+    uint64_t stamp = 0;
+    uint64_t count = 0;
+    for (auto iter = fs::recursive_directory_iterator(root, fs::directory_options::skip_permission_denied, ec);
+        !ec && iter != fs::recursive_directory_iterator(); iter.increment(ec))
+    {
+        const fs::directory_entry& entry = *iter;
+        std::string relative = entry.path().lexically_relative(root).generic_string();
+        uint64_t entryHash = HashBytes(relative.data(), relative.size());
+
+        std::error_code entryEc;
+        int64_t time = entry.last_write_time(entryEc).time_since_epoch().count();
+        entryHash = HashBytes(&time, sizeof(time), entryHash);
+        if (entry.is_regular_file(entryEc))
+        {
+            uint64_t size = entry.file_size(entryEc);
+            entryHash = HashBytes(&size, sizeof(size), entryHash);
+        }
+
+        stamp += Mix(entryHash);
+        count++;
+    }
+
+    // An unreadable or missing models root still gets a stable, distinct stamp
+    stamp = HashBytes(&count, sizeof(count), stamp);
+    m_treeStamps[root] = stamp;
+    return stamp;
+}
+
+std::string PluginCapsCache::MakeLookupKey(const nvigi::PluginID& id, const std::string& modelRoot)
+{
+    std::string key(reinterpret_cast<const char*>(&id), sizeof(id));
+    key += modelRoot;
+    return key;
+}
+
+bool PluginCapsCache::Load(const std::string& path, uint64_t systemStamp)
+{
+    m_systemStamp = systemStamp;
+    m_entries.clear();
+    m_dirty = false;
+
+    std::ifstream file(path, std::ios::binary | std::ios::in);
+    if (!file.is_open())
+        return false;
+
+    Reader in{ file };
+    uint32_t magic = 0, version = 0, numEntries = 0;
+    uint64_t fileSystemStamp = 0;
+    if (!in.Pod(magic) || magic != kCacheMagic ||
+        !in.Pod(version) || version != kCacheVersion ||
+        !in.Pod(fileSystemStamp) || fileSystemStamp != systemStamp ||
+        !in.Pod(numEntries))
+    {
+        m_dirty = true;
+        return false;
+    }
+
+    std::map<std::string, Entry> entries;
+    for (uint32_t i = 0; i < numEntries; i++)
+    {
+        Entry entry;
+        uint32_t numModels = 0;
+        if (!in.Pod(entry.m_key.m_featureID) || !in.Pod(entry.m_key.m_binaryStamp) ||
+            !in.Pod(entry.m_key.m_modelsStamp) || !in.String(entry.m_key.m_modelRoot) ||
+            !in.Pod(numModels))
+        {
+            m_dirty = true;
+            return false;
+        }
+
+        entry.m_models.resize(numModels);
+        for (auto& model : entry.m_models)
+        {
+            if (!in.String(model.m_modelName) || !in.String(model.m_guid) || !in.String(model.m_url) ||
+                !in.Pod(model.m_vram) || !in.Pod(model.m_status))
+            {
+                m_dirty = true;
+                return false;
+            }
+        }
+
+        std::string lookup = MakeLookupKey(entry.m_key.m_featureID, entry.m_key.m_modelRoot);
+        entries[lookup] = std::move(entry);
+    }
+
+    m_entries = std::move(entries);
+    return true;
+}
+
+bool PluginCapsCache::Save(const std::string& path) const
+{
+    // Write next to the destination and swap it in, so a crash mid-write never leaves a torn cache
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::out | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+
+        Writer out{ file };
+        out.Pod(kCacheMagic);
+        out.Pod(kCacheVersion);
+        out.Pod(m_systemStamp);
+        out.Pod((uint32_t)m_entries.size());
+        for (auto& iter : m_entries)
+        {
+            const Entry& entry = iter.second;
+            out.Pod(entry.m_key.m_featureID);
+            out.Pod(entry.m_key.m_binaryStamp);
+            out.Pod(entry.m_key.m_modelsStamp);
+            out.String(entry.m_key.m_modelRoot);
+            out.Pod((uint32_t)entry.m_models.size());
+            for (auto& model : entry.m_models)
+            {
+                out.String(model.m_modelName);
+                out.String(model.m_guid);
+                out.String(model.m_url);
+                out.Pod(model.m_vram);
+                out.Pod(model.m_status);
+            }
+        }
+
+        if (!file.good())
+            return false;
+    }
+
+    std::error_code ec;
+    fs::rename(tempPath, path, ec);
+    if (ec)
+    {
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool PluginCapsCache::Find(const Key& key, std::vector<Model>& models) const
+{
+    auto it = m_entries.find(MakeLookupKey(key.m_featureID, key.m_modelRoot));
+    if (it == m_entries.end())
+        return false;
+
+    const Key& cached = it->second.m_key;
+    if (cached.m_binaryStamp != key.m_binaryStamp || cached.m_modelsStamp != key.m_modelsStamp)
+        return false;
+
+    models = it->second.m_models;
+    return true;
+}
+
+void PluginCapsCache::Store(const Key& key, const std::vector<Model>& models)
+{
+    Entry& entry = m_entries[MakeLookupKey(key.m_featureID, key.m_modelRoot)];
+    entry.m_key = key;
+    entry.m_models = models;
+    m_dirty = true;
+}
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <nvigi_struct.h>
+
+// On-disk cache of the model lists returned by getCapsAndRequirements, so that a warm start
+// can fill the model selection UI without loading every plugin DLL.
+//
+// Entries are keyed by plugin ID, a stamp of the plugin binary (version, size and mtime) and a
+// stamp of the models tree the plugin was queried against.  Any change to either invalidates
+// the entry.  The whole file is also tied to a "system" stamp (SDK version, adapter and driver),
+// so a driver or GPU change throws the cache away.
+class PluginCapsCache
+{
+public:
+    struct Model
+    {
+        std::string m_modelName;
+        std::string m_guid;
+        std::string m_url;
+        uint64_t m_vram = 0;
+        uint8_t m_status = 0;
+    };
+
+    struct Key
+    {
+        nvigi::PluginID m_featureID{};
+        uint64_t m_binaryStamp = 0;
+        uint64_t m_modelsStamp = 0;
+        std::string m_modelRoot;
+    };
+
+    bool Load(const std::string& path, uint64_t systemStamp);
+    bool Save(const std::string& path) const;
+
+    bool Find(const Key& key, std::vector<Model>& models) const;
+    void Store(const Key& key, const std::vector<Model>& models);
+
+    bool IsDirty() const { return m_dirty; }
+
+    // Stamp of a single file: size and last write time; 0 if the file does not exist
+    static uint64_t GetFileStamp(const std::string& path);
+    // Order-independent stamp of every file and directory below root (names, sizes and write times).
+    // Results are memoized per root for the lifetime of the cache object.
+    uint64_t GetDirectoryTreeStamp(const std::string& root);
+
+    static uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 14695981039346656037ull);
+
+private:
+    struct Entry
+    {
+        Key m_key;
+        std::vector<Model> m_models;
+    };
+
+    static std::string MakeLookupKey(const nvigi::PluginID& id, const std::string& modelRoot);
+
+    uint64_t m_systemStamp = 0;
+    std::map<std::string, Entry> m_entries;
+    std::map<std::string, uint64_t> m_treeStamps;
+    bool m_dirty = false;
+};
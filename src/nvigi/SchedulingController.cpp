@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "SchedulingController.h"
+
+#include <nvigi.h>
+#include <nvigi_hwi_common.h>
+
+#include <donut/core/log.h>
+
+#include <algorithm>
+#include <fstream>
+
+namespace
+{
+    constexpr double kOverTarget = 1.1;
+    constexpr double kUnderTarget = 0.9;
+    constexpr double kMinDwellMs = 1000.0;
+    constexpr size_t kMinFrames = 16;
+    // Weight of the newest inter-token time
+    constexpr double kTokenSmoothing = 0.2;
+    constexpr size_t kMaxDecisions = 4096;
+
+    // From prioritizing graphics to prioritizing inference
+    const uint32_t kLevels[] = { nvigi::SchedulingMode::kPrioritizeGraphics, nvigi::SchedulingMode::kBalance, nvigi::SchedulingMode::kPrioritizeCompute };
+    const char* kLevelNames[] = { "graphics", "balanced", "inference" };
+
+    int GetLevel(uint32_t mode)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            if (kLevels[i] == mode)
+                return i;
+        }
+        return 1;
+    }
+}
+
+void SchedulingController::SetEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    m_frameCount = 0;
+    m_timeInModeMs = 0.0;
+}
+
+void SchedulingController::BeginRequest()
+{
+    m_firstToken = false;
+    m_tokenMs = 0.0;
+    m_requestStartUs = std::max<int64_t>(1, GetNowUs());
+}
+
+void SchedulingController::RecordToken(bool first, double ms)
+{
+    if (first)
+    {
+        m_firstToken = true;
+        return;
+    }
+    double smoothed = m_tokenMs;
+    m_tokenMs = smoothed > 0.0 ? smoothed + kTokenSmoothing * (ms - smoothed) : ms;
+}
+
+void SchedulingController::EndRequest()
+{
+    m_requestStartUs = 0;
+}
+
+bool SchedulingController::Update(double frameMs, uint32_t& mode)
+{
+    m_frames[m_frameCount++ % kWindow] = frameMs;
+    m_timeInModeMs += frameMs;
+
+    size_t count = std::min(m_frameCount, kWindow);
+    std::array<double, kWindow> sorted = m_frames;
+    size_t p95 = count * 95 / 100;
+    std::nth_element(sorted.begin(), sorted.begin() + p95, sorted.begin() + count);
+    m_frameP95Ms = sorted[p95];
+
+    int64_t startUs = m_requestStartUs;
+    if (startUs == 0)
+    {
+        m_latencyMs = 0.0;
+        m_latencyTargetMs = 0.0;
+    }
+    else if (!m_firstToken)
+    {
+        m_latencyMs = (GetNowUs() - startUs) / 1000.0;
+        m_latencyTargetMs = m_ttftTargetMs;
+    }
+    else
+    {
+        m_latencyMs = m_tokenMs;
+        m_latencyTargetMs = m_tokenTargetMs;
+    }
+
+    if (!m_enabled || m_frameCount < kMinFrames || m_timeInModeMs < kMinDwellMs)
+        return false;
+
+    int level = GetLevel(mode);
+    int next = level;
+    const char* reason = "";
+    // The frame comes first: inference only gets priority while the frames are comfortably within target
+    if (IsFrameOverTarget() && level > 0)
+    {
+        next = level - 1;
+        reason = "frame time over target";
+    }
+    else if (m_latencyTargetMs > 0.0 && m_latencyMs > m_latencyTargetMs * kOverTarget && m_frameP95Ms < m_frameTargetMs * kUnderTarget && level < 2)
+    {
+        next = level + 1;
+        reason = m_firstToken ? "inter-token time over target" : "time to first token over target";
+    }
+    if (next == level)
+    {
+        if (kLevels[level] == mode)
+            return false;
+        // An unknown mode is moved to balanced
+        reason = "unknown mode";
+    }
+
+    Decision decision;
+    decision.m_timeS = std::chrono::duration<double>(Clock::now() - m_epoch).count();
+    decision.m_from = mode;
+    decision.m_to = kLevels[next];
+    decision.m_frameP95Ms = m_frameP95Ms;
+    decision.m_frameTargetMs = m_frameTargetMs;
+    decision.m_latencyMs = m_latencyMs;
+    decision.m_latencyTargetMs = m_latencyTargetMs;
+    decision.m_reason = reason;
+    if (m_decisions.size() == kMaxDecisions)
+        m_decisions.erase(m_decisions.begin());
+    m_decisions.push_back(decision);
+    donut::log::info("Scheduling: %s -> %s, %s (frame p95 %.2f / %.2f ms, latency %.1f / %.1f ms)", kLevelNames[level], kLevelNames[next],
+        reason, m_frameP95Ms, m_frameTargetMs, m_latencyMs, m_latencyTargetMs);
+
+    mode = kLevels[next];
+    m_frameCount = 0;
+    m_timeInModeMs = 0.0;
+    return true;
+}
+
+bool SchedulingController::IsFrameOverTarget() const
+{
+    return m_frameP95Ms > m_frameTargetMs * kOverTarget;
+}
+
+bool SchedulingController::WriteCSV(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+        return false;
+
+    file << "time_s,from,to,reason,frame_p95_ms,frame_target_ms,latency_ms,latency_target_ms\n";
+    for (const auto& d : m_decisions)
+    {
+        file << d.m_timeS << "," << kLevelNames[GetLevel(d.m_from)] << "," << kLevelNames[GetLevel(d.m_to)] << "," << d.m_reason << ","
+            << d.m_frameP95Ms << "," << d.m_frameTargetMs << "," << d.m_latencyMs << "," << d.m_latencyTargetMs << "\n";
+    }
+    return file.good();
+}
@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Picks the GPU inference scheduling mode from how the frame and the current GPT request are doing.
+//
+// The modes are treated as three steps, from prioritizing graphics through balanced to prioritizing
+// inference.  Each frame the controller compares the p95 frame time of the recent frames with the frame
+// target, and the latency of the current request with its target: the time to first token while it
+// waits for one, then the smoothed inter-token time.  Frames over target move one step towards graphics;
+// latency over target moves one step towards inference if the frames have room to spare.  Both need to
+// be more than 10% over (or under) target, and a step is only taken once the window has seen a second
+// of frames in the current mode, so the mode does not flip back and forth.  A heavy scene therefore
+// keeps graphics first, and a conversation over a light scene gets inference first, without a toggle.
+class SchedulingController
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Decision
+    {
+        // Seconds since the controller was created
+        double m_timeS = 0.0;
+        uint32_t m_from = 0;
+        uint32_t m_to = 0;
+        double m_frameP95Ms = 0.0;
+        double m_frameTargetMs = 0.0;
+        double m_latencyMs = 0.0;
+        double m_latencyTargetMs = 0.0;
+        const char* m_reason = "";
+    };
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const { return m_enabled; }
+
+    // The frame target follows the framerate limiter; the latency targets are set by the user
+    void SetFrameTargetMs(double ms) { m_frameTargetMs = ms; }
+    void SetTTFTTargetMs(double ms) { m_ttftTargetMs = ms; }
+    double GetTTFTTargetMs() const { return m_ttftTargetMs; }
+    void SetTokenTargetMs(double ms) { m_tokenTargetMs = ms; }
+    double GetTokenTargetMs() const { return m_tokenTargetMs; }
+
+    // Inference thread: a GPT request and its tokens
+    void BeginRequest();
+    void RecordToken(bool first, double ms);
+    void EndRequest();
+
+    // Render thread, once per frame; returns true and sets mode when the mode should change
+    bool Update(double frameMs, uint32_t& mode);
+
+    double GetFrameP95Ms() const { return m_frameP95Ms; }
+    // The p95 frame time is more than 10% over target
+    bool IsFrameOverTarget() const;
+    // Latency of the current request against its target, 0 without one
+    double GetLatencyMs() const { return m_latencyMs; }
+    double GetLatencyTargetMs() const { return m_latencyTargetMs; }
+    const std::vector<Decision>& GetDecisions() const { return m_decisions; }
+
+    bool WriteCSV(const std::string& path) const;
+
+private:
+    static constexpr size_t kWindow = 64;
+
+    int64_t GetNowUs() const { return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_epoch).count(); }
+
+    bool m_enabled = false;
+    double m_frameTargetMs = 1000.0 / 60.0;
+    double m_ttftTargetMs = 500.0;
+    double m_tokenTargetMs = 50.0;
+
+    // Written by the inference thread
+    std::atomic<int64_t> m_requestStartUs = 0;
+    std::atomic<bool> m_firstToken = false;
+    std::atomic<double> m_tokenMs = 0.0;
+
+    std::array<double, kWindow> m_frames{};
+    // Frames since the last mode change, the newest kWindow of which are in m_frames
+    size_t m_frameCount = 0;
+    double m_frameP95Ms = 0.0;
+    double m_latencyMs = 0.0;
+    double m_latencyTargetMs = 0.0;
+    double m_timeInModeMs = 0.0;
+    std::vector<Decision> m_decisions;
+    Clock::time_point m_epoch = Clock::now();
+};
@@ -0,0 +1,681 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "ScriptRunner.h"
+#include "AudioToBytes.h"
+#include "FrameCoordinator.h"
+#include "LatencyHistogram.h"
+#include "SchedulingController.h"
+#include "StructuredOutput.h"
+#include "ThreadRegistry.h"
+#include "TTSStream.h"
+
+#include <nvigi.h>
+#include <nvigi_ai.h>
+#include <nvigi_asr_whisper.h>
+#include <nvigi_gpt.h>
+#include <nvigi_stl_helpers.h>
+#include <nvigi_tts.h>
+
+#include <donut/core/log.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    constexpr uint32_t kASRSampleRate = 16000;
+
+    double ElapsedMs(ScriptRunner::Clock::time_point from, ScriptRunner::Clock::time_point to)
+    {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    // An evaluation that goes this long without a callback is given up on
+    constexpr auto kStallTimeout = std::chrono::seconds(60);
+
+    struct EvaluateSync
+    {
+        std::function<void(const nvigi::InferenceDataSlotArray& outputs)> m_onOutput;
+    };
+
+    // Shared by Evaluate and the callback.  If Evaluate gives up on a stalled backend, the callback may
+    // still come later, so the state is left to it: it drops the outputs, asks the backend to cancel and
+    // frees the state.
+    struct PendingEvaluate
+    {
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        nvigi::InferenceExecutionState m_state = nvigi::kInferenceExecutionStateDataPending;
+        uint64_t m_callbacks = 0;
+        bool m_abandoned = false;
+        EvaluateSync* m_sync = nullptr;
+    };
+
+    nvigi::InferenceExecutionState scriptCallback(const nvigi::InferenceExecutionContext* ctx, nvigi::InferenceExecutionState state, void* data)
+    {
+        if (!data)
+            return nvigi::kInferenceExecutionStateInvalid;
+
+        PendingEvaluate* pending = (PendingEvaluate*)data;
+        std::unique_lock lck(pending->m_mutex);
+        if (pending->m_abandoned)
+        {
+            lck.unlock();
+            delete pending;
+            return nvigi::kInferenceExecutionStateCancel;
+        }
+
+        // Under the lock, so Evaluate cannot give up while the caller's outputs are being written
+        pending->m_callbacks++;
+        if (ctx && ctx->outputs && pending->m_sync->m_onOutput)
+            pending->m_sync->m_onOutput(*ctx->outputs);
+
+        if (state != nvigi::kInferenceExecutionStateDataPending)
+        {
+            pending->m_state = state;
+            pending->m_cv.notify_one();
+        }
+        return state;
+    }
+
+    // Runs one evaluation and waits for the callback to leave DataPending, since it may be asynchronous.
+    // Fails if the backend stops calling back for kStallTimeout.
+    bool Evaluate(nvigi::InferenceInstance* inst, nvigi::InferenceExecutionContext& ctx, EvaluateSync& sync)
+    {
+        PendingEvaluate* pending = new PendingEvaluate;
+        pending->m_sync = &sync;
+        ctx.instance = inst;
+        ctx.callback = scriptCallback;
+        ctx.callbackUserData = pending;
+
+        if (inst->evaluate(&ctx) != nvigi::kResultOk)
+        {
+            delete pending;
+            return false;
+        }
+
+        std::unique_lock lck(pending->m_mutex);
+        uint64_t seen = pending->m_callbacks;
+        while (!pending->m_cv.wait_for(lck, kStallTimeout, [pending]() { return pending->m_state != nvigi::kInferenceExecutionStateDataPending; }))
+        {
+            if (pending->m_callbacks == seen)
+            {
+                donut::log::warning("Script: no response from the backend for %lld s, giving up on the evaluation",
+                    (long long)std::chrono::duration_cast<std::chrono::seconds>(kStallTimeout).count());
+                pending->m_abandoned = true;
+                return false;
+            }
+            seen = pending->m_callbacks;
+        }
+        bool ok = pending->m_state == nvigi::kInferenceExecutionStateDone;
+        lck.unlock();
+        delete pending;
+        return ok;
+    }
+
+    std::string Trim(const std::string& text)
+    {
+        size_t begin = text.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos)
+            return "";
+        size_t end = text.find_last_not_of(" \t\r\n");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    std::string EscapeCSV(const std::string& text)
+    {
+        std::string out = "\"";
+        for (char ch : text)
+        {
+            if (ch == '"')
+                out += "\"\"";
+            else if (ch == '\n' || ch == '\r')
+                out += ' ';
+            else
+                out += ch;
+        }
+        return out + "\"";
+    }
+}
+
+bool ScriptRunner::ParseScript(const std::string& path, std::vector<ScriptTurn>& turns)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        donut::log::error("Unable to open script %s", path.c_str());
+        return false;
+    }
+
+    fs::path scriptDir = fs::path(path).parent_path();
+    double thinkMs = -1.0;
+    std::string line;
+    for (int lineNumber = 1; std::getline(file, line); lineNumber++)
+    {
+        line = Trim(line.substr(0, line.find('#')));
+        if (line.empty())
+            continue;
+
+        size_t split = line.find_first_of(" \t");
+        std::string command = line.substr(0, split);
+        std::string argument = split == std::string::npos ? "" : Trim(line.substr(split));
+
+        if (command == "think")
+        {
+            char* end = nullptr;
+            thinkMs = strtod(argument.c_str(), &end);
+            if (argument.empty() || *end != '\0' || thinkMs < 0.0)
+            {
+                donut::log::error("%s(%d): invalid think time '%s'", path.c_str(), lineNumber, argument.c_str());
+                return false;
+            }
+        }
+        else if ((command == "text" || command == "wav") && !argument.empty())
+        {
+            ScriptTurn turn;
+            turn.m_kind = command == "text" ? ScriptTurn::Kind::Text : ScriptTurn::Kind::Audio;
+            turn.m_input = argument;
+            if (turn.m_kind == ScriptTurn::Kind::Audio && fs::path(argument).is_relative())
+                turn.m_input = (scriptDir / argument).string();
+            turn.m_thinkMs = thinkMs;
+            turns.push_back(turn);
+            thinkMs = -1.0;
+        }
+        else
+        {
+            donut::log::error("%s(%d): expected 'text <prompt>', 'wav <path>' or 'think <ms>'", path.c_str(), lineNumber);
+            return false;
+        }
+    }
+
+    if (turns.empty())
+    {
+        donut::log::error("Script %s has no turns", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ScriptRunner::Start(const Stages& stages, const std::vector<ScriptTurn>& turns, const Options& options)
+{
+    Wait();
+
+    if (!stages.m_gpt)
+    {
+        donut::log::error("Script: no GPT model is loaded");
+        return false;
+    }
+
+    m_audio.assign(turns.size(), {});
+    for (size_t i = 0; i < turns.size(); i++)
+    {
+        if (turns[i].m_kind != ScriptTurn::Kind::Audio)
+            continue;
+
+        if (!stages.m_asr)
+        {
+            donut::log::error("Script: turn %d is spoken but no ASR model is loaded", (int)i + 1);
+            return false;
+        }
+
+        uint16_t channels = 0;
+        uint32_t sampleRate = 0;
+        uint16_t bitsPerSample = 0;
+        if (!ReadWavFile(turns[i].m_input, m_audio[i], channels, sampleRate, bitsPerSample))
+        {
+            donut::log::error("Script: unable to read PCM WAV file %s", turns[i].m_input.c_str());
+            return false;
+        }
+        // The format the microphone recorder hands to ASR
+        if (channels != 1 || sampleRate != kASRSampleRate || bitsPerSample != 16)
+        {
+            donut::log::error("Script: %s is %d channel(s) at %u Hz, %d-bit; ASR input must be mono 16 kHz 16-bit",
+                turns[i].m_input.c_str(), channels, sampleRate, bitsPerSample);
+            return false;
+        }
+    }
+
+    if (!options.m_outputDir.empty() && stages.m_tts)
+    {
+        std::error_code ec;
+        fs::create_directories(options.m_outputDir, ec);
+        if (ec)
+        {
+            donut::log::error("Script: unable to create output directory %s", options.m_outputDir.c_str());
+            return false;
+        }
+    }
+
+    m_stages = stages;
+    m_turns = turns;
+    m_options = options;
+    m_options.m_concurrency = std::max(1, options.m_concurrency);
+    m_results.clear();
+    m_completedTurns = 0;
+    {
+        std::scoped_lock lock(m_cancelMutex);
+        m_cancel = false;
+    }
+
+    if (!m_stages.m_systemPrompt.empty())
+    {
+        nvigi::GPTRuntimeParameters runtime{};
+        runtime.seed = -1;
+        runtime.tokensToPredict = 200;
+        runtime.interactive = true;
+        runtime.reversePrompt = "User: ";
+
+        nvigi::InferenceDataTextSTLHelper data(m_stages.m_systemPrompt);
+        std::vector<nvigi::InferenceDataSlot> inSlots = { { nvigi::kGPTDataSlotSystem, data } };
+        nvigi::InferenceDataSlotArray inputs = { inSlots.size(), inSlots.data() };
+        nvigi::InferenceExecutionContext ctx{};
+        ctx.inputs = &inputs;
+        ctx.runtimeParameters = runtime;
+
+        if (m_stages.m_beforeEvaluate)
+            m_stages.m_beforeEvaluate();
+        EvaluateSync sync;
+        if (!Evaluate(m_stages.m_gpt, ctx, sync))
+            donut::log::warning("Script: system prompt evaluation failed");
+    }
+
+    donut::log::info("Script: %d session(s) of %d turn(s)", m_options.m_concurrency, (int)m_turns.size());
+    m_start = Clock::now();
+    m_end = m_start;
+    m_activeSessions = m_options.m_concurrency;
+    for (int session = 0; session < m_options.m_concurrency; session++)
+        m_threads.emplace_back(&ScriptRunner::RunSession, this, session);
+    return true;
+}
+
+void ScriptRunner::Cancel()
+{
+    std::scoped_lock lock(m_cancelMutex);
+    m_cancel = true;
+    m_cancelCV.notify_all();
+}
+
+void ScriptRunner::Wait()
+{
+    for (auto& thread : m_threads)
+    {
+        if (thread.joinable())
+            thread.join();
+    }
+    m_threads.clear();
+}
+
+void ScriptRunner::RunSession(int session)
+{
+    ThreadRegistry::Register("Script Session", ThreadRegistry::Role::Inference);
+    for (int index = 0; index < (int)m_turns.size(); index++)
+    {
+        const ScriptTurn& turn = m_turns[index];
+        double thinkMs = turn.m_thinkMs >= 0.0 ? turn.m_thinkMs : m_options.m_thinkMs;
+        if (thinkMs > 0.0)
+        {
+            std::unique_lock lock(m_cancelMutex);
+            m_cancelCV.wait_for(lock, std::chrono::duration<double, std::milli>(thinkMs), [this]() { return m_cancel.load(); });
+        }
+        if (m_cancel)
+            break;
+
+        ScriptTurnResult result;
+        result.m_session = session;
+        result.m_turn = index;
+        result.m_kind = turn.m_kind;
+        RunTurn(session, index, result);
+
+        if (!result.m_ok)
+            donut::log::warning("Script: session %d turn %d failed", session, index + 1);
+
+        std::scoped_lock lock(m_resultsMutex);
+        m_results.push_back(std::move(result));
+        m_completedTurns++;
+    }
+
+    {
+        std::scoped_lock lock(m_resultsMutex);
+        m_end = std::max(m_end, Clock::now());
+    }
+    m_activeSessions--;
+}
+
+void ScriptRunner::RunTurn(int session, int index, ScriptTurnResult& result)
+{
+    auto turnStart = Clock::now();
+    const ScriptTurn& turn = m_turns[index];
+
+    if (turn.m_kind == ScriptTurn::Kind::Audio)
+    {
+        if (!EvaluateASR(index, result))
+        {
+            result.m_turnMs = ElapsedMs(turnStart, Clock::now());
+            return;
+        }
+    }
+    else
+    {
+        result.m_prompt = turn.m_input;
+    }
+
+    result.m_ok = EvaluateGPT(session, index, turnStart, result);
+    result.m_turnMs = ElapsedMs(turnStart, Clock::now());
+}
+
+bool ScriptRunner::EvaluateASR(size_t index, ScriptTurnResult& result)
+{
+    const std::vector<uint8_t>& pcm = m_audio[index];
+    nvigi::CpuData audioData(pcm.size(), pcm.data());
+    nvigi::InferenceDataAudio wavData(audioData);
+    wavData.bitsPerSample = 16;
+    wavData.samplingRate = kASRSampleRate;
+    wavData.channels = 1;
+    std::vector<nvigi::InferenceDataSlot> inSlots = { { nvigi::kASRWhisperDataSlotAudio, wavData } };
+    nvigi::InferenceDataSlotArray inputs = { inSlots.size(), inSlots.data() };
+    nvigi::InferenceExecutionContext ctx{};
+    ctx.inputs = &inputs;
+
+    // Tagged JSON segments are not part of the transcript
+    StructuredOutputParser parser;
+    std::vector<StructuredEvent> events;
+    EvaluateSync sync;
+    sync.m_onOutput = [&](const nvigi::InferenceDataSlotArray& outputs)
+        {
+            const nvigi::InferenceDataText* text{};
+            if (!outputs.findAndValidateSlot(nvigi::kASRWhisperDataSlotTranscribedText, &text))
+                return;
+            parser.Feed(text->getUTF8Text(), result.m_prompt, events);
+        };
+
+    result.m_inputAudioSeconds = pcm.size() / (2.0 * kASRSampleRate);
+
+    auto queued = Clock::now();
+    std::scoped_lock lock(m_asrMutex);
+    auto start = Clock::now();
+    result.m_waitMs += ElapsedMs(queued, start);
+
+    if (m_stages.m_beforeEvaluate)
+        m_stages.m_beforeEvaluate();
+    if (m_stages.m_coordinator)
+        m_stages.m_coordinator->Yield(FrameCoordinator::Work::Prompt);
+    bool ok = Evaluate(m_stages.m_asr, ctx, sync);
+    result.m_asrMs = ElapsedMs(start, Clock::now());
+    parser.Finish(result.m_prompt, events);
+    return ok;
+}
+
+bool ScriptRunner::EvaluateGPT(int session, int index, Clock::time_point turnStart, ScriptTurnResult& result)
+{
+    nvigi::GPTRuntimeParameters runtime{};
+    runtime.seed = -1;
+    runtime.tokensToPredict = 200;
+    runtime.interactive = true;
+    runtime.reversePrompt = "User: ";
+
+    nvigi::InferenceDataTextSTLHelper data(result.m_prompt);
+    std::vector<nvigi::InferenceDataSlot> inSlots = { { nvigi::kGPTDataSlotUser, data } };
+    nvigi::InferenceDataSlotArray inputs = { inSlots.size(), inSlots.data() };
+    nvigi::InferenceExecutionContext ctx{};
+    ctx.inputs = &inputs;
+    ctx.runtimeParameters = runtime;
+
+    TTSChunker chunker;
+    std::vector<int16_t> audio;
+    bool ttsOk = true;
+    Clock::time_point start;
+    Clock::time_point firstToken;
+    Clock::time_point lastToken;
+    // Tagged JSON segments are not part of the answer, nor spoken
+    StructuredOutputParser parser;
+    std::vector<StructuredEvent> events;
+
+    EvaluateSync sync;
+    sync.m_onOutput = [&](const nvigi::InferenceDataSlotArray& outputs)
+        {
+            const nvigi::InferenceDataText* text{};
+            if (!outputs.findAndValidateSlot(nvigi::kGPTDataSlotResponse, &text))
+                return;
+            std::string str;
+            parser.Feed(text->getUTF8Text(), str, events);
+            if (str.empty())
+                return;
+
+            auto previousToken = result.m_tokens ? lastToken : start;
+            lastToken = Clock::now();
+            if (result.m_tokens++ == 0)
+            {
+                firstToken = lastToken;
+                result.m_gptFirstTokenMs = ElapsedMs(start, firstToken);
+            }
+            result.m_answer.append(str);
+            if (m_stages.m_scheduler)
+            {
+                m_stages.m_scheduler->RecordToken(result.m_tokens == 1, ElapsedMs(previousToken, lastToken));
+                if (m_stages.m_scheduler->IsEnabled() && m_stages.m_beforeEvaluate)
+                    m_stages.m_beforeEvaluate();
+            }
+
+            // Synchronous TTS, holding up GPT like the chat does
+            std::string chunk;
+            if (m_stages.m_tts && chunker.Append(str, false, chunk))
+                ttsOk &= EvaluateTTS(chunk, turnStart, audio, result);
+            if (m_stages.m_coordinator)
+                m_stages.m_coordinator->Yield(FrameCoordinator::Work::Token);
+        };
+
+    auto queued = Clock::now();
+    {
+        std::scoped_lock lock(m_gptMutex);
+        start = Clock::now();
+        result.m_waitMs += ElapsedMs(queued, start);
+
+        if (m_stages.m_beforeEvaluate)
+            m_stages.m_beforeEvaluate();
+        if (m_stages.m_coordinator)
+            m_stages.m_coordinator->Yield(FrameCoordinator::Work::Prompt);
+        if (m_stages.m_scheduler)
+            m_stages.m_scheduler->BeginRequest();
+        bool ok = Evaluate(m_stages.m_gpt, ctx, sync);
+        if (m_stages.m_scheduler)
+            m_stages.m_scheduler->EndRequest();
+        if (!ok)
+            return false;
+        result.m_gptMs = ElapsedMs(start, Clock::now());
+
+        // The text after the last chunk boundary
+        std::string tail;
+        parser.Finish(tail, events);
+        result.m_answer.append(tail);
+        std::string chunk;
+        if (m_stages.m_tts && chunker.Append(tail, true, chunk))
+            ttsOk &= EvaluateTTS(chunk, turnStart, audio, result);
+    }
+
+    if (result.m_tokens > 1)
+        result.m_tokensPerSecond = (result.m_tokens - 1) / std::max(ElapsedMs(firstToken, lastToken) / 1000.0, 1e-6);
+    result.m_outputAudioSeconds = audio.size() / (double)m_stages.m_ttsSampleRate;
+
+    if (!audio.empty() && !m_options.m_outputDir.empty())
+    {
+        std::ostringstream name;
+        name << "s" << session << "_t" << index + 1 << ".wav";
+        std::string path = (fs::path(m_options.m_outputDir) / name.str()).string();
+        if (WriteWavFile(path, audio.data(), audio.size(), m_stages.m_ttsSampleRate))
+            result.m_wavPath = path;
+        else
+            donut::log::warning("Script: unable to write %s", path.c_str());
+    }
+    return ttsOk;
+}
+
+bool ScriptRunner::EvaluateTTS(const std::string& text, Clock::time_point turnStart, std::vector<int16_t>& audio, ScriptTurnResult& result)
+{
+    std::string prompt = PreprocessTTSText(text);
+    if (prompt.find_first_not_of(" \t\r\n") == std::string::npos)
+        return true;
+
+    nvigi::InferenceDataTextSTLHelper data(prompt);
+    nvigi::InferenceDataTextSTLHelper targetPath(m_stages.m_ttsTargetPath);
+    std::vector<nvigi::InferenceDataSlot> inSlots = {
+        { nvigi::kTTSDataSlotInputText, data },
+        { nvigi::kTTSDataSlotInputTargetSpectrogramPath, targetPath } };
+    nvigi::InferenceDataSlotArray inputs = { inSlots.size(), inSlots.data() };
+    nvigi::InferenceExecutionContext ctx{};
+    ctx.inputs = &inputs;
+    ctx.runtimeParameters = m_stages.m_ttsRuntime;
+
+    EvaluateSync sync;
+    sync.m_onOutput = [&](const nvigi::InferenceDataSlotArray& outputs)
+        {
+            const nvigi::InferenceDataByteArray* outputAudioData{};
+            if (!outputs.findAndValidateSlot(nvigi::kTTSDataSlotOutputAudio, &outputAudioData))
+                return;
+            nvigi::CpuData* cpuBuffer = nvigi::castTo<nvigi::CpuData>(outputAudioData->bytes);
+            if (!cpuBuffer || cpuBuffer->sizeInBytes == 0)
+                return;
+
+            if (audio.empty())
+                result.m_firstAudioMs = ElapsedMs(turnStart, Clock::now());
+            const int16_t* samples = reinterpret_cast<const int16_t*>(cpuBuffer->buffer);
+            audio.insert(audio.end(), samples, samples + cpuBuffer->sizeInBytes / 2);
+        };
+
+    auto queued = Clock::now();
+    std::scoped_lock lock(m_ttsMutex);
+    auto start = Clock::now();
+    result.m_waitMs += ElapsedMs(queued, start);
+
+    if (m_stages.m_beforeEvaluate)
+        m_stages.m_beforeEvaluate();
+    if (m_stages.m_coordinator)
+        m_stages.m_coordinator->Yield(FrameCoordinator::Work::Synthesis);
+    bool ok = Evaluate(m_stages.m_tts, ctx, sync);
+    result.m_ttsMs += ElapsedMs(start, Clock::now());
+    return ok;
+}
+
+std::vector<ScriptTurnResult> ScriptRunner::GetResults() const
+{
+    std::vector<ScriptTurnResult> results;
+    {
+        std::scoped_lock lock(m_resultsMutex);
+        results = m_results;
+    }
+    std::sort(results.begin(), results.end(), [](const ScriptTurnResult& a, const ScriptTurnResult& b)
+        {
+            return a.m_session != b.m_session ? a.m_session < b.m_session : a.m_turn < b.m_turn;
+        });
+    return results;
+}
+
+size_t ScriptRunner::GetFailedTurns() const
+{
+    std::scoped_lock lock(m_resultsMutex);
+    return std::count_if(m_results.begin(), m_results.end(), [](const ScriptTurnResult& r) { return !r.m_ok; });
+}
+
+bool ScriptRunner::WriteReport(const std::string& basePath) const
+{
+    auto results = GetResults();
+
+    std::ofstream csv(basePath + ".csv", std::ios::trunc);
+    if (!csv)
+        return false;
+
+    csv << "session,turn,ok,kind,input_audio_s,asr_ms,gpt_first_token_ms,gpt_ms,tokens,tokens_per_s,"
+        "first_audio_ms,tts_ms,output_audio_s,tts_rtf,wait_ms,turn_ms,wav,prompt,answer\n";
+    for (const auto& r : results)
+    {
+        double rtf = r.m_outputAudioSeconds > 0.0 ? r.m_ttsMs / 1000.0 / r.m_outputAudioSeconds : 0.0;
+        csv << r.m_session << "," << r.m_turn + 1 << "," << (r.m_ok ? 1 : 0) << ","
+            << (r.m_kind == ScriptTurn::Kind::Audio ? "wav" : "text") << "," << r.m_inputAudioSeconds << ","
+            << r.m_asrMs << "," << r.m_gptFirstTokenMs << "," << r.m_gptMs << "," << r.m_tokens << ","
+            << r.m_tokensPerSecond << "," << r.m_firstAudioMs << "," << r.m_ttsMs << "," << r.m_outputAudioSeconds << ","
+            << rtf << "," << r.m_waitMs << "," << r.m_turnMs << "," << EscapeCSV(r.m_wavPath) << ","
+            << EscapeCSV(r.m_prompt) << "," << EscapeCSV(r.m_answer) << "\n";
+    }
+    if (!csv.good())
+        return false;
+
+    // Only successful turns contribute to the latency distributions, and only those that had the stage
+    enum class Applies
+    {
+        Always,
+        SpokenInput,
+        SpokenOutput
+    };
+    struct Metric
+    {
+        const char* m_name;
+        double ScriptTurnResult::* m_value;
+        Applies m_applies;
+        LatencyHistogram m_histogram;
+    };
+    Metric metrics[] =
+    {
+        { "turn_ms", &ScriptTurnResult::m_turnMs, Applies::Always, {} },
+        { "asr_ms", &ScriptTurnResult::m_asrMs, Applies::SpokenInput, {} },
+        { "gpt_first_token_ms", &ScriptTurnResult::m_gptFirstTokenMs, Applies::Always, {} },
+        { "gpt_ms", &ScriptTurnResult::m_gptMs, Applies::Always, {} },
+        { "first_audio_ms", &ScriptTurnResult::m_firstAudioMs, Applies::SpokenOutput, {} },
+        { "tts_ms", &ScriptTurnResult::m_ttsMs, Applies::SpokenOutput, {} },
+        { "wait_ms", &ScriptTurnResult::m_waitMs, Applies::Always, {} },
+    };
+
+    uint64_t tokens = 0;
+    double outputAudioSeconds = 0.0;
+    size_t failed = 0;
+    for (const auto& r : results)
+    {
+        if (!r.m_ok)
+        {
+            failed++;
+            continue;
+        }
+        tokens += r.m_tokens;
+        outputAudioSeconds += r.m_outputAudioSeconds;
+        for (auto& metric : metrics)
+        {
+            if ((metric.m_applies == Applies::SpokenInput && r.m_kind != ScriptTurn::Kind::Audio) ||
+                (metric.m_applies == Applies::SpokenOutput && r.m_outputAudioSeconds == 0.0))
+                continue;
+            metric.m_histogram.RecordMs(r.*metric.m_value);
+        }
+    }
+
+    double wallSeconds = ElapsedMs(m_start, m_end) / 1000.0;
+    std::ofstream json(basePath + ".json", std::ios::trunc);
+    if (!json)
+        return false;
+
+    json << "{\n";
+    json << "  \"sessions\": " << m_options.m_concurrency << ",\n";
+    json << "  \"turns\": " << results.size() << ",\n";
+    json << "  \"failed_turns\": " << failed << ",\n";
+    json << "  \"think_ms\": " << m_options.m_thinkMs << ",\n";
+    json << "  \"wall_s\": " << wallSeconds << ",\n";
+    json << "  \"turns_per_minute\": " << (wallSeconds > 0.0 ? (results.size() - failed) * 60.0 / wallSeconds : 0.0) << ",\n";
+    json << "  \"tokens\": " << tokens << ",\n";
+    json << "  \"tokens_per_second\": " << (wallSeconds > 0.0 ? tokens / wallSeconds : 0.0) << ",\n";
+    json << "  \"output_audio_s\": " << outputAudioSeconds << ",\n";
+    json << "  \"latency\": {\n";
+    for (size_t i = 0; i < std::size(metrics); i++)
+    {
+        auto s = metrics[i].m_histogram.GetSummary();
+        json << "    \"" << metrics[i].m_name << "\": { \"count\": " << s.m_count << ", \"min\": " << s.m_minMs
+            << ", \"mean\": " << s.m_meanMs << ", \"p50\": " << s.m_p50Ms << ", \"p90\": " << s.m_p90Ms
+            << ", \"p99\": " << s.m_p99Ms << ", \"max\": " << s.m_maxMs << " }" << (i + 1 < std::size(metrics) ? "," : "") << "\n";
+    }
+    json << "  }\n";
+    json << "}\n";
+    return json.good();
+}
@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class FrameCoordinator;
+class SchedulingController;
+
+namespace nvigi
+{
+    struct InferenceInstance;
+    struct NVIGIParameter;
+}
+
+// One user turn of a conversation script
+struct ScriptTurn
+{
+    enum class Kind
+    {
+        Text,
+        Audio
+    };
+
+    Kind m_kind = Kind::Text;
+    // Prompt text, or the path of a 16 kHz mono 16-bit PCM WAV file for spoken turns
+    std::string m_input;
+    // Pause before the turn; negative uses the default think time
+    double m_thinkMs = -1.0;
+};
+
+struct ScriptTurnResult
+{
+    int m_session = 0;
+    int m_turn = 0;
+    bool m_ok = false;
+    ScriptTurn::Kind m_kind = ScriptTurn::Kind::Text;
+    // Typed prompt, or the ASR transcript of a spoken one
+    std::string m_prompt;
+    std::string m_answer;
+    std::string m_wavPath;
+
+    double m_inputAudioSeconds = 0.0;
+    double m_asrMs = 0.0;
+    double m_gptFirstTokenMs = 0.0;
+    // Includes the TTS evaluations launched from the GPT callback, as in the interactive pipeline
+    double m_gptMs = 0.0;
+    uint64_t m_tokens = 0;
+    double m_tokensPerSecond = 0.0;
+    // From the start of the turn (after think time) to the first synthesized audio
+    double m_firstAudioMs = 0.0;
+    double m_ttsMs = 0.0;
+    double m_outputAudioSeconds = 0.0;
+    // Time spent queued behind other sessions for a stage
+    double m_waitMs = 0.0;
+    double m_turnMs = 0.0;
+};
+
+// Runs a conversation script through ASR -> GPT -> TTS without the chat UI.
+//
+// Each of the m_concurrency sessions plays the whole script on its own thread, pausing for the
+// think time before every turn.  Sessions share the loaded models: a stage runs one evaluation at
+// a time, so concurrent sessions queue for it and that queueing shows up in their latencies (and
+// the GPT conversation context is shared, as it is in the interactive sample).  GPT output is split
+// into TTS chunks exactly as the chat does and synthesized as it streams.
+class ScriptRunner
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stages
+    {
+        // ASR is only needed by spoken turns; without TTS answers stay text-only
+        nvigi::InferenceInstance* m_asr{};
+        nvigi::InferenceInstance* m_gpt{};
+        nvigi::InferenceInstance* m_tts{};
+        // Evaluated once before any turn when not empty
+        std::string m_systemPrompt;
+        const nvigi::NVIGIParameter* m_ttsRuntime{};
+        std::string m_ttsTargetPath;
+        int m_ttsSampleRate = 22050;
+        // Called before each evaluate, e.g. to apply the GPU scheduling mode, and between GPT tokens while
+        // adaptive scheduling is on
+        std::function<void()> m_beforeEvaluate;
+        // Optional; prompts, decode steps and TTS chunks yield to the frame through it
+        FrameCoordinator* m_coordinator{};
+        // Optional; told about each GPT request and its tokens
+        SchedulingController* m_scheduler{};
+    };
+
+    struct Options
+    {
+        int m_concurrency = 1;
+        double m_thinkMs = 0.0;
+        // TTS output is written to <dir>/s<session>_t<turn>.wav; empty disables it
+        std::string m_outputDir;
+    };
+
+    ScriptRunner() = default;
+    ~ScriptRunner() { Cancel(); Wait(); }
+    ScriptRunner(const ScriptRunner&) = delete;
+    ScriptRunner& operator=(const ScriptRunner&) = delete;
+
+    // One command per line, '#' starts a comment:
+    //   text <prompt>      typed prompt
+    //   wav <path>         spoken prompt, relative to the script
+    //   think <ms>         pause before the next turn instead of the default think time
+    static bool ParseScript(const std::string& path, std::vector<ScriptTurn>& turns);
+
+    // Loads the WAV inputs and starts the sessions; false if an input or a required stage is missing
+    bool Start(const Stages& stages, const std::vector<ScriptTurn>& turns, const Options& options);
+    bool IsRunning() const { return m_activeSessions != 0; }
+    // Sessions stop before their next turn, cutting short any think time
+    void Cancel();
+    void Wait();
+
+    size_t GetCompletedTurns() const { return m_completedTurns; }
+    size_t GetTotalTurns() const { return m_turns.size() * m_options.m_concurrency; }
+    std::vector<ScriptTurnResult> GetResults() const;
+    size_t GetFailedTurns() const;
+
+    // <base>.csv has one row per turn, <base>.json the percentiles of each latency and the throughput
+    bool WriteReport(const std::string& basePath) const;
+
+private:
+    void RunSession(int session);
+    void RunTurn(int session, int index, ScriptTurnResult& result);
+    bool EvaluateASR(size_t index, ScriptTurnResult& result);
+    bool EvaluateGPT(int session, int index, Clock::time_point turnStart, ScriptTurnResult& result);
+    bool EvaluateTTS(const std::string& text, Clock::time_point turnStart, std::vector<int16_t>& audio, ScriptTurnResult& result);
+
+    Stages m_stages;
+    Options m_options;
+    std::vector<ScriptTurn> m_turns;
+    // PCM of each spoken turn, indexed like m_turns
+    std::vector<std::vector<uint8_t>> m_audio;
+
+    std::vector<std::thread> m_threads;
+    std::atomic<int> m_activeSessions = 0;
+    std::atomic<bool> m_cancel = false;
+    // Wakes sessions in their think time
+    std::mutex m_cancelMutex;
+    std::condition_variable m_cancelCV;
+    std::atomic<size_t> m_completedTurns = 0;
+
+    // One evaluation at a time per stage
+    std::mutex m_asrMutex;
+    std::mutex m_gptMutex;
+    std::mutex m_ttsMutex;
+
+    mutable std::mutex m_resultsMutex;
+    std::vector<ScriptTurnResult> m_results;
+    Clock::time_point m_start;
+    Clock::time_point m_end;
+};
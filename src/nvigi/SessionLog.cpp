@@ -0,0 +1,515 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "SessionLog.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+namespace
+{
+    const char kMagic[8] = { 'N', 'V', 'I', 'G', 'I', 'S', 'E', 'S' };
+    constexpr uint64_t kVersion = 1;
+
+    constexpr uint64_t kFNVOffset = 0xcbf29ce484222325ull;
+    constexpr uint64_t kFNVPrime = 0x100000001b3ull;
+
+    uint64_t HashBytes(const void* data, size_t size, uint64_t hash = kFNVOffset)
+    {
+        const uint8_t* bytes = (const uint8_t*)data;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= kFNVPrime;
+        }
+        return hash;
+    }
+
+    // LEB128 varints; strings and blobs are a varint length followed by the bytes
+    void WriteVarint(std::string& out, uint64_t value)
+    {
+        do
+        {
+            uint8_t byte = value & 0x7f;
+            value >>= 7;
+            out += (char)(byte | (value ? 0x80 : 0));
+        } while (value);
+    }
+
+    void WriteBytes(std::string& out, const void* data, size_t size)
+    {
+        WriteVarint(out, size);
+        out.append((const char*)data, size);
+    }
+
+    class Reader
+    {
+    public:
+        Reader(const std::string& data) : m_data(data) {}
+
+        bool AtEnd() const { return m_pos >= m_data.size(); }
+
+        bool Byte(uint8_t& value)
+        {
+            if (AtEnd())
+                return false;
+            value = (uint8_t)m_data[m_pos++];
+            return true;
+        }
+
+        bool Varint(uint64_t& value)
+        {
+            value = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                uint8_t byte;
+                if (!Byte(byte))
+                    return false;
+                value |= (uint64_t)(byte & 0x7f) << shift;
+                if (!(byte & 0x80))
+                    return true;
+            }
+            return false;
+        }
+
+        bool Raw(void* out, size_t size)
+        {
+            if (m_data.size() - m_pos < size)
+                return false;
+            memcpy(out, m_data.data() + m_pos, size);
+            m_pos += size;
+            return true;
+        }
+
+        template <typename T> bool Bytes(T& out)
+        {
+            uint64_t size;
+            if (!Varint(size) || m_data.size() - m_pos < size)
+                return false;
+            out.assign(m_data.data() + m_pos, m_data.data() + m_pos + size);
+            m_pos += size;
+            return true;
+        }
+
+    private:
+        const std::string& m_data;
+        size_t m_pos = 0;
+    };
+
+    void WritePluginID(std::string& out, const nvigi::PluginID& id)
+    {
+        WriteVarint(out, id.id.data1);
+        WriteVarint(out, id.id.data2);
+        WriteVarint(out, id.id.data3);
+        out.append((const char*)id.id.data4, sizeof(id.id.data4));
+        WriteVarint(out, id.crc24);
+    }
+
+    bool ReadPluginID(Reader& reader, nvigi::PluginID& id)
+    {
+        uint64_t data1, data2, data3, crc24;
+        if (!reader.Varint(data1) || !reader.Varint(data2) || !reader.Varint(data3) ||
+            !reader.Raw(id.id.data4, sizeof(id.id.data4)) || !reader.Varint(crc24))
+            return false;
+        id.id.data1 = (decltype(id.id.data1))data1;
+        id.id.data2 = (decltype(id.id.data2))data2;
+        id.id.data3 = (decltype(id.id.data3))data3;
+        id.crc24 = (decltype(id.crc24))crc24;
+        return true;
+    }
+
+    void EncodeEvent(std::string& out, const SessionEvent& event, uint64_t deltaUs)
+    {
+        out += (char)event.m_type;
+        WriteVarint(out, deltaUs);
+        switch (event.m_type)
+        {
+        case SessionEvent::Type::ModelSelect:
+            out += (char)event.m_stage;
+            WritePluginID(out, event.m_plugin);
+            WriteBytes(out, event.m_text.data(), event.m_text.size());
+            break;
+        case SessionEvent::Type::SchedulingMode:
+            WriteVarint(out, event.m_value);
+            break;
+        case SessionEvent::Type::TypedPrompt:
+            WriteBytes(out, event.m_text.data(), event.m_text.size());
+            break;
+        case SessionEvent::Type::SpokenPrompt:
+            WriteBytes(out, event.m_audio.data(), event.m_audio.size());
+            break;
+        case SessionEvent::Type::ResetChat:
+            break;
+        case SessionEvent::Type::Output:
+            out += (char)event.m_stage;
+            WriteVarint(out, event.m_value);
+            WriteBytes(out, event.m_text.data(), event.m_text.size());
+            WriteVarint(out, event.m_audioSamples);
+            if (event.m_audioSamples)
+                out.append((const char*)&event.m_audioHash, sizeof(event.m_audioHash));
+            break;
+        }
+    }
+
+    bool DecodeEvent(Reader& reader, SessionEvent& event, uint64_t& timeUs)
+    {
+        uint8_t type, stage;
+        uint64_t deltaUs, value;
+        if (!reader.Byte(type) || !reader.Varint(deltaUs))
+            return false;
+        timeUs += deltaUs;
+        event.m_type = (SessionEvent::Type)type;
+        event.m_timeUs = timeUs;
+
+        switch (event.m_type)
+        {
+        case SessionEvent::Type::ModelSelect:
+            if (!reader.Byte(stage) || !ReadPluginID(reader, event.m_plugin) || !reader.Bytes(event.m_text))
+                return false;
+            event.m_stage = (SessionEvent::Stage)stage;
+            return true;
+        case SessionEvent::Type::SchedulingMode:
+            if (!reader.Varint(value))
+                return false;
+            event.m_value = (uint32_t)value;
+            return true;
+        case SessionEvent::Type::TypedPrompt:
+            return reader.Bytes(event.m_text);
+        case SessionEvent::Type::SpokenPrompt:
+            return reader.Bytes(event.m_audio);
+        case SessionEvent::Type::ResetChat:
+            return true;
+        case SessionEvent::Type::Output:
+            if (!reader.Byte(stage) || !reader.Varint(value) || !reader.Bytes(event.m_text) || !reader.Varint(event.m_audioSamples))
+                return false;
+            event.m_stage = (SessionEvent::Stage)stage;
+            event.m_value = (uint32_t)value;
+            return !event.m_audioSamples || reader.Raw(&event.m_audioHash, sizeof(event.m_audioHash));
+        }
+        return false;
+    }
+}
+
+bool SessionRecorder::Start(const std::string& path, uint64_t seed)
+{
+    Stop();
+
+    std::scoped_lock lock(m_mutex);
+    if (!path.empty())
+    {
+        m_file.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_file)
+            return false;
+
+        std::string header(kMagic, sizeof(kMagic));
+        WriteVarint(header, kVersion);
+        WriteVarint(header, seed);
+        m_file.write(header.data(), header.size());
+    }
+
+    m_events.clear();
+    m_start = Clock::now();
+    m_lastTimeUs = 0;
+    m_seed = seed;
+    m_recording = true;
+    return true;
+}
+
+void SessionRecorder::Stop()
+{
+    std::scoped_lock lock(m_mutex);
+    m_recording = false;
+    if (m_file.is_open())
+        m_file.close();
+}
+
+void SessionRecorder::Record(SessionEvent event)
+{
+    std::scoped_lock lock(m_mutex);
+    if (!m_recording)
+        return;
+
+    event.m_timeUs = std::max(m_lastTimeUs, (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_start).count());
+    if (m_file.is_open())
+    {
+        std::string encoded;
+        EncodeEvent(encoded, event, event.m_timeUs - m_lastTimeUs);
+        m_file.write(encoded.data(), encoded.size());
+    }
+    m_lastTimeUs = event.m_timeUs;
+    m_events.push_back(std::move(event));
+}
+
+void SessionRecorder::RecordModel(SessionEvent::Stage stage, const nvigi::PluginID& plugin, const std::string& guid)
+{
+    SessionEvent event;
+    event.m_type = SessionEvent::Type::ModelSelect;
+    event.m_stage = stage;
+    event.m_plugin = plugin;
+    event.m_text = guid;
+    Record(std::move(event));
+}
+
+void SessionRecorder::RecordSchedulingMode(uint32_t mode)
+{
+    SessionEvent event;
+    event.m_type = SessionEvent::Type::SchedulingMode;
+    event.m_value = mode;
+    Record(std::move(event));
+}
+
+void SessionRecorder::RecordTypedPrompt(const std::string& text)
+{
+    SessionEvent event;
+    event.m_type = SessionEvent::Type::TypedPrompt;
+    event.m_text = text;
+    Record(std::move(event));
+}
+
+void SessionRecorder::RecordSpokenPrompt(const uint8_t* pcm, size_t bytes)
+{
+    SessionEvent event;
+    event.m_type = SessionEvent::Type::SpokenPrompt;
+    event.m_audio.assign(pcm, pcm + bytes);
+    Record(std::move(event));
+}
+
+void SessionRecorder::RecordResetChat()
+{
+    SessionEvent event;
+    event.m_type = SessionEvent::Type::ResetChat;
+    Record(std::move(event));
+}
+
+void SessionRecorder::RecordText(SessionEvent::Stage stage, uint32_t state, const std::string& text)
+{
+    SessionEvent event;
+    event.m_type = SessionEvent::Type::Output;
+    event.m_stage = stage;
+    event.m_value = state;
+    event.m_text = text;
+    Record(std::move(event));
+}
+
+void SessionRecorder::RecordAudio(SessionEvent::Stage stage, uint32_t state, const int16_t* samples, size_t count)
+{
+    SessionEvent event;
+    event.m_type = SessionEvent::Type::Output;
+    event.m_stage = stage;
+    event.m_value = state;
+    event.m_audioSamples = count;
+    event.m_audioHash = HashBytes(samples, count * sizeof(int16_t));
+    Record(std::move(event));
+}
+
+std::vector<SessionEvent> SessionRecorder::GetEvents() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_events;
+}
+
+bool ReadSessionLog(const std::string& path, uint64_t& seed, std::vector<SessionEvent>& events)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    Reader reader(data);
+    char magic[sizeof(kMagic)];
+    uint64_t version;
+    if (!reader.Raw(magic, sizeof(magic)) || memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+        !reader.Varint(version) || version != kVersion || !reader.Varint(seed))
+        return false;
+
+    events.clear();
+    uint64_t timeUs = 0;
+    while (!reader.AtEnd())
+    {
+        SessionEvent event;
+        if (!DecodeEvent(reader, event, timeUs))
+            return false;
+        events.push_back(std::move(event));
+    }
+    return true;
+}
+
+void SessionReplayer::Start(std::vector<SessionEvent> events, double speed)
+{
+    m_events = std::move(events);
+    m_speed = speed;
+    m_next = 0;
+    m_start = Clock::now();
+    SkipOutputs();
+}
+
+const SessionEvent* SessionReplayer::GetDueInput(Clock::time_point now) const
+{
+    if (IsFinished())
+        return nullptr;
+
+    const SessionEvent& event = m_events[m_next];
+    if (m_speed > 0.0)
+    {
+        auto due = m_start + std::chrono::microseconds((uint64_t)(event.m_timeUs / m_speed));
+        if (now < due)
+            return nullptr;
+    }
+    return &event;
+}
+
+void SessionReplayer::Advance()
+{
+    m_next++;
+    SkipOutputs();
+}
+
+void SessionReplayer::SkipOutputs()
+{
+    while (m_next < m_events.size() && !m_events[m_next].IsInput())
+        m_next++;
+}
+
+namespace
+{
+    struct StageSummary
+    {
+        bool m_seen = false;
+        double m_firstMs = 0.0;
+        double m_lastMs = 0.0;
+        uint32_t m_finalState = 0;
+        std::string m_text;
+        uint64_t m_samples = 0;
+        uint64_t m_hash = kFNVOffset;
+
+        bool Matches(const StageSummary& other) const
+        {
+            return m_seen == other.m_seen && m_finalState == other.m_finalState && m_text == other.m_text &&
+                m_samples == other.m_samples && m_hash == other.m_hash;
+        }
+
+        std::string Describe() const
+        {
+            if (!m_seen)
+                return "";
+            if (m_samples == 0)
+                return m_text;
+            std::ostringstream out;
+            out << m_samples << " samples #" << std::hex << std::setw(16) << std::setfill('0') << m_hash;
+            return out.str();
+        }
+    };
+
+    struct TurnSummary
+    {
+        std::string m_prompt;
+        StageSummary m_stages[3];
+    };
+
+    std::vector<TurnSummary> SummarizeTurns(const std::vector<SessionEvent>& events)
+    {
+        std::vector<TurnSummary> turns;
+        uint64_t turnStartUs = 0;
+        for (const auto& event : events)
+        {
+            if (event.StartsTurn())
+            {
+                turns.emplace_back();
+                turns.back().m_prompt = event.m_type == SessionEvent::Type::TypedPrompt ? event.m_text : "<spoken>";
+                turnStartUs = event.m_timeUs;
+                continue;
+            }
+            // Outputs before the first prompt come from the system prompt
+            if (event.IsInput() || turns.empty())
+                continue;
+
+            StageSummary& stage = turns.back().m_stages[(int)event.m_stage % 3];
+            double ms = (event.m_timeUs - turnStartUs) / 1000.0;
+            if (!stage.m_seen)
+                stage.m_firstMs = ms;
+            stage.m_seen = true;
+            stage.m_lastMs = ms;
+            stage.m_finalState = event.m_value;
+            stage.m_text += event.m_text;
+            if (event.m_audioSamples)
+            {
+                stage.m_samples += event.m_audioSamples;
+                stage.m_hash = HashBytes(&event.m_audioHash, sizeof(event.m_audioHash), stage.m_hash);
+            }
+        }
+        return turns;
+    }
+
+    std::string EscapeCSV(const std::string& text)
+    {
+        std::string out = "\"";
+        for (char ch : text)
+        {
+            if (ch == '"')
+                out += "\"\"";
+            else if (ch == '\n' || ch == '\r')
+                out += ' ';
+            else
+                out += ch;
+        }
+        return out + "\"";
+    }
+}
+
+size_t WriteSessionDiff(const std::string& path, const std::vector<SessionEvent>& recorded, const std::vector<SessionEvent>& replayed)
+{
+    auto recordedTurns = SummarizeTurns(recorded);
+    auto replayedTurns = SummarizeTurns(replayed);
+    const char* stageNames[] = { "ASR", "GPT", "TTS" };
+
+    std::ofstream file(path, std::ios::trunc);
+    if (file)
+    {
+        file << "turn,stage,prompt,recorded_first_ms,replayed_first_ms,first_delta_ms,"
+            "recorded_last_ms,replayed_last_ms,last_delta_ms,match,recorded_output,replayed_output\n";
+    }
+
+    size_t mismatches = 0;
+    size_t turnCount = std::max(recordedTurns.size(), replayedTurns.size());
+    for (size_t i = 0; i < turnCount; i++)
+    {
+        static const TurnSummary kMissing;
+        const TurnSummary& a = i < recordedTurns.size() ? recordedTurns[i] : kMissing;
+        const TurnSummary& b = i < replayedTurns.size() ? replayedTurns[i] : kMissing;
+        bool turnMatches = i < recordedTurns.size() && i < replayedTurns.size();
+
+        for (int s = 0; s < (int)std::size(stageNames); s++)
+        {
+            const StageSummary& ra = a.m_stages[s];
+            const StageSummary& rb = b.m_stages[s];
+            if (!ra.m_seen && !rb.m_seen)
+                continue;
+
+            bool match = ra.Matches(rb);
+            turnMatches &= match;
+            if (!file)
+                continue;
+
+            file << i + 1 << "," << stageNames[s] << "," << EscapeCSV(a.m_prompt.empty() ? b.m_prompt : a.m_prompt) << ",";
+            if (ra.m_seen) file << ra.m_firstMs;
+            file << ",";
+            if (rb.m_seen) file << rb.m_firstMs;
+            file << ",";
+            if (ra.m_seen && rb.m_seen) file << rb.m_firstMs - ra.m_firstMs;
+            file << ",";
+            if (ra.m_seen) file << ra.m_lastMs;
+            file << ",";
+            if (rb.m_seen) file << rb.m_lastMs;
+            file << ",";
+            if (ra.m_seen && rb.m_seen) file << rb.m_lastMs - ra.m_lastMs;
+            file << "," << (match ? 1 : 0) << "," << EscapeCSV(ra.Describe()) << "," << EscapeCSV(rb.Describe()) << "\n";
+        }
+
+        if (!turnMatches)
+            mismatches++;
+    }
+    return mismatches;
+}
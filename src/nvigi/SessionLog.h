@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <nvigi_struct.h>
+
+// Everything that drives the pipeline, plus what each stage produced, for record/replay.
+//
+// Inputs are model selections, scheduling mode changes, typed prompts, spoken prompts (the PCM
+// handed to ASR) and chat resets; outputs are the text of every ASR/GPT callback and a hash of
+// every TTS audio chunk.  Times are microseconds since the recording started.
+struct SessionEvent
+{
+    enum class Type : uint8_t
+    {
+        ModelSelect = 1,
+        SchedulingMode,
+        TypedPrompt,
+        SpokenPrompt,
+        ResetChat,
+        Output
+    };
+
+    enum class Stage : uint8_t
+    {
+        ASR,
+        GPT,
+        TTS
+    };
+
+    Type m_type = Type::Output;
+    uint64_t m_timeUs = 0;
+    Stage m_stage = Stage::ASR;
+    // Scheduling mode, or the callback state of an output
+    uint32_t m_value = 0;
+    // Model GUID, prompt or output text
+    std::string m_text;
+    nvigi::PluginID m_plugin{};
+    // Spoken prompts only: 16 kHz mono 16-bit PCM
+    std::vector<uint8_t> m_audio;
+    // TTS outputs only: the audio itself is not kept
+    uint64_t m_audioSamples = 0;
+    uint64_t m_audioHash = 0;
+
+    bool IsInput() const { return m_type != Type::Output; }
+    bool StartsTurn() const { return m_type == Type::TypedPrompt || m_type == Type::SpokenPrompt; }
+};
+
+// Appends events to a compact binary log (varint-encoded, audio outputs reduced to a hash) and
+// keeps them in memory for comparison.  Record() may be called from any thread.
+class SessionRecorder
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // An empty path keeps the events in memory only
+    bool Start(const std::string& path, uint64_t seed);
+    void Stop();
+    bool IsRecording() const { return m_recording; }
+    uint64_t GetSeed() const { return m_seed; }
+
+    void Record(SessionEvent event);
+    void RecordModel(SessionEvent::Stage stage, const nvigi::PluginID& plugin, const std::string& guid);
+    void RecordSchedulingMode(uint32_t mode);
+    void RecordTypedPrompt(const std::string& text);
+    void RecordSpokenPrompt(const uint8_t* pcm, size_t bytes);
+    void RecordResetChat();
+    void RecordText(SessionEvent::Stage stage, uint32_t state, const std::string& text);
+    void RecordAudio(SessionEvent::Stage stage, uint32_t state, const int16_t* samples, size_t count);
+
+    std::vector<SessionEvent> GetEvents() const;
+
+private:
+    mutable std::mutex m_mutex;
+    std::ofstream m_file;
+    std::vector<SessionEvent> m_events;
+    Clock::time_point m_start;
+    uint64_t m_lastTimeUs = 0;
+    uint64_t m_seed = 0;
+    bool m_recording = false;
+};
+
+bool ReadSessionLog(const std::string& path, uint64_t& seed, std::vector<SessionEvent>& events);
+
+// Hands out the inputs of a recording when they are due: at their recorded time divided by the
+// speed, but never before the previous input has been processed (the caller decides when the
+// pipeline is idle).  A speed of 0 issues each input as soon as the pipeline is idle.
+class SessionReplayer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void Start(std::vector<SessionEvent> events, double speed);
+    // Next input if it is due, otherwise null; call Advance() once it has been issued
+    const SessionEvent* GetDueInput(Clock::time_point now) const;
+    void Advance();
+    bool IsFinished() const { return m_next >= m_events.size(); }
+    const std::vector<SessionEvent>& GetEvents() const { return m_events; }
+
+private:
+    void SkipOutputs();
+
+    std::vector<SessionEvent> m_events;
+    size_t m_next = 0;
+    double m_speed = 1.0;
+    Clock::time_point m_start;
+};
+
+// Compares two sessions turn by turn (a turn starts at each prompt) and writes one CSV row per turn
+// and stage: time from the prompt to the first and the last output, and whether the outputs match.
+// Returns the number of turns whose outputs differ, counting turns missing from either side.
+size_t WriteSessionDiff(const std::string& path, const std::vector<SessionEvent>& recorded, const std::vector<SessionEvent>& replayed);
@@ -0,0 +1,31 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Incremental SHA-256 (FIPS 180-4), used to verify downloaded model files as they are written
+class Sha256
+{
+public:
+    static constexpr size_t kDigestSize = 32;
+
+    Sha256() { Reset(); }
+
+    void Reset();
+    void Update(const void* data, size_t size);
+    void Finish(uint8_t digest[kDigestSize]);
+    // Finishes and returns the digest as lowercase hex
+    std::string FinishHex();
+
+private:
+    void Transform(const uint8_t block[64]);
+
+    uint32_t m_state[8];
+    uint64_t m_length = 0;
+    uint8_t m_buffer[64];
+    size_t m_bufferSize = 0;
+};
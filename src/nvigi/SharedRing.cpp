@@ -0,0 +1,354 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "SharedRing.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <climits>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // Each message starts with its size and type, and is padded to the record alignment
+    constexpr size_t kRecordHeader = 8;
+    constexpr size_t kRecordAlign = 8;
+    // Fills the rest of the ring when a message does not fit before the end
+    constexpr uint32_t kWrapType = ~0u;
+    constexpr int kSpinCount = 2000;
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+        "the ring's atomics must be lock-free to be shared between processes");
+
+    size_t AlignRecord(size_t size)
+    {
+        return (size + kRecordAlign - 1) & ~(kRecordAlign - 1);
+    }
+
+    void CpuRelax()
+    {
+#if defined(_M_X64) || defined(__x86_64__)
+        _mm_pause();
+#endif
+    }
+
+#ifdef _WIN32
+    std::wstring ToWide(const std::string& text)
+    {
+        return std::wstring(text.begin(), text.end());
+    }
+#endif
+}
+
+// Producer and consumer state on separate cache lines
+struct SharedRing::Header
+{
+    alignas(64) std::atomic<uint64_t> m_head;
+    alignas(64) std::atomic<uint64_t> m_tail;
+    // Set while the consumer sleeps; bumped by the producer to wake it
+    std::atomic<uint32_t> m_sleeping;
+    std::atomic<uint32_t> m_wakeups;
+    alignas(64) uint64_t m_capacity;
+};
+
+bool SharedMemory::Create(const std::string& name, size_t size)
+{
+    Close();
+#ifdef _WIN32
+    std::wstring path = L"Local\\nvigi." + ToWide(name);
+    HANDLE mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)size, path.c_str());
+    if (!mapping)
+        return false;
+    if (GetLastError() == ERROR_ALREADY_EXISTS)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+    m_data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!m_data)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+    m_mapping = mapping;
+#else
+    std::string path = "/nvigi." + name;
+    int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+        return false;
+    m_name = path;
+    m_owner = true;
+    if (ftruncate(fd, (off_t)size) != 0)
+    {
+        close(fd);
+        Close();
+        return false;
+    }
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        Close();
+        return false;
+    }
+    m_data = data;
+#endif
+    m_size = size;
+    return true;
+}
+
+bool SharedMemory::Open(const std::string& name, size_t size)
+{
+    Close();
+#ifdef _WIN32
+    std::wstring path = L"Local\\nvigi." + ToWide(name);
+    HANDLE mapping = OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, path.c_str());
+    if (!mapping)
+        return false;
+    m_data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!m_data)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+    m_mapping = mapping;
+#else
+    std::string path = "/nvigi." + name;
+    int fd = shm_open(path.c_str(), O_RDWR, 0600);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && (size_t)info.st_size >= size)
+        data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+    m_data = data;
+#endif
+    m_size = size;
+    return true;
+}
+
+void SharedMemory::Unlink()
+{
+#ifndef _WIN32
+    // Windows removes the name with the last handle
+    if (m_owner)
+        shm_unlink(m_name.c_str());
+    m_owner = false;
+#endif
+}
+
+void SharedMemory::Close()
+{
+#ifdef _WIN32
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle(m_mapping);
+    m_mapping = nullptr;
+#else
+    if (m_data)
+        munmap(m_data, m_size);
+    if (m_owner)
+        shm_unlink(m_name.c_str());
+    m_owner = false;
+    m_name.clear();
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+size_t SharedRing::GetRequiredSize(size_t capacity)
+{
+    return sizeof(Header) + capacity;
+}
+
+bool SharedRing::Attach(void* memory, size_t capacity, const std::string& name, bool create)
+{
+    Detach();
+    if (!memory || capacity < 64 || (capacity & (capacity - 1)) != 0)
+        return false;
+
+    auto header = (Header*)memory;
+    if (create)
+    {
+        new (header) Header();
+        header->m_head = 0;
+        header->m_tail = 0;
+        header->m_sleeping = 0;
+        header->m_wakeups = 0;
+        header->m_capacity = capacity;
+    }
+    else if (header->m_capacity != capacity)
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    // Auto-reset, so a wakeup sent just before the consumer starts waiting is not lost
+    std::wstring eventName = L"Local\\nvigi." + ToWide(name) + L".wake";
+    m_event = CreateEventW(nullptr, FALSE, FALSE, eventName.c_str());
+    if (!m_event)
+        return false;
+#else
+    (void)name;
+#endif
+    m_header = header;
+    m_data = (uint8_t*)memory + sizeof(Header);
+    m_capacity = capacity;
+    return true;
+}
+
+void SharedRing::Detach()
+{
+#ifdef _WIN32
+    if (m_event)
+        CloseHandle(m_event);
+    m_event = nullptr;
+#endif
+    m_header = nullptr;
+    m_data = nullptr;
+    m_capacity = 0;
+}
+
+size_t SharedRing::GetMaxMessageSize() const
+{
+    // Room for the record and a wrap marker in front of it
+    return m_capacity > 2 * kRecordHeader ? m_capacity / 2 - kRecordHeader : 0;
+}
+
+bool SharedRing::Write(uint32_t type, const void* data, size_t size, int timeoutMs)
+{
+    if (!m_header || size > GetMaxMessageSize())
+        return false;
+
+    size_t record = AlignRecord(kRecordHeader + size);
+    uint64_t head = m_header->m_head.load(std::memory_order_relaxed);
+    size_t offset = (size_t)(head & (m_capacity - 1));
+    // A message never wraps; the space left before the end is skipped instead
+    size_t skip = m_capacity - offset < record ? m_capacity - offset : 0;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    for (int spin = 0; head + skip + record - m_header->m_tail.load(std::memory_order_acquire) > m_capacity; spin++)
+    {
+        if (spin < kSpinCount)
+            CpuRelax();
+        else if (std::chrono::steady_clock::now() >= deadline)
+            return false;
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    if (skip)
+    {
+        uint32_t marker[2] = { 0, kWrapType };
+        memcpy(m_data + offset, marker, sizeof(marker));
+        head += skip;
+        offset = 0;
+    }
+    uint32_t recordHeader[2] = { (uint32_t)size, type };
+    memcpy(m_data + offset, recordHeader, sizeof(recordHeader));
+    if (size)
+        memcpy(m_data + offset + kRecordHeader, data, size);
+    m_header->m_head.store(head + record, std::memory_order_seq_cst);
+
+    if (m_header->m_sleeping.load(std::memory_order_seq_cst))
+        Signal();
+    return true;
+}
+
+bool SharedRing::Read(uint32_t& type, std::vector<uint8_t>& payload, int timeoutMs)
+{
+    if (!m_header)
+        return false;
+
+    uint64_t tail = m_header->m_tail.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        if (m_header->m_head.load(std::memory_order_acquire) == tail)
+        {
+            WaitForData(tail, timeoutMs);
+            if (m_header->m_head.load(std::memory_order_acquire) == tail)
+                return false;
+        }
+
+        size_t offset = (size_t)(tail & (m_capacity - 1));
+        uint32_t recordHeader[2];
+        memcpy(recordHeader, m_data + offset, sizeof(recordHeader));
+        if (recordHeader[1] == kWrapType)
+        {
+            tail += m_capacity - offset;
+            m_header->m_tail.store(tail, std::memory_order_release);
+            continue;
+        }
+
+        type = recordHeader[1];
+        payload.assign(m_data + offset + kRecordHeader, m_data + offset + kRecordHeader + recordHeader[0]);
+        m_header->m_tail.store(tail + AlignRecord(kRecordHeader + recordHeader[0]), std::memory_order_release);
+        return true;
+    }
+}
+
+void SharedRing::WaitForData(uint64_t tail, int timeoutMs)
+{
+    for (int spin = 0; spin < kSpinCount; spin++)
+    {
+        if (m_header->m_head.load(std::memory_order_acquire) != tail)
+            return;
+        CpuRelax();
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    for (;;)
+    {
+        uint32_t wakeups = m_header->m_wakeups.load(std::memory_order_seq_cst);
+        m_header->m_sleeping.store(1, std::memory_order_seq_cst);
+        // The producer checks the flag after publishing, so a message that arrived in between is seen here
+        if (m_header->m_head.load(std::memory_order_seq_cst) != tail)
+            break;
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0)
+            break;
+#ifdef _WIN32
+        (void)wakeups;
+        WaitForSingleObject(m_event, (DWORD)remaining);
+#else
+        timespec timeout = { (time_t)(remaining / 1000), (long)(remaining % 1000) * 1000000 };
+        // Not FUTEX_PRIVATE_FLAG: the word is shared with the other process
+        syscall(SYS_futex, &m_header->m_wakeups, FUTEX_WAIT, wakeups, &timeout, nullptr, 0);
+#endif
+        if (m_header->m_head.load(std::memory_order_acquire) != tail)
+            break;
+    }
+    m_header->m_sleeping.store(0, std::memory_order_relaxed);
+}
+
+void SharedRing::Signal()
+{
+    m_header->m_wakeups.fetch_add(1, std::memory_order_seq_cst);
+#ifdef _WIN32
+    SetEvent(m_event);
+#else
+    syscall(SYS_futex, &m_header->m_wakeups, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A named block of memory shared between processes.
+//
+// The creating process owns the name; on Linux the name is removed again when the owner closes it,
+// on Windows once the last process has closed its handle.
+class SharedMemory
+{
+public:
+    SharedMemory() = default;
+    ~SharedMemory() { Close(); }
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    // Creates the block zero-filled; fails if the name is already in use
+    bool Create(const std::string& name, size_t size);
+    bool Open(const std::string& name, size_t size);
+    // Removes the name once every process has opened the block, so that it does not outlive them
+    void Unlink();
+    void Close();
+
+    void* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+private:
+    void* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_mapping = nullptr;
+#else
+    std::string m_name;
+    bool m_owner = false;
+#endif
+};
+
+// Single-producer, single-consumer queue of typed messages in shared memory.
+//
+// Each message is a type and a byte payload, copied in and out of a power-of-two ring.  A consumer
+// that finds the ring empty spins briefly, then sleeps until the producer signals it: on a futex on
+// Linux, on a named event on Windows.  The producer only signals while the consumer sleeps, so a busy
+// stream of small messages costs no system calls.  A message must fit in the ring in one piece.
+class SharedRing
+{
+public:
+    SharedRing() = default;
+    ~SharedRing() { Detach(); }
+    SharedRing(const SharedRing&) = delete;
+    SharedRing& operator=(const SharedRing&) = delete;
+
+    // Memory needed for a ring with the given capacity, which must be a power of two
+    static size_t GetRequiredSize(size_t capacity);
+
+    // Lays out a new ring (create) or attaches to one the other process laid out; the name identifies
+    // the wakeup event and must be the same on both sides
+    bool Attach(void* memory, size_t capacity, const std::string& name, bool create);
+    void Detach();
+
+    // Producer; waits up to timeoutMs while the ring is too full, and fails at once if the message can
+    // never fit
+    bool Write(uint32_t type, const void* data, size_t size, int timeoutMs);
+    // Consumer; waits up to timeoutMs for a message, or returns false
+    bool Read(uint32_t& type, std::vector<uint8_t>& payload, int timeoutMs);
+
+    size_t GetMaxMessageSize() const;
+
+private:
+    struct Header;
+
+    void Signal();
+    void WaitForData(uint64_t tail, int timeoutMs);
+
+    Header* m_header = nullptr;
+    uint8_t* m_data = nullptr;
+    size_t m_capacity = 0;
+#ifdef _WIN32
+    void* m_event = nullptr;
+#endif
+};
@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "SpeechStats.h"
+
+#include <fstream>
+
+void RTFStats::Add(double audioSeconds, double processingSeconds)
+{
+    if (audioSeconds <= 0.0)
+        return;
+
+    m_count++;
+    m_audioSeconds += audioSeconds;
+    m_processingSeconds += processingSeconds;
+    m_lastRTF = processingSeconds / audioSeconds;
+    if (m_lastRTF > m_maxRTF)
+        m_maxRTF = m_lastRTF;
+}
+
+void SpeechStats::AddASR(double audioSeconds, double processingSeconds)
+{
+    std::scoped_lock lock(m_mutex);
+    m_asr.Add(audioSeconds, processingSeconds);
+}
+
+void SpeechStats::BeginTTSSequence(int sampleRate)
+{
+    std::scoped_lock lock(m_mutex);
+    m_sampleRate = sampleRate;
+    m_sequenceChunks = 0;
+    m_minLeadMs = 0.0;
+    m_drained = false;
+}
+
+SpeechStats::ChunkInfo SpeechStats::OnTTSSynthesized(uint64_t samples, double processingSeconds)
+{
+    auto now = Clock::now();
+    std::scoped_lock lock(m_mutex);
+
+    ChunkInfo info;
+    if (m_sequenceChunks > 0)
+    {
+        double lead = GetLeadMsLocked(now);
+        if (m_sequenceChunks == 1 || lead < m_minLeadMs)
+            m_minLeadMs = lead;
+        info.m_leadMs = lead;
+        info.m_first = false;
+    }
+    m_sequenceChunks++;
+
+    // Playback ran out before this chunk was ready
+    if (m_drained)
+    {
+        m_underruns++;
+        m_underrunMs += std::chrono::duration<double, std::milli>(now - m_drainedAt).count();
+        m_drained = false;
+        info.m_underrun = true;
+    }
+
+    m_synthesizedSamples += samples;
+    m_tts.Add((double)samples / m_sampleRate, processingSeconds);
+    info.m_rtf = samples ? processingSeconds * m_sampleRate / samples : 0.0;
+    return info;
+}
+
+void SpeechStats::OnPlaybackStart(uint64_t samples)
+{
+    std::scoped_lock lock(m_mutex);
+    m_playingSamples = samples;
+    m_playingStart = Clock::now();
+}
+
+void SpeechStats::OnPlaybackEnd(uint64_t samples)
+{
+    auto now = Clock::now();
+    std::scoped_lock lock(m_mutex);
+    m_playedSamples += samples;
+    m_playingSamples = 0;
+    if (m_playedSamples >= m_synthesizedSamples && m_sequenceChunks > 0)
+    {
+        m_drained = true;
+        m_drainedAt = now;
+    }
+}
+
+double SpeechStats::GetLeadMsLocked(Clock::time_point now) const
+{
+    double queued = (double)(m_synthesizedSamples - m_playedSamples) * 1000.0 / m_sampleRate;
+    if (m_playingSamples)
+    {
+        double chunkMs = (double)m_playingSamples * 1000.0 / m_sampleRate;
+        double elapsed = std::chrono::duration<double, std::milli>(now - m_playingStart).count();
+        queued -= elapsed < chunkMs ? elapsed : chunkMs;
+    }
+    return queued > 0.0 ? queued : 0.0;
+}
+
+SpeechStats::Snapshot SpeechStats::GetSnapshot() const
+{
+    std::scoped_lock lock(m_mutex);
+    Snapshot snapshot;
+    snapshot.m_asr = m_asr;
+    snapshot.m_tts = m_tts;
+    snapshot.m_leadMs = GetLeadMsLocked(Clock::now());
+    snapshot.m_minLeadMs = m_minLeadMs;
+    snapshot.m_underruns = m_underruns;
+    snapshot.m_underrunMs = m_underrunMs;
+    snapshot.m_playing = m_playingSamples != 0;
+    return snapshot;
+}
+
+bool SpeechStats::WriteCSV(const std::string& path) const
+{
+    auto s = GetSnapshot();
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+        return false;
+
+    file << "stage,count,audio_s,processing_s,avg_rtf,last_rtf,max_rtf,underruns,underrun_ms,last_answer_min_lead_ms\n";
+    auto row = [&](const char* name, const RTFStats& rtf)
+        {
+            file << name << "," << rtf.m_count << "," << rtf.m_audioSeconds << "," << rtf.m_processingSeconds << ","
+                << rtf.GetAverageRTF() << "," << rtf.m_lastRTF << "," << rtf.m_maxRTF;
+        };
+    row("ASR", s.m_asr);
+    file << ",,,\n";
+    row("TTS", s.m_tts);
+    file << "," << s.m_underruns << "," << s.m_underrunMs << "," << s.m_minLeadMs << "\n";
+    return file.good();
+}
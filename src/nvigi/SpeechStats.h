@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Real-time factor (processing time / audio duration) for a speech stage; below 1 is faster than real time
+struct RTFStats
+{
+    uint64_t m_count = 0;
+    double m_audioSeconds = 0.0;
+    double m_processingSeconds = 0.0;
+    double m_lastRTF = 0.0;
+    double m_maxRTF = 0.0;
+
+    void Add(double audioSeconds, double processingSeconds);
+    double GetAverageRTF() const { return m_audioSeconds > 0.0 ? m_processingSeconds / m_audioSeconds : 0.0; }
+};
+
+// ASR and TTS speed relative to the audio they consume or produce, plus how far TTS synthesis is
+// ahead of playback.
+//
+// Synthesized audio is queued for playback chunk by chunk.  If playback finishes everything queued
+// and more audio for the same answer arrives later, the listener heard a gap; those are counted
+// as underruns.  All methods may be called from any thread.
+class SpeechStats
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // What the arrival of a synthesized chunk looked like from playback
+    struct ChunkInfo
+    {
+        // Audio still queued ahead of playback when the chunk arrived; only meaningful after the first chunk
+        double m_leadMs = 0.0;
+        bool m_first = true;
+        // Playback had run out waiting for this chunk
+        bool m_underrun = false;
+        double m_rtf = 0.0;
+    };
+
+    struct Snapshot
+    {
+        RTFStats m_asr;
+        RTFStats m_tts;
+        double m_leadMs = 0.0;
+        double m_minLeadMs = 0.0;
+        uint64_t m_underruns = 0;
+        double m_underrunMs = 0.0;
+        bool m_playing = false;
+    };
+
+    void AddASR(double audioSeconds, double processingSeconds);
+
+    // A new answer starts; a drained buffer between answers is not an underrun
+    void BeginTTSSequence(int sampleRate);
+    ChunkInfo OnTTSSynthesized(uint64_t samples, double processingSeconds);
+    void OnPlaybackStart(uint64_t samples);
+    void OnPlaybackEnd(uint64_t samples);
+
+    Snapshot GetSnapshot() const;
+    bool WriteCSV(const std::string& path) const;
+
+private:
+    double GetLeadMsLocked(Clock::time_point now) const;
+
+    mutable std::mutex m_mutex;
+    RTFStats m_asr;
+    RTFStats m_tts;
+
+    int m_sampleRate = 22050;
+    uint64_t m_synthesizedSamples = 0;
+    uint64_t m_playedSamples = 0;
+    // Chunk currently playing
+    uint64_t m_playingSamples = 0;
+    Clock::time_point m_playingStart;
+
+    // Lead just before each chunk arrives, from the second chunk of the answer on
+    uint64_t m_sequenceChunks = 0;
+    double m_minLeadMs = 0.0;
+    bool m_drained = false;
+    Clock::time_point m_drainedAt;
+    uint64_t m_underruns = 0;
+    double m_underrunMs = 0.0;
+};
@@ -0,0 +1,573 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "StructuredOutput.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace
+{
+    constexpr char kOpenTag[] = "<JSON>";
+    constexpr char kCloseTag[] = "</JSON>";
+    constexpr size_t kOpenTagLength = sizeof(kOpenTag) - 1;
+    constexpr size_t kCloseTagLength = sizeof(kCloseTag) - 1;
+    constexpr uint32_t kReplacementCharacter = 0xFFFD;
+
+    bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    int HexDigit(char c)
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        return -1;
+    }
+
+    void WriteString(std::string& out, const std::string& text)
+    {
+        static const char* kHex = "0123456789abcdef";
+        out += '"';
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            default:
+                if ((unsigned char)c < 0x20)
+                {
+                    out += "\\u00";
+                    out += kHex[(c >> 4) & 0xf];
+                    out += kHex[c & 0xf];
+                }
+                else
+                {
+                    out += c;
+                }
+            }
+        }
+        out += '"';
+    }
+}
+
+const JsonValue* JsonValue::Find(std::string_view key) const
+{
+    if (m_type != Type::Object)
+        return nullptr;
+    for (size_t i = 0; i < m_keys.size(); i++)
+    {
+        if (m_keys[i] == key)
+            return &m_items[i];
+    }
+    return nullptr;
+}
+
+std::string_view JsonValue::GetString(std::string_view key, std::string_view fallback) const
+{
+    const JsonValue* value = Find(key);
+    return value && value->m_type == Type::String ? std::string_view(value->m_string) : fallback;
+}
+
+double JsonValue::GetNumber(std::string_view key, double fallback) const
+{
+    const JsonValue* value = Find(key);
+    return value && value->m_type == Type::Number ? value->m_number : fallback;
+}
+
+void JsonValue::Write(std::string& out) const
+{
+    switch (m_type)
+    {
+    case Type::Null:
+        out += "null";
+        break;
+    case Type::Bool:
+        out += m_bool ? "true" : "false";
+        break;
+    case Type::Number:
+    {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), m_number);
+        out.append(buffer, result.ptr);
+        break;
+    }
+    case Type::String:
+        WriteString(out, m_string);
+        break;
+    case Type::Array:
+        out += '[';
+        for (size_t i = 0; i < m_items.size(); i++)
+        {
+            if (i)
+                out += ',';
+            m_items[i].Write(out);
+        }
+        out += ']';
+        break;
+    case Type::Object:
+        out += '{';
+        for (size_t i = 0; i < m_items.size(); i++)
+        {
+            if (i)
+                out += ',';
+            WriteString(out, m_keys[i]);
+            out += ':';
+            m_items[i].Write(out);
+        }
+        out += '}';
+        break;
+    }
+}
+
+std::string JsonValue::ToJSON() const
+{
+    std::string out;
+    Write(out);
+    return out;
+}
+
+void StructuredOutputParser::Reset()
+{
+    m_mode = Mode::Text;
+    m_tagMatched = 0;
+    m_pendingSpace.clear();
+    m_scalar = Scalar::None;
+    m_stack.clear();
+    m_root = {};
+}
+
+void StructuredOutputParser::Feed(std::string_view chunk, std::string& text, std::vector<StructuredEvent>& events)
+{
+    size_t i = 0;
+    while (i < chunk.size())
+    {
+        char c = chunk[i];
+        switch (m_mode)
+        {
+        case Mode::Text:
+        {
+            // Everything up to the next possible tag is text
+            const char* start = chunk.data() + i;
+            auto tag = (const char*)memchr(start, '<', chunk.size() - i);
+            if (!tag)
+            {
+                text.append(start, chunk.size() - i);
+                return;
+            }
+            text.append(start, tag - start);
+            i += tag - start + 1;
+            m_mode = Mode::OpenTag;
+            m_tagMatched = 1;
+            break;
+        }
+        case Mode::OpenTag:
+            if (c == kOpenTag[m_tagMatched])
+            {
+                i++;
+                if (++m_tagMatched == kOpenTagLength)
+                    BeginValue();
+            }
+            else
+            {
+                // Not a tag after all; the byte is looked at again as text, since it may start a tag itself
+                FlushTag(text);
+            }
+            break;
+        case Mode::Value:
+            if (FeedValue(c, events))
+                i++;
+            break;
+        case Mode::CloseTag:
+            if (m_tagMatched == 0 && IsSpace(c))
+            {
+                m_pendingSpace += c;
+                i++;
+            }
+            else if (c == kCloseTag[m_tagMatched])
+            {
+                i++;
+                if (++m_tagMatched == kCloseTagLength)
+                {
+                    m_pendingSpace.clear();
+                    m_tagMatched = 0;
+                    m_mode = Mode::Text;
+                }
+            }
+            else if (m_tagMatched == 1)
+            {
+                // "<" followed by something other than "/" may still open the next segment
+                text += m_pendingSpace;
+                m_pendingSpace.clear();
+                m_mode = Mode::OpenTag;
+            }
+            else
+            {
+                FlushTag(text);
+            }
+            break;
+        }
+    }
+}
+
+void StructuredOutputParser::Finish(std::string& text, std::vector<StructuredEvent>& events)
+{
+    if (m_mode == Mode::Value)
+    {
+        // A number is only known to be complete at the byte after it
+        if (m_scalar == Scalar::Number && m_stack.empty())
+            EndNumber(events);
+        else
+            Fail("unterminated segment", events);
+    }
+    if (m_mode == Mode::OpenTag || m_mode == Mode::CloseTag)
+        FlushTag(text);
+    Reset();
+}
+
+void StructuredOutputParser::FlushTag(std::string& text)
+{
+    if (m_mode == Mode::OpenTag)
+    {
+        text.append(kOpenTag, m_tagMatched);
+    }
+    else
+    {
+        text += m_pendingSpace;
+        text.append(kCloseTag, m_tagMatched);
+    }
+    m_pendingSpace.clear();
+    m_tagMatched = 0;
+    m_mode = Mode::Text;
+}
+
+void StructuredOutputParser::BeginValue()
+{
+    m_mode = Mode::Value;
+    m_expect = Expect::Value;
+    m_scalar = Scalar::None;
+    m_highSurrogate = 0;
+    m_segmentBytes = 0;
+    m_stack.clear();
+    m_root = {};
+}
+
+void StructuredOutputParser::Fail(const char* error, std::vector<StructuredEvent>& events)
+{
+    StructuredEvent event;
+    event.m_type = StructuredEvent::Type::Error;
+    event.m_error = error;
+    events.push_back(std::move(event));
+
+    m_mode = Mode::Text;
+    m_scalar = Scalar::None;
+    m_stack.clear();
+    m_root = {};
+}
+
+void StructuredOutputParser::AddValue(JsonValue&& value, std::vector<StructuredEvent>& events)
+{
+    if (!m_stack.empty())
+    {
+        m_stack.back()->m_items.push_back(std::move(value));
+        m_expect = Expect::CommaOrEnd;
+        return;
+    }
+
+    // The segment is complete
+    StructuredEvent event;
+    event.m_value = std::move(value);
+    const JsonValue* action = event.m_value.Find("action");
+    if (action && action->m_type == JsonValue::Type::String)
+    {
+        event.m_type = StructuredEvent::Type::Action;
+        event.m_action = action->m_string;
+    }
+    events.push_back(std::move(event));
+
+    m_mode = Mode::CloseTag;
+    m_tagMatched = 0;
+    m_pendingSpace.clear();
+}
+
+bool StructuredOutputParser::EndNumber(std::vector<StructuredEvent>& events)
+{
+    m_scalar = Scalar::None;
+    JsonValue value;
+    value.m_type = JsonValue::Type::Number;
+    const char* end = m_scratch.data() + m_scratch.size();
+    auto result = std::from_chars(m_scratch.data(), end, value.m_number);
+    if (result.ec != std::errc() || result.ptr != end)
+    {
+        Fail("invalid number", events);
+        return false;
+    }
+    AddValue(std::move(value), events);
+    return true;
+}
+
+void StructuredOutputParser::AppendCodePoint(uint32_t codePoint)
+{
+    if (codePoint < 0x80)
+    {
+        m_scratch += (char)codePoint;
+    }
+    else if (codePoint < 0x800)
+    {
+        m_scratch += (char)(0xC0 | (codePoint >> 6));
+        m_scratch += (char)(0x80 | (codePoint & 0x3F));
+    }
+    else if (codePoint < 0x10000)
+    {
+        m_scratch += (char)(0xE0 | (codePoint >> 12));
+        m_scratch += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        m_scratch += (char)(0x80 | (codePoint & 0x3F));
+    }
+    else
+    {
+        m_scratch += (char)(0xF0 | (codePoint >> 18));
+        m_scratch += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+        m_scratch += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        m_scratch += (char)(0x80 | (codePoint & 0x3F));
+    }
+}
+
+bool StructuredOutputParser::FeedValue(char c, std::vector<StructuredEvent>& events)
+{
+    if (++m_segmentBytes > kMaxSegmentBytes)
+    {
+        Fail("segment too long", events);
+        return true;
+    }
+    if (m_scalar != Scalar::None)
+        return FeedScalar(c, events);
+    if (IsSpace(c))
+        return true;
+
+    bool expectValue = m_expect == Expect::Value || m_expect == Expect::ValueOrEnd;
+    JsonValue* top = m_stack.empty() ? nullptr : m_stack.back();
+    switch (c)
+    {
+    case '{':
+    case '[':
+    {
+        if (!expectValue)
+            break;
+        if (m_stack.size() == kMaxDepth)
+        {
+            Fail("segment nested too deeply", events);
+            return true;
+        }
+        JsonValue container;
+        container.m_type = c == '{' ? JsonValue::Type::Object : JsonValue::Type::Array;
+        if (top)
+        {
+            top->m_items.push_back(std::move(container));
+            m_stack.push_back(&top->m_items.back());
+        }
+        else
+        {
+            m_root = std::move(container);
+            m_stack.push_back(&m_root);
+        }
+        m_expect = c == '{' ? Expect::KeyOrEnd : Expect::ValueOrEnd;
+        return true;
+    }
+    case '}':
+    case ']':
+    {
+        bool object = c == '}';
+        if (!top || (top->m_type == JsonValue::Type::Object) != object)
+            break;
+        if (m_expect != Expect::CommaOrEnd && m_expect != (object ? Expect::KeyOrEnd : Expect::ValueOrEnd))
+            break;
+        m_stack.pop_back();
+        if (m_stack.empty())
+            AddValue(std::move(m_root), events);
+        else
+            m_expect = Expect::CommaOrEnd;
+        return true;
+    }
+    case ',':
+        if (m_expect != Expect::CommaOrEnd)
+            break;
+        m_expect = top->m_type == JsonValue::Type::Object ? Expect::Key : Expect::Value;
+        return true;
+    case ':':
+        if (m_expect != Expect::Colon)
+            break;
+        m_expect = Expect::Value;
+        return true;
+    case '"':
+        if (!expectValue && m_expect != Expect::Key && m_expect != Expect::KeyOrEnd)
+            break;
+        m_stringIsKey = !expectValue;
+        m_scalar = Scalar::String;
+        m_scratch.clear();
+        return true;
+    case 't':
+    case 'f':
+    case 'n':
+        if (!expectValue)
+            break;
+        m_literal = c == 't' ? "true" : (c == 'f' ? "false" : "null");
+        m_literalMatched = 1;
+        m_scalar = Scalar::Literal;
+        return true;
+    default:
+        if (!expectValue || (c != '-' && (c < '0' || c > '9')))
+            break;
+        m_scratch.assign(1, c);
+        m_scalar = Scalar::Number;
+        return true;
+    }
+
+    Fail("unexpected character", events);
+    return true;
+}
+
+bool StructuredOutputParser::FeedScalar(char c, std::vector<StructuredEvent>& events)
+{
+    switch (m_scalar)
+    {
+    case Scalar::String:
+        if (c == '"')
+        {
+            if (m_highSurrogate)
+                AppendCodePoint(kReplacementCharacter);
+            m_highSurrogate = 0;
+            m_scalar = Scalar::None;
+            if (m_stringIsKey)
+            {
+                m_stack.back()->m_keys.push_back(std::move(m_scratch));
+                m_expect = Expect::Colon;
+            }
+            else
+            {
+                JsonValue value;
+                value.m_type = JsonValue::Type::String;
+                value.m_string = std::move(m_scratch);
+                AddValue(std::move(value), events);
+            }
+            m_scratch.clear();
+        }
+        else if (c == '\\')
+        {
+            m_scalar = Scalar::Escape;
+        }
+        else
+        {
+            if (m_highSurrogate)
+                AppendCodePoint(kReplacementCharacter);
+            m_highSurrogate = 0;
+            m_scratch += c;
+        }
+        return true;
+
+    case Scalar::Escape:
+    {
+        if (c == 'u')
+        {
+            m_unicode = 0;
+            m_unicodeDigits = 0;
+            m_scalar = Scalar::Unicode;
+            return true;
+        }
+        const char* escapes = "\"\\/bfnrt";
+        const char* values = "\"\\/\b\f\n\r\t";
+        const char* match = c ? strchr(escapes, c) : nullptr;
+        if (!match)
+        {
+            Fail("invalid escape", events);
+            return true;
+        }
+        if (m_highSurrogate)
+            AppendCodePoint(kReplacementCharacter);
+        m_highSurrogate = 0;
+        m_scratch += values[match - escapes];
+        m_scalar = Scalar::String;
+        return true;
+    }
+
+    case Scalar::Unicode:
+    {
+        int digit = HexDigit(c);
+        if (digit < 0)
+        {
+            Fail("invalid unicode escape", events);
+            return true;
+        }
+        m_unicode = (m_unicode << 4) | (uint32_t)digit;
+        if (++m_unicodeDigits < 4)
+            return true;
+
+        m_scalar = Scalar::String;
+        uint32_t unit = m_unicode;
+        if (unit >= 0xD800 && unit < 0xDC00)
+        {
+            if (m_highSurrogate)
+                AppendCodePoint(kReplacementCharacter);
+            m_highSurrogate = unit;
+        }
+        else if (unit >= 0xDC00 && unit < 0xE000)
+        {
+            AppendCodePoint(m_highSurrogate ? 0x10000 + ((m_highSurrogate - 0xD800) << 10) + (unit - 0xDC00) : kReplacementCharacter);
+            m_highSurrogate = 0;
+        }
+        else
+        {
+            if (m_highSurrogate)
+                AppendCodePoint(kReplacementCharacter);
+            m_highSurrogate = 0;
+            AppendCodePoint(unit);
+        }
+        return true;
+    }
+
+    case Scalar::Number:
+        if ((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-')
+        {
+            m_scratch += c;
+            return true;
+        }
+        // The byte after the number is looked at again, whether or not the number was valid
+        EndNumber(events);
+        return false;
+
+    case Scalar::Literal:
+        if (c != m_literal[m_literalMatched])
+        {
+            Fail("invalid literal", events);
+            return true;
+        }
+        if (m_literal[++m_literalMatched] == '\0')
+        {
+            JsonValue value;
+            value.m_type = m_literal[0] == 'n' ? JsonValue::Type::Null : JsonValue::Type::Bool;
+            value.m_bool = m_literal[0] == 't';
+            m_scalar = Scalar::None;
+            AddValue(std::move(value), events);
+        }
+        return true;
+
+    default:
+        return true;
+    }
+}
+
+void StructuredEventQueue::Push(StructuredEvent&& event)
+{
+    std::scoped_lock lock(m_mutex);
+    m_events.push_back(std::move(event));
+}
@@ -0,0 +1,172 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A parsed JSON value.  Object members keep their order; m_keys and m_items are parallel.
+struct JsonValue
+{
+    enum class Type : uint8_t
+    {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    Type m_type = Type::Null;
+    bool m_bool = false;
+    double m_number = 0.0;
+    std::string m_string;
+    std::vector<std::string> m_keys;
+    std::vector<JsonValue> m_items;
+
+    // Member of an object, or null
+    const JsonValue* Find(std::string_view key) const;
+    std::string_view GetString(std::string_view key, std::string_view fallback = {}) const;
+    double GetNumber(std::string_view key, double fallback = 0.0) const;
+
+    // Compact JSON text of the value
+    void Write(std::string& out) const;
+    std::string ToJSON() const;
+};
+
+// A segment of model output tagged as JSON
+struct StructuredEvent
+{
+    enum class Type : uint8_t
+    {
+        // An object with a string "action" member: a request for the game to do something
+        Action,
+        // Any other value, e.g. the statistics some plugins report at the end of a response
+        Data,
+        // A segment that is not valid JSON, or was cut off
+        Error
+    };
+
+    Type m_type = Type::Data;
+    std::string m_action;
+    JsonValue m_value;
+    std::string m_error;
+    // Set by whoever routes the event, e.g. the stage that produced it
+    const char* m_source = "";
+};
+
+// Separates tagged JSON segments from the text streamed by the GPT and ASR callbacks.
+//
+// A segment starts with <JSON> and ends with its JSON value, optionally followed by </JSON>.  Tokens
+// are fed as they arrive: tags and values may be split across any number of tokens, and every byte is
+// looked at once, with plain text copied out in runs up to the next '<'.  A partial tag is held back
+// until it is known not to be one.  Values are built as they are read, so a segment is complete, and
+// its event emitted, at the token that closes it.  A malformed or oversized segment is reported as an
+// Error event and the output after the offending byte is text again.  Strings are read leniently: raw
+// control characters are kept, and a lone surrogate becomes U+FFFD.
+class StructuredOutputParser
+{
+public:
+    static constexpr size_t kMaxSegmentBytes = 64 * 1024;
+    static constexpr size_t kMaxDepth = 32;
+
+    // Starts a new response, dropping anything pending from the previous one
+    void Reset();
+    // Appends the plain text of chunk to text, and the segments it completes to events
+    void Feed(std::string_view chunk, std::string& text, std::vector<StructuredEvent>& events);
+    // End of the response: a pending partial tag is text, and an unfinished segment an Error
+    void Finish(std::string& text, std::vector<StructuredEvent>& events);
+
+    bool InSegment() const { return m_mode == Mode::Value; }
+
+private:
+    enum class Mode : uint8_t
+    {
+        Text,
+        OpenTag,
+        Value,
+        CloseTag
+    };
+
+    // What the value parser expects next
+    enum class Expect : uint8_t
+    {
+        Value,
+        ValueOrEnd,
+        Key,
+        KeyOrEnd,
+        Colon,
+        CommaOrEnd
+    };
+
+    // The scalar being read, if any
+    enum class Scalar : uint8_t
+    {
+        None,
+        String,
+        Escape,
+        Unicode,
+        Number,
+        Literal
+    };
+
+    // Returns false if the byte was not consumed and must be looked at again in the new mode
+    bool FeedValue(char c, std::vector<StructuredEvent>& events);
+    bool FeedScalar(char c, std::vector<StructuredEvent>& events);
+    void BeginValue();
+    void AddValue(JsonValue&& value, std::vector<StructuredEvent>& events);
+    bool EndNumber(std::vector<StructuredEvent>& events);
+    void AppendCodePoint(uint32_t codePoint);
+    void Fail(const char* error, std::vector<StructuredEvent>& events);
+    // Text held back while matching a tag that turned out not to be one
+    void FlushTag(std::string& text);
+
+    Mode m_mode = Mode::Text;
+    size_t m_tagMatched = 0;
+    std::string m_pendingSpace;
+
+    Expect m_expect = Expect::Value;
+    Scalar m_scalar = Scalar::None;
+    bool m_stringIsKey = false;
+    std::string m_scratch;
+    const char* m_literal = nullptr;
+    size_t m_literalMatched = 0;
+    uint32_t m_unicode = 0;
+    int m_unicodeDigits = 0;
+    uint32_t m_highSurrogate = 0;
+    size_t m_segmentBytes = 0;
+
+    JsonValue m_root;
+    // Open arrays and objects, innermost last; each is the last item of the one before it
+    std::vector<JsonValue*> m_stack;
+};
+
+// Events on their way from the inference callbacks to the UI thread, which drains them once per frame
+class StructuredEventQueue
+{
+public:
+    void Push(StructuredEvent&& event);
+
+    // Calls sink(StructuredEvent&) for each event in push order
+    template <typename Sink>
+    void Drain(Sink&& sink)
+    {
+        std::vector<StructuredEvent> events;
+        {
+            std::scoped_lock lock(m_mutex);
+            events.swap(m_events);
+        }
+        for (auto& event : events)
+            sink(event);
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<StructuredEvent> m_events;
+};
@@ -0,0 +1,488 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "SyntheticBackend.h"
+#include "LogSink.h"
+
+#include <nvigi.h>
+#include <nvigi_ai.h>
+#include <nvigi_asr_whisper.h>
+#include <nvigi_gpt.h>
+#include <nvigi_stl_helpers.h>
+#include <nvigi_tts.h>
+
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+    SyntheticBackend::Config s_config;
+
+    // Outside the ranges used by the shipped plugins
+    const nvigi::PluginID kPluginIDs[] =
+    {
+        { { 0x5e7a1c01, 0x6a1d, 0x4c3e, { 0x8f, 0x21, 0x0b, 0x5a, 0x93, 0x4e, 0x7c, 0x01 } }, 0x5e7a01 }, // GPT
+        { { 0x5e7a1c02, 0x6a1d, 0x4c3e, { 0x8f, 0x21, 0x0b, 0x5a, 0x93, 0x4e, 0x7c, 0x02 } }, 0x5e7a02 }, // ASR
+        { { 0x5e7a1c03, 0x6a1d, 0x4c3e, { 0x8f, 0x21, 0x0b, 0x5a, 0x93, 0x4e, 0x7c, 0x03 } }, 0x5e7a03 }, // TTS
+    };
+
+    const SyntheticBackend::Model kGPTModels[] =
+    {
+        { "Synthetic GPT", "{5E7A0001-0000-4000-8000-000000000001}", 512 },
+        { "Synthetic GPT Large", "{5E7A0001-0000-4000-8000-000000000002}", 4096 },
+    };
+    const SyntheticBackend::Model kASRModels[] =
+    {
+        { "Synthetic ASR", "{5E7A0002-0000-4000-8000-000000000001}", 256 },
+    };
+    const SyntheticBackend::Model kTTSModels[] =
+    {
+        { "Synthetic TTS", "{5E7A0003-0000-4000-8000-000000000001}", 256 },
+    };
+
+    const char* kWords[] =
+    {
+        "the", "light", "falls", "across", "a", "quiet", "hall", "where", "old", "banners", "hang",
+        "above", "stone", "floors", "and", "every", "step", "echoes", "through", "arches", "of",
+        "carved", "marble", "that", "travelers", "have", "admired", "for", "centuries",
+    };
+
+    // Roughly the pace of the shipped TTS voices
+    constexpr double kSpokenSecondsPerCharacter = 0.065;
+    constexpr double kTTSChunkSeconds = 1.0;
+
+    struct SyntheticInstance
+    {
+        nvigi::InferenceInstance m_instance;
+        SyntheticBackend::Stage m_stage = SyntheticBackend::Stage::GPT;
+        std::string m_guid;
+        std::mt19937 m_rng;
+    };
+
+    double Jitter(std::mt19937& rng)
+    {
+        if (s_config.m_jitter <= 0.0)
+            return 1.0;
+        std::uniform_real_distribution<double> dist(1.0 - s_config.m_jitter, 1.0 + s_config.m_jitter);
+        return dist(rng);
+    }
+
+    bool Roll(std::mt19937& rng, double probability)
+    {
+        if (probability <= 0.0)
+            return false;
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        return dist(rng) < probability;
+    }
+
+    void SleepMs(double ms)
+    {
+        if (ms > 0.0)
+            std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(ms));
+    }
+
+    SyntheticInstance* GetInstance(nvigi::InferenceExecutionContext* ctx)
+    {
+        if (!ctx || !ctx->instance || !ctx->instance->data || !ctx->callback)
+            return nullptr;
+        return (SyntheticInstance*)ctx->instance->data;
+    }
+
+    const char* GetInputText(const nvigi::InferenceExecutionContext* ctx, const char* slot)
+    {
+        const nvigi::InferenceDataText* text{};
+        if (!ctx->inputs || !ctx->inputs->findAndValidateSlot(slot, &text) || !text)
+            return nullptr;
+        return (const char*)text->getUTF8Text();
+    }
+
+    // Same prompt, same answer; the answer length varies with the prompt
+    std::vector<std::string> MakeAnswerTokens(const std::string& prompt, int maxTokens)
+    {
+        std::mt19937 rng((uint32_t)std::hash<std::string>()(prompt) ^ s_config.m_seed);
+        int count = 24 + (int)(rng() % 96);
+        if (maxTokens > 0 && count > maxTokens)
+            count = maxTokens;
+
+        std::vector<std::string> tokens;
+        int sentenceLength = 0;
+        for (int i = 0; i < count; i++)
+        {
+            std::string word = kWords[rng() % (sizeof(kWords) / sizeof(kWords[0]))];
+            if (sentenceLength == 0)
+                word[0] = (char)toupper(word[0]);
+            sentenceLength++;
+            if (i + 1 == count || (sentenceLength > 6 && rng() % 5 == 0))
+            {
+                word += ". ";
+                sentenceLength = 0;
+            }
+            else
+            {
+                word += (rng() % 9 == 0) ? ", " : " ";
+            }
+            tokens.push_back(word);
+        }
+        return tokens;
+    }
+
+    nvigi::Result EvaluateGPT(nvigi::InferenceExecutionContext* ctx, SyntheticInstance& inst)
+    {
+        bool system = false;
+        const char* prompt = GetInputText(ctx, nvigi::kGPTDataSlotUser);
+        if (!prompt)
+        {
+            prompt = GetInputText(ctx, nvigi::kGPTDataSlotSystem);
+            system = prompt != nullptr;
+        }
+        if (!prompt)
+            return nvigi::kResultInvalidParameter;
+
+        int maxTokens = 0;
+        if (auto runtime = nvigi::findStruct<nvigi::GPTRuntimeParameters>(ctx->runtimeParameters))
+            maxTokens = runtime->tokensToPredict;
+
+        // The system prompt is only prefilled; it produces no tokens
+        std::vector<std::string> tokens;
+        if (!system)
+            tokens = MakeAnswerTokens(prompt, maxTokens);
+
+        // Fails before the first callback or part way through the answer
+        size_t failAt = SIZE_MAX;
+        if (Roll(inst.m_rng, s_config.m_evalFailureRate))
+            failAt = tokens.empty() ? 0 : inst.m_rng() % tokens.size();
+        if (failAt == 0)
+            return nvigi::kResultInvalidState;
+
+        SleepMs(s_config.m_ttftMs * Jitter(inst.m_rng));
+        double tokenMs = s_config.m_tokensPerSecond > 0.0 ? 1000.0 / s_config.m_tokensPerSecond : 0.0;
+
+        if (tokens.empty())
+            tokens.push_back("");
+        for (size_t i = 0; i < tokens.size(); i++)
+        {
+            if (i > 0)
+                SleepMs(tokenMs * Jitter(inst.m_rng));
+
+            bool failed = i == failAt;
+            bool last = i + 1 == tokens.size();
+            nvigi::InferenceDataTextSTLHelper text(failed ? std::string() : tokens[i]);
+            std::vector<nvigi::InferenceDataSlot> slots = { { nvigi::kGPTDataSlotResponse, text } };
+            nvigi::InferenceDataSlotArray outputs = { slots.size(), slots.data() };
+            ctx->outputs = &outputs;
+
+            nvigi::InferenceExecutionState state = failed ? nvigi::kInferenceExecutionStateInvalid :
+                (last ? nvigi::kInferenceExecutionStateDone : nvigi::kInferenceExecutionStateDataPending);
+            nvigi::InferenceExecutionState res = ctx->callback(ctx, state, ctx->callbackUserData);
+            ctx->outputs = nullptr;
+
+            if (failed)
+                return nvigi::kResultInvalidState;
+            if (res == nvigi::kInferenceExecutionStateCancel)
+                break;
+        }
+        return nvigi::kResultOk;
+    }
+
+    nvigi::Result EvaluateASR(nvigi::InferenceExecutionContext* ctx, SyntheticInstance& inst)
+    {
+        const nvigi::InferenceDataAudio* audio{};
+        if (!ctx->inputs || !ctx->inputs->findAndValidateSlot(nvigi::kASRWhisperDataSlotAudio, &audio) || !audio)
+            return nvigi::kResultInvalidParameter;
+        const nvigi::CpuData* cpuBuffer = nvigi::castTo<nvigi::CpuData>(audio->audio);
+        if (!cpuBuffer)
+            return nvigi::kResultInvalidParameter;
+
+        double bytesPerSecond = (double)audio->samplingRate * audio->channels * (audio->bitsPerSample / 8);
+        double audioSeconds = bytesPerSecond > 0.0 ? cpuBuffer->sizeInBytes / bytesPerSecond : 0.0;
+
+        if (Roll(inst.m_rng, s_config.m_evalFailureRate))
+            return nvigi::kResultInvalidState;
+
+        // Transcribed in two segments, like a short utterance through the whisper plugin
+        char transcript[128];
+        snprintf(transcript, sizeof(transcript), "This is a synthetic transcript of %.1f seconds of audio.", audioSeconds);
+        std::string full = transcript;
+        size_t split = full.find(" of ");
+        std::string segments[2] = { full.substr(0, split), full.substr(split) };
+
+        double processingMs = audioSeconds * 1000.0 * s_config.m_asrRTF;
+        for (int i = 0; i < 2; i++)
+        {
+            SleepMs(processingMs * 0.5 * Jitter(inst.m_rng));
+
+            nvigi::InferenceDataTextSTLHelper text(segments[i]);
+            std::vector<nvigi::InferenceDataSlot> slots = { { nvigi::kASRWhisperDataSlotTranscribedText, text } };
+            nvigi::InferenceDataSlotArray outputs = { slots.size(), slots.data() };
+            ctx->outputs = &outputs;
+            nvigi::InferenceExecutionState res = ctx->callback(ctx,
+                i == 1 ? nvigi::kInferenceExecutionStateDone : nvigi::kInferenceExecutionStateDataPending, ctx->callbackUserData);
+            ctx->outputs = nullptr;
+            if (res == nvigi::kInferenceExecutionStateCancel)
+                break;
+        }
+        return nvigi::kResultOk;
+    }
+
+    nvigi::Result EvaluateTTS(nvigi::InferenceExecutionContext* ctx, SyntheticInstance& inst)
+    {
+        const char* input = GetInputText(ctx, nvigi::kTTSDataSlotInputText);
+        if (!input)
+            return nvigi::kResultInvalidParameter;
+
+        if (Roll(inst.m_rng, s_config.m_evalFailureRate))
+            return nvigi::kResultInvalidState;
+
+        // Synthesis time scales with the flow-matching steps, 16 being the plugin default
+        double rtf = s_config.m_ttsRTF;
+        if (auto runtime = nvigi::findStruct<nvigi::TTSASqFlowRuntimeParameters>(ctx->runtimeParameters))
+            rtf *= runtime->n_timesteps / 16.0;
+
+        // A quiet tone for as long as the text would take to say
+        double audioSeconds = strlen(input) * kSpokenSecondsPerCharacter;
+        if (audioSeconds < 0.25)
+            audioSeconds = 0.25;
+        size_t totalSamples = (size_t)(audioSeconds * SyntheticBackend::kTTSSampleRate);
+        size_t chunkSamples = (size_t)(kTTSChunkSeconds * SyntheticBackend::kTTSSampleRate);
+
+        const double step = 2.0 * 3.14159265358979 * 220.0 / SyntheticBackend::kTTSSampleRate;
+        size_t produced = 0;
+        while (produced < totalSamples)
+        {
+            size_t count = totalSamples - produced < chunkSamples ? totalSamples - produced : chunkSamples;
+            SleepMs(count * 1000.0 / SyntheticBackend::kTTSSampleRate * rtf * Jitter(inst.m_rng));
+
+            std::vector<uint8_t> bytes(count * sizeof(int16_t));
+            int16_t* samples = (int16_t*)bytes.data();
+            for (size_t i = 0; i < count; i++)
+                samples[i] = (int16_t)(1500.0 * sin(step * (double)(produced + i)));
+            produced += count;
+
+            nvigi::InferenceDataByteArraySTLHelper audio(bytes);
+            std::vector<nvigi::InferenceDataSlot> slots = { { nvigi::kTTSDataSlotOutputAudio, audio } };
+            nvigi::InferenceDataSlotArray outputs = { slots.size(), slots.data() };
+            ctx->outputs = &outputs;
+            nvigi::InferenceExecutionState res = ctx->callback(ctx,
+                produced == totalSamples ? nvigi::kInferenceExecutionStateDone : nvigi::kInferenceExecutionStateDataPending, ctx->callbackUserData);
+            ctx->outputs = nullptr;
+            if (res == nvigi::kInferenceExecutionStateCancel)
+                break;
+        }
+        return nvigi::kResultOk;
+    }
+
+    nvigi::Result Evaluate(nvigi::InferenceExecutionContext* ctx)
+    {
+        SyntheticInstance* inst = GetInstance(ctx);
+        if (!inst)
+            return nvigi::kResultInvalidParameter;
+
+        switch (inst->m_stage)
+        {
+        case SyntheticBackend::Stage::GPT: return EvaluateGPT(ctx, *inst);
+        case SyntheticBackend::Stage::ASR: return EvaluateASR(ctx, *inst);
+        case SyntheticBackend::Stage::TTS: return EvaluateTTS(ctx, *inst);
+        }
+        return nvigi::kResultInvalidParameter;
+    }
+
+    template <SyntheticBackend::Stage S>
+    nvigi::Result CreateInstance(const nvigi::NVIGIParameter* params, nvigi::InferenceInstance** instance)
+    {
+        if (!instance)
+            return nvigi::kResultInvalidParameter;
+        auto common = nvigi::findStruct<nvigi::CommonCreationParameters>(params);
+        if (!common || !common->modelGUID)
+            return nvigi::kResultInvalidParameter;
+
+        size_t count = 0;
+        const SyntheticBackend::Model* models = SyntheticBackend::GetModels(S, count);
+        bool known = false;
+        for (size_t i = 0; i < count; i++)
+            known |= !strcmp(models[i].m_guid, common->modelGUID);
+        if (!known)
+            return nvigi::kResultItemNotFound;
+
+        static std::atomic<uint32_t> s_instanceCount = 0;
+        auto inst = new SyntheticInstance;
+        inst->m_stage = S;
+        inst->m_guid = common->modelGUID;
+        inst->m_rng.seed(s_config.m_seed + 7919u * s_instanceCount++ + (uint32_t)S);
+        inst->m_instance.data = (nvigi::InferenceInstanceData*)inst;
+        inst->m_instance.evaluate = Evaluate;
+
+        SleepMs(s_config.m_loadMs * Jitter(inst->m_rng));
+        if (Roll(inst->m_rng, s_config.m_loadFailureRate))
+        {
+            delete inst;
+            return nvigi::kResultInvalidState;
+        }
+
+        *instance = &inst->m_instance;
+        return nvigi::kResultOk;
+    }
+
+    nvigi::Result DestroyInstance(const nvigi::InferenceInstance* instance)
+    {
+        if (!instance)
+            return nvigi::kResultInvalidParameter;
+        delete (SyntheticInstance*)instance->data;
+        return nvigi::kResultOk;
+    }
+
+    // Capabilities in the same layout the real plugins report, built once per stage
+    struct Caps
+    {
+        using Budget = std::remove_pointer_t<decltype(nvigi::CommonCapabilitiesAndRequirements::modelMemoryBudgetMB)>;
+        using Flags = std::remove_pointer_t<decltype(nvigi::CommonCapabilitiesAndRequirements::modelFlags)>;
+        static constexpr size_t kMaxModels = 4;
+
+        nvigi::CommonCapabilitiesAndRequirements m_caps;
+        const char* m_names[kMaxModels] = {};
+        const char* m_guids[kMaxModels] = {};
+        Budget m_budgets[kMaxModels] = {};
+        Flags m_flags[kMaxModels] = {};
+
+        explicit Caps(SyntheticBackend::Stage stage)
+        {
+            size_t count = 0;
+            const SyntheticBackend::Model* models = SyntheticBackend::GetModels(stage, count);
+            for (size_t i = 0; i < count && i < kMaxModels; i++)
+            {
+                m_names[i] = models[i].m_name;
+                m_guids[i] = models[i].m_guid;
+                m_budgets[i] = (Budget)models[i].m_vramMB;
+            }
+            m_caps.numSupportedModels = (uint32_t)count;
+            m_caps.supportedModelNames = m_names;
+            m_caps.supportedModelGUIDs = m_guids;
+            m_caps.modelMemoryBudgetMB = m_budgets;
+            m_caps.modelFlags = m_flags;
+        }
+    };
+
+    template <SyntheticBackend::Stage S>
+    nvigi::Result GetCapsAndRequirements(nvigi::NVIGIParameter** modelInfo, const nvigi::NVIGIParameter*)
+    {
+        if (!modelInfo)
+            return nvigi::kResultInvalidParameter;
+        static Caps s_caps(S);
+        *modelInfo = s_caps.m_caps;
+        return nvigi::kResultOk;
+    }
+
+    template <SyntheticBackend::Stage S>
+    nvigi::InferenceInterface* MakeInterface()
+    {
+        static nvigi::InferenceInterface s_interface;
+        s_interface.createInstance = CreateInstance<S>;
+        s_interface.destroyInstance = DestroyInstance;
+        s_interface.getCapsAndRequirements = GetCapsAndRequirements<S>;
+        return &s_interface;
+    }
+}
+
+bool SyntheticBackend::ParseConfig(const std::string& text, Config& config)
+{
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        size_t eq = item.find('=');
+        if (eq == std::string::npos)
+        {
+            LogSink::Error("Synthetic backend: expected key=value, got '%s'", item.c_str());
+            return false;
+        }
+        std::string key = item.substr(0, eq);
+        double value = atof(item.c_str() + eq + 1);
+        if (key == "load")
+            config.m_loadMs = value;
+        else if (key == "ttft")
+            config.m_ttftMs = value;
+        else if (key == "tps")
+            config.m_tokensPerSecond = value;
+        else if (key == "asrRTF")
+            config.m_asrRTF = value;
+        else if (key == "ttsRTF")
+            config.m_ttsRTF = value;
+        else if (key == "jitter")
+            config.m_jitter = value;
+        else if (key == "loadFail")
+            config.m_loadFailureRate = value;
+        else if (key == "evalFail")
+            config.m_evalFailureRate = value;
+        else if (key == "seed")
+            config.m_seed = (uint32_t)value;
+        else
+        {
+            LogSink::Error("Synthetic backend: unknown setting '%s'", key.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+void SyntheticBackend::SetConfig(const Config& config)
+{
+    s_config = config;
+}
+
+const SyntheticBackend::Config& SyntheticBackend::GetConfig()
+{
+    return s_config;
+}
+
+nvigi::PluginID SyntheticBackend::GetPluginID(Stage stage)
+{
+    return kPluginIDs[(int)stage];
+}
+
+bool SyntheticBackend::IsSynthetic(const nvigi::PluginID& id)
+{
+    for (auto& synthetic : kPluginIDs)
+    {
+        if (synthetic == id)
+            return true;
+    }
+    return false;
+}
+
+const SyntheticBackend::Model* SyntheticBackend::GetModels(Stage stage, size_t& count)
+{
+    switch (stage)
+    {
+    case Stage::GPT: count = std::size(kGPTModels); return kGPTModels;
+    case Stage::ASR: count = std::size(kASRModels); return kASRModels;
+    case Stage::TTS: count = std::size(kTTSModels); return kTTSModels;
+    }
+    count = 0;
+    return nullptr;
+}
+
+nvigi::InferenceInterface* SyntheticBackend::GetInterface(const nvigi::PluginID& id)
+{
+    static nvigi::InferenceInterface* s_interfaces[] =
+    {
+        MakeInterface<Stage::GPT>(),
+        MakeInterface<Stage::ASR>(),
+        MakeInterface<Stage::TTS>(),
+    };
+    for (int i = 0; i < 3; i++)
+    {
+        if (kPluginIDs[i] == id)
+            return s_interfaces[i];
+    }
+    return nullptr;
+}
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <nvigi_struct.h>
+
+namespace nvigi
+{
+    struct InferenceInterface;
+}
+
+// Built-in stand-ins for the GPT, ASR and TTS plugins that need no GPU, no model files and no
+// NVIGI core.
+//
+// Each implements the same InferenceInterface/InferenceInstance contract as the real plugins and
+// paces its callbacks (DataPending for every token or audio chunk, then Done) to a configurable
+// time to first token, token rate and real-time factor, with optional jitter and injected failures.
+// Generated text and audio are deterministic for a given seed and prompt.
+class SyntheticBackend
+{
+public:
+    enum class Stage
+    {
+        GPT,
+        ASR,
+        TTS
+    };
+
+    struct Config
+    {
+        // Instance creation time
+        double m_loadMs = 300.0;
+        // GPT time to first token and decode rate; 0 tokens/s streams without delay
+        double m_ttftMs = 150.0;
+        double m_tokensPerSecond = 40.0;
+        // Processing time per second of audio consumed (ASR) or produced (TTS, at 16 timesteps)
+        double m_asrRTF = 0.1;
+        double m_ttsRTF = 0.25;
+        // Every delay is scaled by a random factor in [1 - jitter, 1 + jitter]
+        double m_jitter = 0.1;
+        // Probability of createInstance or evaluate failing
+        double m_loadFailureRate = 0.0;
+        double m_evalFailureRate = 0.0;
+        uint32_t m_seed = 1;
+    };
+
+    struct Model
+    {
+        const char* m_name;
+        const char* m_guid;
+        size_t m_vramMB;
+    };
+
+    static constexpr int kTTSSampleRate = 22050;
+
+    // Parses "key=value" pairs separated by commas, e.g. "ttft=200,tps=30,jitter=0.2,evalFail=0.05";
+    // unknown keys are reported and fail the parse
+    static bool ParseConfig(const std::string& text, Config& config);
+    // Must be set before any instance is created
+    static void SetConfig(const Config& config);
+    static const Config& GetConfig();
+
+    static nvigi::PluginID GetPluginID(Stage stage);
+    static bool IsSynthetic(const nvigi::PluginID& id);
+    static const char* GetPluginName() { return "synthetic"; }
+
+    // Models offered by the synthetic plugin of a stage
+    static const Model* GetModels(Stage stage, size_t& count);
+
+    // Null for IDs that are not synthetic
+    static nvigi::InferenceInterface* GetInterface(const nvigi::PluginID& id);
+};
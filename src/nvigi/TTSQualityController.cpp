@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "TTSQualityController.h"
+
+#include <donut/core/log.h>
+
+#include <fstream>
+
+namespace
+{
+    constexpr double kLowLeadMs = 250.0;
+    constexpr double kHighLeadMs = 1500.0;
+    constexpr double kMaxRaiseRTF = 0.5;
+    constexpr int kRaiseChunks = 3;
+
+    // From the default to the soonest to reach playback
+    const TTSQualityController::Level kLevels[TTSQualityController::kLevelCount] =
+    {
+        { 64, 128 },
+        { 48, 96 },
+        { 32, 64 },
+        { 24, 48 },
+    };
+}
+
+const TTSQualityController::Level& TTSQualityController::GetLevel(size_t index)
+{
+    return kLevels[index < kLevelCount ? index : kDefaultLevel];
+}
+
+void TTSQualityController::SetEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    m_level = kDefaultLevel;
+    m_headroomChunks = 0;
+}
+
+void TTSQualityController::OnChunk(const SpeechStats::ChunkInfo& chunk, size_t level)
+{
+    bool enabled = m_enabled;
+    size_t next = level;
+    if (enabled && !chunk.m_first && m_level == level)
+    {
+        if (chunk.m_underrun || chunk.m_leadMs < kLowLeadMs)
+        {
+            m_headroomChunks = 0;
+            if (level + 1 < kLevelCount)
+                next = level + 1;
+        }
+        else if (chunk.m_leadMs > kHighLeadMs && chunk.m_rtf < kMaxRaiseRTF)
+        {
+            if (++m_headroomChunks >= kRaiseChunks && level > kDefaultLevel)
+            {
+                m_headroomChunks = 0;
+                next = level - 1;
+            }
+        }
+        else
+        {
+            m_headroomChunks = 0;
+        }
+    }
+
+    {
+        std::scoped_lock lock(m_mutex);
+        Stats& stats = m_stats[enabled ? 1 : 0];
+        stats.m_chunks++;
+        stats.m_maxChunk += (double)GetLevel(level).m_maxChunk;
+        if (chunk.m_underrun)
+            stats.m_gaps++;
+        if (!chunk.m_first)
+        {
+            stats.m_leadCount++;
+            stats.m_leadMs += chunk.m_leadMs;
+        }
+        if (next > level)
+            stats.m_lowered++;
+        else if (next < level)
+            stats.m_raised++;
+    }
+
+    if (next != level)
+    {
+        m_level = next;
+        donut::log::info("TTS quality: %d-%d -> %d-%d character chunks (lead %.0f ms%s, RTF %.2f)",
+            (int)GetLevel(level).m_minChunk, (int)GetLevel(level).m_maxChunk, (int)GetLevel(next).m_minChunk, (int)GetLevel(next).m_maxChunk,
+            chunk.m_leadMs, chunk.m_underrun ? ", gap" : "", chunk.m_rtf);
+    }
+}
+
+TTSQualityController::Stats TTSQualityController::GetStats(bool enabled) const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_stats[enabled ? 1 : 0];
+}
+
+void TTSQualityController::ResetStats()
+{
+    std::scoped_lock lock(m_mutex);
+    m_stats = {};
+}
+
+bool TTSQualityController::WriteCSV(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+        return false;
+
+    file << "controller,chunks,gaps,avg_lead_ms,avg_max_chunk,lowered,raised\n";
+    for (bool enabled : { false, true })
+    {
+        Stats s = GetStats(enabled);
+        file << (enabled ? "on" : "off") << "," << s.m_chunks << "," << s.m_gaps << "," << s.GetAverageLeadMs() << ","
+            << s.GetAverageMaxChunk() << "," << s.m_lowered << "," << s.m_raised << "\n";
+    }
+    return file.good();
+}
@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "SpeechStats.h"
+
+// Shrinks the TTS chunks to keep playback fed.
+//
+// Each level is a chunk size range for the TTS chunker; smaller chunks reach playback sooner, at the
+// cost of more evaluates and less natural prosody.  After every chunk the controller looks at how much
+// audio was still queued ahead of playback: a gap or a lead under 250 ms drops one level at once, and
+// three chunks in a row with more than 1.5 s of lead and a real-time factor under 0.5 raise it by one,
+// up to the default.  The flow-matching timesteps are not part of the levels, since the TTS plugin
+// ignores n_timesteps.  Audio gaps are counted separately for the chunks synthesized with and without
+// the controller, so the two can be compared.
+class TTSQualityController
+{
+public:
+    struct Level
+    {
+        size_t m_minChunk;
+        size_t m_maxChunk;
+    };
+
+    struct Stats
+    {
+        uint64_t m_chunks = 0;
+        uint64_t m_gaps = 0;
+        // Lead before each chunk, from the second chunk of an answer on
+        uint64_t m_leadCount = 0;
+        double m_leadMs = 0.0;
+        double m_maxChunk = 0.0;
+        uint64_t m_lowered = 0;
+        uint64_t m_raised = 0;
+
+        double GetAverageLeadMs() const { return m_leadCount ? m_leadMs / m_leadCount : 0.0; }
+        double GetAverageMaxChunk() const { return m_chunks ? m_maxChunk / m_chunks : 0.0; }
+    };
+
+    static constexpr size_t kLevelCount = 4;
+    // 64-128 character chunks, the fixed setting used without the controller
+    static constexpr size_t kDefaultLevel = 0;
+    static const Level& GetLevel(size_t index);
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const { return m_enabled; }
+
+    // TTS thread: level for the next evaluate, and how a chunk synthesized at a given level went.  A
+    // level only moves once per evaluate, since its chunks all share the settings.
+    size_t GetLevelIndex() const { return m_enabled ? m_level.load() : kDefaultLevel; }
+    void OnChunk(const SpeechStats::ChunkInfo& chunk, size_t level);
+
+    Stats GetStats(bool enabled) const;
+    void ResetStats();
+    // One row each for the chunks synthesized with the controller off and on
+    bool WriteCSV(const std::string& path) const;
+
+private:
+    std::atomic<bool> m_enabled = false;
+    std::atomic<size_t> m_level = kDefaultLevel;
+    int m_headroomChunks = 0;
+
+    mutable std::mutex m_mutex;
+    std::array<Stats, 2> m_stats;
+};
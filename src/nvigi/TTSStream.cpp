@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "TTSStream.h"
+
+#include <regex>
+
+bool TTSChunker::Append(const std::string& text, bool done, std::string& chunk)
+{
+    m_input += text;
+
+    if (m_input.empty())
+        return false;
+
+    bool isLastCharacterPeriod = (m_input.back() == '\n' || m_input.back() == '.' ||
+        m_input.back() == '!' || m_input.back() == '?' || m_input.back() == '"');
+
+    if (isLastCharacterPeriod)
+        m_posLastPeriod = m_input.size() - 1;
+    else if (m_input.back() == ' ')
+        m_posLastSpace = m_input.size() - 1;
+    else if (m_input.back() == ',')
+        m_posLastComma = m_input.size() - 1;
+
+    if (!(isLastCharacterPeriod && m_input.size() >= m_minChunk) && m_input.size() <= m_maxChunk && !done)
+        return false;
+
+    if (done || isLastCharacterPeriod || (m_posLastPeriod == 0 && m_posLastSpace == 0 && m_posLastComma == 0))
+    {
+        chunk = m_input;
+        m_input = "";
+    }
+    else
+    {
+        size_t cut = m_posLastPeriod != 0 ? m_posLastPeriod : (m_posLastComma != 0 ? m_posLastComma : m_posLastSpace);
+        chunk = m_input.substr(0, cut + 1);
+        m_input = m_input.substr(cut + 1);
+    }
+
+    m_posLastPeriod = 0;
+    m_posLastSpace = 0;
+    m_posLastComma = 0;
+    return true;
+}
+
+void TTSChunker::Reset()
+{
+    m_input = "";
+    m_posLastPeriod = 0;
+    m_posLastSpace = 0;
+    m_posLastComma = 0;
+}
+
+void TTSChunker::SetChunkSize(size_t minChunk, size_t maxChunk)
+{
+    m_minChunk = minChunk;
+    m_maxChunk = maxChunk;
+}
+
+std::string PreprocessTTSText(const std::string& text)
+{
+    // GPT answers can produce a lot of asterisks, and TTS will read them as a word.
+    // We need to remove them except when they're between numbers (e.g., keep "3*5" but remove standalone *)
+
+    // Step 1: Temporarily replace number*number patterns with a placeholder
+    std::string result = std::regex_replace(text, std::regex(R"((\d)\*(\d))"), "$1MULT$2");
+
+    // Step 2: Remove all remaining asterisks
+    result = std::regex_replace(result, std::regex(R"(\*)"), "");
+
+    // Step 3: Restore the multiplication patterns
+    result = std::regex_replace(result, std::regex(R"(MULT)"), "*");
+
+    // Remove non-UTF-8 characters
+    std::string output;
+    for (char ch : result)
+    {
+        if (static_cast<unsigned char>(ch) < 0x80) // ASCII range (valid UTF-8 single byte)
+            output += ch;
+    }
+    return output;
+}
+
+void AppendTTSAudio(const int16_t* samples, size_t count, std::vector<int16_t>& answer, std::vector<int16_t>& chunk)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        answer.push_back(samples[i]);
+        chunk.push_back(samples[i]);
+    }
+}
@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Splits streamed GPT text into chunks for TTS.
+//
+// Chunks are between 64 and 128 characters where possible (or the sizes set with SetChunkSize), and
+// are cut at the last sentence end, then comma, then space, so that sentences are not split mid-word.
+class TTSChunker
+{
+public:
+    static constexpr size_t kMinChunk = 64;
+    static constexpr size_t kMaxChunk = 128;
+
+    // Returns true and fills chunk when enough text has been gathered; done flushes everything pending
+    bool Append(const std::string& text, bool done, std::string& chunk);
+    void Reset();
+    // Takes effect from the next Append
+    void SetChunkSize(size_t minChunk, size_t maxChunk);
+
+    const std::string& GetPending() const { return m_input; }
+
+private:
+    size_t m_minChunk = kMinChunk;
+    size_t m_maxChunk = kMaxChunk;
+    std::string m_input;
+    size_t m_posLastSpace = 0;
+    size_t m_posLastPeriod = 0;
+    size_t m_posLastComma = 0;
+};
+
+// Cleans up GPT output before it is spoken: removes asterisks (keeping "3*5") and any non-ASCII bytes
+std::string PreprocessTTSText(const std::string& text);
+
+// Appends a synthesized chunk to the full answer and to the chunk queued for playback
+void AppendTTSAudio(const int16_t* samples, size_t count, std::vector<int16_t>& answer, std::vector<int16_t>& chunk);
@@ -0,0 +1,405 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "ThreadRegistry.h"
+#include "LogSink.h"
+#include "Trace.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using Role = ThreadRegistry::Role;
+    using Priority = ThreadRegistry::Priority;
+
+    const char* kRoleNames[] = { "render", "audio", "inference", "loading" };
+    const char* kPriorityNames[] = { "default", "low", "normal", "high", "realtime" };
+
+    struct ThreadEntry
+    {
+        const char* m_name = nullptr;
+        Role m_role = Role::Render;
+        Clock::time_point m_start;
+        bool m_applied = true;
+#ifdef _WIN32
+        HANDLE m_handle = nullptr;
+#else
+        pthread_t m_handle{};
+        pid_t m_tid = 0;
+#endif
+    };
+
+    // Per-platform backend; all of these take the registry lock's word that the thread is still alive
+#ifdef _WIN32
+    void OpenCurrentThread(ThreadEntry& entry)
+    {
+        entry.m_handle = OpenThread(THREAD_SET_INFORMATION | THREAD_QUERY_INFORMATION, FALSE, GetCurrentThreadId());
+    }
+
+    void CloseThread(ThreadEntry& entry)
+    {
+        if (entry.m_handle)
+            CloseHandle(entry.m_handle);
+        entry.m_handle = nullptr;
+    }
+
+    void SetCurrentThreadName(const char* name)
+    {
+        std::wstring wide(name, name + strlen(name));
+        SetThreadDescription(GetCurrentThread(), wide.c_str());
+    }
+
+    bool ApplyAffinity(const ThreadEntry& entry, uint64_t mask)
+    {
+        if (!entry.m_handle)
+            return false;
+        if (mask == 0)
+        {
+            DWORD_PTR processMask = 0, systemMask = 0;
+            if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+                return false;
+            mask = processMask;
+        }
+        return SetThreadAffinityMask(entry.m_handle, (DWORD_PTR)mask) != 0;
+    }
+
+    bool ApplyPriority(const ThreadEntry& entry, Priority priority)
+    {
+        if (!entry.m_handle)
+            return false;
+        int value = THREAD_PRIORITY_NORMAL;
+        switch (priority)
+        {
+        case Priority::Low: value = THREAD_PRIORITY_BELOW_NORMAL; break;
+        case Priority::High: value = THREAD_PRIORITY_HIGHEST; break;
+        case Priority::Realtime: value = THREAD_PRIORITY_TIME_CRITICAL; break;
+        default: break;
+        }
+        return SetThreadPriority(entry.m_handle, value) != 0;
+    }
+
+    double QueryCpuMs(const ThreadEntry& entry)
+    {
+        FILETIME creation, exit, kernel, user;
+        if (!entry.m_handle || !GetThreadTimes(entry.m_handle, &creation, &exit, &kernel, &user))
+            return 0.0;
+        auto ticks = [](const FILETIME& time) { return ((uint64_t)time.dwHighDateTime << 32) | time.dwLowDateTime; };
+        // 100 ns units
+        return (ticks(kernel) + ticks(user)) / 10000.0;
+    }
+#else
+    void OpenCurrentThread(ThreadEntry& entry)
+    {
+        entry.m_handle = pthread_self();
+        entry.m_tid = (pid_t)syscall(SYS_gettid);
+    }
+
+    void CloseThread(ThreadEntry&)
+    {
+    }
+
+    void SetCurrentThreadName(const char* name)
+    {
+        // Linux thread names are limited to 15 characters
+        char truncated[16] = {};
+        strncpy(truncated, name, sizeof(truncated) - 1);
+        pthread_setname_np(pthread_self(), truncated);
+    }
+
+    bool ApplyAffinity(const ThreadEntry& entry, uint64_t mask)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            // CPUs that are not online are ignored by the kernel
+            if (mask == 0 || (cpu < 64 && (mask & (1ull << cpu))))
+                CPU_SET(cpu, &set);
+        }
+        return pthread_setaffinity_np(entry.m_handle, sizeof(set), &set) == 0;
+    }
+
+    bool ApplyPriority(const ThreadEntry& entry, Priority priority)
+    {
+        sched_param param{};
+        if (priority == Priority::Realtime)
+        {
+            param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+            if (pthread_setschedparam(entry.m_handle, SCHED_FIFO, &param) == 0)
+                return true;
+            // Without CAP_SYS_NICE or an RLIMIT_RTPRIO the closest is the highest nice value we may set
+        }
+        else
+        {
+            pthread_setschedparam(entry.m_handle, SCHED_OTHER, &param);
+        }
+
+        int nice = 0;
+        switch (priority)
+        {
+        case Priority::Low: nice = 10; break;
+        case Priority::High: nice = -5; break;
+        case Priority::Realtime: nice = -10; break;
+        default: break;
+        }
+        // The nice value is per thread on Linux
+        return setpriority(PRIO_PROCESS, (id_t)entry.m_tid, nice) == 0;
+    }
+
+    double QueryCpuMs(const ThreadEntry& entry)
+    {
+        clockid_t clock;
+        timespec time{};
+        if (pthread_getcpuclockid(entry.m_handle, &clock) != 0 || clock_gettime(clock, &time) != 0)
+            return 0.0;
+        return time.tv_sec * 1000.0 + time.tv_nsec / 1e6;
+    }
+#endif
+
+    struct RegistryState
+    {
+        std::mutex m_mutex;
+        ThreadRegistry::RoleConfig m_configs[(int)Role::Count];
+        // One warning per role until its configuration changes; audio threads start with every chunk
+        bool m_warned[(int)Role::Count] = {};
+        std::vector<std::shared_ptr<ThreadEntry>> m_live;
+        std::vector<ThreadRegistry::ThreadInfo> m_exited;
+    };
+
+    RegistryState& GetState()
+    {
+        static RegistryState state;
+        return state;
+    }
+
+    double GetWallMs(const ThreadEntry& entry)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - entry.m_start).count();
+    }
+
+    // With initial set, a zero mask and the default priority leave the thread alone; otherwise they restore it
+    void Apply(RegistryState& state, ThreadEntry& entry, bool initial)
+    {
+        const auto& config = state.m_configs[(int)entry.m_role];
+        bool applied = true;
+        if (config.m_affinityMask != 0 || !initial)
+            applied = ApplyAffinity(entry, config.m_affinityMask) && applied;
+        if (config.m_priority != Priority::Default || !initial)
+            applied = ApplyPriority(entry, config.m_priority) && applied;
+        entry.m_applied = applied;
+
+        if (!applied && !state.m_warned[(int)entry.m_role])
+        {
+            state.m_warned[(int)entry.m_role] = true;
+            LogSink::Warning("Unable to apply the %s affinity 0x%llx and %s priority to thread %s",
+                kRoleNames[(int)entry.m_role], (unsigned long long)config.m_affinityMask,
+                kPriorityNames[(int)config.m_priority], entry.m_name);
+        }
+    }
+
+    // Moves the thread into the exited totals when it ends
+    struct ThreadEntryOwner
+    {
+        std::shared_ptr<ThreadEntry> m_entry;
+        ~ThreadEntryOwner()
+        {
+            if (!m_entry)
+                return;
+            auto& state = GetState();
+            std::scoped_lock lock(state.m_mutex);
+            double cpuMs = QueryCpuMs(*m_entry);
+            double wallMs = GetWallMs(*m_entry);
+            CloseThread(*m_entry);
+            for (auto it = state.m_live.begin(); it != state.m_live.end(); ++it)
+            {
+                if (*it == m_entry)
+                {
+                    state.m_live.erase(it);
+                    break;
+                }
+            }
+
+            ThreadRegistry::ThreadInfo* total = nullptr;
+            for (auto& info : state.m_exited)
+            {
+                if (info.m_role == m_entry->m_role && info.m_name == m_entry->m_name)
+                    total = &info;
+            }
+            if (!total)
+            {
+                total = &state.m_exited.emplace_back();
+                total->m_name = m_entry->m_name;
+                total->m_role = m_entry->m_role;
+                total->m_threads = 0;
+            }
+            total->m_threads++;
+            total->m_applied = total->m_applied && m_entry->m_applied;
+            total->m_cpuMs += cpuMs;
+            total->m_wallMs += wallMs;
+        }
+    };
+
+    template <typename T>
+    bool ParseRoleList(const char* spec, T parseValue)
+    {
+        std::string list = spec;
+        size_t start = 0;
+        while (start <= list.size())
+        {
+            size_t end = list.find(',', start);
+            if (end == std::string::npos)
+                end = list.size();
+            std::string item = list.substr(start, end - start);
+            size_t equals = item.find('=');
+            if (equals == std::string::npos)
+                return false;
+            std::string name = item.substr(0, equals);
+            int role = 0;
+            while (role < (int)Role::Count && name != kRoleNames[role])
+                role++;
+            if (role == (int)Role::Count || !parseValue((Role)role, item.substr(equals + 1)))
+                return false;
+            start = end + 1;
+        }
+        return true;
+    }
+}
+
+const char* ThreadRegistry::GetRoleName(Role role)
+{
+    return kRoleNames[(int)role];
+}
+
+const char* ThreadRegistry::GetPriorityName(Priority priority)
+{
+    return kPriorityNames[(int)priority];
+}
+
+void ThreadRegistry::Register(const char* name, Role role)
+{
+    Trace::SetThreadName(name);
+    SetCurrentThreadName(name);
+
+    thread_local ThreadEntryOwner owner;
+    auto& state = GetState();
+    std::scoped_lock lock(state.m_mutex);
+    if (!owner.m_entry)
+    {
+        owner.m_entry = std::make_shared<ThreadEntry>();
+        owner.m_entry->m_start = Clock::now();
+        OpenCurrentThread(*owner.m_entry);
+        state.m_live.push_back(owner.m_entry);
+    }
+    // A thread that moves to another role takes all of its settings, defaults included
+    bool initial = owner.m_entry->m_name == nullptr || owner.m_entry->m_role == role;
+    owner.m_entry->m_name = name;
+    owner.m_entry->m_role = role;
+    Apply(state, *owner.m_entry, initial);
+}
+
+ThreadRegistry::RoleConfig ThreadRegistry::GetRoleConfig(Role role)
+{
+    auto& state = GetState();
+    std::scoped_lock lock(state.m_mutex);
+    return state.m_configs[(int)role];
+}
+
+void ThreadRegistry::SetRoleConfig(Role role, const RoleConfig& config)
+{
+    auto& state = GetState();
+    std::scoped_lock lock(state.m_mutex);
+    state.m_configs[(int)role] = config;
+    state.m_warned[(int)role] = false;
+    for (auto& entry : state.m_live)
+    {
+        if (entry->m_role == role)
+            Apply(state, *entry, false);
+    }
+}
+
+bool ThreadRegistry::ParseAffinity(const char* spec)
+{
+    return ParseRoleList(spec, [](Role role, const std::string& value)
+        {
+            char* end = nullptr;
+            uint64_t mask = strtoull(value.c_str(), &end, 0);
+            if (value.empty() || *end)
+                return false;
+            RoleConfig config = GetRoleConfig(role);
+            config.m_affinityMask = mask;
+            SetRoleConfig(role, config);
+            return true;
+        });
+}
+
+bool ThreadRegistry::ParsePriority(const char* spec)
+{
+    return ParseRoleList(spec, [](Role role, const std::string& value)
+        {
+            for (int i = 0; i < (int)Priority::Count; i++)
+            {
+                if (value == kPriorityNames[i])
+                {
+                    RoleConfig config = GetRoleConfig(role);
+                    config.m_priority = (Priority)i;
+                    SetRoleConfig(role, config);
+                    return true;
+                }
+            }
+            return false;
+        });
+}
+
+std::vector<ThreadRegistry::ThreadInfo> ThreadRegistry::GetThreads()
+{
+    auto& state = GetState();
+    std::scoped_lock lock(state.m_mutex);
+    std::vector<ThreadInfo> threads;
+    threads.reserve(state.m_live.size() + state.m_exited.size());
+    for (auto& entry : state.m_live)
+    {
+        ThreadInfo& info = threads.emplace_back();
+        info.m_name = entry->m_name;
+        info.m_role = entry->m_role;
+        info.m_live = true;
+        info.m_applied = entry->m_applied;
+        info.m_cpuMs = QueryCpuMs(*entry);
+        info.m_wallMs = GetWallMs(*entry);
+    }
+    threads.insert(threads.end(), state.m_exited.begin(), state.m_exited.end());
+    return threads;
+}
+
+bool ThreadRegistry::WriteCSV(const std::string& path)
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+        return false;
+
+    file << "name,role,threads,live,applied,affinity_mask,priority,cpu_ms,wall_ms,utilization\n";
+    for (const auto& info : GetThreads())
+    {
+        RoleConfig config = GetRoleConfig(info.m_role);
+        file << info.m_name << "," << GetRoleName(info.m_role) << "," << info.m_threads << "," << info.m_live << ","
+            << info.m_applied << ",0x" << std::hex << config.m_affinityMask << std::dec << "," << GetPriorityName(config.m_priority) << ","
+            << info.m_cpuMs << "," << info.m_wallMs << "," << info.GetUtilization() << "\n";
+    }
+    return file.good();
+}
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Names the sample's threads, applies an affinity mask and priority per role, and reports their CPU time.
+//
+// Threads register themselves when they start.  Each role has a configuration, set from the command
+// line or the UI, which is applied at registration and again to the live threads of the role whenever it
+// changes.  A zero mask and the default priority leave the thread as the OS created it.  Threads that
+// have exited are summed by name, so the short-lived audio threads show up as one row.  Threads the
+// NVIGI plugins create themselves are not registered; on Linux they inherit the affinity and nice
+// value of the thread that created them, on Windows they do not.
+class ThreadRegistry
+{
+public:
+    enum class Role
+    {
+        Render,
+        Audio,
+        Inference,
+        Loading,
+        Count
+    };
+
+    enum class Priority
+    {
+        Default,
+        Low,
+        Normal,
+        High,
+        Realtime,
+        Count
+    };
+
+    struct RoleConfig
+    {
+        // Bit n allows CPU n; 0 allows all of them
+        uint64_t m_affinityMask = 0;
+        Priority m_priority = Priority::Default;
+    };
+
+    struct ThreadInfo
+    {
+        std::string m_name;
+        Role m_role = Role::Render;
+        // Threads summed into this row; live threads are one row each
+        uint32_t m_threads = 1;
+        bool m_live = false;
+        // The role's affinity and priority were applied without error
+        bool m_applied = true;
+        double m_cpuMs = 0.0;
+        // Wall time the thread(s) were registered for
+        double m_wallMs = 0.0;
+
+        double GetUtilization() const { return m_wallMs > 0.0 ? m_cpuMs / m_wallMs : 0.0; }
+    };
+
+    static const char* GetRoleName(Role role);
+    static const char* GetPriorityName(Priority priority);
+
+    // Names the calling thread for debuggers and the trace, and applies its role's configuration; the
+    // name must be a string literal
+    static void Register(const char* name, Role role);
+
+    static RoleConfig GetRoleConfig(Role role);
+    static void SetRoleConfig(Role role, const RoleConfig& config);
+    // Comma-separated role=value lists, e.g. "render=0x3,inference=0xfc" and "audio=realtime,loading=low"
+    static bool ParseAffinity(const char* spec);
+    static bool ParsePriority(const char* spec);
+
+    // Live threads with their CPU time so far, then the exited ones summed by name and role
+    static std::vector<ThreadInfo> GetThreads();
+    static bool WriteCSV(const std::string& path);
+};
@@ -0,0 +1,27 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "TokenQueue.h"
+
+#include <algorithm>
+#include <cstring>
+
+void TokenQueue::Push(std::string_view text)
+{
+    while (!text.empty())
+    {
+        Slot slot;
+        slot.m_size = (uint8_t)std::min(text.size(), Slot::kMaxText);
+        memcpy(slot.m_text, text.data(), slot.m_size);
+        text.remove_prefix(slot.m_size);
+
+        // Stay on the overflow list until the consumer has emptied it, to keep the order
+        if (!m_overflowing.load(std::memory_order_acquire) && m_ring.TryPush(slot))
+            continue;
+
+        std::scoped_lock lock(m_overflowMutex);
+        m_overflow.push_back(slot);
+        m_overflowing.store(true, std::memory_order_release);
+        m_overflowCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
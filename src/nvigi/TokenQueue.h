@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+// Bounded single-producer/single-consumer ring.  TryPush and TryPop never block or allocate; each
+// side writes only its own index and keeps a cached copy of the other, on separate cache lines.
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer only
+    bool TryPush(const T& value)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tailCache == Capacity)
+        {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head - m_tailCache == Capacity)
+                return false;
+        }
+        m_items[head & (Capacity - 1)] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only
+    bool TryPop(T& value)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_headCache)
+        {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail == m_headCache)
+                return false;
+        }
+        value = m_items[tail & (Capacity - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    alignas(64) std::atomic<size_t> m_head = 0;
+    size_t m_tailCache = 0;
+    alignas(64) std::atomic<size_t> m_tail = 0;
+    size_t m_headCache = 0;
+    alignas(64) std::array<T, Capacity> m_items{};
+};
+
+// Answer text streamed from the inference callbacks to the chat UI.
+//
+// Only one inference callback runs at a time (each evaluation finishes before the next is launched),
+// so there is a single producer; the UI thread is the consumer and drains the queue once per frame.
+// Text is copied into fixed-size slots, splitting long fragments.  If the ring fills up because the
+// UI has stalled, the producer switches to a locked overflow list until the UI has caught up, so no
+// text is lost and a callback never waits for a frame.
+class TokenQueue
+{
+public:
+    struct Slot
+    {
+        static constexpr size_t kMaxText = 63;
+        uint8_t m_size = 0;
+        char m_text[kMaxText];
+    };
+    static constexpr size_t kCapacity = 4096;
+
+    // Producer only
+    void Push(std::string_view text);
+
+    // Consumer only: calls sink(std::string_view) for each fragment in push order; returns the number of fragments
+    template <typename Sink>
+    size_t Drain(Sink&& sink)
+    {
+        size_t count = 0;
+        Slot slot;
+        while (m_ring.TryPop(slot))
+        {
+            sink(std::string_view(slot.m_text, slot.m_size));
+            count++;
+        }
+
+        // The producer only uses the overflow once the ring was full, so everything in the ring came first.
+        // Entries pushed just before the switch may only be visible now; the ring stays untouched until
+        // the overflow is cleared, so draining it again here keeps the order.
+        if (m_overflowing.load(std::memory_order_acquire))
+        {
+            while (m_ring.TryPop(slot))
+            {
+                sink(std::string_view(slot.m_text, slot.m_size));
+                count++;
+            }
+
+            std::vector<Slot> overflow;
+            {
+                std::scoped_lock lock(m_overflowMutex);
+                overflow.swap(m_overflow);
+                m_overflowing.store(false, std::memory_order_release);
+            }
+            for (const Slot& s : overflow)
+                sink(std::string_view(s.m_text, s.m_size));
+            count += overflow.size();
+        }
+        return count;
+    }
+
+    // Fragments that went through the overflow list; non-zero means the UI fell behind
+    uint64_t GetOverflowCount() const { return m_overflowCount.load(std::memory_order_relaxed); }
+
+private:
+    SpscRing<Slot, kCapacity> m_ring;
+    std::atomic<bool> m_overflowing = false;
+    std::atomic<uint64_t> m_overflowCount = 0;
+    std::mutex m_overflowMutex;
+    std::vector<Slot> m_overflow;
+};
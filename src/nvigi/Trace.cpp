@@ -0,0 +1,226 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#include "Trace.h"
+#include "LogSink.h"
+
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Trace::s_enabled = false;
+std::atomic<int> Trace::s_framesRemaining = 0;
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char* m_name;
+        uint64_t m_start;
+        // Instant events have no duration
+        uint64_t m_end;
+    };
+
+    // Only the owning thread writes; the lock is uncontended except while a capture is written out
+    struct ThreadBuffer
+    {
+        std::mutex m_mutex;
+        std::vector<TraceEvent> m_events;
+        uint64_t m_written = 0;
+        uint32_t m_tid = 0;
+        const char* m_name = nullptr;
+        bool m_exited = false;
+    };
+
+    // Marks the buffer when its thread exits, so short-lived threads can be dropped by the next capture
+    struct ThreadBufferOwner
+    {
+        std::shared_ptr<ThreadBuffer> m_buffer;
+        ~ThreadBufferOwner()
+        {
+            if (m_buffer)
+            {
+                std::scoped_lock lock(m_buffer->m_mutex);
+                m_buffer->m_exited = true;
+            }
+        }
+    };
+
+    struct TraceState
+    {
+        std::mutex m_mutex;
+        // Buffers outlive their thread so its events still make it into the capture; dropped at the next start
+        std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+        uint32_t m_nextTid = 1;
+        std::string m_path;
+        uint64_t m_captureStart = 0;
+        std::atomic<uint64_t> m_lastFrame = 0;
+    };
+
+    TraceState& GetState()
+    {
+        static TraceState state;
+        return state;
+    }
+
+    ThreadBuffer& GetThreadBuffer()
+    {
+        thread_local ThreadBufferOwner owner;
+        if (!owner.m_buffer)
+        {
+            owner.m_buffer = std::make_shared<ThreadBuffer>();
+            auto& state = GetState();
+            std::scoped_lock lock(state.m_mutex);
+            owner.m_buffer->m_tid = state.m_nextTid++;
+            state.m_buffers.push_back(owner.m_buffer);
+        }
+        return *owner.m_buffer;
+    }
+
+    void Push(const char* name, uint64_t start, uint64_t end)
+    {
+        auto& buffer = GetThreadBuffer();
+        std::scoped_lock lock(buffer.m_mutex);
+        // Grow up to the ring size; threads that record little (e.g. audio playback) stay small
+        if (buffer.m_events.size() < Trace::kEventsPerThread)
+            buffer.m_events.push_back({ name, start, end });
+        else
+            buffer.m_events[buffer.m_written % Trace::kEventsPerThread] = { name, start, end };
+        buffer.m_written++;
+    }
+
+    std::string EscapeJSON(const char* text)
+    {
+        std::string out;
+        for (const char* c = text; *c; c++)
+        {
+            if (*c == '"' || *c == '\\')
+                out += '\\';
+            if ((unsigned char)*c >= 0x20)
+                out += *c;
+        }
+        return out;
+    }
+}
+
+void Trace::StartCapture(const std::string& path, int frames)
+{
+    auto& state = GetState();
+    {
+        std::scoped_lock lock(state.m_mutex);
+        std::vector<std::shared_ptr<ThreadBuffer>> live;
+        for (auto& buffer : state.m_buffers)
+        {
+            std::scoped_lock bufferLock(buffer->m_mutex);
+            if (buffer->m_exited)
+                continue;
+            buffer->m_written = 0;
+            buffer->m_events.clear();
+            live.push_back(buffer);
+        }
+        state.m_buffers.swap(live);
+        state.m_path = path;
+        state.m_captureStart = Now();
+    }
+    state.m_lastFrame = 0;
+    s_framesRemaining = frames > 0 ? frames : 0;
+    s_enabled = true;
+    LogSink::Info("Trace capture started%s", frames > 0 ? " (frame limited)" : "");
+}
+
+bool Trace::StopCapture()
+{
+    if (!s_enabled.exchange(false))
+        return false;
+    s_framesRemaining = 0;
+
+    auto& state = GetState();
+    std::scoped_lock lock(state.m_mutex);
+
+    std::ofstream file(state.m_path, std::ios::trunc);
+    if (!file)
+    {
+        LogSink::Warning("Unable to write trace to %s", state.m_path.c_str());
+        return false;
+    }
+
+    // Chrome trace timestamps are in microseconds
+    auto toMicros = [&](uint64_t ns) { return (double)(ns - state.m_captureStart) / 1000.0; };
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"args\":{\"name\":\"NVIGISample\"}}";
+    size_t eventCount = 0;
+    for (auto& buffer : state.m_buffers)
+    {
+        std::scoped_lock bufferLock(buffer->m_mutex);
+        if (buffer->m_name)
+        {
+            file << ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->m_tid
+                << ",\"args\":{\"name\":\"" << EscapeJSON(buffer->m_name) << "\"}}";
+        }
+
+        uint64_t count = buffer->m_written < kEventsPerThread ? buffer->m_written : kEventsPerThread;
+        for (uint64_t i = buffer->m_written - count; i < buffer->m_written; i++)
+        {
+            const TraceEvent& event = buffer->m_events[i % kEventsPerThread];
+            // Zones that began before the capture started
+            if (event.m_start < state.m_captureStart)
+                continue;
+
+            file << ",\n{\"name\":\"" << EscapeJSON(event.m_name) << "\",\"cat\":\"nvigi\",\"pid\":1,\"tid\":" << buffer->m_tid
+                << ",\"ts\":" << toMicros(event.m_start);
+            if (event.m_end)
+                file << ",\"ph\":\"X\",\"dur\":" << (double)(event.m_end - event.m_start) / 1000.0 << "}";
+            else
+                file << ",\"ph\":\"i\",\"s\":\"t\"}";
+            eventCount++;
+        }
+    }
+    file << "\n]}\n";
+
+    if (!file.good())
+    {
+        LogSink::Warning("Unable to write trace to %s", state.m_path.c_str());
+        return false;
+    }
+    LogSink::Info("Wrote %zu trace events to %s", eventCount, state.m_path.c_str());
+    return true;
+}
+
+void Trace::EndFrame()
+{
+    if (!IsEnabled())
+        return;
+
+    // Present-to-present zone on the presenting thread
+    uint64_t now = Now();
+    uint64_t last = GetState().m_lastFrame.exchange(now);
+    if (last)
+        Push("Frame", last, now);
+
+    int remaining = s_framesRemaining.load();
+    if (remaining > 0 && s_framesRemaining.fetch_sub(1) == 1)
+        StopCapture();
+}
+
+void Trace::SetThreadName(const char* name)
+{
+    auto& buffer = GetThreadBuffer();
+    std::scoped_lock lock(buffer.m_mutex);
+    buffer.m_name = name;
+}
+
+void Trace::RecordZone(const char* name, uint64_t startNs, uint64_t endNs)
+{
+    // Keep zero-length zones distinguishable from instants
+    Push(name, startNs, endNs > startNs ? endNs : startNs + 1);
+}
+
+void Trace::RecordInstant(const char* name)
+{
+    if (IsEnabled())
+        Push(name, Now(), 0);
+}
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Lightweight timeline tracing, written out in the Chrome trace event format (chrome://tracing or
+// https://ui.perfetto.dev).
+//
+// Each thread records into its own fixed-size ring buffer, so once the buffer fills only the most
+// recent events are kept.  Zone names must be string literals (or otherwise outlive the capture).
+// While no capture is running a zone costs one relaxed atomic load.
+class Trace
+{
+public:
+    static constexpr uint32_t kEventsPerThread = 1u << 16;
+
+    static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // Clears previous events and starts recording.  With frames > 0 the capture stops and is written
+    // to the path by EndFrame() once that many frames have been presented.
+    static void StartCapture(const std::string& path, int frames = 0);
+    // Stops recording and writes everything captured so far
+    static bool StopCapture();
+    // Counts presented frames for captures with a frame limit; to be called once per frame
+    static void EndFrame();
+    static int GetFramesRemaining() { return s_framesRemaining.load(std::memory_order_relaxed); }
+
+    // Names the calling thread in the trace; the name must be a string literal
+    static void SetThreadName(const char* name);
+
+    static uint64_t Now()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    static void RecordZone(const char* name, uint64_t startNs, uint64_t endNs);
+    static void RecordInstant(const char* name);
+
+private:
+    static std::atomic<bool> s_enabled;
+    static std::atomic<int> s_framesRemaining;
+};
+
+// Records the enclosing scope as one zone
+class TraceZone
+{
+public:
+    explicit TraceZone(const char* name)
+        : m_name(Trace::IsEnabled() ? name : nullptr)
+    {
+        if (m_name)
+            m_start = Trace::Now();
+    }
+    ~TraceZone()
+    {
+        if (m_name)
+            Trace::RecordZone(m_name, m_start, Trace::Now());
+    }
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+    const char* m_name;
+    uint64_t m_start = 0;
+};
+
+#define NVIGI_TRACE_CONCAT_INNER(a, b) a##b
+#define NVIGI_TRACE_CONCAT(a, b) NVIGI_TRACE_CONCAT_INNER(a, b)
+#define NVIGI_TRACE_ZONE(name) TraceZone NVIGI_TRACE_CONCAT(traceZone, __LINE__)(name)